@@ -152,6 +152,9 @@ export type StaticSystemInformation = {
 	cpu_reset_reason: string;
 	heap_info_app: string; // 🌙
 	heap_info_dma: string; // 🌙
+	ws_queue: string; // 🌙 websocket send queues
+	mem_degradation?: string; // 🌙 memory degradation level, optional as only with MoonBase
+	mem_tags?: string[]; // 🌙 heap per subsystem
 	coprocessor?: string; // 🌙 optional as only for ESP32-P4
 };
 
@@ -56,4 +56,21 @@ export type FilesState = {
 	fs_total: number;
 	fs_used: number;
 	showHidden: boolean;
+	version?: number; // of the FileIndex on the device, see FilesJournal
+};
+
+// Changes of the files on the device since version from (FileIndex.h), sent instead of the whole tree
+export type FilesJournal = {
+	from: number;
+	version: number;
+	fs_total: number;
+	fs_used: number;
+	showHidden: boolean;
+	changes: {
+		op: 'added' | 'removed' | 'modified';
+		path: string;
+		isFile?: boolean;
+		size?: number;
+		time?: number;
+	}[];
 };
@@ -0,0 +1,91 @@
+/**
+ * Pure utility functions for FileManager.svelte, extracted for testability.
+ */
+
+import type { FilesJournal, FilesState } from '$lib/types/moonbase_models';
+
+/** Same order as the device index (FileIndex.h): by name, byte wise. */
+function compareNames(a: string, b: string): number {
+	return a < b ? -1 : a > b ? 1 : 0;
+}
+
+/** The files array of the folder at path, created (with its parents) if create is set. */
+function folderFiles(tree: FilesState, path: string, create: boolean): FilesState[] | null {
+	let files = tree.files;
+	let folderPath = '';
+	for (const name of path.split('/').filter((part) => part !== '')) {
+		folderPath += '/' + name;
+		let folder = files.find((file) => file.name === name && !file.isFile);
+		if (!folder) {
+			if (!create) return null;
+			folder = newEntry(name, folderPath, false);
+			insertEntry(files, folder);
+		}
+		files = folder.files;
+	}
+	return files;
+}
+
+function newEntry(name: string, path: string, isFile: boolean): FilesState {
+	return {
+		name,
+		path,
+		isFile,
+		size: 0,
+		time: 0,
+		contents: '',
+		files: [],
+		fs_total: 0,
+		fs_used: 0,
+		showHidden: false
+	};
+}
+
+function insertEntry(files: FilesState[], entry: FilesState) {
+	const index = files.findIndex((file) => compareNames(file.name, entry.name) > 0);
+	if (index < 0) files.push(entry);
+	else files.splice(index, 0, entry);
+}
+
+/**
+ * Applies a journal of file changes to the tree (in place).
+ * 'ignored': the tree already has this version, 'reload': the tree is not the version the journal starts from
+ * (a journal was missed): get the whole tree.
+ */
+export function applyFilesJournal(
+	tree: FilesState,
+	journal: FilesJournal
+): 'applied' | 'ignored' | 'reload' {
+	if (tree.version === journal.version) return 'ignored';
+	if (tree.version !== journal.from) return 'reload';
+
+	for (const change of journal.changes) {
+		const slash = change.path.lastIndexOf('/');
+		const name = change.path.substring(slash + 1);
+		const files = folderFiles(tree, change.path.substring(0, slash), change.op !== 'removed');
+		if (!files) continue;
+		const index = files.findIndex((file) => file.name === name);
+		if (change.op === 'removed') {
+			if (index >= 0) files.splice(index, 1);
+			continue;
+		}
+		let entry = index >= 0 ? files[index] : null;
+		if (entry && entry.isFile !== !!change.isFile) {
+			files.splice(index, 1); // a file replaced by a folder or vice versa
+			entry = null;
+		}
+		if (!entry) {
+			entry = newEntry(name, change.path, !!change.isFile);
+			insertEntry(files, entry);
+		}
+		if (entry.isFile) {
+			entry.size = change.size ?? 0;
+			entry.time = change.time ?? 0;
+		}
+	}
+
+	tree.version = journal.version;
+	tree.fs_total = journal.fs_total;
+	tree.fs_used = journal.fs_used;
+	return 'applied';
+}
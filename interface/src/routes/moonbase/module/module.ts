@@ -74,3 +74,21 @@ export function updateRecursive(
 		}
 	}
 }
+
+/**
+ * Returns the value at a state path like 'nodes[3].controls[5].value' (the format of StatePath.h on the server),
+ * or undefined if the path does not exist in data.
+ */
+export function getByPath(data: Record<string, unknown>, path: string): unknown {
+	let current: unknown = data;
+	for (const step of path.split('.')) {
+		const match = /^([^[\]]+)(?:\[(\d+)\])?$/.exec(step);
+		if (!match || current === null || typeof current !== 'object') return undefined;
+		current = (current as Record<string, unknown>)[match[1]];
+		if (match[2] !== undefined) {
+			if (!Array.isArray(current)) return undefined;
+			current = current[Number(match[2])];
+		}
+	}
+	return current;
+}
@@ -21,3 +21,83 @@ export function normalizePosition(
 		depth === 1 ? 0 : ((depth - 1 - z) / (depth - 1)) * 2.0 - 1.0
 	];
 }
+
+/** A decoded monitor frame: channels of every step-th light (see MonitorCodec.h). */
+export interface MonitorFrame {
+	channels: Uint8Array;
+	step: number;
+}
+
+/**
+ * Decodes a compressed monitor frame (MonitorCodec.h: 'M', flags, channelsPerLight, step, length, RLE payload).
+ * A keyframe holds the channels, a delta frame is XORed into previous (its channels are updated in place).
+ * Returns null if data is not a valid frame, or a delta frame arrives without a previous frame of its length
+ * (e.g. right after connecting: wait for the next keyframe).
+ */
+export function decodeMonitorFrame(
+	data: Uint8Array,
+	previous: MonitorFrame | null
+): MonitorFrame | null {
+	if (data.length < 8 || data[0] != 0x4d) return null; // 'M'
+	const keyframe = (data[1] & 0x01) != 0;
+	const step = data[3] || 1;
+	const length = (data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24)) >>> 0;
+	let frame: Uint8Array;
+	if (keyframe)
+		frame =
+			previous && previous.channels.length == length ? previous.channels : new Uint8Array(length);
+	else if (previous && previous.channels.length == length && previous.step == step)
+		frame = previous.channels;
+	else return null;
+
+	let i = 8;
+	let out = 0;
+	while (out < length && i < data.length) {
+		const c = data[i++];
+		if (c < 0x80) {
+			// literals
+			const count = c + 1;
+			if (i + count > data.length || out + count > length) return null;
+			for (let k = 0; k < count; k++, out++)
+				frame[out] = keyframe ? data[i + k] : frame[out] ^ data[i + k];
+			i += count;
+			continue;
+		}
+		let count = 0;
+		if (c < 0xff) count = c - 0x80 + 3;
+		else {
+			// varint run length
+			for (let shift = 0; ; shift += 7) {
+				if (i >= data.length || shift > 28) return null;
+				const b = data[i++];
+				count += (b & 0x7f) * 2 ** shift;
+				if (!(b & 0x80)) break;
+			}
+		}
+		if (i >= data.length || out + count > length) return null;
+		const value = data[i++];
+		if (keyframe) frame.fill(value, out, out + count);
+		else if (value) for (let k = out; k < out + count; k++) frame[k] ^= value;
+		out += count;
+	}
+	return out == length ? { channels: frame, step } : null;
+}
+
+/**
+ * Expands a downsampled frame (every step-th light) to nrOfLights: light i shows sampled light floor(i / step).
+ * Returns sampled itself when step is 1.
+ */
+export function expandMonitorFrame(
+	sampled: Uint8Array,
+	step: number,
+	channelsPerLight: number,
+	nrOfLights: number
+): Uint8Array {
+	if (step <= 1) return sampled;
+	const channels = new Uint8Array(nrOfLights * channelsPerLight);
+	for (let light = 0; light < nrOfLights; light++) {
+		const from = Math.floor(light / step) * channelsPerLight;
+		channels.set(sampled.subarray(from, from + channelsPerLight), light * channelsPerLight);
+	}
+	return channels;
+}
@@ -0,0 +1,86 @@
+import { describe, expect, it } from 'vitest';
+import { applyFilesJournal } from '../routes/moonbase/filemanager/files';
+import type { FilesJournal, FilesState } from '$lib/types/moonbase_models';
+
+function entry(path: string, isFile: boolean, files: FilesState[] = [], size = 0): FilesState {
+	return {
+		name: path.substring(path.lastIndexOf('/') + 1),
+		path,
+		isFile,
+		size,
+		time: 0,
+		contents: '',
+		files,
+		fs_total: 0,
+		fs_used: 0,
+		showHidden: false
+	};
+}
+
+function tree(): FilesState {
+	const root = entry('', false, [
+		entry('/livescripts', false, [entry('/livescripts/fire.sc', true, [], 10)]),
+		entry('/readme.txt', true, [], 5)
+	]);
+	root.name = '/';
+	root.version = 7;
+	return root;
+}
+
+function journal(from: number, version: number, changes: FilesJournal['changes']): FilesJournal {
+	return { from, version, fs_total: 1000, fs_used: 200, showHidden: false, changes };
+}
+
+describe('applyFilesJournal', () => {
+	it('adds files in name order, creating missing folders', () => {
+		const files = tree();
+		const result = applyFilesJournal(
+			files,
+			journal(7, 9, [
+				{ op: 'added', path: '/livescripts/air.sc', isFile: true, size: 3, time: 1 },
+				{ op: 'added', path: '/new/deep/a.json', isFile: true, size: 1, time: 1 }
+			])
+		);
+		expect(result).toBe('applied');
+		expect(files.version).toBe(9);
+		expect(files.fs_used).toBe(200);
+		expect(files.files.map((f) => f.name)).toEqual(['livescripts', 'new', 'readme.txt']);
+		expect(files.files[0].files.map((f) => f.name)).toEqual(['air.sc', 'fire.sc']);
+		expect(files.files[1].files[0].files[0].path).toBe('/new/deep/a.json');
+	});
+
+	it('removes a folder with its contents and modifies files', () => {
+		const files = tree();
+		applyFilesJournal(
+			files,
+			journal(7, 8, [
+				{ op: 'removed', path: '/livescripts' },
+				{ op: 'modified', path: '/readme.txt', isFile: true, size: 50, time: 2 },
+				{ op: 'removed', path: '/not/there' }
+			])
+		);
+		expect(files.files.map((f) => f.name)).toEqual(['readme.txt']);
+		expect(files.files[0].size).toBe(50);
+	});
+
+	it('a renamed folder arrives as removed and added', () => {
+		const files = tree();
+		applyFilesJournal(
+			files,
+			journal(7, 10, [
+				{ op: 'removed', path: '/livescripts' },
+				{ op: 'added', path: '/scripts', isFile: false },
+				{ op: 'added', path: '/scripts/fire.sc', isFile: true, size: 10, time: 0 }
+			])
+		);
+		expect(files.files.map((f) => f.path)).toEqual(['/readme.txt', '/scripts']);
+		expect(files.files[1].files[0].path).toBe('/scripts/fire.sc');
+	});
+
+	it('ignores a journal it already has and reloads after a missed one', () => {
+		const files = tree();
+		expect(applyFilesJournal(files, journal(6, 7, []))).toBe('ignored');
+		expect(applyFilesJournal(files, journal(8, 9, []))).toBe('reload');
+		expect(files.version).toBe(7);
+	});
+});
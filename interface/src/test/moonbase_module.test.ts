@@ -1,5 +1,5 @@
 import { describe, expect, it } from 'vitest';
-import { updateRecursive } from '../routes/moonbase/module/module';
+import { getByPath, updateRecursive } from '../routes/moonbase/module/module';
 
 describe('updateRecursive', () => {
 	it('updates a primitive value when changed', () => {
@@ -116,3 +116,33 @@ describe('updateRecursive', () => {
 		expect(old.a).toBeNull();
 	});
 });
+
+describe('getByPath', () => {
+	const data = {
+		brightness: 10,
+		nodes: [
+			{ name: 'Solid', controls: [] },
+			{ name: 'Lava', controls: [{ name: 'speed', value: 128 }, { name: 'center', value: { x: 1, y: 2 } }] }
+		]
+	};
+
+	it('returns a root value', () => {
+		expect(getByPath(data, 'brightness')).toBe(10);
+	});
+
+	it('returns a value in a row', () => {
+		expect(getByPath(data, 'nodes[1].name')).toBe('Lava');
+	});
+
+	it('returns a control value two rows deep', () => {
+		expect(getByPath(data, 'nodes[1].controls[0].value')).toBe(128);
+		expect(getByPath(data, 'nodes[1].controls[1].value')).toEqual({ x: 1, y: 2 });
+	});
+
+	it('returns undefined for missing rows, keys and malformed paths', () => {
+		expect(getByPath(data, 'nodes[5].name')).toBeUndefined();
+		expect(getByPath(data, 'brightness[0]')).toBeUndefined();
+		expect(getByPath(data, 'nodes[1].controls[0].value.x')).toBeUndefined();
+		expect(getByPath(data, 'nodes[x].name')).toBeUndefined();
+	});
+});
@@ -1,5 +1,9 @@
 import { describe, expect, it } from 'vitest';
-import { normalizePosition } from '../routes/moonbase/monitor/monitor';
+import {
+	decodeMonitorFrame,
+	expandMonitorFrame,
+	normalizePosition
+} from '../routes/moonbase/monitor/monitor';
 
 describe('normalizePosition', () => {
 	it('maps origin (0,0,0) to (-1, 1, 1) for a 3D grid', () => {
@@ -58,3 +62,69 @@ describe('normalizePosition', () => {
 		expect(z).toBe(0); // depth=1 collapses
 	});
 });
+
+// frame header: 'M', flags (1 = keyframe), channelsPerLight, step, length (LE)
+const frame = (keyframe: boolean, step: number, length: number, payload: number[]) =>
+	new Uint8Array([0x4d, keyframe ? 1 : 0, 3, step, length & 0xff, length >> 8, 0, 0, ...payload]);
+
+describe('decodeMonitorFrame', () => {
+	it('decodes a keyframe of literals and runs', () => {
+		// 3 literals 1,2,3 then a run of 3 × 9
+		const decoded = decodeMonitorFrame(frame(true, 1, 6, [2, 1, 2, 3, 0x80, 9]), null);
+		expect(decoded?.channels).toEqual(new Uint8Array([1, 2, 3, 9, 9, 9]));
+		expect(decoded?.step).toBe(1);
+	});
+
+	it('applies a delta frame to the previous frame', () => {
+		const key = decodeMonitorFrame(frame(true, 1, 6, [5, 1, 2, 3, 4, 5, 6]), null);
+		// XOR: first 5 bytes unchanged (run of zeros), last byte ^ 0x0f
+		const delta = decodeMonitorFrame(frame(false, 1, 6, [0x82, 0, 0, 0x0f]), key);
+		expect(delta?.channels).toEqual(new Uint8Array([1, 2, 3, 4, 5, 6 ^ 0x0f]));
+	});
+
+	it('decodes long runs with a varint count', () => {
+		// 0xff, 300 = 0xac 0x02, value 7
+		const decoded = decodeMonitorFrame(frame(true, 1, 300, [0xff, 0xac, 0x02, 7]), null);
+		expect(decoded?.channels.length).toBe(300);
+		expect(decoded?.channels.every((c) => c == 7)).toBe(true);
+	});
+
+	it('ignores a delta frame without a matching previous frame', () => {
+		expect(decodeMonitorFrame(frame(false, 1, 3, [0x80, 0]), null)).toBeNull();
+		const key = decodeMonitorFrame(frame(true, 1, 6, [0x83, 1]), null);
+		expect(decodeMonitorFrame(frame(false, 1, 3, [0x80, 0]), key)).toBeNull(); // other length
+		expect(decodeMonitorFrame(frame(false, 2, 6, [0x83, 0]), key)).toBeNull(); // other step
+	});
+
+	it('rejects malformed frames', () => {
+		const noMagic = new Uint8Array([0x58, 1, 3, 1, 3, 0, 0, 0, 2, 1, 2, 3]);
+		expect(decodeMonitorFrame(noMagic, null)).toBeNull(); // no 'M'
+		expect(decodeMonitorFrame(frame(true, 1, 6, [5, 1, 2]), null)).toBeNull(); // truncated literals
+		expect(decodeMonitorFrame(frame(true, 1, 3, [0x81, 5]), null)).toBeNull(); // run past the end
+		expect(decodeMonitorFrame(frame(true, 1, 6, [0x80, 5]), null)).toBeNull(); // too short
+	});
+
+	it('ignores the padding byte of a 48 byte frame', () => {
+		// 39 literals: 8 + 40 = 48 bytes with padding
+		const payload = [38, ...Array.from({ length: 39 }, (_, i) => i)];
+		const decoded = decodeMonitorFrame(frame(true, 1, 39, [...payload, 0]), null);
+		expect(decoded?.channels.length).toBe(39);
+		expect(decoded?.channels[38]).toBe(38);
+	});
+});
+
+describe('expandMonitorFrame', () => {
+	it('repeats every sampled light step times', () => {
+		const sampled = new Uint8Array([1, 1, 1, 2, 2, 2, 3, 3, 3]); // lights 0, 4, 8 of 10
+		const channels = expandMonitorFrame(sampled, 4, 3, 10);
+		expect(channels.length).toBe(30);
+		expect(Array.from(channels.subarray(9, 12))).toEqual([1, 1, 1]); // light 3
+		expect(Array.from(channels.subarray(12, 15))).toEqual([2, 2, 2]); // light 4
+		expect(Array.from(channels.subarray(27, 30))).toEqual([3, 3, 3]); // light 9
+	});
+
+	it('returns the frame itself when not downsampled', () => {
+		const sampled = new Uint8Array([1, 2, 3]);
+		expect(expandMonitorFrame(sampled, 1, 3, 1)).toBe(sampled);
+	});
+});
@@ -123,6 +123,7 @@ public:
     uint32_t lps_drivers_cycles = 0; // 🌙 CPU cycles consumed by layerP.loopDrivers() per second (accumulated)
     uint16_t lps_effects = 0;        // 🌙 effects theoretical max loops/s (computed each second)
     uint16_t lps_drivers = 0;        // 🌙 drivers theoretical max loops/s (computed each second)
+    void (*systemStatusExtension)(JsonObject root) = nullptr; // 🌙 adds application fields to System Status (memory per subsystem)
 
     ESP32SvelteKit(PsychicHttpServer *server, unsigned int numberEndpoints = 115);
 
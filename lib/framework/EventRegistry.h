@@ -0,0 +1,120 @@
+#ifndef EventRegistry_h
+#define EventRegistry_h
+
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2025 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+// 🌙 Event names interned to small ids at registerEvent(), subscriptions in flat arrays indexed by id:
+// emitting looks up an id once (or not at all when the caller keeps it) instead of String keyed maps.
+// Threading: add(), subscribe(), unsubscribe() and iterating subscribers() need the owner's lock (EventSocket:
+// clientSubscriptionsMutex). find(), name() and isValid() are lock free: the storage is reserved for
+// EVENT_REGISTRY_CAPACITY events and never grows beyond it, so it is never reallocated under a reader.
+// No ESP32 / Arduino dependencies, used in native unit tests.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+typedef uint8_t EventId;
+#define EVENT_ID_NONE UINT8_MAX
+#define EVENT_REGISTRY_CAPACITY 64 // hard cap: reserved up front so lock free lookups never see a reallocation
+
+class EventRegistry
+{
+public:
+    EventRegistry()
+    {
+        _names.reserve(EVENT_REGISTRY_CAPACITY);
+        _hashes.reserve(EVENT_REGISTRY_CAPACITY);
+        _subscribers.reserve(EVENT_REGISTRY_CAPACITY);
+    }
+
+    // Id of name, added if new. EVENT_ID_NONE if the registry is full (EVENT_REGISTRY_CAPACITY).
+    EventId add(const char *name)
+    {
+        EventId id = find(name);
+        if (id != EVENT_ID_NONE || _names.size() >= EVENT_REGISTRY_CAPACITY)
+            return id;
+        _subscribers.emplace_back();
+        _names.emplace_back(name);
+        _hashes.push_back(hash(name)); // last: find() compares hashes first, so the name and subscribers exist
+        return _names.size() - 1;
+    }
+
+    // Id of name, EVENT_ID_NONE if not registered
+    EventId find(const char *name) const
+    {
+        if (!name)
+            return EVENT_ID_NONE;
+        uint32_t h = hash(name);
+        for (size_t id = 0; id < _hashes.size(); id++)
+            if (_hashes[id] == h && _names[id] == name)
+                return id;
+        return EVENT_ID_NONE;
+    }
+
+    bool isValid(EventId id) const { return id < _hashes.size(); }
+    const char *name(EventId id) const { return isValid(id) ? _names[id].c_str() : ""; }
+    size_t size() const { return _names.size(); }
+
+    // Subscriptions: client sockets per event, each client once
+    void subscribe(EventId id, int client)
+    {
+        if (!isValid(id))
+            return;
+        std::vector<int> &clients = _subscribers[id];
+        if (std::find(clients.begin(), clients.end(), client) == clients.end())
+            clients.push_back(client);
+    }
+
+    void unsubscribe(EventId id, int client)
+    {
+        if (!isValid(id))
+            return;
+        std::vector<int> &clients = _subscribers[id];
+        clients.erase(std::remove(clients.begin(), clients.end(), client), clients.end());
+    }
+
+    // client closed: remove it from all events
+    void unsubscribeAll(int client)
+    {
+        for (EventId id = 0; id < _subscribers.size(); id++)
+            unsubscribe(id, client);
+    }
+
+    const std::vector<int> &subscribers(EventId id) const
+    {
+        static const std::vector<int> none;
+        return isValid(id) ? _subscribers[id] : none;
+    }
+
+private:
+    static_assert(EVENT_REGISTRY_CAPACITY < EVENT_ID_NONE, "EventId must hold every id and EVENT_ID_NONE");
+
+    std::vector<std::string> _names;
+    std::vector<uint32_t> _hashes; // compared before the name
+    std::vector<std::vector<int>> _subscribers;
+
+    static uint32_t hash(const char *name)
+    {
+        uint32_t h = 2166136261u; // FNV-1a
+        while (*name)
+            h = (h ^ (uint8_t)*name++) * 16777619u;
+        return h;
+    }
+};
+
+#endif
@@ -0,0 +1,296 @@
+#ifndef EventSendQueue_h
+#define EventSendQueue_h
+
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2025 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+// 🌙 Bounded send queue of one websocket client: EventSocket::emitEvent() queues a message per subscriber
+// and returns, the HTTP task sends them. A slow client only fills its own queue.
+// EventSendFrame: the message of a client being written without blocking, resumed where the socket stopped taking bytes.
+// No ESP32 / Arduino dependencies, used in native unit tests.
+
+#include <EventRegistry.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <vector>
+
+// How messages of an event are queued when a client does not keep up
+enum class EventSendPolicy : uint8_t
+{
+    ordered, // every message is sent, in order (notifications)
+    latest,  // a queued message of the same event is replaced: the message is the whole state (module and service state)
+    stream   // frames (monitor): dropped when the client lags, then skipped until the next keyframe
+};
+
+// One emitted message, shared by the queues of all subscribers
+struct EventMessage
+{
+    EventId event = EVENT_ID_NONE;
+    EventSendPolicy policy = EventSendPolicy::ordered;
+    bool keyframe = false; // stream: frame does not depend on earlier frames
+    std::vector<uint8_t> data;
+};
+
+typedef std::shared_ptr<const EventMessage> EventMessagePtr;
+
+struct EventSendStats
+{
+    uint32_t queued = 0;    // messages accepted
+    uint32_t sent = 0;      // messages taken by the sender
+    uint32_t coalesced = 0; // messages replaced by a newer one before they were sent
+    uint32_t dropped = 0;   // messages not sent: queue full, or stream frames of a lagging client
+    uint16_t depth = 0;     // messages in the queue now
+    uint16_t maxDepth = 0;  // high-water mark of depth
+    uint32_t bytes = 0;     // bytes in the queue now
+};
+
+class EventSendQueue
+{
+public:
+    EventSendQueue(size_t maxMessages = 16, size_t maxBytes = 64 * 1024) : _maxMessages(maxMessages), _maxBytes(maxBytes) {}
+
+    // Queues message according to its policy. Returns false if it is dropped.
+    bool push(const EventMessagePtr &message)
+    {
+        const EventMessage &m = *message;
+        if (m.policy == EventSendPolicy::latest)
+        {
+            for (EventMessagePtr &queued : _messages)
+            {
+                if (queued->policy == EventSendPolicy::latest && queued->event == m.event)
+                {
+                    _stats.bytes = _stats.bytes - queued->data.size() + m.data.size();
+                    queued = message; // keeps its place in the queue
+                    _stats.coalesced++;
+                    _stats.queued++;
+                    return true;
+                }
+            }
+        }
+        else if (m.policy == EventSendPolicy::stream)
+        {
+            if (m.keyframe)
+            {
+                setLagging(m.event, false);
+                removeFrames(m.event); // queued frames are superseded by the keyframe
+            }
+            else if (isLagging(m.event) || _messages.size() >= _maxMessages / 2)
+            {
+                // lagging: skip deltas, the client only gets keyframes until it catches up
+                setLagging(m.event, true);
+                _stats.dropped++;
+                return false;
+            }
+        }
+
+        while (!fits(m.data.size()))
+        {
+            if (!dropOldestFrame()) // make room for state and ordered messages at the cost of frames
+            {
+                if (m.policy == EventSendPolicy::stream)
+                    setLagging(m.event, true);
+                _stats.dropped++;
+                return false;
+            }
+        }
+
+        _messages.push_back(message);
+        _stats.bytes += m.data.size();
+        _stats.queued++;
+        _stats.depth = _messages.size();
+        if (_stats.depth > _stats.maxDepth)
+            _stats.maxDepth = _stats.depth;
+        return true;
+    }
+
+    // Takes the oldest message, false if the queue is empty
+    bool pop(EventMessagePtr &message)
+    {
+        if (_messages.empty())
+            return false;
+        message = std::move(_messages.front());
+        _messages.pop_front();
+        _stats.bytes -= message->data.size();
+        _stats.depth = _messages.size();
+        _stats.sent++;
+        return true;
+    }
+
+    // Drops all queued messages (client gone or send failed)
+    void clear()
+    {
+        _stats.dropped += _messages.size();
+        _messages.clear();
+        _stats.bytes = 0;
+        _stats.depth = 0;
+    }
+
+    size_t size() const { return _messages.size(); }
+    bool empty() const { return _messages.empty(); }
+    const EventSendStats &stats() const { return _stats; }
+
+private:
+    size_t _maxMessages;
+    size_t _maxBytes;
+    std::deque<EventMessagePtr> _messages;
+    std::vector<EventId> _lagging; // stream events waiting for a keyframe
+    EventSendStats _stats;
+
+    bool fits(size_t size) const
+    {
+        // an empty queue takes any message, so a message larger than maxBytes is still sent
+        return _messages.empty() || (_messages.size() < _maxMessages && _stats.bytes + size <= _maxBytes);
+    }
+
+    bool isLagging(EventId event) const
+    {
+        for (EventId lagging : _lagging)
+            if (lagging == event)
+                return true;
+        return false;
+    }
+
+    void setLagging(EventId event, bool lagging)
+    {
+        for (auto it = _lagging.begin(); it != _lagging.end(); ++it)
+        {
+            if (*it == event)
+            {
+                if (!lagging)
+                    _lagging.erase(it);
+                return;
+            }
+        }
+        if (lagging)
+            _lagging.push_back(event);
+    }
+
+    // removes the queued stream frames of event, superseded by a keyframe
+    void removeFrames(EventId event)
+    {
+        size_t removed = 0;
+        for (auto it = _messages.begin(); it != _messages.end();)
+        {
+            if ((*it)->policy == EventSendPolicy::stream && (*it)->event == event)
+            {
+                _stats.bytes -= (*it)->data.size();
+                it = _messages.erase(it);
+                removed++;
+            }
+            else
+                ++it;
+        }
+        _stats.coalesced += removed;
+        _stats.depth = _messages.size();
+    }
+
+    bool dropOldestFrame()
+    {
+        for (auto it = _messages.begin(); it != _messages.end(); ++it)
+        {
+            if ((*it)->policy == EventSendPolicy::stream)
+            {
+                setLagging((*it)->event, true); // the client misses a frame: wait for the next keyframe
+                _stats.bytes -= (*it)->data.size();
+                _messages.erase(it);
+                _stats.dropped++;
+                _stats.depth = _messages.size();
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// One websocket frame (RFC 6455, server to client: not masked) being written to a non-blocking socket. write() sends
+// what the socket takes and keeps the offset, the next write() resumes there: a large message reaches a slow client in
+// pieces instead of failing a send timeout halfway (and leaving half a frame in the stream).
+class EventSendFrame
+{
+public:
+    // Starts sending message as one frame with opcode (0x1 text, 0x2 binary) at time now (ms)
+    void begin(EventMessagePtr message, uint8_t opcode, uint32_t now)
+    {
+        size_t size = message->data.size();
+        _header[0] = 0x80 | opcode; // FIN: the whole message in one frame
+        if (size < 126)
+        {
+            _header[1] = size;
+            _headerSize = 2;
+        }
+        else if (size <= 0xFFFF)
+        {
+            _header[1] = 126;
+            _header[2] = size >> 8;
+            _header[3] = size;
+            _headerSize = 4;
+        }
+        else
+        {
+            _header[1] = 127;
+            for (int i = 0; i < 8; i++)
+                _header[2 + i] = (uint64_t)size >> (8 * (7 - i));
+            _headerSize = 10;
+        }
+        _message = std::move(message);
+        _offset = 0;
+        _progress = now;
+    }
+
+    // Writes the rest of the frame with send(data, length): bytes taken, 0 if the socket would block, < 0 on an error.
+    // Returns the bytes written by this call, -1 on an error (the frame stays unfinished: close the client).
+    template <typename Send>
+    int write(Send &&send, uint32_t now)
+    {
+        if (!_message)
+            return 0;
+        size_t total = _headerSize + _message->data.size();
+        int written = 0;
+        while (_offset < total)
+        {
+            const uint8_t *data = _offset < _headerSize ? _header + _offset : _message->data.data() + (_offset - _headerSize);
+            size_t length = _offset < _headerSize ? _headerSize - _offset : total - _offset;
+            int n = send(data, length);
+            if (n < 0)
+                return -1;
+            if (n == 0)
+                break; // socket full: resume on the next write()
+            _offset += n;
+            written += n;
+        }
+        if (written)
+            _progress = now;
+        if (_offset == total)
+            _message.reset(); // done
+        return written;
+    }
+
+    bool active() const { return (bool)_message; }
+    size_t offset() const { return _offset; }
+    // ms since the socket last took bytes of this frame (0 when no frame is being sent)
+    uint32_t stalled(uint32_t now) const { return _message ? now - _progress : 0; }
+    const EventMessage *message() const { return _message.get(); }
+
+private:
+    EventMessagePtr _message;
+    uint8_t _header[10];
+    uint8_t _headerSize = 0;
+    size_t _offset = 0;
+    uint32_t _progress = 0; // time the socket last took bytes
+};
+
+#endif
@@ -1,5 +1,8 @@
 #include <EventSocket.h>
 
+#include <errno.h>        // 🌙
+#include <lwip/sockets.h> // 🌙 select / send without waiting: websocket sends must not block the HTTP task
+
 SemaphoreHandle_t clientSubscriptionsMutex = xSemaphoreCreateMutex();
 
 EventSocket::EventSocket(PsychicHttpServer *server,
@@ -8,6 +11,10 @@ EventSocket::EventSocket(PsychicHttpServer *server,
                                                                             _securityManager(securityManager),
                                                                             _authenticationPredicate(authenticationPredicate)
 {
+    // 🌙 indexed by EventId and read without the mutex: never reallocated, like the registry itself
+    event_policies.reserve(EVENT_REGISTRY_CAPACITY);
+    event_callbacks.reserve(EVENT_REGISTRY_CAPACITY);
+    subscribe_callbacks.reserve(EVENT_REGISTRY_CAPACITY);
 }
 
 void EventSocket::begin()
@@ -28,17 +35,30 @@ void EventSocket::begin()
     ESP_LOGV(SVK_TAG, "Registered event socket endpoint: %s", EVENT_SERVICE_PATH);
 }
 
-void EventSocket::registerEvent(String event)
+EventId EventSocket::registerEvent(String event, EventSendPolicy policy)
 {
-    if (!isEventValid(event))
+    EventId id = _events.find(event.c_str());
+    if (id == EVENT_ID_NONE)
     {
         ESP_LOGD(SVK_TAG, "Registering event: %s", event.c_str());
-        events.push_back(event);
+        xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
+        id = _events.add(event.c_str());
+        if (id != EVENT_ID_NONE) // 🌙 indexed by id
+        {
+            event_policies.resize(_events.size(), EventSendPolicy::latest);
+            event_callbacks.resize(_events.size());
+            subscribe_callbacks.resize(_events.size());
+            event_policies[id] = policy;
+        }
+        xSemaphoreGive(clientSubscriptionsMutex);
+        if (id == EVENT_ID_NONE)
+            ESP_LOGE(SVK_TAG, "Too many events, not registered: %s", event.c_str());
     }
     else
     {
         ESP_LOGW(SVK_TAG, "Event already registered: %s", event.c_str());
     }
+    return id;
 }
 
 void EventSocket::onWSOpen(PsychicWebSocketClient *client)
@@ -49,11 +69,23 @@ void EventSocket::onWSOpen(PsychicWebSocketClient *client)
 void EventSocket::onWSClose(PsychicWebSocketClient *client)
 {
     xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
-    for (auto &event_subscriptions : client_subscriptions)
+    _events.unsubscribeAll(client->socket()); // 🌙
+     _clientVisibility.erase((int)client->socket()); // 🌙
+    // 🌙 keep the stats of the closed client, drop its queued messages
+    auto queue = _sendQueues.find((int)client->socket());
+    if (queue != _sendQueues.end())
     {
-        event_subscriptions.second.remove(client->socket());
+        queue->second.clear();
+        const EventSendStats &stats = queue->second.stats();
+        _closedSendStats.queued += stats.queued;
+        _closedSendStats.sent += stats.sent;
+        _closedSendStats.coalesced += stats.coalesced;
+        _closedSendStats.dropped += stats.dropped;
+        if (stats.maxDepth > _closedSendStats.maxDepth)
+            _closedSendStats.maxDepth = stats.maxDepth;
+        _sendQueues.erase(queue);
     }
-     _clientVisibility.erase((int)client->socket()); // 🌙
+    _sendFrames.erase((int)client->socket());
     xSemaphoreGive(clientSubscriptionsMutex);
     ESP_LOGI(SVK_TAG, "ws[%s][%u] disconnect", client->remoteIP().toString().c_str(), client->socket());
 }
@@ -82,28 +114,33 @@ esp_err_t EventSocket::onFrame(PsychicWebSocketRequest *request, httpd_ws_frame
 
         if (!error && doc.is<JsonObject>())
         {
-            String event = doc["event"];
-            if (event == "subscribe")
+            const char *event = doc["event"] | ""; // 🌙 no String copies: compared and looked up in place
+            if (strcmp(event, "subscribe") == 0)
             {
                 // only subscribe to events that are registered
-                if (isEventValid(doc["data"].as<String>()))
+                EventId id = _events.find(doc["data"].as<const char *>());
+                if (id != EVENT_ID_NONE)
                 {
-                    client_subscriptions[doc["data"]].push_back(request->client()->socket());
-                    handleSubscribeCallbacks(doc["data"], String(request->client()->socket()));
+                    xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
+                    _events.subscribe(id, request->client()->socket());
+                    xSemaphoreGive(clientSubscriptionsMutex);
+                    handleSubscribeCallbacks(id, String(request->client()->socket()));
                 }
                 else
                 {
                     ESP_LOGW(SVK_TAG, "Client tried to subscribe to unregistered event: %s", doc["data"].as<String>().c_str());
                 }
             }
-            else if (event == "unsubscribe")
+            else if (strcmp(event, "unsubscribe") == 0)
             {
-                client_subscriptions[doc["data"]].remove(request->client()->socket());
+                xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
+                _events.unsubscribe(_events.find(doc["data"].as<const char *>()), request->client()->socket());
+                xSemaphoreGive(clientSubscriptionsMutex);
             }
             else
             {
                 JsonObject jsonObject = doc["data"].as<JsonObject>();
-                handleEventCallbacks(event, jsonObject, request->client()->socket());
+                handleEventCallbacks(_events.find(event), jsonObject, request->client()->socket());
             }
             return ESP_OK;
         }
@@ -124,127 +161,292 @@ void EventSocket::emitEvent(const String& event, const JsonObject &jsonObject, c
 // 🌙 extracted from above function so the caller can prepare the JsonDocument, which saves on heap usage
 void EventSocket::emitEvent(const JsonDocument &doc, const char *originId, bool onlyToSameOrigin)
 {
-    #if FT_ENABLED(EVENT_USE_JSON)
-        static String outBuffer;      // reused across calls to avoid repeated allocation
-        outBuffer.clear();            // keep capacity, reset length
-        outBuffer.reserve(measureJson(doc)); // pre-reserve exact size (optional, improves speed for large JSON)
-        serializeJson(doc, outBuffer);
+    const char *event = doc["event"] | "";
+    EventId id = _events.find(event);
+    if (id == EVENT_ID_NONE)
+    {
+        ESP_LOGW(SVK_TAG, "Method tried to emit unregistered event: %s from %s", event, originId);
+        return;
+    }
+    emitEvent(id, doc, originId, onlyToSameOrigin);
+}
 
-        emitEvent(doc["event"], outBuffer.c_str(), outBuffer.length(), originId, onlyToSameOrigin);
+// 🌙
+void EventSocket::emitEvent(EventId event, const JsonDocument &doc, const char *originId, bool onlyToSameOrigin)
+{
+    if (!_events.isValid(event))
+        return;
+    EventMessagePtr message = newMessage(event, event_policies[event]);
+    if (!message)
+        return; // no subscribers
+    std::vector<uint8_t> &outBuffer = const_cast<EventMessage &>(*message).data; // not shared yet
+
+    // serialize straight into the message: + 1 as the writer reserves a byte for a null terminator
+    #if FT_ENABLED(EVENT_USE_JSON)
+        outBuffer.resize(measureJson(doc) + 1);
+        outBuffer.resize(serializeJson(doc, (char *)outBuffer.data(), outBuffer.size()));
     #else
         // --- MsgPack path ---
-        struct VecWriter {
-            std::vector<uint8_t> &v;
-            size_t write(uint8_t c) {
-                v.push_back(c);
-                return 1;
-            }
-            size_t write(const uint8_t *buf, size_t size) {
-                v.insert(v.end(), buf, buf + size);
-                return size;
-            }
-        };
-
-        static std::vector<uint8_t> outBuffer;   // reuse across calls
-        outBuffer.clear();                        // reset length but keep capacity
-        outBuffer.reserve(measureMsgPack(doc));// optional: pre-reserve based on measureMsgPack
-        VecWriter writer{outBuffer};
-        serializeMsgPack(doc, writer);
-
-        emitEvent(doc["event"], (char *)outBuffer.data(), outBuffer.size(), originId, onlyToSameOrigin);
+        outBuffer.resize(measureMsgPack(doc) + 1);
+        outBuffer.resize(serializeMsgPack(doc, (char *)outBuffer.data(), outBuffer.size()));
     #endif
+
+    emitMessage(message, originId, onlyToSameOrigin);
 }
 
 // 🌙 extracted from above function for FT_MONITOR, which uses char *output
 void EventSocket::emitEvent(const String& event, const char *output, size_t len, const char *originId, bool onlyToSameOrigin)
 {
     // Only process valid events
-    if (!isEventValid(event))
+    EventId id = _events.find(event.c_str());
+    if (id == EVENT_ID_NONE)
     {
         ESP_LOGW(SVK_TAG, "Method tried to emit unregistered event: %s from %s (len %zu)", event.c_str(), originId, len);
         return;
     }
+    emitEvent(id, output, len, originId, onlyToSameOrigin);
+}
 
-    int originSubscriptionId = originId[0] ? atoi(originId) : -1;
-    xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
-    auto &subscriptions = client_subscriptions[event];
-    if (subscriptions.empty())
+// 🌙
+void EventSocket::emitEvent(EventId event, const char *output, size_t len, const char *originId, bool onlyToSameOrigin)
+{
+    if (!_events.isValid(event))
+        return;
+    EventMessagePtr message = newMessage(event, event_policies[event]);
+    if (!message)
+        return; // no subscribers
+    const_cast<EventMessage &>(*message).data.assign((const uint8_t *)output, (const uint8_t *)output + len);
+    emitMessage(message, originId, onlyToSameOrigin);
+}
+
+// 🌙
+void EventSocket::emitStreamEvent(const String& event, const char *output, size_t len, bool keyframe)
+{
+    EventId id = _events.find(event.c_str());
+    if (id == EVENT_ID_NONE)
     {
-        xSemaphoreGive(clientSubscriptionsMutex);
+        ESP_LOGW(SVK_TAG, "Method tried to emit unregistered event: %s (len %zu)", event.c_str(), len);
         return;
     }
+    emitStreamEvent(id, output, len, keyframe);
+}
+
+// 🌙
+void EventSocket::emitStreamEvent(EventId event, const char *output, size_t len, bool keyframe)
+{
+    if (!_events.isValid(event))
+        return;
+    EventMessagePtr message = newMessage(event, EventSendPolicy::stream, keyframe);
+    if (!message)
+        return; // no subscribers
+    const_cast<EventMessage &>(*message).data.assign((const uint8_t *)output, (const uint8_t *)output + len);
+    emitMessage(message, "", false);
+}
+
+// 🌙 message to be filled by the caller, nullptr if nobody subscribed to event (nothing to serialize)
+EventMessagePtr EventSocket::newMessage(EventId event, EventSendPolicy policy, bool keyframe)
+{
+    xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
+    bool subscribed = !_events.subscribers(event).empty();
+    xSemaphoreGive(clientSubscriptionsMutex);
+    if (!subscribed)
+        return nullptr;
+
+    auto message = std::make_shared<EventMessage>();
+    message->event = event;
+    message->policy = policy;
+    message->keyframe = keyframe;
+    return message;
+}
+
+// 🌙 queue the message for its subscribers and let the HTTP task send it: a slow client no longer blocks the caller or other clients
+void EventSocket::emitMessage(const EventMessagePtr &message, const char *originId, bool onlyToSameOrigin)
+{
+    int originSubscriptionId = originId[0] ? atoi(originId) : -1;
+    xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
 
     // if onlyToSameOrigin == true, send the message back to the origin
     if (onlyToSameOrigin && originSubscriptionId > 0)
     {
-        auto *client = _socket.getClient(originSubscriptionId);
-        if (client)
-        {
-            if (event != "monitor")
-                ESP_LOGV(SVK_TAG, "Emitting event: %s to %s[%u], Message[%d]: %s", event.c_str(), client->remoteIP().toString().c_str(), client->socket(), len, output);
-#if FT_ENABLED(EVENT_USE_JSON)
-            esp_err_t result = client->sendMessage(HTTPD_WS_TYPE_TEXT, output, len);
-#else
-            esp_err_t result = client->sendMessage(HTTPD_WS_TYPE_BINARY, output, len);
-#endif
-            // 🌙 error check
-            if (result != ESP_OK)
-            {
-                ESP_LOGW(SVK_TAG, "Failed to send event %s from %s to client %d: %s (len: %zu)", event.c_str(), originId, client->socket(), esp_err_to_name(result), len);
-                // subscriptions.remove(originSubscriptionId);
-            }
-        }
+        auto queue = _sendQueues.try_emplace(originSubscriptionId, EVENT_SEND_QUEUE_MESSAGES, EVENT_SEND_QUEUE_BYTES).first;
+        queue->second.push(message);
     }
     else
     { // else send the message to all other clients
-
-        // 🌙 use iterator so remove / erase also removes from the iterator
-        for (auto it = subscriptions.begin(); it != subscriptions.end();)
+        for (int subscription : _events.subscribers(message->event))
         {
-            int subscription = *it;
             if (subscription == originSubscriptionId)
+                continue;
+            auto queue = _sendQueues.try_emplace(subscription, EVENT_SEND_QUEUE_MESSAGES, EVENT_SEND_QUEUE_BYTES).first;
+            if (!queue->second.push(message) && message->policy != EventSendPolicy::stream)
+                ESP_LOGW(SVK_TAG, "Send queue of client %d full, dropped event %s (len: %zu)", subscription, _events.name(message->event), message->data.size());
+        }
+    }
+
+    xSemaphoreGive(clientSubscriptionsMutex);
+    scheduleSend();
+}
+
+// 🌙 one work item at a time in the HTTP task
+void EventSocket::scheduleSend()
+{
+    if (_sendScheduled.exchange(true))
+        return;
+    if (httpd_queue_work(_server->server, sendQueuedWork, this) != ESP_OK)
+    {
+        _sendScheduled = false; // retried on the next emit
+        ESP_LOGW(SVK_TAG, "Could not queue send work");
+    }
+}
+
+void EventSocket::sendQueuedWork(void *eventSocket)
+{
+    ((EventSocket *)eventSocket)->sendQueued();
+}
+
+// 🌙 true if the socket's send buffer has room: a send will not wait for the client
+bool EventSocket::isWritable(int socket)
+{
+    fd_set writeSet;
+    FD_ZERO(&writeSet);
+    FD_SET(socket, &writeSet);
+    struct timeval noWait = {0, 0};
+    return select(socket + 1, nullptr, &writeSet, nullptr, &noWait) > 0;
+}
+
+// 🌙 runs in the HTTP task: sends queued messages round robin, one message per client per round.
+// Frames are written without waiting (EventSendFrame): what the socket does not take now is resumed in a later round,
+// so a large message reaches a slow client in pieces. A client whose socket is full gets no new message meanwhile:
+// its queue coalesces states and drops frames at its limit (EventSendQueue::push). Full sockets are retried on the
+// next emit, at least every second (status event). Only a client that takes no bytes for EVENT_SEND_STALL_MS, or
+// whose socket fails, is closed. httpd writes to an event socket itself only to answer a ping or a close, which
+// browsers do not send while receiving.
+void EventSocket::sendQueued()
+{
+    _sendScheduled = false; // messages emitted from now on schedule a new round
+#if FT_ENABLED(EVENT_USE_JSON)
+    const uint8_t opcode = HTTPD_WS_TYPE_TEXT;
+#else
+    const uint8_t opcode = HTTPD_WS_TYPE_BINARY;
+#endif
+    std::vector<int> round;
+    std::vector<int> stalled;
+    bool more = false;
+    for (int r = 0; r < EVENT_SEND_ROUNDS; r++)
+    {
+        uint32_t now = millis();
+        round.clear();
+        stalled.clear();
+        more = false;
+        xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
+        for (auto &queue : _sendQueues)
+        {
+            EventSendFrame &frame = _sendFrames[queue.first];
+            if (!frame.active() && queue.second.empty())
+                continue;
+            if (!isWritable(queue.first))
             {
-                ++it;
+                if (frame.stalled(now) > EVENT_SEND_STALL_MS)
+                    stalled.push_back(queue.first);
                 continue;
             }
-            auto *client = _socket.getClient(subscription);
-            if (!client)
+            if (!frame.active())
             {
-                it = subscriptions.erase(it);
-                continue;
+                EventMessagePtr message;
+                queue.second.pop(message);
+                frame.begin(std::move(message), opcode, now);
             }
-            if (event != "monitor")
-                ESP_LOGV(SVK_TAG, "Emitting event: %s to %s[%u], Message[%d]: %s", event.c_str(), client->remoteIP().toString().c_str(), client->socket(), len, output);
-#if FT_ENABLED(EVENT_USE_JSON)
-            esp_err_t result = client->sendMessage(HTTPD_WS_TYPE_TEXT, output, len);
-#else
-            esp_err_t result = client->sendMessage(HTTPD_WS_TYPE_BINARY, output, len);
-#endif
-            // 🌙 error check
-            if (result != ESP_OK)
+            round.push_back(queue.first);
+        }
+        xSemaphoreGive(clientSubscriptionsMutex);
+        for (int socket : stalled)
+            dropClient(socket, "no progress");
+        if (round.empty())
+            break;
+
+        // write without holding the mutex: emitters keep queueing meanwhile
+        for (int socket : round)
+        {
+            EventSendFrame &frame = _sendFrames[socket];
+            EventId event = frame.message()->event; // the frame lets go of its message when it is written
+            size_t size = frame.message()->data.size();
+            if (frame.offset() == 0 && frame.message()->policy != EventSendPolicy::stream)
+                ESP_LOGV(SVK_TAG, "Emitting event: %s to %d, Message[%zu]", _events.name(event), socket, size);
+            // the session must still be a websocket: a send on a closed netconn can assert in lwIP
+            int written = -1;
+            if (httpd_ws_get_fd_info(_server->server, socket) == HTTPD_WS_CLIENT_WEBSOCKET)
+                written = frame.write([socket](const uint8_t *data, size_t length) -> int
+                                      {
+                                          int n = send(socket, data, length, MSG_DONTWAIT);
+                                          if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                                              return 0;
+                                          return n; },
+                                      now);
+            if (written < 0)
             {
-                ESP_LOGW(SVK_TAG, "Failed to send event %s from %s to client %u: %s (len: %zu)", event.c_str(), originId, client->socket(), esp_err_to_name(result), len);
-                // it = subscriptions.erase(it);// do not erase as we hope for better times
-                it = subscriptions.erase(it);  // remove dead client; don't keep retrying
+                ESP_LOGW(SVK_TAG, "Failed to send event %s to client %d at byte %zu (len: %zu)", _events.name(event), socket, frame.offset(), size);
+                dropClient(socket, "send failed");
                 continue;
             }
-            ++it;
+            xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
+            auto queue = _sendQueues.find(socket);
+            more |= frame.active() ? written > 0 : queue != _sendQueues.end() && !queue->second.empty(); // full socket: wait for the next emit
+            xSemaphoreGive(clientSubscriptionsMutex);
         }
     }
+    if (more)
+        scheduleSend(); // let other requests be handled first
+}
+
+// 🌙 remove a dead or stalled client, don't keep retrying: its stream may hold a partial frame
+void EventSocket::dropClient(int socket, const char *reason)
+{
+    ESP_LOGW(SVK_TAG, "Closing event client %d: %s", socket, reason);
+    xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
+    _events.unsubscribeAll(socket);
+    auto queue = _sendQueues.find(socket);
+    if (queue != _sendQueues.end())
+        queue->second.clear();
+    _sendFrames.erase(socket);
+    xSemaphoreGive(clientSubscriptionsMutex);
+    httpd_sess_trigger_close(_server->server, socket);
+}
 
+// 🌙
+EventSendStats EventSocket::getSendStats()
+{
+    xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
+    EventSendStats total = _closedSendStats;
+    for (auto &queue : _sendQueues)
+    {
+        const EventSendStats &stats = queue.second.stats();
+        total.queued += stats.queued;
+        total.sent += stats.sent;
+        total.coalesced += stats.coalesced;
+        total.dropped += stats.dropped;
+        total.depth += stats.depth;
+        total.bytes += stats.bytes;
+        if (stats.maxDepth > total.maxDepth)
+            total.maxDepth = stats.maxDepth;
+    }
     xSemaphoreGive(clientSubscriptionsMutex);
+    return total;
 }
 
-void EventSocket::handleEventCallbacks(String event, JsonObject &jsonObject, int originId)
+void EventSocket::handleEventCallbacks(EventId event, JsonObject &jsonObject, int originId)
 {
+    if (!_events.isValid(event))
+        return;
     for (auto &callback : event_callbacks[event])
     {
         callback(jsonObject, originId);
     }
 }
 
-void EventSocket::handleSubscribeCallbacks(String event, const String &originId)
+void EventSocket::handleSubscribeCallbacks(EventId event, const String &originId)
 {
+    if (!_events.isValid(event))
+        return;
     for (auto &callback : subscribe_callbacks[event])
     {
         callback(originId);
@@ -253,28 +455,30 @@ void EventSocket::handleSubscribeCallbacks(String event, const String &originId)
 
 void EventSocket::onEvent(String event, EventCallback callback)
 {
-    if (!isEventValid(event))
+    EventId id = _events.find(event.c_str());
+    if (id == EVENT_ID_NONE)
     {
         ESP_LOGW(SVK_TAG, "Method tried to register unregistered event: %s", event.c_str());
         return;
     }
-    event_callbacks[event].push_back(callback);
+    event_callbacks[id].push_back(callback);
 }
 
 void EventSocket::onSubscribe(String event, SubscribeCallback callback)
 {
-    if (!isEventValid(event))
+    EventId id = _events.find(event.c_str());
+    if (id == EVENT_ID_NONE)
     {
         ESP_LOGW(SVK_TAG, "Method tried to subscribe to unregistered event: %s", event.c_str());
         return;
     }
-    subscribe_callbacks[event].push_back(callback);
+    subscribe_callbacks[id].push_back(callback);
     ESP_LOGI(SVK_TAG, "onSubscribe for event: %s", event.c_str());
 }
 
 bool EventSocket::isEventValid(String event)
 {
-    return std::find(events.begin(), events.end(), event) != events.end();
+    return _events.find(event.c_str()) != EVENT_ID_NONE;
 }
 
 unsigned int EventSocket::getConnectedClients()
@@ -15,9 +15,12 @@
  *   the terms of the LGPL v3 license. See the LICENSE file for details.
  **/
 
+#include <EventRegistry.h>  // 🌙
+#include <EventSendQueue.h> // 🌙
 #include <PsychicHttp.h>
 #include <SecurityManager.h>
 #include <StatefulService.h>
+#include <atomic>
 #include <list>
 #include <map>
 #include <vector>
@@ -25,6 +28,18 @@
 #define EVENT_SERVICE_PATH "/ws/events"
 #define EVENT_CLIENT_INFO "client_info" // 🌙 
 
+// 🌙 per client send queue limits, see EventSendQueue.h
+#ifndef EVENT_SEND_QUEUE_MESSAGES
+#define EVENT_SEND_QUEUE_MESSAGES 16
+#endif
+#ifndef EVENT_SEND_QUEUE_BYTES
+#define EVENT_SEND_QUEUE_BYTES (64 * 1024)
+#endif
+#define EVENT_SEND_ROUNDS 4 // messages per client sent in one HTTP task work item, then other requests are served first
+#ifndef EVENT_SEND_STALL_MS
+#define EVENT_SEND_STALL_MS 5000 // 🌙 a client that takes no bytes of its message for this long is closed (httpd send timeout: 5 s)
+#endif
+
 typedef std::function<void(JsonObject &root, int originId)> EventCallback;
 typedef std::function<void(const String &originId)> SubscribeCallback;
 
@@ -35,7 +50,10 @@ public:
 
     void begin();
 
-    void registerEvent(String event);
+    // 🌙 policy: how messages are queued for a client that does not keep up (default: only the latest state is sent)
+    // returns the id of the event: emitting by id skips the name lookup
+    EventId registerEvent(String event, EventSendPolicy policy = EventSendPolicy::latest);
+    EventId getEventId(const char *event) { return _events.find(event); } // 🌙 EVENT_ID_NONE if not registered
 
     void onEvent(String event, EventCallback callback);
 
@@ -45,29 +63,53 @@ public:
     void emitEvent(const JsonDocument &doc, const char *originId = "", bool onlyToSameOrigin = false); // 🌙 jsonDocument contains event
     // if onlyToSameOrigin == true, the message will be sent to the originId only, otherwise it will be broadcasted to all clients except the originId
     void emitEvent(const String& event, const char *output, size_t len, const char *originId = "", bool onlyToSameOrigin = false); // 🌙 char output directly emitted
+    // 🌙 frame of a stream (monitor): dropped for lagging clients, which then only get keyframes until they catch up
+    void emitStreamEvent(const String& event, const char *output, size_t len, bool keyframe);
+
+    // 🌙 by event id (registerEvent / getEventId), the String versions above look up the id and call these
+    void emitEvent(EventId event, const JsonDocument &doc, const char *originId = "", bool onlyToSameOrigin = false);
+    void emitEvent(EventId event, const char *output, size_t len, const char *originId = "", bool onlyToSameOrigin = false);
+    void emitStreamEvent(EventId event, const char *output, size_t len, bool keyframe);
 
     bool isEventValid(String event);
 
     unsigned int getConnectedClients();
     unsigned int getActiveClients();
 
+    // 🌙 send queue metrics: summed over clients (maxDepth: highest of any client), including closed clients
+    EventSendStats getSendStats();
+
 private:
     PsychicHttpServer *_server;
     PsychicWebSocketHandler _socket;
     SecurityManager *_securityManager;
     AuthenticationPredicate _authenticationPredicate;
 
-    std::vector<String> events;
-    std::map<String, std::list<int>> client_subscriptions;
-    std::map<String, std::list<EventCallback>> event_callbacks;
-    std::map<String, std::list<SubscribeCallback>> subscribe_callbacks;
-    void handleEventCallbacks(String event, JsonObject &jsonObject, int originId);
-    void handleSubscribeCallbacks(String event, const String &originId);
+    // 🌙 indexed by EventId: names and subscriptions in _events, policies and callbacks in the vectors
+    EventRegistry _events;
+    std::vector<EventSendPolicy> event_policies;
+    std::vector<std::list<EventCallback>> event_callbacks;
+    std::vector<std::list<SubscribeCallback>> subscribe_callbacks;
+    void handleEventCallbacks(EventId event, JsonObject &jsonObject, int originId);
+    void handleSubscribeCallbacks(EventId event, const String &originId);
 
     void onWSOpen(PsychicWebSocketClient *client);
     void onWSClose(PsychicWebSocketClient *client);
     esp_err_t onFrame(PsychicWebSocketRequest *request, httpd_ws_frame *frame);
 
+    // 🌙 per client send queues, drained by the HTTP task so emitEvent never waits for a client
+    std::map<int, EventSendQueue> _sendQueues;
+    std::map<int, EventSendFrame> _sendFrames; // message being written per client, resumed in a later round
+    EventSendStats _closedSendStats; // stats of closed clients
+    std::atomic<bool> _sendScheduled{false};
+    EventMessagePtr newMessage(EventId event, EventSendPolicy policy, bool keyframe = false);
+    void emitMessage(const EventMessagePtr &message, const char *originId, bool onlyToSameOrigin);
+    void scheduleSend();
+    static void sendQueuedWork(void *eventSocket);
+    void sendQueued();
+    static bool isWritable(int socket);
+    void dropClient(int socket, const char *reason);
+
     // 🌙 Track client visibility (clientId -> isVisible)
     std::map<int, bool> _clientVisibility;
     void handleClientInfo(JsonObject &data, int originId);
@@ -19,6 +19,7 @@
 #include <FS.h>
 
 inline std::vector<std::function<void(char)>> delayedWrites; // 🌙 Global vector to store delayed write functions (not in FSPersistence as it has to be used for all T types)
+inline std::function<void(const char *path)> fsPersistenceWritten; // 🌙 called after a settings file is written, for all T types (e.g. FileManager::fileChanged)
 
 template <class T>
 class FSPersistence
@@ -88,6 +89,8 @@ public:
         // serialize the data to the file
         serializeJson(jsonDocument, settingsFile);
         settingsFile.close();
+        if (fsPersistenceWritten) // 🌙
+            fsPersistenceWritten(_filePath.c_str());
         return true;
     }
 
@@ -9,7 +9,7 @@ NotificationService::NotificationService(EventSocket *eventSocket) : _eventSocke
 
 void NotificationService::begin()
 {
-    _eventSocket->registerEvent(NOTIFICATION_EVENT);
+    _eventSocket->registerEvent(NOTIFICATION_EVENT, EventSendPolicy::ordered); // 🌙 every notification is shown
 }
 
 void NotificationService::pushNotification(String message, pushType event)
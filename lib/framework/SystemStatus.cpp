@@ -217,6 +217,14 @@ esp_err_t SystemStatus::systemStatus(PsychicRequest *request)
     heapHealth(root["heap_info_app"].to<JsonVariant>(), MALLOC_CAP_INTERNAL);
     heapHealth(root["heap_info_dma"].to<JsonVariant>(), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
 
+    // 🌙 websocket send queues: are clients keeping up
+    EventSendStats sendStats = esp32sveltekit.getSocket()->getSendStats();
+    char wsQueue[96];
+    snprintf(wsQueue, sizeof(wsQueue), "%u queued (max %u), %u sent, %u coalesced, %u dropped", sendStats.depth, sendStats.maxDepth, sendStats.sent, sendStats.coalesced, sendStats.dropped);
+    root["ws_queue"] = wsQueue;
+
+    if (esp32sveltekit.systemStatusExtension) esp32sveltekit.systemStatusExtension(root); // 🌙
+
     return response.send();
 }
 
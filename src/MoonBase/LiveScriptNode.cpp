@@ -18,6 +18,8 @@
 
   #define USE_FASTLED  // as ESPLiveScript.h calls hsv ! one of the reserved functions!!
   #include "ESPLiveScript.h"
+  #include "MoonBase/utilities/ScriptExternals.h"
+  #include "MoonBase/utilities/TaskBindings.h"
 
 Node* gNode = nullptr;  // fallback for synchronous (non-task) contexts such as onLayout
 
@@ -25,25 +27,24 @@ Node* gNode = nullptr;  // fallback for synchronous (non-task) contexts such as
 // Fixes the gNode race when multiple scripts run concurrently as separate tasks.
 // Max 4 matches the WaitAnimationSync semaphore count.
 static const int MAX_LIVE_SCRIPTS = 4;
-struct TaskNodePair { TaskHandle_t task = nullptr; Node* node = nullptr; };
-static TaskNodePair gTaskNodeMap[MAX_LIVE_SCRIPTS];
+static TaskBindings<TaskHandle_t, Node, MAX_LIVE_SCRIPTS> gTaskNodes;
+
+// The node of the script task calling, found in gTaskNodes on its first external call after execute() registered it
+// and kept for the life of the task: no task handle lookup and scan per setRGB.
+static thread_local Node* tTaskNode = nullptr;
 
 // Returns the Node for the calling task; falls back to gNode for synchronous contexts. 🌙
 static Node* currentNode() {
-  TaskHandle_t h = xTaskGetCurrentTaskHandle();
-  for (const auto& m : gTaskNodeMap)
-    if (m.task == h) return m.node;
-  return gNode;
+  if (tTaskNode) return tTaskNode;
+  Node* node = gTaskNodes.find(xTaskGetCurrentTaskHandle());
+  if (!node) return gNode;  // not a script task (onLayout in the drivers task), or not registered yet
+  tTaskNode = node;
+  return node;
 }
 static void registerNodeForTask(TaskHandle_t task, Node* node) {
-  for (auto& m : gTaskNodeMap)
-    if (m.task == nullptr) { m.task = task; m.node = node; return; }
-  EXT_LOGE(MB_TAG, "gTaskNodeMap full");
-}
-static void unregisterNodeForTask(TaskHandle_t task) {
-  for (auto& m : gTaskNodeMap)
-    if (m.task == task) { m.task = nullptr; m.node = nullptr; return; }
+  if (!gTaskNodes.bind(task, node)) EXT_LOGE(MB_TAG, "gTaskNodes full");
 }
+static void unregisterNodeForTask(TaskHandle_t task) { gTaskNodes.unbind(task); }
 
 static void _addControl(uint8_t* var, char* name, char* type, uint8_t min = 0, uint8_t max = UINT8_MAX) {
   EXT_LOGV(MB_TAG, "%s %s %p (%d-%d)", name, type, (void*)var, min, max);
@@ -60,13 +61,10 @@ static void _addLight(uint16_t x, uint16_t y, uint16_t z) { layerP.addLight({x,
 // Layout drawing helper: adds numPixels lights linearly interpolated between two 3D points
 // and advances to the next output pin. Mirrors drawLine3D for effects, but for onLayout().
 static void _addTube(uint16_t x1, uint16_t y1, uint16_t z1, uint16_t x2, uint16_t y2, uint16_t z2, uint8_t numPixels) {
-  for (uint8_t i = 0; i < numPixels; i++) {
-    float t = numPixels > 1 ? (float)i / (float)(numPixels - 1) : 0.0f;
-    int x = (int)(x1 + ((float)x2 - (float)x1) * t + 0.5f);
-    int y = (int)(y1 + ((float)y2 - (float)y1) * t + 0.5f);
-    int z = (int)(z1 + ((float)z2 - (float)z1) * t + 0.5f);
-    layerP.addLight({x, y, z});
-  }
+  layerP.addLights(numPixels, [&](size_t i, Coord3D& position) {
+    position = lineLight(Coord3D(x1, y1, z1), Coord3D(x2, y2, z2), i, numPixels);
+    return true;
+  });
   layerP.nextPin();
 }
 
@@ -79,8 +77,8 @@ static CRGB _getRGB(uint16_t indexV) { return currentNode()->layer->getRGB(index
 static void _setRGB(uint16_t indexV, CRGB color) { currentNode()->layer->setRGB(indexV, color); }
 static void _setRGBXY(int x, int y, CRGB color) { currentNode()->layer->setRGB(Coord3D{x, y}, color); }  // 🌙 coordinate-based setRGB, exposed via preamble-injected setRGB(Coord3D,CRGB) wrapper
 static void _setRGBXYZ(int x, int y, int z, CRGB color) { currentNode()->layer->setRGB(Coord3D{x, y, z}, color); }  // 🌙 coordinate-based setRGB, exposed via preamble-injected setRGB(Coord3D,CRGB) wrapper
-static CRGB _colorFromPalette(uint8_t index, uint8_t bri) { return ColorFromPalette(layerP.palette, index, bri); }  // 🌙
-static void _setRGBPal(uint16_t indexV, uint8_t index, uint8_t brightness) { currentNode()->layer->setRGB(indexV, ColorFromPalette(layerP.palette, index, brightness)); }
+static CRGB _colorFromPalette(uint8_t index, uint8_t bri) { return layerP.colorFromPalette(index, bri); }  // 🌙
+static void _setRGBPal(uint16_t indexV, uint8_t index, uint8_t brightness) { currentNode()->layer->setRGB(indexV, layerP.colorFromPalette(index, brightness)); }
 static void _setPan(uint16_t indexV, uint8_t value) { currentNode()->layer->setPan(indexV, value); }
 static void _setTilt(uint16_t indexV, uint8_t value) { currentNode()->layer->setTilt(indexV, value); }
 static void _setPalEntry(uint8_t index, uint8_t r, uint8_t g, uint8_t b) { if (index < 16) layerP.palette.entries[index] = CRGB(r, g, b); }
@@ -94,6 +92,26 @@ static void _drawLine3D(uint8_t x1, uint8_t y1, uint8_t z1, uint8_t x2, uint8_t
 static void _drawCircle(int cx, int cy, uint8_t radius, CRGB color) { currentNode()->layer->drawCircle(cx, cy, radius, color, false); }
 static void _blur2d(uint8_t blur_amount) { currentNode()->layer->blur2d(blur_amount); }
 
+// bulk drawing: one call per span of lights (BulkDraw.h), palette gradient from startIndex to endIndex (wrapping)
+static int16_t gradientStep(uint8_t startIndex, uint8_t endIndex, uint16_t count) { return count > 1 ? (uint8_t)(endIndex - startIndex) * 16 / (count - 1) : 0; }
+static void _fillPal(uint16_t first, uint16_t count, uint8_t startIndex, uint8_t endIndex, uint8_t brightness) { currentNode()->layer->fillGradient(first, count, 1, startIndex, gradientStep(startIndex, endIndex, count), brightness); }
+static void _fillRowPal(uint8_t y, uint8_t startIndex, uint8_t endIndex, uint8_t brightness) {
+  VirtualLayer* layer = currentNode()->layer;
+  layer->fillRowGradient(y, startIndex, gradientStep(startIndex, endIndex, layer->size.x), brightness);
+}
+static void _fillColumnPal(uint8_t x, uint8_t startIndex, uint8_t endIndex, uint8_t brightness) {
+  VirtualLayer* layer = currentNode()->layer;
+  layer->fillColumnGradient(x, startIndex, gradientStep(startIndex, endIndex, layer->size.y), brightness);
+}
+static void _setPalSpan(uint16_t first, uint16_t count, uint8_t* indexes, uint8_t brightness) { currentNode()->layer->fillIndexes(first, count, indexes, brightness); }
+static void _copyRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t toX, uint8_t toY) { currentNode()->layer->copyRect(x, y, width, height, toX, toY); }
+static void _shift(int dx, int dy) { currentNode()->layer->shift(dx, dy); }
+
+// 🌙 channel overrides: physical channels held over the effects (fixture tests), mode 0 set, 1 max, 2 min
+static void _overrideChannel(uint16_t channel, uint8_t value, uint8_t mode) { layerP.overrideChannel(channel, value, mode); }
+static void _releaseChannel(uint16_t channel) { layerP.releaseChannel(channel); }
+static void _releaseChannels() { layerP.releaseChannels(); }
+
 // time of day
 static uint8_t _lsHour = 0;
 static uint8_t _lsMinute = 0;
@@ -136,35 +154,120 @@ void sync() {
 }
 
 void addExternal(string definition, void* ptr) {
-  bool success = false;
-  size_t firstSpace = definition.find(' ');
-  if (firstSpace != std::string::npos) {
-    string returnType = definition.substr(0, firstSpace);
-
-    string parameters = "";
-    string functionName = "";
-
-    size_t openParen = definition.find('(', firstSpace + 1);
-    if (openParen != std::string::npos) {  // function
-      functionName = definition.substr(firstSpace + 1, openParen - firstSpace - 1);
-
-      size_t closeParen = definition.find(')', openParen + 1);
-      if (closeParen != std::string::npos) {  // function with parameters
-        parameters = definition.substr(openParen + 1, closeParen - openParen - 1);
-        success = true;
-        if (findLink(functionName, externalType::function) == -1)  // not allready added earlier
-          addExternalFunction(functionName, returnType, parameters, ptr);
-      }
-    } else {  // variable
-      functionName = definition.substr(firstSpace + 1);
-      success = true;
-      if (findLink(functionName, externalType::value) == -1)  // not allready added earlier
-        addExternalVariable(functionName, returnType, "", ptr);
-    }
-  }
-  if (!success) {
+  ExternalSymbol symbol;
+  if (!parseExternal(definition, symbol)) {
     EXT_LOGE(MB_TAG, "Failed to parse function definition: %s", definition.c_str());
+    return;
   }
+  if (symbol.isFunction) {
+    if (findLink(symbol.name, externalType::function) == -1)  // not allready added earlier
+      addExternalFunction(symbol.name, symbol.returnType, symbol.parameters, ptr);
+  } else if (findLink(symbol.name, externalType::value) == -1)  // not allready added earlier
+    addExternalVariable(symbol.name, symbol.returnType, "", ptr);
+}
+
+// The externals of all scripts, added to the linker once per boot by the first LiveScriptNode::setup (addExternals)
+// instead of parsing the definitions again in every setup. Externals of a node (leds, width, on, ...) are added in setup.
+struct ExternalDefinition {
+  const char* definition;
+  void* ptr;
+};
+static const ExternalDefinition externals[] = {
+    // make sure types in below functions are correct !!! otherwise livescript will crash
+
+    // generic functions
+    {"uint32_t millis()", (void*)millis},
+    {"uint32_t now()", (void*)millis},  // todo: synchronized time (sys->now)
+    {"uint8_t random8(uint8_t)", (void*)(uint8_t (*)(uint8_t))random8},
+    {"uint16_t random16(uint16_t)", (void*)(uint16_t (*)(uint16_t))random16},
+    {"void delay(uint32_t)", (void*)((void (*)(uint32_t))delay)},
+    {"void pinMode(uint8_t,uint8_t)", (void*)pinMode},
+    {"void digitalWrite(uint8_t,uint8_t)", (void*)digitalWrite},
+
+    // trigonometric functions
+    {"float sin(float)", (void*)(float (*)(float))sin},
+    {"float cos(float)", (void*)(float (*)(float))cos},
+    {"uint8_t sin8(uint8_t)", (void*)sin8},
+    {"uint8_t cos8(uint8_t)", (void*)cos8},
+    {"float atan2(float,float)", (void*)(float (*)(float, float))atan2},
+    {"uint8_t inoise8(uint16_t,uint16_t,uint16_t)", (void*)(uint8_t (*)(uint16_t, uint16_t, uint16_t))inoise8},
+    {"uint8_t beatsin8(uint16_t,uint8_t,uint8_t,uint32_t,uint8_t)", (void*)beatsin8},
+    {"uint8_t beatsin16(uint16_t,uint16_t,uint16_t,uint32_t,uint8_t)", (void*)beatsin16},
+    {"float sqrt(float)", (void*)(float (*)(float))sqrtf},
+    {"float hypot(float,float)", (void*)(float (*)(float, float))hypot},
+    {"uint8_t beat8(uint16_t,uint32_t)", (void*)(uint8_t (*)(uint16_t, uint32_t))beat8},  // saw wave
+    {"uint8_t triangle8(uint8_t)", (void*)triangle8},
+
+    // MoonLight functions
+    {"void addControl(void*,char*,char*,uint8_t,uint8_t)", (void*)_addControl},
+    {"void nextPin()", (void*)_nextPin},
+    {"void addLight(uint16_t,uint16_t,uint16_t)", (void*)_addLight},
+    {"void addTube(uint16_t,uint16_t,uint16_t,uint16_t,uint16_t,uint16_t,uint8_t)", (void*)_addTube},  // 🌙 interpolates numPixels lights along a 3D line then calls nextPin
+    {"void modifySize()", (void*)_modifySize},
+    //   {"void modifyPosition(Coord3D &position)", (void *)_modifyPosition},
+    //   {"void modifyXYZ(uint16_t,uint16_t,uint16_t)", (void *)_modifyXYZ},
+
+    // MoonLight Parallel LED Driver vars
+    //   but keep enabled to avoid compile errors when used in non virtual context
+    //   {"uint8_t colorOrder", &layerP.ledsDriver.colorOrder},
+    //   {"uint8_t clockPin", &layerP.ledsDriver.clockPin},
+    //   {"uint8_t latchPin", &layerP.ledsDriver.latchPin},
+    //   {"uint8_t clockFreq", &layerP.ledsDriver.clockFreq},
+    //   {"uint8_t dmaBuffer", &layerP.ledsDriver.dmaBuffer},
+
+    {"void fadeToBlackBy(uint8_t)", (void*)_fadeToBlackBy},
+    {"CRGB getRGB(uint16_t)", (void*)_getRGB},
+    {"void setRGB(uint16_t,CRGB)", (void*)_setRGB},
+    {"void setRGBXY(int,int,CRGB)", (void*)_setRGBXY},  // 🌙 called by preamble-injected setRGB(Coord3D,CRGB)
+    {"void setRGBXYZ(int,int,int,CRGB)", (void*)_setRGBXYZ},  // 🌙 called by preamble-injected setRGB(Coord3D,CRGB)
+    {"CRGB ColorFromPalette(uint8_t,uint8_t)", (void*)_colorFromPalette},  // 🌙
+    {"void setRGBPal(uint16_t,uint8_t,uint8_t)", (void*)_setRGBPal},
+    {"void setPan(uint16_t,uint8_t)", (void*)_setPan},
+    {"void setTilt(uint16_t,uint8_t)", (void*)_setTilt},
+    {"void setPalEntry(uint8_t,uint8_t,uint8_t,uint8_t)", (void*)_setPalEntry},
+    {"void setPalEntryHSV(uint8_t,uint8_t,uint8_t,uint8_t)", (void*)_setPalEntryHSV},
+    {"void setHSV(uint16_t,uint8_t,uint8_t,uint8_t)", (void*)_setHSV},
+    {"void setHSVXY(int,int,uint8_t,uint8_t,uint8_t)", (void*)_setHSVXY},
+
+    // audio sync
+    {"uint8_t* bands", (void*)sharedData.bands},
+    {"float volume", &sharedData.volume},
+
+    // gyro / IMU
+    {"int gravityX", &sharedData.gravity.x},
+    {"int gravityY", &sharedData.gravity.y},
+    {"int gravityZ", &sharedData.gravity.z},
+
+    // 2D/3D drawing
+    {"void drawLine(uint8_t,uint8_t,uint8_t,uint8_t,CRGB)", (void*)_drawLine},
+    {"void drawLine3D(uint8_t,uint8_t,uint8_t,uint8_t,uint8_t,uint8_t,CRGB)", (void*)_drawLine3D},
+    {"void drawCircle(int,int,uint8_t,CRGB)", (void*)_drawCircle},
+    {"void blur2d(uint8_t)", (void*)_blur2d},
+    {"void fillPal(uint16_t,uint16_t,uint8_t,uint8_t,uint8_t)", (void*)_fillPal},
+    {"void fillRowPal(uint8_t,uint8_t,uint8_t,uint8_t)", (void*)_fillRowPal},
+    {"void fillColumnPal(uint8_t,uint8_t,uint8_t,uint8_t)", (void*)_fillColumnPal},
+    {"void setPalSpan(uint16_t,uint16_t,uint8_t*,uint8_t)", (void*)_setPalSpan},
+    {"void copyRect(uint8_t,uint8_t,uint8_t,uint8_t,uint8_t,uint8_t)", (void*)_copyRect},
+    {"void shift(int,int)", (void*)_shift},
+
+    // channel overrides
+    {"void overrideChannel(uint16_t,uint8_t,uint8_t)", (void*)_overrideChannel},
+    {"void releaseChannel(uint16_t)", (void*)_releaseChannel},
+    {"void releaseChannels()", (void*)_releaseChannels},
+
+    // time of day
+    {"uint8_t hour", &_lsHour},
+    {"uint8_t minute", &_lsMinute},
+    {"uint8_t second", &_lsSecond},
+};
+static bool externalsAdded = false;
+
+static void addExternals() {
+  if (externalsAdded) return;
+  uint32_t start = millis();
+  for (const ExternalDefinition& external : externals) addExternal(external.definition, external.ptr);
+  externalsAdded = true;
+  EXT_LOGI(MB_TAG, "%d externals added in %dms", (int)(sizeof(externals) / sizeof(externals[0])), millis() - start);
 }
 
 Parser parser = Parser();
@@ -176,87 +279,15 @@ void LiveScriptNode::setup() {
     return;
   }
 
-  // make sure types in below functions are correct !!! otherwise livescript will crash
-
-  // generic functions
-  addExternal("uint32_t millis()", (void*)millis);
-  addExternal("uint32_t now()", (void*)millis);  // todo: synchronized time (sys->now)
-  addExternal("uint8_t random8(uint8_t)", (void*)(uint8_t (*)(uint8_t))random8);
-  addExternal("uint16_t random16(uint16_t)", (void*)(uint16_t (*)(uint16_t))random16);
-  addExternal("void delay(uint32_t)", (void*)((void (*)(uint32_t))delay));
-  addExternal("void pinMode(uint8_t,uint8_t)", (void*)pinMode);
-  addExternal("void digitalWrite(uint8_t,uint8_t)", (void*)digitalWrite);
-
-  // trigonometric functions
-  addExternal("float sin(float)", (void*)(float (*)(float))sin);
-  addExternal("float cos(float)", (void*)(float (*)(float))cos);
-  addExternal("uint8_t sin8(uint8_t)", (void*)sin8);
-  addExternal("uint8_t cos8(uint8_t)", (void*)cos8);
-  addExternal("float atan2(float,float)", (void*)(float (*)(float, float))atan2);
-  addExternal("uint8_t inoise8(uint16_t,uint16_t,uint16_t)", (void*)(uint8_t (*)(uint16_t, uint16_t, uint16_t))inoise8);
-  addExternal("uint8_t beatsin8(uint16_t,uint8_t,uint8_t,uint32_t,uint8_t)", (void*)beatsin8);
-  addExternal("uint8_t beatsin16(uint16_t,uint16_t,uint16_t,uint32_t,uint8_t)", (void*)beatsin16);
-  addExternal("float sqrt(float)", (void*)(float (*)(float))sqrtf);
-  addExternal("float hypot(float,float)", (void*)(float (*)(float, float))hypot);
-  addExternal("uint8_t beat8(uint16_t,uint32_t)", (void*)(uint8_t (*)(uint16_t, uint32_t))beat8);  // saw wave
-  addExternal("uint8_t triangle8(uint8_t)", (void*)triangle8);
-
-  // MoonLight functions
-  addExternal("void addControl(void*,char*,char*,uint8_t,uint8_t)", (void*)_addControl);
-  addExternal("void nextPin()", (void*)_nextPin);
-  addExternal("void addLight(uint16_t,uint16_t,uint16_t)", (void*)_addLight);
-  addExternal("void addTube(uint16_t,uint16_t,uint16_t,uint16_t,uint16_t,uint16_t,uint8_t)", (void*)_addTube);  // 🌙 interpolates numPixels lights along a 3D line then calls nextPin
-  addExternal("void modifySize()", (void*)_modifySize);
-  //   addExternal(    "void modifyPosition(Coord3D &position)", (void *)_modifyPosition);
-  //   addExternal(    "void modifyXYZ(uint16_t,uint16_t,uint16_t)", (void *)_modifyXYZ);
-
-  // MoonLight Parallel LED Driver vars
-  //   but keep enabled to avoid compile errors when used in non virtual context
-  //   addExternal( "uint8_t colorOrder", &layerP.ledsDriver.colorOrder);
-  //   addExternal( "uint8_t clockPin", &layerP.ledsDriver.clockPin);
-  //   addExternal( "uint8_t latchPin", &layerP.ledsDriver.latchPin);
-  //   addExternal( "uint8_t clockFreq", &layerP.ledsDriver.clockFreq);
-  //   addExternal( "uint8_t dmaBuffer", &layerP.ledsDriver.dmaBuffer);
-
-  addExternal("void fadeToBlackBy(uint8_t)", (void*)_fadeToBlackBy);
+  addExternals();
+
+  // externals of this node
   addExternal("CRGB* leds", (void*)(CRGB*)layer->virtualChannels);
-  addExternal("CRGB getRGB(uint16_t)", (void*)_getRGB);
-  addExternal("void setRGB(uint16_t,CRGB)", (void*)_setRGB);
-  addExternal("void setRGBXY(int,int,CRGB)", (void*)_setRGBXY);  // 🌙 called by preamble-injected setRGB(Coord3D,CRGB)
-  addExternal("void setRGBXYZ(int,int,int,CRGB)", (void*)_setRGBXYZ);  // 🌙 called by preamble-injected setRGB(Coord3D,CRGB)
-  addExternal("CRGB ColorFromPalette(uint8_t,uint8_t)", (void*)_colorFromPalette);  // 🌙
-  addExternal("void setRGBPal(uint16_t,uint8_t,uint8_t)", (void*)_setRGBPal);
-  addExternal("void setPan(uint16_t,uint8_t)", (void*)_setPan);
-  addExternal("void setTilt(uint16_t,uint8_t)", (void*)_setTilt);
-  addExternal("void setPalEntry(uint8_t,uint8_t,uint8_t,uint8_t)", (void*)_setPalEntry);
-  addExternal("void setPalEntryHSV(uint8_t,uint8_t,uint8_t,uint8_t)", (void*)_setPalEntryHSV);
-  addExternal("void setHSV(uint16_t,uint8_t,uint8_t,uint8_t)", (void*)_setHSV);
-  addExternal("void setHSVXY(int,int,uint8_t,uint8_t,uint8_t)", (void*)_setHSVXY);
   addExternal("uint8_t width", &layer->size.x);
   addExternal("uint8_t height", &layer->size.y);
   addExternal("uint8_t depth", &layer->size.z);
   addExternal("bool on", &on);
-
-  // audio sync
-  addExternal("uint8_t* bands", (void*)sharedData.bands);
-  addExternal("float volume", &sharedData.volume);
-
-  // gyro / IMU
-  addExternal("int gravityX", &sharedData.gravity.x);
-  addExternal("int gravityY", &sharedData.gravity.y);
-  addExternal("int gravityZ", &sharedData.gravity.z);
-
-  // 2D/3D drawing
-  addExternal("void drawLine(uint8_t,uint8_t,uint8_t,uint8_t,CRGB)", (void*)_drawLine);
-  addExternal("void drawLine3D(uint8_t,uint8_t,uint8_t,uint8_t,uint8_t,uint8_t,CRGB)", (void*)_drawLine3D);
-  addExternal("void drawCircle(int,int,uint8_t,CRGB)", (void*)_drawCircle);
-  addExternal("void blur2d(uint8_t)", (void*)_blur2d);
-
-  // time of day
-  _updateTime();
-  addExternal("uint8_t hour", &_lsHour);
-  addExternal("uint8_t minute", &_lsMinute);
-  addExternal("uint8_t second", &_lsSecond);
+  _updateTime();  // hour, minute and second current before the script starts
 
   //   for (asm_external el: external_links) {
   //       EXT_LOGV(MB_TAG, "elink %s %s %d", el.shortname.c_str(), el.name.c_str(), el.type);
@@ -373,16 +404,8 @@ void LiveScriptNode::compileAndRun() {
   if (!compileScript.empty()) {
     std::string& scScript = compileScript;  // use the pre-read script source
 
-    hasSetupFunction = false;
-    hasLoopFunction = false;
+    setFunctions(scriptFunctions(scScript));
     hasLoopTask = false;  // 🌙 reset before recompile; set again in execute() if task starts
-    hasOnLayoutFunction = false;
-    hasModifyFunction = false;
-
-    if (scScript.find("setup()") != std::string::npos) hasSetupFunction = true;
-    if (scScript.find("loop()") != std::string::npos) hasLoopFunction = true;
-    if (scScript.find("onLayout()") != std::string::npos) hasOnLayoutFunction = true;
-    if (scScript.find("modifyPosition(") != std::string::npos) hasModifyFunction = true;
     //   if (scScript.find("modifyXYZ(") != std::string::npos) hasModifier = true;
 
     // add main function
@@ -401,6 +424,7 @@ void LiveScriptNode::compileAndRun() {
     uint32_t parseTime = millis() - parseStart;
     EXT_LOGI(MB_TAG, "parsing %s done in %dms (exeExist=%s)", animation.c_str(), parseTime,
              executable.exeExist ? "true" : "false");
+    unbindControls();                  // addExe deletes the executable compiled before, with the variables of its controls
     scriptRuntime.addExe(executable);  // if already exists, delete it first
     EXT_LOGV(MB_TAG, "addExe success %s", executable.exeExist ? "true" : "false");
 
@@ -424,6 +448,13 @@ void LiveScriptNode::compileAndRun() {
   // stop UI spinner
 }
 
+void LiveScriptNode::setFunctions(uint8_t functions) {
+  hasSetupFunction = functions & SCRIPT_SETUP;
+  hasLoopFunction = functions & SCRIPT_LOOP;
+  hasOnLayoutFunction = functions & SCRIPT_ONLAYOUT;
+  hasModifyFunction = functions & SCRIPT_MODIFY;
+}
+
 void LiveScriptNode::execute() {
   if (safeModeMB) {
     EXT_LOGW(MB_TAG, "Safe mode enabled, not executing script %s", animation.c_str());
@@ -495,6 +526,7 @@ void LiveScriptNode::kill() {
 
 void LiveScriptNode::free() {
   EXT_LOGV(MB_TAG, "%s", animation.c_str());
+  unbindControls();
   scriptRuntime.free(animation.c_str());
 }
 
@@ -502,9 +534,16 @@ void LiveScriptNode::killAndDelete() {
   EXT_LOGV(MB_TAG, "%s", animation.c_str());
   kill();
   // scriptRuntime.free(animation.c_str());
+  unbindControls();
   scriptRuntime.deleteExe(animation.c_str());
 };
 
+void LiveScriptNode::unbindControls() {
+  if (layerMutex) xSemaphoreTake(*layerMutex, portMAX_DELAY);
+  controlTable.unbind();  // main() -> setup() -> addControl binds them to the variables of the new executable
+  if (layerMutex) xSemaphoreGive(*layerMutex);
+}
+
 void LiveScriptNode::getScriptsJson(JsonArray scripts) {
   for (Executable& exec : scriptRuntime._scExecutables) {
     exe_info exeInfo = scriptRuntime.getExecutableInfo(exec.name);
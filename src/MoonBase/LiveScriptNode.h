@@ -55,6 +55,8 @@ class LiveScriptNode : public Node {
   void startCompile();
   /// Reads the .sc file from ESPFS, parses it, and sets needsExecute (execution deferred to loop20ms).
   void compileAndRun();
+  /// Sets hasSetupFunction .. hasModifyFunction from SCRIPT_ flags.
+  void setFunctions(uint8_t functions);
   /// Requests mappings and starts script execution (as task if loop exists, synchronous otherwise).
   void execute();
   /// Kills the running script instance.
@@ -63,6 +65,9 @@ class LiveScriptNode : public Node {
   void free();
   /// Kills the script and deletes its executable from the runtime.
   void killAndDelete();
+  /// The variables of the executable go away (replaced, freed, deleted): its controls write nothing until the script's
+  /// setup() adds them again (ControlTable::unbind). Takes the layer mutex: commands are applied on the layer task.
+  void unbindControls();
   /// Populates a JsonArray with info about all running LiveScript executables.
   static void getScriptsJson(JsonArray scripts);
 };
@@ -266,6 +266,9 @@ StateUpdateResult ModuleState::update(JsonObject& newData, ModuleState& state, c
 
   if (newData.size() != 0) {  // in case of empty file
 
+    // a single value sent by the UI: no need to compare the whole state
+    if (newData["_path"].is<const char*>()) return updatePath(newData["_path"].as<const char*>(), newData["_value"], state, originId);
+
     // check which controls have updated
     if (newData != state.data) {
       UpdatedItem updatedItem;
@@ -298,6 +301,33 @@ StateUpdateResult ModuleState::update(JsonObject& newData, ModuleState& state, c
   }
 }
 
+StateUpdateResult ModuleState::updatePath(const char* path, JsonVariantConst value, ModuleState& state, const String& originId) {
+  StatePath statePath;
+  if (!parseStatePath(path, statePath)) {
+    EXT_LOGW(MB_TAG, "invalid path %s", path ? path : "null");
+    return StateUpdateResult::ERROR;
+  }
+
+  UpdatedItem updatedItem;
+  StatePathResult result = applyStatePath(state.data, statePath, value, [&](const StatePath& changedPath, JsonVariant oldValue, JsonVariant newValue) {
+    const char* parent[2];
+    changedPath.location(parent, updatedItem.index);
+    updatedItem.parent[0] = parent[0];
+    updatedItem.parent[1] = parent[1];
+    updatedItem.name = changedPath.name();
+    updatedItem.oldValue = oldValue;
+    updatedItem.value = newValue;
+    updatedItem.originId = &originId;
+    state.processUpdatedItem(updatedItem);
+  });
+
+  if (result == StatePathResult::invalid) {
+    EXT_LOGW(MB_TAG, "path %s not in state", path);
+    return StateUpdateResult::ERROR;
+  }
+  return result == StatePathResult::changed ? StateUpdateResult::CHANGED : StateUpdateResult::UNCHANGED;
+}
+
 Module::Module(const char* moduleName, PsychicHttpServer* server, ESP32SvelteKit* sveltekit) {
   _moduleName = (moduleName && moduleName[0] != '\0') ? moduleName : "unnamed";
 
@@ -367,6 +397,29 @@ bool Module::updatePin(uint8_t& pin, const uint8_t pinUsage, bool checkOut) {
   }
 }
 
+bool Module::updatePins(uint8_t* pins, uint8_t count, const uint8_t pinUsage, bool checkOut) {
+  uint8_t found[16];
+  if (count > sizeof(found)) count = sizeof(found);
+  memset(found, UINT8_MAX, count);
+  uint8_t nrOfPins = 0;
+
+  read(
+      [&](ModuleState& state) {
+        for (JsonObject pinObject : state.data["pins"].as<JsonArray>()) {
+          if (nrOfPins == count) break;
+          uint8_t gpio = pinObject["GPIO"];
+          if (GPIO_IS_VALID_GPIO(gpio) && gpio < GPIO_PIN_COUNT && (!checkOut || GPIO_IS_VALID_OUTPUT_GPIO(gpio))) {
+            if (pinObject["usage"] == pinUsage) found[nrOfPins++] = gpio;
+          } else
+            EXT_LOGW(MB_TAG, "Pin %d (u:%d) not valid (o:%d)", gpio, pinUsage, checkOut);
+        }
+      },
+      _moduleName);
+  if (memcmp(pins, found, count) == 0) return false;
+  memcpy(pins, found, count);
+  return true;
+}
+
 void Module::begin() {
   EXT_LOGV(MB_TAG, "");
 
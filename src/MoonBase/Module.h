@@ -16,6 +16,7 @@
 
   #include <ESP32SvelteKit.h>
   #include "utilities/PlatformFunctions.h"
+  #include "utilities/StatePath.h"
 
 /// Tracks which control changed during a state update, including its parent context and old/new values.
 // sizeof was 160 chars -> 80 -> 68 -> 88
@@ -75,8 +76,13 @@ class ModuleState {
   static void read(ModuleState& state, JsonObject& stateJson);
 
   /// Applies newData to the module state, detecting changes and dispatching updates. Returns CHANGED or UNCHANGED.
+  /// newData {"_path": "nodes[3].controls[5].value", "_value": 42} is handed to updatePath().
   static StateUpdateResult update(JsonObject& newData, ModuleState& state, const String& originId);  //, const String& originId
 
+  /// Sets one value addressed by path (see StatePath.h) without comparing the rest of the state and dispatches
+  /// one processUpdatedItem if it changed. Returns ERROR if the path does not address an existing value slot.
+  static StateUpdateResult updatePath(const char* path, JsonVariantConst value, ModuleState& state, const String& originId);
+
   /// Optional hook called before read() copies state, allowing modules to refresh dynamic data.
   ReadHook readHook = nullptr;  // called when the UI requests the state, can be used to update the state before sending it to the UI
 };
@@ -136,6 +142,8 @@ class Module : public StatefulService<ModuleState> {
 
   /// Reads the assigned GPIO pin for the given usage from ModuleIO state. Returns true if pin changed.
   bool updatePin(uint8_t& pin, const uint8_t pinUsage, bool checkOut = false);
+  /// As updatePin for boards with more pins of a usage: pins[0..count) get the first count (max 16) GPIOs in ModuleIO order, UINT8_MAX if fewer. Returns true if any pin changed.
+  bool updatePins(uint8_t* pins, uint8_t count, const uint8_t pinUsage, bool checkOut = false);
 
  protected:
 
@@ -16,44 +16,102 @@
   #include "MoonBase/SharedFSPersistence.h"
   #include "MoonBase/utilities/PlatformFunctions.h"
 
-// recursively fill a fileArray with all files and folders on the FS
-void addFolder(File folder, bool showHidden, const JsonArray& fileArray) {
+// recursively add all files and folders on the FS to the index (once, after that the index is updated per change)
+void indexFolder(File folder, const std::function<void(const char*, bool, uint32_t, uint32_t)>& add) {
   folder.rewindDirectory();
   while (true) {
     File file = folder.openNextFile();
     if (!file) {
       break;
     } else {
-      if (showHidden || file.name()[0] != '.') {
-        JsonObject fileObject = fileArray.add<JsonObject>();
-        fileObject["name"] = (char*)file.name();  // enforces copy, solved in latest arduinojson!, see https://arduinojson.org/news/2024/12/29/arduinojson-7-3/
-        fileObject["path"] = (char*)file.path();  // enforces copy, solved in latest arduinojson!, see https://arduinojson.org/news/2024/12/29/arduinojson-7-3/
-        fileObject["isFile"] = !file.isDirectory();
-        // EXT_LOGI(MB_TAG, "file %s (%d)", file.path(), file.size());
-        if (file.isDirectory()) {
-          addFolder(file, showHidden, fileObject["files"].to<JsonArray>());
-        } else {
-          fileObject["size"] = file.size();
-          fileObject["time"] = file.getLastWrite();
-        }
-        // serializeJson(fileObject, Serial);
+      if (file.isDirectory()) {
+        add(file.path(), false, 0, 0);
+        indexFolder(file, add);
+      } else {
+        add(file.path(), true, file.size(), file.getLastWrite());
       }
       file.close();
     }
   }
 }
 
-void FilesState::read(FilesState& state, JsonObject& stateJson) {
-  stateJson["name"] = "/";
-  // crashes for some reason: ???
-  stateJson["fs_total"] = ESPFS.totalBytes();
-  stateJson["fs_used"] = ESPFS.usedBytes();
-  stateJson["showHidden"] = state.showHidden;
+void FilesState::buildIndex() {
+  if (index.built()) return;
   File folder = ESPFS.open("/");
-  addFolder(folder, state.showHidden, stateJson["files"].to<JsonArray>());
+  index.rebuild([&](auto add) { indexFolder(folder, add); });
   folder.close();
-  // print->printJson("FilesState::read", stateJson);
-  EXT_LOGI(MB_TAG, "");
+  _fsTotal = ESPFS.totalBytes();
+  EXT_LOGI(MB_TAG, "indexed %d files and folders", index.size());
+}
+
+bool FilesState::indexPath(const char* path) {
+  buildIndex();
+  if (!ESPFS.exists(path)) return index.remove(path);
+  File file = ESPFS.open(path);
+  if (!file) return false;
+  bool isFile = !file.isDirectory();
+  bool changed = index.set(path, isFile, isFile ? file.size() : 0, isFile ? file.getLastWrite() : 0);
+  file.close();
+  return changed;
+}
+
+void FilesState::readUsage(JsonObject& stateJson) {
+  if (_fsUsedVersion != index.version()) {  // usedBytes walks the FS blocks: only when files changed
+    _fsUsed = ESPFS.usedBytes();
+    _fsUsedVersion = index.version();
+  }
+  stateJson["fs_total"] = _fsTotal;
+  stateJson["fs_used"] = _fsUsed;
+  stateJson["showHidden"] = showHidden;
+  stateJson["version"] = index.version();
+}
+
+void FilesState::read(FilesState& state, JsonObject& stateJson) {
+  state.buildIndex();
+  stateJson["name"] = "/";
+  state.readUsage(stateJson);
+  // nest the depth first index: folders[depth] is the files array of the folder at that depth
+  std::vector<JsonArray> folders = {stateJson["files"].to<JsonArray>()};
+  state.index.forEach([&](const char* path, const char* name, const FileIndexEntry& entry, int depth) {
+    if (!state.showHidden && isHiddenPath(path)) return;
+    if (depth >= (int)folders.size()) return;
+    folders.resize(depth + 1);
+    JsonObject fileObject = folders[depth].add<JsonObject>();
+    fileObject["name"] = (char*)name;  // enforces copy, solved in latest arduinojson!, see https://arduinojson.org/news/2024/12/29/arduinojson-7-3/
+    fileObject["path"] = (char*)path;  // enforces copy, solved in latest arduinojson!, see https://arduinojson.org/news/2024/12/29/arduinojson-7-3/
+    fileObject["isFile"] = entry.isFile;
+    if (entry.isFile) {
+      fileObject["size"] = entry.size;
+      fileObject["time"] = entry.time;
+    } else {
+      folders.push_back(fileObject["files"].to<JsonArray>());
+    }
+  });
+}
+
+void FilesState::readChanges(FilesState& state, JsonObject& stateJson) {
+  state.buildIndex();
+  if (!state.index.journalComplete()) {  // after boot, showHidden or many changes
+    read(state, stateJson);
+  } else {
+    stateJson["from"] = state.index.journalFrom();  // the UI applies the changes to the tree of this version
+    state.readUsage(stateJson);
+    JsonArray changes = stateJson["changes"].to<JsonArray>();
+    for (const FileJournalEntry& change : state.index.journal()) {
+      if (!state.showHidden && isHiddenPath(change.path.c_str())) continue;
+      JsonObject changeObject = changes.add<JsonObject>();
+      changeObject["op"] = change.change == FileChange::added ? "added" : change.change == FileChange::removed ? "removed" : "modified";
+      changeObject["path"] = (char*)change.path.c_str();  // enforces copy
+      if (change.change != FileChange::removed) {
+        changeObject["isFile"] = change.entry.isFile;
+        if (change.entry.isFile) {
+          changeObject["size"] = change.entry.size;
+          changeObject["time"] = change.entry.time;
+        }
+      }
+    }
+  }
+  state.index.publish();
 }
 
 StateUpdateResult FilesState::update(JsonObject& newData, FilesState& state, const String& originId) {
@@ -62,9 +120,11 @@ StateUpdateResult FilesState::update(JsonObject& newData, FilesState& state, con
   if (newData["showHidden"] != state.showHidden) {
     state.showHidden = newData["showHidden"];
     EXT_LOGD(MB_TAG, "showHidden %d", state.showHidden);
+    state.index.reset();  // other files are shown: send the whole tree
     changed = true;
   }
 
+  state.buildIndex();
   state.updatedItems.clear();
 
   JsonArray deletes = newData["deletes"].as<JsonArray>();
@@ -76,6 +136,7 @@ StateUpdateResult FilesState::update(JsonObject& newData, FilesState& state, con
         ESPFS.remove(var["path"].as<const char*>());
       else
         ESPFS.rmdir(var["path"].as<const char*>());
+      state.indexPath(var["path"].as<const char*>());
 
       state.updatedItems.push_back(var["path"].as<const char*>());
     }
@@ -98,6 +159,7 @@ StateUpdateResult FilesState::update(JsonObject& newData, FilesState& state, con
       } else {
         ESPFS.mkdir(var["path"].as<const char*>());
       }
+      state.indexPath(var["path"].as<const char*>());
       state.updatedItems.push_back(var["path"].as<const char*>());
     }
   }
@@ -124,8 +186,9 @@ StateUpdateResult FilesState::update(JsonObject& newData, FilesState& state, con
 
         EXT_LOGI(MB_TAG, "rename %s to %s", var["path"].as<const char*>(), newPath);
 
+        state.indexPath(var["path"].as<const char*>());
         if (strcmp(var["path"], newPath) != 0) {
-          ESPFS.rename(var["path"].as<const char*>(), newPath);
+          if (ESPFS.rename(var["path"].as<const char*>(), newPath)) state.index.rename(var["path"].as<const char*>(), newPath);
         }
         state.updatedItems.push_back(var["path"].as<const char*>());
       }
@@ -142,13 +205,39 @@ StateUpdateResult FilesState::update(JsonObject& newData, FilesState& state, con
 FileManager::FileManager(PsychicHttpServer* server, ESP32SvelteKit* sveltekit)
     : _httpEndpoint(FilesState::read, FilesState::update, this, server, "/rest/FileManager",  //
                     sveltekit->getSecurityManager(), AuthenticationPredicates::IS_AUTHENTICATED),
-      _eventEndpoint(FilesState::read, FilesState::update, this, sveltekit->getSocket(), "FileManager"),
+      _eventEndpoint(FilesState::readChanges, FilesState::update, this, sveltekit->getSocket(), "FileManager"),
       _webSocketServer(FilesState::read, FilesState::update, this, server, "/ws/FileManager", sveltekit->getSecurityManager(), AuthenticationPredicates::IS_AUTHENTICATED),
       _socket(sveltekit->getSocket()),
       _server(server),
       _sveltekit(sveltekit) {}
 
+void FileManager::fileChanged(const char* path, const String& originId) {
+  xSemaphoreTake(_pendingMutex, portMAX_DELAY);
+  bool queued = false;
+  for (auto& change : _pendingChanges) queued = queued || change.first == path;  // a file saved twice before loop()
+  if (!queued) _pendingChanges.emplace_back(path, originId);
+  xSemaphoreGive(_pendingMutex);
+}
+
+void FileManager::loop() {
+  xSemaphoreTake(_pendingMutex, portMAX_DELAY);
+  std::vector<std::pair<String, String>> changes;
+  changes.swap(_pendingChanges);
+  xSemaphoreGive(_pendingMutex);
+
+  // one update per change: the event is a journal of this path. Handlers writing files queue new changes, applied next loop
+  for (auto& change : changes) {
+    update(
+        [&](FilesState& state) {
+          state.updatedItems.clear();
+          return state.indexPath(change.first.c_str()) ? StateUpdateResult::CHANGED : StateUpdateResult::UNCHANGED;
+        },
+        change.second);
+  }
+}
+
 void FileManager::begin() {
+  _socket->registerEvent("FileManager", EventSendPolicy::ordered);  // journals build on each other: never coalesce
   _httpEndpoint.begin();
   _eventEndpoint.begin();
   _webSocketServer.begin();
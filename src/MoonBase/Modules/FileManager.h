@@ -18,7 +18,8 @@
 // * folderListFromBreadCrumbs: create folderList of current folder
 // * handleEdit: when edit button pressed: navigate back and forward through folders, edit current file
 // * confirmDelete: when delete button pressed
-// * socket files / handleFileState (->folderListFromBreadCrumbs)
+// * socket files / handleFileState (->folderListFromBreadCrumbs): the whole tree, or a journal of changes applied to it
+// Server side the tree is an in-memory FileIndex: the FS is walked once, then each write, delete or rename updates it
 // Using component FileManager, FileEditWidget and EditRowWidget, see [Components](https://moonmodules.org/MoonLight/components/#FileEditWidget)
 
 #ifndef FileManager_h
@@ -33,14 +34,31 @@
   #include <PsychicHttp.h>
   #include <WebSocketServer.h>
 
+  #include "MoonBase/utilities/FileIndex.h"
+
 class FilesState {
  public:
   std::vector<String> updatedItems;
   bool showHidden = false;
+  FileIndex index;  // all files and folders on the FS
 
+  // the whole tree (REST and /ws/FileManager)
   static void read(FilesState& settings, JsonObject& stateJson);
+  // the changes since the last event as a journal, or the whole tree if clients need it (event socket)
+  static void readChanges(FilesState& state, JsonObject& stateJson);
 
   static StateUpdateResult update(JsonObject& newData, FilesState& filesState, const String &originId);
+
+  // updates the index entry of path from the FS after it has been written, created or removed. True if it changed
+  bool indexPath(const char* path);
+
+ private:
+  size_t _fsTotal = 0;
+  size_t _fsUsed = 0;
+  uint32_t _fsUsedVersion = UINT32_MAX;  // index version _fsUsed was measured at
+
+  void buildIndex();
+  void readUsage(JsonObject& stateJson);
 };
 
 class FileManager : public StatefulService<FilesState> {
@@ -49,6 +67,15 @@ class FileManager : public StatefulService<FilesState> {
 
   void begin();
 
+  // a file was written, created or removed outside FileManager: update the index and send the change to the UI
+  // (not an updatedItem: update handlers do not reload it). Deferred to loop(): callers may run inside a FileManager
+  // update handler (e.g. a module saving its config), a nested update() would clear updatedItems
+  // while that handler iterates them
+  void fileChanged(const char* path, const String& originId);
+
+  // applies the changes queued by fileChanged (sveltekit loop task)
+  void loop();
+
  protected:
   EventSocket* _socket;
 
@@ -58,6 +85,9 @@ class FileManager : public StatefulService<FilesState> {
   WebSocketServer<FilesState> _webSocketServer;
   PsychicHttpServer* _server;
   ESP32SvelteKit* _sveltekit;
+
+  std::vector<std::pair<String, String>> _pendingChanges;  // path, originId
+  SemaphoreHandle_t _pendingMutex = xSemaphoreCreateMutex();
 };
 
 #endif
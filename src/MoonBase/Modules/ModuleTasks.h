@@ -15,11 +15,36 @@
 #if FT_MOONBASE == 1
 
   #include "MoonBase/Module.h"
+  #include "MoonBase/utilities/TaskTelemetry.h"
+
+  #define MAX_TASKS 30
+
+// columns of the telemetry ring, one sample per second
+enum TasksTelemetry : uint8_t { TelCore0, TelCore1, TelEffects, TelDrivers, TelEffectsSwapWait, TelChannelsFreeWait, TelDriversSwapWait, TelLps, TelEffectsStack, TelDriversStack, TelColumns };
 
 class ModuleTasks : public Module {
  public:
+  // time blocked at the semaphores of the frame pipeline, added by effectTask and driverTask (main.cpp)
+  WaitPoint effectsSwapWait;    // swapMutex in effectTask
+  WaitPoint channelsFreeWait;   // channelsDFreeSemaphore in effectTask: the drivers still read channelsD
+  WaitPoint driversSwapWait;    // swapMutex in driverTask
+
   ModuleTasks(PsychicHttpServer* server, ESP32SvelteKit* sveltekit) : Module("tasks", server, sveltekit) { EXT_LOGV(MB_TAG, "constructor"); }
 
+  void begin() override {
+    Module::begin();
+
+    // the telemetry ring as CSV, for a spreadsheet or a plot
+    _server->on("/rest/tasksTelemetry", HTTP_GET, [&](PsychicRequest* request) {
+      PsychicResponse response(request);
+      response.setCode(200);
+      response.setContentType("text/csv");
+      response.sendHeaders();
+      _telemetry.csv(telemetryColumns(), [&](const char* line, size_t length) { response.sendChunk((uint8_t*)line, length); });
+      return response.finishChunking();
+    });
+  }
+
   void setupDefinition(const JsonArray& controls) override {
     EXT_LOGV(MB_TAG, "");
     JsonObject control;  // state.data has one or more properties
@@ -44,14 +69,20 @@ class ModuleTasks : public Module {
       addControl(rows, "runtime", "text", 0, 32, true);
       // addControl(rows, "core", "number", 0, 65538, true);
     }
+
+    control = addControl(controls, "telemetry", "rows");
+    control["crud"] = "r";
+    rows = control["n"].to<JsonArray>();
+    {
+      addControl(rows, "name", "text", 0, 32, true);
+      addControl(rows, "now", "text", 0, 32, true);
+      addControl(rows, "min", "text", 0, 32, true);
+      addControl(rows, "avg", "text", 0, 32, true);
+      addControl(rows, "max", "text", 0, 32, true);
+    }
   }
 
   void loop1s() override {
-    if (!_sveltekit->getSocket()->getConnectedClients()) return;  // 🌙 No need for UI tasks
-    if (!networkIsConnected()) return;
-
-  #define MAX_TASKS 30
-
     TaskStatus_t taskStatusArray[MAX_TASKS];
     UBaseType_t taskCount;
     uint32_t totalRunTime = 1;
@@ -62,6 +93,13 @@ class ModuleTasks : public Module {
     // Sort the taskStatusArray by task name
     std::sort(taskStatusArray, taskStatusArray + taskCount, [](const TaskStatus_t& a, const TaskStatus_t& b) { return strcmp(a.pcTaskName, b.pcTaskName) < 0; });
 
+    // sampled also without clients, so the ring is complete when asked for
+    uint16_t cpu[MAX_TASKS];  // permille of a core in the last second
+    sampleTelemetry(taskStatusArray, taskCount, totalRunTime, cpu);
+
+    if (!_sveltekit->getSocket()->getConnectedClients()) return;  // 🌙 No need for UI tasks
+    if (!networkIsConnected()) return;
+
     // printf("Found %d tasks\n", taskCount);
     // printf("Name\t\tState\tPrio\tStack\tRun Time\tCPU %%\tCore\n");
 
@@ -97,7 +135,10 @@ class ModuleTasks : public Module {
       }
 
       Char<32> text;
-      text.format("%s %d%% @P%d @C%d", state, (uint32_t)(100ULL * ts->ulRunTimeCounter / totalRunTime), ts->uxCurrentPriority, ts->xCoreID == tskNO_AFFINITY ? -1 : ts->xCoreID);
+      if (cpu[i] == TELEMETRY_UNKNOWN)
+        text.format("%s ?%% @P%d @C%d", state, ts->uxCurrentPriority, ts->xCoreID == tskNO_AFFINITY ? -1 : ts->xCoreID);
+      else  // over the last second, not since boot
+        text.format("%s %d.%d%% @P%d @C%d", state, cpu[i] / 10, cpu[i] % 10, ts->uxCurrentPriority, ts->xCoreID == tskNO_AFFINITY ? -1 : ts->xCoreID);
 
       task["name"] = ts->pcTaskName;
       task["summary"] = text.c_str();
@@ -109,7 +150,7 @@ class ModuleTasks : public Module {
       else if (equal(ts->pcTaskName, "httpd"))
         text.format("%d - %d", ts->usStackHighWaterMark, HTTPD_STACK_SIZE);
   #if FT_ENABLED(FT_MOONLIGHT)
-      else if (equal(ts->pcTaskName, "AppEffects"))
+      else if (equal(ts->pcTaskName, "AppEffects") || equal(ts->pcTaskName, "AppRender"))
         text.format("%d - %d", ts->usStackHighWaterMark, EFFECTS_STACK_SIZE);
       else if (equal(ts->pcTaskName, "AppDrivers"))
         text.format("%d - %d", ts->usStackHighWaterMark, DRIVERS_STACK_SIZE);
@@ -138,12 +179,76 @@ class ModuleTasks : public Module {
     newState["core1"] = pcTaskGetName(current1);
   #endif
 
+    newState["telemetry"].to<JsonArray>();
+    const TelemetryColumn* columns = telemetryColumns();
+    for (uint8_t column = 0; column < TelColumns; column++) {
+      JsonObject row = newState["telemetry"].as<JsonArray>().add<JsonObject>();
+      TelemetryRing<TelColumns>::Summary summary = _telemetry.summary(column);
+      char text[12];
+      row["name"] = columns[column].name;
+      TelemetryRing<TelColumns>::format(text, sizeof(text), _telemetry.last(column), columns[column].decimals);
+      row["now"] = text;
+      TelemetryRing<TelColumns>::format(text, sizeof(text), summary.min, columns[column].decimals);
+      row["min"] = text;
+      TelemetryRing<TelColumns>::format(text, sizeof(text), summary.avg, columns[column].decimals);
+      row["avg"] = text;
+      TelemetryRing<TelColumns>::format(text, sizeof(text), summary.max, columns[column].decimals);
+      row["max"] = text;
+    }
+
     // UpdatedItem updatedItem;
     // _state.compareRecursive("", _state.data, newState, updatedItem); //fill data with doc
 
     // _socket->emitEvent(_moduleName, newState);
     update(newState, ModuleState::update, _moduleName);
   }
+
+ private:
+  CpuWindow<MAX_TASKS> _cpu;
+  TelemetryRing<TelColumns> _telemetry;
+  unsigned long _lastSample = 0;  // micros
+
+  static const TelemetryColumn* telemetryColumns() {
+    // percentages are permille with 1 decimal
+    static const TelemetryColumn columns[TelColumns] = {{"core0_pct", 1}, {"core1_pct", 1}, {"effects_pct", 1}, {"drivers_pct", 1}, {"effects_swap_wait_pct", 1}, {"channels_free_wait_pct", 1}, {"drivers_swap_wait_pct", 1}, {"lps", 0}, {"effects_stack", 0}, {"drivers_stack", 0}};
+    return columns;
+  }
+
+  // CPU per task and core over the last second, the waits of the frame pipeline, into the ring
+  void sampleTelemetry(const TaskStatus_t* tasks, UBaseType_t count, uint32_t totalRunTime, uint16_t* cpu) {
+    TaskRunTime runTimes[MAX_TASKS];
+    for (UBaseType_t i = 0; i < count; i++) {
+      runTimes[i].id = (uintptr_t)tasks[i].xHandle;
+      runTimes[i].counter = tasks[i].ulRunTimeCounter;
+      // IDLE0 / IDLE1 (IDLE on a single core): what they don't get is the load of their core
+      if (strncmp(tasks[i].pcTaskName, "IDLE", 4) == 0) runTimes[i].idleCore = tasks[i].xCoreID == tskNO_AFFINITY ? 0 : tasks[i].xCoreID;
+    }
+    _cpu.update(runTimes, count, totalRunTime, cpu);
+
+    unsigned long now = micros();
+    uint32_t windowUs = _lastSample ? now - _lastSample : 0;
+    _lastSample = now;
+
+    uint16_t values[TelColumns];
+    for (uint16_t& value : values) value = TELEMETRY_UNKNOWN;
+    values[TelCore0] = _cpu.coreLoad(0);
+    values[TelCore1] = _cpu.coreLoad(1);
+    for (UBaseType_t i = 0; i < count; i++) {
+      uint16_t stack = tasks[i].usStackHighWaterMark;
+      if (equal(tasks[i].pcTaskName, "AppEffects")) {
+        values[TelEffects] = cpu[i];
+        values[TelEffectsStack] = stack;
+      } else if (equal(tasks[i].pcTaskName, "AppDrivers")) {
+        values[TelDrivers] = cpu[i];
+        values[TelDriversStack] = stack;
+      }
+    }
+    values[TelEffectsSwapWait] = WaitPoint::permille(effectsSwapWait.take(), windowUs);
+    values[TelChannelsFreeWait] = WaitPoint::permille(channelsFreeWait.take(), windowUs);
+    values[TelDriversSwapWait] = WaitPoint::permille(driversSwapWait.take(), windowUs);
+    values[TelLps] = _sveltekit->lps_all_snapshot;
+    _telemetry.push(millis() / 1000, values);
+  }
 };
 
 #endif
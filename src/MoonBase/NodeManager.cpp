@@ -72,6 +72,29 @@ void NodeManager::loop20ms() {
   #endif
 }
 
+const NodeRegistry<Node>& NodeManager::nodeTypes() const {
+  static const NodeRegistry<Node> none;
+  return none;
+}
+
+void NodeManager::addNodeValues(const JsonObject& control, const char* board) const {
+  if (control["values"].isNull()) control["values"].to<JsonArray>();
+  JsonArray values = control["values"];
+  for (const NodeType<Node>& type : nodeTypes()) {
+    if (type.board && !equal(type.board, board)) continue;
+    JsonObject entry = values.add<JsonObject>();
+    entry["name"] = buildNameAndTags(type.name, type.dim, type.tags);
+    entry["category"] = type.category;
+  }
+}
+
+Node* NodeManager::createNode(char* name, const char* board) const {
+  const NodeType<Node>* type = nodeTypes().find(name);
+  if (!type || (type->board && !equal(type->board, board))) return nullptr;
+  strlcpy(name, buildNameAndTags(type->name, type->dim, type->tags).c_str(), 32);  // if the non AZaz09 part of the name changed, reassign the right name
+  return type->create();
+}
+
 void NodeManager::setupDefinition(const JsonArray& controls) {
   EXT_LOGV(MB_TAG, "");
   JsonObject control;  // state.data has one or more properties
@@ -193,16 +216,26 @@ void NodeManager::handleNodeNameChange(const UpdatedItem& updatedItem, JsonVaria
 
     oldNode->requestMappings();
 
-    // Wait for any in-progress loop()/loop20ms() on this node to complete.
-    // The task loops in PhysicalLayer/VirtualLayer take layerMutex around each node call,
+    // Wait for any in-progress frame on this node to complete.
+    // PhysicalLayer::loop()/loopDrivers() hold layerMutex for the whole frame,
     // so acquiring it here guarantees the node isn't mid-execution.
+    // Commands still queued for this node are applied now so none refers to it after it is freed.
     if (oldNode->layerMutex) {
       xSemaphoreTake(*oldNode->layerMutex, portMAX_DELAY);
+      layerP.applyNodeCommands(oldNode->layerMutex == &layerP.driversMutex ? layerP.driversCommands : layerP.effectsCommands);
       xSemaphoreGive(*oldNode->layerMutex);
     }
 
     EXT_LOGD(MB_TAG, "remove oldNode: %d p:%p", nodes->size(), oldNode);
+    NodePool* pool = oldNode->poolOwner && oldNode->layer ? &oldNode->layer->nodePool : nullptr;
+    uint16_t poolOwner = oldNode->poolOwner;
     freeMBObject(oldNode);  // calls virtual destructor + frees memory
+    if (pool) {             // the node is replaced as a unit: free what its destructor left in the layer pool
+      size_t leaked = pool->releaseOwner(poolOwner);
+      if (leaked) EXT_LOGW(MB_TAG, "%d blocks not freed by the node, released", leaked);
+      NodePoolStats stats = pool->stats();
+      EXT_LOGD(MB_TAG, "node pool used %d (peak %d) reserved %d (peak %d) of %d, fallbacks %d", stats.used, stats.usedPeak, stats.reserved, stats.reservedPeak, stats.capacity, stats.fallbacks);
+    }
     onNodeRemoved();
   }
 
@@ -231,10 +264,12 @@ void NodeManager::handleNodeOnChange(const UpdatedItem& updatedItem, JsonVariant
     EXT_LOGD(MB_TAG, "%s on: %s (#%d)", name ? name : "", updatedItem.value.as<String>().c_str(), nodes->size());
     Node* nodeClass = (*nodes)[updatedItem.index[0]];
     if (nodeClass != nullptr) {
-      nodeClass->on = updatedItem.value.as<bool>();  // set nodeclass on/off
-      xSemaphoreTake(*nodeClass->layerMutex, portMAX_DELAY);
-      nodeClass->onUpdate(nodeState);  // custom onUpdate for the node
-      xSemaphoreGive(*nodeClass->layerMutex);
+      nodeClass->on = updatedItem.value.as<bool>();  // set nodeclass on/off (mapping reads it, so not deferred)
+      NodeCommand command;                           // onUpdate is applied by the task running the node at the start of its next frame
+      command.node = nodeClass;
+      command.isOnChange = true;
+      command.number = nodeClass->on;
+      layerP.queueNodeCommand(command);
       nodeClass->requestMappings();
     } else
       EXT_LOGW(MB_TAG, "Nodeclass %s not found", name ? name : "");
@@ -251,12 +286,22 @@ void NodeManager::handleNodeControlValueChange(const UpdatedItem& updatedItem, J
   if (updatedItem.index[0] < nodes->size()) {
     Node* nodeClass = (*nodes)[updatedItem.index[0]];
     if (nodeClass != nullptr) {
-      xSemaphoreTake(*nodeClass->layerMutex, portMAX_DELAY);
-      nodeClass->updateControl(control);
-      nodeClass->onUpdate(control);  // custom onUpdate for the node
-      xSemaphoreGive(*nodeClass->layerMutex);
-
-      nodeClass->requestMappings();
+      NodeCommand command;  // updateControl + onUpdate + requestMappings, applied by the task running the node
+      command.node = nodeClass;
+      strlcpy(command.name, control["name"] | "", sizeof(command.name));
+      command.pointer = control["p"];
+      strlcpy(command.type, control["type"] | "", sizeof(command.type));
+      command.size = control["size"];
+      if (!control["max"].isNull()) command.max = control["max"];
+      if (control["type"] == "text" || control["type"] == "selectFile") {
+        command.isText = true;
+        strlcpy(command.text, control["value"] | "", sizeof(command.text));
+      } else if (control["type"] == "coord3D") {
+        command.isCoord = true;
+        command.coord = control["value"].as<Coord3D>();
+      } else
+        command.number = control["value"].as<double>();  // numbers and checkboxes
+      layerP.queueNodeCommand(command);
     } else {
       const char* name = nodeState["name"];
       EXT_LOGW(MB_TAG, "nodeClass not found %s", name ? name : "");
@@ -17,6 +17,7 @@
   #include "MoonBase/Module.h"
   #include "MoonBase/Modules/FileManager.h"
   #include "Nodes.h"  //Nodes.h will include VirtualLayer.h which will include PhysicalLayer.h
+  #include "MoonBase/utilities/NodeRegistry.h"
   #if FT_LIVESCRIPT
     #include "LiveScriptNode.h"
   #endif
@@ -43,17 +44,27 @@ class NodeManager : public Module {
   /// Processes deferred LiveScript compilations. Subclasses must call NodeManager::loop20ms().
   void loop20ms() override;
 
-  /// Override to populate the node name dropdown with addNodeValue() calls.
-  virtual void addNodes(const JsonObject& control) {}
+  /// The node types this module can create, in the order of the node name dropdown. Built once by the module.
+  virtual const NodeRegistry<Node>& nodeTypes() const;
 
-  /// Adds a node entry as {name, category} object to the control's values array.
+  /// Populates the node name dropdown: the registered node types (for this board), then e.g. LiveScript files.
+  virtual void addNodes(const JsonObject& control) { addNodeValues(control); }
+
+  /// Adds all registered node types available on board as {name, category} objects to the control's values array.
+  void addNodeValues(const JsonObject& control, const char* board = nullptr) const;
+
+  /// Registers node type T in registry, created with allocMBObject. name: T::name() as in the node type list (EffectNodeTypes.h,
+  /// DriverNodeTypes.h). board: only available on this board preset.
   template <typename T>
-  void addNodeValue(const JsonObject& control) {
-    if (control["values"].isNull()) control["values"].to<JsonArray>();
-    JsonArray values = control["values"];
-    JsonObject entry = values.add<JsonObject>();
-    entry["name"] = getNameAndTags<T>();
-    entry["category"] = T::category();
+  static void registerNode(NodeRegistry<Node>& registry, const char* name, const char* board = nullptr) {
+    if (strcmp(T::name(), name) != 0) EXT_LOGE(MB_TAG, "node type %s is listed as %s: update the node type list", T::name(), name);  // the list is what test_node_registry checks
+    if (!registry.add<T>([]() -> Node* { return allocMBObject<T>(); }, board))
+      EXT_LOGE(MB_TAG, "node type %s not registered: a type with this name exists", T::name());  // presets would create the other type
+  }
+
+  /// Presets saved with alias (an old name of a node type) create the node type name.
+  static void addAlias(NodeRegistry<Node>& registry, const char* alias, const char* name) {
+    if (!registry.addAlias(alias, name)) EXT_LOGE(MB_TAG, "alias %s of %s not added", alias, name);
   }
 
  public:
@@ -61,16 +72,9 @@ class NodeManager : public Module {
   virtual Node* addNode(const uint8_t index, char* name, const JsonArray& controls) const { return nullptr; }
 
  protected:
-
-  /// Checks if name matches T::name() (case/symbol insensitive) and allocates a T if so.
-  template <typename T>
-  Node* checkAndAlloc(char* name) const {
-    if (equalAZaz09(name, T::name())) {
-      strlcpy(name, getNameAndTags<T>().c_str(), 32);  // if the non AZaz09 part of the name changed, reassign the right name
-      return allocMBObject<T>();
-    } else
-      return nullptr;
-  }
+  /// Looks up name in nodeTypes() (case/symbol insensitive) and allocates the node if found and available on board.
+  /// name is reassigned with the current name, dim and tags (they may have changed, or name is an alias).
+  Node* createNode(char* name, const char* board = nullptr) const;
 
   /// Defines the data model: nodes array with name, on/off, and controls sub-rows.
   void setupDefinition(const JsonArray& controls) override;
@@ -16,7 +16,7 @@ SharedData sharedData;
 
 JsonObject Node::findOrCreateControl(const char* name, bool& newControl) { return ::findOrCreateControl(controls, name, newControl); }
 
-JsonObject Node::setupControl(const char* name, const char* type, int min, int max, bool ro, const char* desc, uint8_t sizeCode, size_t sizeofVar, bool newControl, JsonObject control) {
+JsonObject Node::setupControl(const char* name, const char* type, int min, int max, bool ro, const char* desc, uint8_t sizeCode, void* variable, size_t sizeofVar, bool newControl, JsonObject control) {
   control["type"] = type;
   control["valid"] = true;
   // optional properties
@@ -38,26 +38,35 @@ JsonObject Node::setupControl(const char* name, const char* type, int min, int m
     control.remove("desc");
 
   // set size based on control type and sizeCode
+  ControlKind kind = ControlKind::none;
   if (control["type"] == "slider" || control["type"] == "select" || control["type"] == "pin" || control["type"] == "number") {
-    if (sizeCode == 8 || sizeCode == 108 || sizeCode == 16 || sizeCode == 32 || sizeCode == 33 || sizeCode == 34)
+    if (sizeCode == 8 || sizeCode == 108 || sizeCode == 16 || sizeCode == 32 || sizeCode == 33 || sizeCode == 34) {
       control["size"] = sizeCode;
-    else
+      kind = sizeCode == 8 ? ControlKind::u8 : sizeCode == 108 ? ControlKind::i8 : sizeCode == 16 ? ControlKind::u16 : sizeCode == 32 ? ControlKind::u32 : sizeCode == 33 ? ControlKind::i32 : ControlKind::f32;
+    } else
       EXT_LOGE(MB_TAG, "size %d mismatch for %s", sizeCode, name);
   } else if (control["type"] == "selectFile" || control["type"] == "text") {
     control["size"] = sizeofVar;
+    kind = ControlKind::text;
   } else if (control["type"] == "checkbox") {
     if (sizeCode != sizeof(bool))
       EXT_LOGE(MB_TAG, "type for %s is not bool", name);
-    else
+    else {
       control["size"] = sizeof(bool);
+      kind = ControlKind::boolean;
+    }
   } else if (control["type"] == "coord3D") {
     if (sizeCode != sizeof(Coord3D))
       EXT_LOGE(MB_TAG, "type for %s is not Coord3D", name);
-    else
+    else {
       control["size"] = sizeof(Coord3D);
+      kind = ControlKind::coord3D;
+    }
   } else
     EXT_LOGE(MB_TAG, "type of %s not compatible: %s (%d)", control["name"].as<const char*>(), control["type"].as<const char*>(), control["size"].as<uint8_t>());
 
+  if (kind != ControlKind::none) controlTable.add(name, kind, variable, sizeofVar, min, max, ro, control);
+
   if (newControl) {
     onUpdate(control);  // custom onUpdate for the node
   } else {
@@ -77,6 +86,87 @@ void Node::addControlValue(const char* value) {
   EXT_LOGD(MB_TAG, "%s, %d", value, control["values"].size());
 }
 
-void Node::updateControl(const JsonObject& control) { ::updateControl(control); }
+void Node::updateControl(const JsonObject& control) {
+  // fast path: the typed control added by addControl, if the JSON control is still bound to its variable (LiveScript recompiles)
+  ControlTable<JsonObject>::Descriptor* descriptor = controlTable.find(control["name"].as<const char*>());
+  if (descriptor && !descriptor->bound()) return;  // the variable is gone with a replaced LiveScript executable: p is stale too
+  if (!descriptor || descriptor->pointer != reinterpret_cast<void*>(control["p"].as<uintptr_t>())) {
+    ::updateControl(control);
+    return;
+  }
+  JsonVariant value = control["value"];
+  switch (descriptor->kind) {
+    case ControlKind::u8: *(uint8_t*)descriptor->pointer = value; break;
+    case ControlKind::i8: *(int8_t*)descriptor->pointer = value; break;
+    case ControlKind::u16: *(uint16_t*)descriptor->pointer = value; break;
+    case ControlKind::u32: *(uint32_t*)descriptor->pointer = value; break;
+    case ControlKind::i32: *(int*)descriptor->pointer = value; break;
+    case ControlKind::f32: *(float*)descriptor->pointer = value; break;
+    case ControlKind::boolean: *(bool*)descriptor->pointer = value.as<bool>(); break;
+    case ControlKind::text:
+      ControlTable<JsonObject>::setText(*descriptor, value.as<const char*>());
+      return;  // setText marks it synced
+    default:
+      ::updateControl(control);  // coord3D
+      return;
+  }
+  ControlTable<JsonObject>::markSynced(*descriptor, value.as<double>());
+}
+
+void Node::applyCommand(const NodeCommand& command, JsonArenaAllocator& arena) {
+  arena.reset();              // the document of the previous command is gone
+  JsonDocument doc(&arena);  // onUpdate gets a control of its own, not the one in the module state
+  JsonObject control = doc.to<JsonObject>();
+  if (command.isOnChange) {
+    control["on"] = command.number != 0;  // the node row: on is already set
+    onUpdate(control);
+    return;
+  }
+
+  control["name"] = command.name;
+  if (command.isText)
+    control["value"] = command.text;
+  else if (command.isCoord)
+    control["value"] = command.coord;
+  else
+    control["value"] = command.number;
+
+  ControlTable<JsonObject>::Descriptor* descriptor = controlTable.find(command.name);
+  if (!descriptor) {  // not in the table (type mismatch, table full): through the JSON control, as updateControl(control)
+    control["type"] = command.type;
+    control["size"] = command.size;
+    control["p"] = command.pointer;
+    if (command.max >= 0) control["max"] = command.max;
+    ::updateControl(control);
+    onUpdate(control);
+    requestMappings();
+    return;
+  }
+  if (descriptor->pointer != reinterpret_cast<void*>(command.pointer)) {
+    // rebound since it was queued (LiveScript recompile, which restores the value itself): the queued pointer is stale
+    EXT_LOGW(MB_TAG, "%s: control rebound, change not applied", command.name);
+    return;
+  }
+  switch (descriptor->kind) {
+    case ControlKind::text:
+      ControlTable<JsonObject>::setText(*descriptor, command.text);
+      break;
+    case ControlKind::coord3D:
+      *(Coord3D*)descriptor->pointer = command.coord;
+      break;
+    default:
+      ControlTable<JsonObject>::setNumber(*descriptor, command.number);
+      break;
+  }
+  // the JSON control has this value already (the UI wrote it): no write back
+  if (descriptor->isText())
+    ControlTable<JsonObject>::markSyncedText(*descriptor, command.text);
+  else if (descriptor->isNumber())
+    ControlTable<JsonObject>::markSynced(*descriptor, command.number);
+
+  onUpdate(control);  // custom onUpdate for the node
+  // remap only after the new value is in the node's variable (layouts/modifiers read it during mapping)
+  requestMappings();
+}
 
 #endif  // FT_MOONLIGHT
\ No newline at end of file
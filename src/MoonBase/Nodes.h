@@ -18,6 +18,9 @@
 
   /// Portable pure functions (buildNameAndTags, dimension constants, control functions).
   #include "MoonBase/utilities/PureFunctions.h"
+  #include "MoonBase/utilities/ControlTable.h"
+  #include "MoonBase/utilities/FixedMath.h"  // integer sin / cos / sqrt / atan2 for per-light loops
+  #include "MoonBase/utilities/JuliaKernel.h"  // the rows of the Julia effect
 
 /// Returns the display name of a node type with dimension emoji and tags appended.
 /// Used in the UI dropdown to show e.g. "Glow 📏 ⚙️".
@@ -38,7 +41,9 @@ class Node {
   static uint8_t dim() { return _NoD; };
 
   VirtualLayer* layer = nullptr;  // the virtual layer this effect is using
+  uint16_t poolOwner = 0;         // owner of the blocks of this node in layer->nodePool, 0: heap (see NodePool.h)
   JsonArray controls;
+  ControlTable<JsonObject> controlTable;  // typed index of controls: the fast path of updateControl, see ControlTable.h
   Module* moduleControl = nullptr;                // to access global lights control functions if needed
   Module* moduleIO = nullptr;                     // to access io pins if needed
   Module* moduleNodes = nullptr;                  // to request UI update if needed
@@ -47,6 +52,7 @@ class Node {
   virtual bool isLiveScriptNode() const { return false; }
   virtual bool hasOnLayout() const { return false; }  // run map on monitor (pass1) and modifier new Node, on/off, control changed or layout setup, on/off or control changed (pass1 and 2)
   virtual bool hasModifier() const { return false; }  // modifier new Node, on/off, control changed: run layout.requestMapLayout. onLayoutPre: modifySize, addLight: modifyPosition XYZ: modifyXYZ
+  virtual bool hasModifyXYZ() const { return false; }  // modifier overriding modifyXYZ: the layer blurs through XYZ() instead of on its buffer
 
   bool on = false;  // onUpdate will set it on
 
@@ -69,7 +75,7 @@ class Node {
   JsonObject findOrCreateControl(const char* name, bool& newControl);
 
   /// Sets control properties, size, and calls onUpdate for new controls. Implementation in Nodes.cpp.
-  JsonObject setupControl(const char* name, const char* type, int min, int max, bool ro, const char* desc, uint8_t sizeCode, size_t sizeofVar, bool newControl, JsonObject control);
+  JsonObject setupControl(const char* name, const char* type, int min, int max, bool ro, const char* desc, uint8_t sizeCode, void* variable, size_t sizeofVar, bool newControl, JsonObject control);
 
   /// Registers a UI control for this node, binding it to the given variable.
   /// The template sets value/default/pointer; all other logic is in findOrCreateControl() and setupControl().
@@ -106,7 +112,7 @@ class Node {
     else if (std::is_same<ControlType, Coord3D>::value)
       sizeCode = sizeof(Coord3D);
 
-    return setupControl(name, type, min, max, ro, desc, sizeCode, sizeof(variable), newControl, control);
+    return setupControl(name, type, min, max, ro, desc, sizeCode, &variable, sizeof(variable), newControl, control);
   }
 
   // add select options to select control
@@ -115,8 +121,24 @@ class Node {
   // called in addControl (oldValue = "") and in NodeManager onUpdate nodes[i].control[j]
   void updateControl(const JsonObject& control);  // see Nodes.cpp for implementation
 
+  /// Sets a control from the node (status, measured values): writes the variable, and the JSON value for the UI only if it changed.
   template <typename T>
   void updateControl(const char* name, const T value) {
+    ControlTable<JsonObject>::Descriptor* descriptor = controlTable.find(name);
+    if (descriptor && !descriptor->bound()) return;  // LiveScript executable replaced, its setup() did not add it again yet
+    if constexpr (std::is_arithmetic<T>::value) {
+      if (descriptor && descriptor->isNumber()) {
+        if (ControlTable<JsonObject>::setNumber(*descriptor, value)) descriptor->ref["value"] = value;
+        return;
+      }
+    } else if constexpr (isControlText<T>::value) {
+      if (descriptor && descriptor->isText()) {
+        const char* text = controlText(value);
+        if (ControlTable<JsonObject>::setText(*descriptor, text)) descriptor->ref["value"] = text;
+        return;
+      }
+    }
+    // not added with addControl, or a value of another type: through the JSON control
     for (JsonObject control : controls) {
       if (control["name"] == name) {
         control["value"] = value;
@@ -128,6 +150,10 @@ class Node {
 
   virtual void onUpdate(const JsonObject& control) {}
 
+  /// Applies a queued control change (PhysicalLayer::applyNodeCommands) on the task running the node: writes the
+  /// variable, calls onUpdate with a copy of the control (in arena) and requests remapping. See Nodes.cpp.
+  void applyCommand(const NodeCommand& command, JsonArenaAllocator& arena);
+
   void requestMappings() {
     if (hasOnLayout()) {
       // EXT_LOGD(MB_TAG, "hasOnLayout -> requestMapPhysical");
@@ -144,12 +170,30 @@ class Node {
   virtual void loop20ms() {}
   virtual void onSizeChanged(const Coord3D& oldSize) {}  // virtual/effect nodes: virtual size, physical/driver nodes: physical size
 
+  // multi-core rendering (PhysicalLayer::parallelRender): a tile-safe effect can render a band of rows of its layer
+  // on any core. loopFrame() runs once per frame on effectTask (advance time/state), then loopRows() runs per tile and
+  // may only write rows [rowStart, rowEnd): no fadeToBlackBy/blur/shift or other whole-layer operations, no state changes.
+  // loopRows() runs while other layers render on effectTask: pure functions only (sin8, inoise8, colorFromPalette), no
+  // random8/random16 (one global seed) and no static buffers. Effects that are not tile-safe always run on effectTask.
+  // A tile-safe effect implements loop() as loopFrame(); loopRows(0, layer->size.y);
+  virtual bool isTileSafe() const { return false; }
+  virtual void loopFrame() {}
+  virtual void loopRows(uint16_t rowStart, uint16_t rowEnd) {}
+
   // layout
   virtual void onLayout() {}  // the definition of the layout, called by mapLayout()
 
   // convenience functions to add a light
   void addLight(Coord3D position) { layerP.addLight(position); }
 
+  // convenience functions to add lights at once: a grid (all or lights first .. first + count), or the lights
+  // generate(n, position) returns true for (LightRuns.h)
+  void addLights(const LightGrid& grid, size_t first = 0, size_t count = SIZE_MAX) { layerP.addLights(grid, first, count); }
+  template <typename Generator>
+  void addLights(size_t count, Generator&& generate) {
+    layerP.addLights(count, generate);
+  }
+
   // convenience function for next pin
   void nextPin(uint8_t ledPinDIO = UINT8_MAX) { layerP.nextPin(ledPinDIO); }
 
@@ -27,17 +27,17 @@ class SharedEventEndpoint {
   void registerModule(Module* module) {
     const char* eventName = module->_moduleName;
 
-    // Register the event with the socket
-    _socket->registerEvent(eventName);
+    // Register the event with the socket, emitted by id
+    EventId eventId = _socket->registerEvent(eventName);
 
     // ADDED: Register handler for INCOMING events (client -> server updates)
     _socket->onEvent(eventName, [this, module](JsonObject& root, int originId) { module->update(root, ModuleState::update, String(originId)); });
 
     // ADDED: Register handler for new subscriptions (send state when client subscribes)
-    _socket->onSubscribe(eventName, [this, module](const String& originId) { syncState(module, originId, true); });
+    _socket->onSubscribe(eventName, [this, module, eventId](const String& originId) { syncState(module, eventId, originId, true); });
 
     // Register this module for state updates (server -> clients)
-    module->addUpdateHandler([this, module](const String& originId) { syncState(module, originId, false); }, false);
+    module->addUpdateHandler([this, module, eventId](const String& originId) { syncState(module, eventId, originId, false); }, false);
   }
 
   void begin() {
@@ -45,7 +45,7 @@ class SharedEventEndpoint {
   }
 
  private:
-  void syncState(Module* module, const String& originId, bool sync = false) {
+  void syncState(Module* module, EventId eventId, const String& originId, bool sync = false) {
     JsonDocument doc;
 
     // CHANGED: Use JsonObject overload, not buffer
@@ -53,7 +53,7 @@ class SharedEventEndpoint {
     JsonObject root = doc["data"].to<JsonObject>();
     module->read(root, ModuleState::read, originId);
 
-    _socket->emitEvent(doc, originId.c_str(), sync);
+    _socket->emitEvent(eventId, doc, originId.c_str(), sync);
   }
 };
 
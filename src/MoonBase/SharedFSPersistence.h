@@ -41,6 +41,8 @@ class SharedFSPersistence {
  public:
   SharedFSPersistence(FS* fs) : _fs(fs) {}
 
+  std::function<void(const char* path)> onFileWritten;  // e.g. FileManager::fileChanged: keep its index up to date
+
   // ADDED: Support for delayed writing parameter
   void registerModule(Module* module, bool delayedWriting = false) {
     ModuleInfo info;
@@ -166,6 +168,7 @@ class SharedFSPersistence {
 
     serializeJson(doc, file);
     file.close();
+    if (onFileWritten) onFileWritten(info.filePath.c_str());
 
     return true;
   }
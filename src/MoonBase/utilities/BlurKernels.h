@@ -0,0 +1,89 @@
+/**
+    @title     MoonBase
+    @file      BlurKernels.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/nodes/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Blur kernels working on a channel buffer by byte strides, used by VirtualLayer blur1d / blurRows / blurColumns /
+    blur3d on virtualChannels (no XYZ() / getRGB() / addRGB() per light).
+    Same result as the FastLED blur of WLED: every light keeps keep/256 of itself and gets seep/256 of both neighbours
+    (scale8 and saturating add as CRGB nscale8 / +=), the ends of a line lose what seeps out.
+    blurLine: one line, light after light (rows). blurLines: many parallel lines at once, step after step, the inner
+    loop going over the lights next to each other in memory (columns, z): contiguous bytes the compiler vectorises.
+    Only the RGB bytes at the given addresses are blurred, other channels of a light are not touched.
+    This header has NO ESP32 / FastLED dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#define BLUR_CHUNK 64  // lights of parallel lines blurred at once by blurLines (carry on the stack: 3 bytes per light)
+
+inline uint8_t blurScale(uint8_t value, uint8_t scale) { return ((uint16_t)value * (1 + scale)) >> 8; }  // FastLED scale8
+inline uint8_t blurAdd(uint8_t a, uint8_t b) {
+  uint16_t sum = a + b;
+  return sum > 255 ? 255 : sum;
+}  // FastLED qadd8
+
+/// Blurs length lights, RGB of light i at rgb + i * step bytes.
+inline void blurLine(uint8_t* rgb, size_t step, uint16_t length, uint8_t keep, uint8_t seep) {
+  if (!length) return;
+  uint8_t carry[3] = {0, 0, 0};
+  uint8_t* previous = nullptr;
+  for (uint16_t i = 0; i < length; i++, rgb += step) {
+    for (int c = 0; c < 3; c++) {
+      uint8_t part = blurScale(rgb[c], seep);
+      if (previous) previous[c] = blurAdd(previous[c], part);
+      rgb[c] = blurAdd(blurScale(rgb[c], keep), carry[c]);
+      carry[c] = part;
+    }
+    previous = rgb;
+  }
+  for (int c = 0; c < 3; c++) previous[c] = blurAdd(previous[c], carry[c]);
+}
+
+/// Blurs lines parallel lines of length lights: RGB of light i of line l at rgb + l * lightBytes + i * step bytes.
+/// lightBytes 3 (only RGB channels) makes the lines one run of bytes per step.
+inline void blurLines(uint8_t* rgb, size_t lightBytes, uint32_t lines, size_t step, uint16_t length, uint8_t keep, uint8_t seep) {
+  if (!length) return;
+  uint8_t carry[BLUR_CHUNK * 3];
+  for (uint32_t first = 0; first < lines; first += BLUR_CHUNK) {
+    uint32_t chunk = lines - first < BLUR_CHUNK ? lines - first : BLUR_CHUNK;
+    uint8_t* line = rgb + first * lightBytes;
+    uint8_t* previous = nullptr;
+    for (uint32_t n = 0; n < chunk * 3; n++) carry[n] = 0;
+    for (uint16_t i = 0; i < length; i++, line += step) {
+      if (lightBytes == 3) {  // the RGB of the lines back to back: previous, line and carry don't overlap
+        uint8_t* __restrict current = line;
+        uint8_t* __restrict carried = carry;
+        for (uint32_t n = 0; n < chunk * 3; n++) {
+          uint8_t part = blurScale(current[n], seep);
+          current[n] = blurAdd(blurScale(current[n], keep), carried[n]);
+          carried[n] = part;
+        }
+        if (previous) {  // previous gets the part of this step
+          uint8_t* __restrict before = previous;
+          for (uint32_t n = 0; n < chunk * 3; n++) before[n] = blurAdd(before[n], carried[n]);
+        }
+      } else {
+        for (uint32_t l = 0; l < chunk; l++)
+          for (int c = 0; c < 3; c++) {
+            size_t offset = l * lightBytes + c;
+            uint8_t part = blurScale(line[offset], seep);
+            if (previous) previous[offset] = blurAdd(previous[offset], part);
+            line[offset] = blurAdd(blurScale(line[offset], keep), carry[l * 3 + c]);
+            carry[l * 3 + c] = part;
+          }
+      }
+      previous = line;
+    }
+    for (uint32_t l = 0; l < chunk; l++)
+      for (int c = 0; c < 3; c++) previous[l * lightBytes + c] = blurAdd(previous[l * lightBytes + c], carry[l * 3 + c]);
+  }
+}
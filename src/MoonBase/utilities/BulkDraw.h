@@ -0,0 +1,103 @@
+/**
+    @title     MoonBase
+    @file      BulkDraw.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/livescripts/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Drawing a span of lights in one call, on a layer buffer (VirtualLayer::virtualChannels): a palette gradient along
+    a row, column or range of lights, palette colors of a span from an array of indexes (a per-light expression
+    evaluated by the caller), copying and shifting a rectangle. LiveScript calls these once per span instead of an
+    external call per light.
+    ChannelView: lights of channelsPerLight bytes, RGB at offsetRGB, index x + y * width + z * width * height.
+    colorAt(index): the palette color of index 0..255 (PhysicalLayer::colorFromPalette on the device), a struct of r, g, b.
+    This header has NO ESP32 / FastLED dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+struct ChannelView {
+  uint8_t* channels;
+  uint8_t channelsPerLight;
+  uint8_t offsetRGB;
+  int width, height, depth;
+};
+
+/// count lights from light first, stride lights apart, get colorAt(index >> 4), index starting at startIndex << 4 and
+/// going up by step (1/16 palette index per light: 16 is the next palette entry, 4096 / count spans the palette once).
+template <typename ColorAt>
+void fillGradient(const ChannelView& view, size_t first, size_t count, ptrdiff_t stride, uint8_t startIndex, int16_t step, ColorAt colorAt) {
+  uint8_t* light = view.channels + first * view.channelsPerLight + view.offsetRGB;
+  ptrdiff_t lightStride = stride * view.channelsPerLight;
+  uint16_t index = startIndex << 4;  // wraps around the palette
+  for (size_t i = 0; i < count; i++, light += lightStride, index += step) {
+    auto color = colorAt((uint8_t)(index >> 4));
+    light[0] = color.r;
+    light[1] = color.g;
+    light[2] = color.b;
+  }
+}
+
+/// count lights from light first get colorAt(indexes[i]).
+template <typename ColorAt>
+void fillIndexes(const ChannelView& view, size_t first, size_t count, const uint8_t* indexes, ColorAt colorAt) {
+  uint8_t* light = view.channels + first * view.channelsPerLight + view.offsetRGB;
+  for (size_t i = 0; i < count; i++, light += view.channelsPerLight) {
+    auto color = colorAt(indexes[i]);
+    light[0] = color.r;
+    light[1] = color.g;
+    light[2] = color.b;
+  }
+}
+
+/// Copies the width x height rectangle at (x, y) to (toX, toY) in every z plane, all channels of the lights.
+/// Clipped to the layer, overlapping rectangles are copied as if through a buffer.
+inline void copyRect(const ChannelView& view, int x, int y, int width, int height, int toX, int toY) {
+  // clip the source, then the destination, moving both together
+  if (x < 0) { width += x; toX -= x; x = 0; }
+  if (y < 0) { height += y; toY -= y; y = 0; }
+  if (toX < 0) { width += toX; x -= toX; toX = 0; }
+  if (toY < 0) { height += toY; y -= toY; toY = 0; }
+  if (x + width > view.width) width = view.width - x;
+  if (y + height > view.height) height = view.height - y;
+  if (toX + width > view.width) width = view.width - toX;
+  if (toY + height > view.height) height = view.height - toY;
+  if (width <= 0 || height <= 0) return;
+
+  size_t rowBytes = (size_t)width * view.channelsPerLight;
+  size_t lineBytes = (size_t)view.width * view.channelsPerLight;
+  for (int z = 0; z < view.depth; z++) {
+    uint8_t* plane = view.channels + (size_t)z * view.height * lineBytes;
+    for (int r = 0; r < height; r++) {
+      int row = toY > y ? height - 1 - r : r;  // moving down: bottom row first
+      memmove(plane + (size_t)(toY + row) * lineBytes + (size_t)toX * view.channelsPerLight, plane + (size_t)(y + row) * lineBytes + (size_t)x * view.channelsPerLight, rowBytes);
+    }
+  }
+}
+
+/// Moves the whole layer dx lights right and dy lights down (negative: left, up), lights moved in are black.
+inline void shiftLights(const ChannelView& view, int dx, int dy) {
+  copyRect(view, 0, 0, view.width, view.height, dx, dy);
+  size_t lineBytes = (size_t)view.width * view.channelsPerLight;
+  for (int z = 0; z < view.depth; z++) {
+    uint8_t* plane = view.channels + (size_t)z * view.height * lineBytes;
+    for (int y = 0; y < view.height; y++) {
+      uint8_t* line = plane + (size_t)y * lineBytes;
+      if (y < dy || y >= view.height + dy)
+        memset(line, 0, lineBytes);  // rows moved in
+      else if (dx > 0)
+        memset(line, 0, (size_t)(dx < view.width ? dx : view.width) * view.channelsPerLight);
+      else if (dx < 0) {
+        int cleared = -dx < view.width ? -dx : view.width;
+        memset(line + (size_t)(view.width - cleared) * view.channelsPerLight, 0, (size_t)cleared * view.channelsPerLight);
+      }
+    }
+  }
+}
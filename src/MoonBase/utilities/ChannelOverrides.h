@@ -0,0 +1,104 @@
+/**
+    @title     MoonBase
+    @file      ChannelOverrides.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/channels/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Channel overrides: physical channels held at a value while effects keep running, for testing fixtures during a
+    show (Channels module, Network In, LiveScript). A few entries sorted by channel, applied to channelsD after all
+    layers are composited: set replaces the composited value, max keeps the highest of both (HTP), min the lowest
+    (a limit). size() is atomic so the compositor skips the overrides without a lock when there are none.
+    This header has NO ESP32 dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+enum ChannelOverrideMode : uint8_t { OverrideSet, OverrideMax, OverrideMin };
+
+struct ChannelOverride {
+  uint32_t channel;
+  uint8_t value;
+  uint8_t mode;  ///< ChannelOverrideMode
+};
+
+template <size_t capacity>
+class ChannelOverrides {
+ public:
+  /// Holds channel at value in mode, replacing an override of channel. False if full.
+  bool set(uint32_t channel, uint8_t value, uint8_t mode = OverrideSet) {
+    size_t count = _count.load(std::memory_order_relaxed);
+    size_t index = lowerBound(channel);
+    if (index == count || _entries[index].channel != channel) {
+      if (count == capacity) return false;
+      for (size_t n = count; n > index; n--) _entries[n] = _entries[n - 1];
+      _count.store(count + 1, std::memory_order_release);
+    }
+    _entries[index] = {channel, value, mode};
+    return true;
+  }
+
+  /// Gives channel back to the effects. False if it was not overridden.
+  bool release(uint32_t channel) {
+    size_t count = _count.load(std::memory_order_relaxed);
+    size_t index = lowerBound(channel);
+    if (index == count || _entries[index].channel != channel) return false;
+    for (size_t n = index; n + 1 < count; n++) _entries[n] = _entries[n + 1];
+    _count.store(count - 1, std::memory_order_release);
+    return true;
+  }
+
+  void clear() { _count.store(0, std::memory_order_release); }
+
+  /// The override of channel, nullptr if none.
+  const ChannelOverride* find(uint32_t channel) const {
+    size_t index = lowerBound(channel);
+    return index < size() && _entries[index].channel == channel ? &_entries[index] : nullptr;
+  }
+
+  size_t size() const { return _count.load(std::memory_order_acquire); }
+  bool empty() const { return size() == 0; }
+
+  /// Applies the overrides to channels, skipping those at or beyond nrOfChannels (another layout).
+  void apply(uint8_t* channels, size_t nrOfChannels) const {
+    size_t count = size();
+    for (size_t n = 0; n < count; n++) {
+      const ChannelOverride& entry = _entries[n];
+      if (entry.channel >= nrOfChannels) break;  // sorted: the rest is beyond too
+      uint8_t& channel = channels[entry.channel];
+      if (entry.mode == OverrideMax) {
+        if (entry.value > channel) channel = entry.value;
+      } else if (entry.mode == OverrideMin) {
+        if (entry.value < channel) channel = entry.value;
+      } else
+        channel = entry.value;
+    }
+  }
+
+  const ChannelOverride* begin() const { return _entries; }
+  const ChannelOverride* end() const { return _entries + size(); }
+
+ private:
+  /// The first entry with a channel not below channel.
+  size_t lowerBound(uint32_t channel) const {
+    size_t low = 0, high = _count.load(std::memory_order_relaxed);
+    while (low < high) {
+      size_t middle = (low + high) / 2;
+      if (_entries[middle].channel < channel)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+    return low;
+  }
+
+  ChannelOverride _entries[capacity];
+  std::atomic<size_t> _count{0};
+};
@@ -0,0 +1,162 @@
+/**
+    @title     MoonBase
+    @file      ControlTable.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/nodes/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Typed table of the controls of a node, filled by Node::addControl: per control the name hash, kind, range and
+    the bound variable. Node::updateControl() finds a control by hash and writes the variable without parsing the
+    type and size strings of the JSON control, and only touches the JSON (the definition and value for the UI)
+    when the value really changed: a node setting the same status every loop costs a hash and a compare.
+    Ref is the handle of the JSON control (JsonObject in Node), kept to write changed values back.
+    This header has NO ESP32 / ArduinoJson dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#define CONTROL_NAME_MAX 24  // longer names are compared by hash and the first 23 characters
+
+// the variable type bound to a control (the size code of the JSON control)
+enum class ControlKind : uint8_t { none, u8, i8, u16, u32, i32, f32, boolean, text, coord3D };
+
+inline uint32_t controlHash(const char* name) {
+  uint32_t h = 2166136261u;  // FNV-1a
+  while (*name) h = (h ^ (uint8_t)*name++) * 16777619u;
+  return h;
+}
+
+template <typename Ref>
+struct ControlDescriptor {
+  uint32_t hash = 0;
+  void* pointer = nullptr;  // the bound variable
+  Ref ref{};                // the JSON control
+  double shadow = 0;        // value in the JSON control: the number, or the hash of the text
+  bool synced = false;      // shadow is valid
+  ControlKind kind = ControlKind::none;
+  bool ro = false;
+  uint16_t size = 0;  // text: buffer size of the variable
+  int32_t min = 0;
+  int32_t max = UINT8_MAX;
+  char name[CONTROL_NAME_MAX] = {};
+
+  bool bound() const { return pointer != nullptr; }  // false after ControlTable::unbind() until add() binds it again
+  bool isText() const { return kind == ControlKind::text; }
+  bool isNumber() const { return kind != ControlKind::none && kind != ControlKind::text && kind != ControlKind::coord3D; }
+};
+
+template <typename Ref>
+class ControlTable {
+ public:
+  typedef ControlDescriptor<Ref> Descriptor;
+
+  /// Adds the control, or rebinds it if a control with this name exists (LiveScript recompiles, setup() called again).
+  Descriptor* add(const char* name, ControlKind kind, void* pointer, uint16_t size, int32_t min, int32_t max, bool ro, Ref ref) {
+    Descriptor* control = find(name);
+    if (!control) {
+      _controls.emplace_back();
+      control = &_controls.back();
+      control->hash = controlHash(name);
+      memcpy(control->name, name, strnlen(name, CONTROL_NAME_MAX - 1));  // name[] is zeroed
+    }
+    if (control->pointer != pointer || control->kind != kind) control->synced = false;
+    control->kind = kind;
+    control->pointer = pointer;
+    control->size = size;
+    control->min = min;
+    control->max = max;
+    control->ro = ro;
+    control->ref = ref;
+    return control;
+  }
+
+  Descriptor* find(const char* name) {
+    if (!name) return nullptr;
+    uint32_t hash = controlHash(name);
+    for (Descriptor& control : _controls)
+      if (control.hash == hash && strncmp(control.name, name, CONTROL_NAME_MAX - 1) == 0) return &control;
+    return nullptr;
+  }
+
+  size_t size() const { return _controls.size(); }
+  void clear() { _controls.clear(); }
+  /// The variables are gone (a LiveScript executable is replaced or deleted): no writes until add() binds them again.
+  void unbind() {
+    for (Descriptor& control : _controls) {
+      control.pointer = nullptr;
+      control.synced = false;
+    }
+  }
+  typename std::vector<Descriptor>::iterator begin() { return _controls.begin(); }
+  typename std::vector<Descriptor>::iterator end() { return _controls.end(); }
+
+  /// Writes value to the variable of a number control. False if the JSON control already has this value (no JSON write
+  /// needed); the variable is written either way, a node or script may have changed it since.
+  template <typename T>
+  static bool setNumber(Descriptor& control, T value) {
+    static_assert(std::is_arithmetic<T>::value, "setNumber: arithmetic types only");
+    double number = (double)value;
+    bool changed = !control.synced || control.shadow != number;
+    switch (control.kind) {
+      case ControlKind::u8: *(uint8_t*)control.pointer = (uint8_t)value; break;
+      case ControlKind::i8: *(int8_t*)control.pointer = (int8_t)value; break;
+      case ControlKind::u16: *(uint16_t*)control.pointer = (uint16_t)value; break;
+      case ControlKind::u32: *(uint32_t*)control.pointer = (uint32_t)value; break;
+      case ControlKind::i32: *(int*)control.pointer = (int)value; break;
+      case ControlKind::f32: *(float*)control.pointer = (float)value; break;
+      case ControlKind::boolean: *(bool*)control.pointer = value != 0; break;
+      default: return false;
+    }
+    markSynced(control, number);
+    return changed;
+  }
+
+  /// Writes text to the variable of a text control (truncated to its buffer and max). False if the JSON control already
+  /// has this text (no JSON write needed); the variable is written either way.
+  static bool setText(Descriptor& control, const char* text) {
+    if (!text) text = "";
+    double hash = controlHash(text);
+    bool changed = !control.synced || control.shadow != hash;
+    char* variable = (char*)control.pointer;
+    if (variable != text && control.size) {  // a node often passes its own status variable
+      size_t bufSize = control.size;
+      if (control.max != UINT8_MAX && control.max >= 0 && (size_t)control.max + 1 < bufSize) bufSize = control.max + 1;  // max set: text length
+      size_t n = strnlen(text, bufSize - 1);
+      memmove(variable, text, n);
+      variable[n] = '\0';
+    }
+    markSynced(control, hash);
+    return changed;
+  }
+
+  /// The JSON control now has this value (written by the UI, or restored from the FS).
+  static void markSynced(Descriptor& control, double numberOrTextHash) {
+    control.shadow = numberOrTextHash;
+    control.synced = true;
+  }
+  static void markSyncedText(Descriptor& control, const char* text) { markSynced(control, controlHash(text ? text : "")); }
+
+ private:
+  std::vector<Descriptor> _controls;
+};
+
+// values Node::updateControl(name, value) writes to a text control: C strings and classes with c_str() (Char<N>, String)
+template <typename T, typename = void>
+struct isControlText : std::is_convertible<T, const char*> {};
+template <typename T>
+struct isControlText<T, std::void_t<decltype(std::declval<const T&>().c_str())>> : std::true_type {};
+
+inline const char* controlText(const char* text) { return text; }
+template <typename T>
+auto controlText(const T& text) -> decltype(text.c_str()) {
+  return text.c_str();
+}
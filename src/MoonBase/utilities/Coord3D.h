@@ -83,6 +83,7 @@ struct Coord3D {
   }
 
   Coord3D maximum(const Coord3D& rhs) const { return Coord3D(MAX(x, rhs.x), MAX(y, rhs.y), MAX(z, rhs.z)); }
+  Coord3D minimum(const Coord3D& rhs) const { return Coord3D(MIN(x, rhs.x), MIN(y, rhs.y), MIN(z, rhs.z)); }
 
   unsigned distanceSquared(const Coord3D& rhs) const {
     Coord3D delta = (*this - rhs);
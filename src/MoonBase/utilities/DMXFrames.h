@@ -0,0 +1,93 @@
+/**
+    @title     MoonBase
+    @file      DMXFrames.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/drivers/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    DMX512 frames from the physical channels (DMXOutDriver): a frame is the start code and up to 512 slots, a universe
+    is a frame on its own UART. Lights are never split over two universes: the next universe starts with the light
+    that did not fit, at slot 1. mapLight(dst, src) is called per light after its channels are copied (the RGBW
+    reordering and brightness of the driver).
+    FrameHandoff: three frame buffers between the driver task (builds a frame, publish) and the DMX task (take, send):
+    neither waits for the other, the DMX task always sends the newest complete frame, a frame published while the
+    previous one was not taken yet replaces it (dropped).
+    This header has NO ESP32 dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#define DMX_SLOTS 512
+#define DMX_FRAME_BYTES (1 + DMX_SLOTS)  // start code + slots
+
+/// Fills frame (DMX_FRAME_BYTES) with start code 0 and whole lights from light on, the first at slot offset (0-based).
+/// light is advanced to the first light not in the frame. Returns the slots used, 0 if no light fits.
+template <typename MapLight>
+uint16_t dmxBuildUniverse(uint8_t* frame, const uint8_t* channels, size_t nrOfLights, uint8_t channelsPerLight, size_t& light, uint16_t offset, MapLight mapLight) {
+  if (!channelsPerLight || offset + channelsPerLight > DMX_SLOTS || light >= nrOfLights) return 0;
+  memset(frame, 0, 1 + offset);  // start code and the slots before the first light
+  uint16_t lights = (DMX_SLOTS - offset) / channelsPerLight;
+  if (lights > nrOfLights - light) lights = nrOfLights - light;
+  uint8_t* dst = frame + 1 + offset;
+  const uint8_t* src = channels + light * channelsPerLight;
+  memcpy(dst, src, (size_t)lights * channelsPerLight);
+  for (uint16_t i = 0; i < lights; i++, dst += channelsPerLight, src += channelsPerLight) mapLight(dst, src);
+  light += lights;
+  return offset + lights * channelsPerLight;
+}
+
+/// Fills universes frames (DMX_FRAME_BYTES apart), sizes[u] the slots of universe u (0: nothing to send). The first
+/// universe starts at slot offset, the others at slot 0. Returns the number of lights in the frames.
+template <typename MapLight>
+size_t dmxBuildFrames(uint8_t* frames, uint16_t* sizes, uint8_t universes, const uint8_t* channels, size_t nrOfLights, uint8_t channelsPerLight, uint16_t offset, MapLight mapLight) {
+  size_t light = 0;
+  for (uint8_t u = 0; u < universes; u++) sizes[u] = dmxBuildUniverse(frames + (size_t)u * DMX_FRAME_BYTES, channels, nrOfLights, channelsPerLight, light, u ? 0 : offset, mapLight);
+  return light;
+}
+
+class FrameHandoff {
+ public:
+  /// Writer: the buffer to build the next frame in.
+  uint8_t back() const { return _back; }
+
+  /// Writer: the back buffer is complete and becomes the newest frame. False if the newest frame before was not
+  /// taken (it is dropped, its buffer is the next back buffer).
+  bool publish() {
+    uint8_t previous = _middle.exchange(_back | FRESH, std::memory_order_acq_rel);
+    _back = previous & BUFFER;
+    if (previous & FRESH) {
+      _dropped++;
+      return false;
+    }
+    return true;
+  }
+
+  /// Reader: the buffer of the frame taken last (initially a buffer not written yet).
+  uint8_t front() const { return _front; }
+
+  /// Reader: takes the newest frame as front if one was published since the last take. False: front unchanged.
+  bool take() {
+    if (!(_middle.load(std::memory_order_acquire) & FRESH)) return false;
+    _front = _middle.exchange(_front, std::memory_order_acq_rel) & BUFFER;
+    return true;
+  }
+
+  /// Frames published but never taken.
+  uint32_t dropped() const { return _dropped; }
+
+ private:
+  static constexpr uint8_t BUFFER = 3;
+  static constexpr uint8_t FRESH = 4;
+  std::atomic<uint8_t> _middle{1};  // the buffer between writer and reader, FRESH if not taken yet
+  uint8_t _back = 0;                // writer only
+  uint8_t _front = 2;               // reader only
+  uint32_t _dropped = 0;            // writer only
+};
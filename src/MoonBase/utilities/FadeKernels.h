@@ -0,0 +1,170 @@
+/**
+    @title     MoonBase
+    @file      FadeKernels.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/nodes/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Fade of trail effects (fadeToBlackBy), fused with compositing a layer: VirtualLayer::compositeTo reads a light of
+    virtualChannels once, adds it to the physical channels and writes it back faded for the next frame, instead of a
+    separate pass over the buffer before the effects run.
+    Same values as FastLED: fade is nscale8(255 - fadeBy) (scale8), layer brightness nscale8_video, add is qadd8.
+    compositeFadeRGBRun: the same for a run of an analytic mapping (MappingDescriptor.h), lights stepping on the fixture.
+    FadeBlocks: which blocks of FADE_BLOCK lights were black after the last fade. Trail effects leave most of a large
+    layer black: such a block is only checked (is it still black?) instead of composited and faded light by light.
+    Lights with more channels (RGBW, moving heads) fade with a factor per channel (FadeFactors): no checks per light
+    which channels are colors, and a run of lights is one loop over bytes the compiler vectorises.
+    This header has NO ESP32 / FastLED dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#define FADE_BLOCK 64  // lights per bit of FadeBlocks
+
+inline uint8_t fadeScale(uint8_t value, uint16_t factor) { return (value * factor) >> 8; }  // factor = 1 + scale: FastLED scale8
+inline uint8_t fadeScaleVideo(uint8_t value, uint8_t scale) { return value ? ((value * scale) >> 8) + (scale != 0) : 0; }  // FastLED scale8_video
+inline uint8_t fadeAdd(uint8_t a, uint8_t b) {
+  uint16_t sum = a + b;
+  return sum > 255 ? 255 : sum;
+}  // FastLED qadd8
+
+/// True if bytes bytes from data are 0.
+inline bool fadeIsBlack(const uint8_t* data, size_t bytes) {
+  uint8_t any = 0;
+  for (size_t n = 0; n < bytes; n++) any |= data[n];
+  return !any;
+}
+
+/// Composites bytes RGB bytes of src into dst (qadd8) at brightness (nscale8_video, 255: as is) and fades src by
+/// fadeBy (0: src unchanged). True if src is black afterwards.
+inline bool compositeFadeRGB(uint8_t* __restrict src, uint8_t* __restrict dst, size_t bytes, uint8_t brightness, uint8_t fadeBy) {
+  uint16_t keep = 256 - fadeBy;  // 1 + (255 - fadeBy)
+  uint8_t any = 0;
+  if (brightness == 255) {
+    if (fadeBy) {
+      for (size_t n = 0; n < bytes; n++) {
+        uint8_t value = src[n];
+        dst[n] = fadeAdd(dst[n], value);
+        src[n] = fadeScale(value, keep);
+        any |= src[n];
+      }
+    } else
+      for (size_t n = 0; n < bytes; n++) {
+        dst[n] = fadeAdd(dst[n], src[n]);
+        any |= src[n];
+      }
+  } else {
+    for (size_t n = 0; n < bytes; n++) {
+      uint8_t value = src[n];
+      dst[n] = fadeAdd(dst[n], fadeScaleVideo(value, brightness));
+      if (fadeBy) src[n] = fadeScale(value, keep);
+      any |= src[n];
+    }
+  }
+  return !any;
+}
+
+/// compositeFadeRGB for lights RGB lights of src going to physical lights that are not one after the other: light n
+/// of src to light n * step (+ odd if n is odd) of dst (a MappingRun from dst). Two lights per iteration, no
+/// multiply or parity test per light; step 1 without odd is compositeFadeRGB.
+inline bool compositeFadeRGBRun(uint8_t* __restrict src, uint8_t* __restrict dst, size_t lights, int32_t step, int32_t odd, uint8_t brightness, uint8_t fadeBy) {
+  if (step == 1 && !odd) return compositeFadeRGB(src, dst, lights * 3, brightness, fadeBy);
+  const ptrdiff_t pair = (ptrdiff_t)step * 6;            // bytes from an even light to the next even light
+  const ptrdiff_t second = ((ptrdiff_t)step + odd) * 3;  // bytes from an even light to the odd light after it
+  uint8_t* odds = dst + second;
+  uint8_t* end = src + lights * 3;
+  uint8_t any = 0;
+  if (brightness == 255 && !fadeBy) {  // as is: most frames
+    for (; src + 6 <= end; src += 6, dst += pair, odds += pair) {
+      for (uint8_t c = 0; c < 3; c++) dst[c] = fadeAdd(dst[c], src[c]);
+      for (uint8_t c = 0; c < 3; c++) odds[c] = fadeAdd(odds[c], src[3 + c]);
+      any |= src[0] | src[1] | src[2] | src[3] | src[4] | src[5];
+    }
+    if (src < end) {
+      for (uint8_t c = 0; c < 3; c++) dst[c] = fadeAdd(dst[c], src[c]);
+      any |= src[0] | src[1] | src[2];
+    }
+    return !any;
+  }
+  uint16_t keep = 256 - fadeBy;
+  for (size_t n = 0; n < lights; n++, src += 3) {
+    uint8_t* d = (n & 1) ? odds : dst;
+    for (uint8_t c = 0; c < 3; c++) {
+      uint8_t value = src[c];
+      d[c] = fadeAdd(d[c], brightness == 255 ? value : fadeScaleVideo(value, brightness));
+      if (fadeBy) src[c] = fadeScale(value, keep);
+      any |= src[c];
+    }
+    if (n & 1) {
+      dst += pair;
+      odds += pair;
+    }
+  }
+  return !any;
+}
+
+/// Factor per byte of a run of lights: 256 - fadeBy for the color and white channels, 256 (unchanged) for the
+/// others. Built once per fade, then fade() is a multiply and shift per byte.
+class FadeFactors {
+ public:
+  /// colorChannels: the channels of a light to fade (offsets within channelsPerLight).
+  void set(uint8_t channelsPerLight, const uint8_t* colorChannels, uint8_t nrOfColorChannels, uint8_t fadeBy) {
+    _channelsPerLight = channelsPerLight ? channelsPerLight : 1;
+    _lightsPerRun = 256 / _channelsPerLight;  // 85 RGB, 64 RGBW, 8 lights of 32 channels
+    for (int c = 0; c < _channelsPerLight; c++) _factors[c] = 256;
+    for (int i = 0; i < nrOfColorChannels; i++)
+      if (colorChannels[i] < _channelsPerLight) _factors[colorChannels[i]] = 256 - fadeBy;
+    for (size_t n = _channelsPerLight; n < (size_t)_lightsPerRun * _channelsPerLight; n++) _factors[n] = _factors[n % _channelsPerLight];
+  }
+
+  /// Fades count lights from channels.
+  void fade(uint8_t* channels, size_t count) const {
+    while (count) {
+      size_t lights = count < _lightsPerRun ? count : _lightsPerRun;
+      size_t bytes = lights * _channelsPerLight;
+      for (size_t n = 0; n < bytes; n++) channels[n] = fadeScale(channels[n], _factors[n]);
+      channels += bytes;
+      count -= lights;
+    }
+  }
+
+ private:
+  uint16_t _factors[256];
+  uint8_t _channelsPerLight = 3;
+  uint8_t _lightsPerRun = 85;
+};
+
+/// One bit per FADE_BLOCK lights: the block was black after the last composite. Only a hint (effects may have drawn
+/// in it since), checked with fadeIsBlack before a block is skipped.
+template <template <typename> class Allocator = std::allocator>
+class FadeBlocks {
+ public:
+  /// All blocks of nrOfLights lights black (a cleared buffer).
+  void reset(size_t nrOfLights) {
+    _nrOfLights = nrOfLights;
+    _bits.assign((nrOfLights + FADE_BLOCK * 32 - 1) / (FADE_BLOCK * 32), UINT32_MAX);
+  }
+
+  size_t blocks() const { return (_nrOfLights + FADE_BLOCK - 1) / FADE_BLOCK; }
+  bool black(size_t block) const { return block / 32 < _bits.size() && (_bits[block / 32] >> (block % 32)) & 1; }
+  void set(size_t block, bool black) {
+    if (block / 32 >= _bits.size()) return;
+    if (black)
+      _bits[block / 32] |= 1u << (block % 32);
+    else
+      _bits[block / 32] &= ~(1u << (block % 32));
+  }
+  size_t nrOfLights() const { return _nrOfLights; }
+
+ private:
+  std::vector<uint32_t, Allocator<uint32_t>> _bits;
+  size_t _nrOfLights = 0;
+};
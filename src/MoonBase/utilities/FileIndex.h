@@ -0,0 +1,228 @@
+/**
+    @title     MoonBase
+    @file      FileIndex.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonbase/filemanager/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    In-memory index of the files and folders on the FS, for FileManager: built by one walk of the FS,
+    then updated per file written, removed or renamed, so the tree is served without walking the FS again.
+    Every change is recorded in a journal, sent to the UI instead of the whole tree:
+      journal from version A to version B: the changes which turn the tree of version A into the tree of version B.
+    A journal is published when it is sent; the next change starts a new journal from the published version.
+    This header has NO ESP32 / Arduino dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#define FILE_JOURNAL_MAX 64  // more changes in one journal: the UI reloads the whole tree
+
+struct FileIndexEntry {
+  bool isFile = true;
+  uint32_t size = 0;
+  uint32_t time = 0;  // last write, seconds since epoch
+};
+
+enum class FileChange : uint8_t { added, removed, modified };
+
+struct FileJournalEntry {
+  FileChange change;
+  std::string path;
+  FileIndexEntry entry;  // added / modified: the new values
+};
+
+/// Orders paths as a depth first walk: a folder, then everything below it, then its next sibling
+/// ('/' sorts before any other character, so "/a/x" comes before "/a b").
+struct FilePathLess {
+  bool operator()(const std::string& a, const std::string& b) const {
+    size_t n = a.size() < b.size() ? a.size() : b.size();
+    for (size_t i = 0; i < n; i++) {
+      if (a[i] == b[i]) continue;
+      if (a[i] == '/') return true;
+      if (b[i] == '/') return false;
+      return (uint8_t)a[i] < (uint8_t)b[i];
+    }
+    return a.size() < b.size();
+  }
+};
+
+/// True if a folder or file name in path starts with '.' (hidden in the File Manager unless showHidden).
+inline bool isHiddenPath(const char* path) {
+  for (const char* p = path; *p; p++)
+    if (*p == '/' && p[1] == '.') return true;
+  return path[0] == '.';
+}
+
+class FileIndex {
+ public:
+  /// Replaces the index by a walk of the FS: walk(add) calls add(path, isFile, size, time) for every file and folder.
+  /// The journal is incomplete afterwards: clients need the whole tree.
+  template <typename Walker>
+  void rebuild(Walker&& walk) {
+    _entries.clear();
+    walk([this](const char* path, bool isFile, uint32_t size, uint32_t time) {
+      FileIndexEntry& entry = _entries[normalize(path)];
+      entry.isFile = isFile;
+      entry.size = size;
+      entry.time = time;
+    });
+    _built = true;
+    reset();
+  }
+
+  bool built() const { return _built; }
+  size_t size() const { return _entries.size(); }
+
+  const FileIndexEntry* find(const char* path) const {
+    auto it = _entries.find(normalize(path));
+    return it == _entries.end() ? nullptr : &it->second;
+  }
+
+  /// Adds or updates path, adding missing parent folders. False if nothing changed.
+  bool set(const char* path, bool isFile, uint32_t size, uint32_t time) {
+    std::string key = normalize(path);
+    if (key == "/") return false;
+    addParents(key);
+    auto it = _entries.find(key);
+    if (it == _entries.end()) {
+      FileIndexEntry& entry = _entries[key];
+      entry.isFile = isFile;
+      entry.size = size;
+      entry.time = time;
+      record(FileChange::added, key, entry);
+      return true;
+    }
+    FileIndexEntry& entry = it->second;
+    if (entry.isFile != isFile) {  // a file replaced by a folder or vice versa
+      remove(key.c_str());
+      return set(key.c_str(), isFile, size, time);
+    }
+    if (entry.size == size && entry.time == time) return false;
+    entry.size = size;
+    entry.time = time;
+    record(FileChange::modified, key, entry);
+    return true;
+  }
+
+  /// Removes path and, if it is a folder, everything below it. False if it was not in the index.
+  bool remove(const char* path) {
+    std::string key = normalize(path);
+    auto it = _entries.find(key);
+    if (it == _entries.end()) return false;
+    auto end = subtreeEnd(key);
+    _entries.erase(it, end);
+    FileIndexEntry none;
+    record(FileChange::removed, key, none);
+    return true;
+  }
+
+  /// Moves path and everything below it to newPath. False if path is not in the index.
+  bool rename(const char* path, const char* newPath) {
+    std::string from = normalize(path), to = normalize(newPath);
+    auto it = _entries.find(from);
+    if (it == _entries.end() || from == to) return false;
+    std::vector<std::pair<std::string, FileIndexEntry>> moved;
+    for (auto end = subtreeEnd(from); it != end; ++it) moved.emplace_back(to + it->first.substr(from.size()), it->second);
+    remove(from.c_str());
+    remove(to.c_str());  // replaced
+    for (auto& item : moved) set(item.first.c_str(), item.second.isFile, item.second.size, item.second.time);
+    return true;
+  }
+
+  /// Depth first: fun(path, name, entry, depth), a folder before its contents, depth 0 = in the root folder.
+  template <typename F>
+  void forEach(F&& fun) const {
+    for (const auto& item : _entries) {
+      const std::string& path = item.first;
+      size_t slash = path.rfind('/');
+      int depth = 0;
+      for (size_t i = 1; i < path.size(); i++) depth += path[i] == '/';
+      fun(path.c_str(), path.c_str() + slash + 1, item.second, depth);
+    }
+  }
+
+  // journal
+
+  uint32_t version() const { return _version; }
+  uint32_t journalFrom() const { return _journalFrom; }
+  /// False if the journal does not describe all changes since journalFrom() (rebuilt, reset or too long): send the whole tree.
+  bool journalComplete() const { return _journalComplete; }
+  const std::vector<FileJournalEntry>& journal() const { return _journal; }
+
+  /// The journal is sent: the next change starts a new one.
+  void publish() { _published = true; }
+
+  /// Clients need the whole tree (e.g. other files are shown): starts an incomplete journal.
+  void reset() {
+    _version++;
+    _journal.clear();
+    _journalFrom = _version;
+    _journalComplete = false;
+    _published = false;
+  }
+
+ private:
+  std::map<std::string, FileIndexEntry, FilePathLess> _entries;
+  bool _built = false;
+  uint32_t _version = 0;
+  uint32_t _journalFrom = 0;
+  bool _journalComplete = true;
+  bool _published = false;
+  std::vector<FileJournalEntry> _journal;
+
+  static std::string normalize(const char* path) {
+    std::string key = path && path[0] == '/' ? path : std::string("/") + (path ? path : "");
+    while (key.size() > 1 && key.back() == '/') key.pop_back();
+    return key;
+  }
+
+  // first entry after the subtree of key (key itself included in the subtree)
+  std::map<std::string, FileIndexEntry, FilePathLess>::iterator subtreeEnd(const std::string& key) {
+    auto it = _entries.lower_bound(key + '/');
+    while (it != _entries.end() && it->first.compare(0, key.size() + 1, key + '/') == 0) ++it;
+    return it;
+  }
+
+  void addParents(const std::string& key) {
+    for (size_t slash = key.find('/', 1); slash != std::string::npos; slash = key.find('/', slash + 1)) {
+      std::string parent = key.substr(0, slash);
+      auto it = _entries.find(parent);
+      if (it != _entries.end() && !it->second.isFile) continue;
+      if (it != _entries.end()) remove(parent.c_str());  // a file in the way of a folder
+      FileIndexEntry& entry = _entries[parent];
+      entry.isFile = false;
+      record(FileChange::added, parent, entry);
+    }
+  }
+
+  void record(FileChange change, const std::string& path, const FileIndexEntry& entry) {
+    if (_published) {  // start a new journal from the published version
+      _journal.clear();
+      _journalFrom = _version;
+      _journalComplete = true;
+      _published = false;
+    }
+    _version++;
+    if (!_journalComplete) return;
+    // repeated writes of the same file (settings, presets): keep one entry
+    if (change == FileChange::modified && !_journal.empty() && _journal.back().path == path && _journal.back().change != FileChange::removed) {
+      _journal.back().entry = entry;
+      return;
+    }
+    if (_journal.size() >= FILE_JOURNAL_MAX) {
+      _journal.clear();
+      _journalComplete = false;
+      return;
+    }
+    _journal.push_back({change, path, entry});
+  }
+};
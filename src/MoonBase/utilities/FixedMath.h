@@ -0,0 +1,102 @@
+/**
+    @title     MoonBase
+    @file      FixedMath.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/nodes/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Integer trig and square root for per-light loops of effects and modifiers. ESP32-C3 and other boards without an
+    FPU run sinf / atan2f / sqrtf in software, hundreds of cycles per call; these use a table, shifts and adds.
+    Angles are uint16_t, 65536 is a full turn (as FastLED sin16 / beat16); as int16_t -32768..32767 is -π..π.
+    sinFixed / cosFixed: Q15 (-32767..32767), 129 entry quarter wave table with linear interpolation, error at most 1 (Q15).
+    atan2Fixed: CORDIC, 16 iterations, error at most 2 (of 65536). sqrtFixed: floor(sqrt(x)), exact.
+    This header has NO ESP32 / FastLED dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <cstdint>
+
+inline constexpr int16_t fixedSinQuarter[129] = {
+    0,     402,   804,   1206,  1608,  2009,  2410,  2811,  3212,  3612,  4011,  4410,  4808,  5205,  5602,  5998,  //
+    6393,  6786,  7179,  7571,  7962,  8351,  8739,  9126,  9512,  9896,  10278, 10659, 11039, 11417, 11793, 12167,  //
+    12539, 12910, 13279, 13645, 14010, 14372, 14732, 15090, 15446, 15800, 16151, 16499, 16846, 17189, 17530, 17869,  //
+    18204, 18537, 18868, 19195, 19519, 19841, 20159, 20475, 20787, 21096, 21403, 21705, 22005, 22301, 22594, 22884,  //
+    23170, 23452, 23731, 24007, 24279, 24547, 24811, 25072, 25329, 25582, 25832, 26077, 26319, 26556, 26790, 27019,  //
+    27245, 27466, 27683, 27896, 28105, 28310, 28510, 28706, 28898, 29085, 29268, 29447, 29621, 29791, 29956, 30117,  //
+    30273, 30424, 30571, 30714, 30852, 30985, 31113, 31237, 31356, 31470, 31580, 31685, 31785, 31880, 31971, 32057,  //
+    32137, 32213, 32285, 32351, 32412, 32469, 32521, 32567, 32609, 32646, 32678, 32705, 32728, 32745, 32757, 32765,  //
+    32767};
+
+// atan(2^-i) in 1/262144 turn (4x the angle resolution, rounded at the end)
+inline constexpr int32_t fixedAtanSteps[16] = {32768, 19344, 10221, 5188, 2604, 1303, 652, 326, 163, 81, 41, 20, 10, 5, 3, 1};
+
+/// sin of angle (65536 = full turn), Q15
+inline int16_t sinFixed(uint16_t angle) {
+  uint16_t offset = angle & 0x3FFF;              // within the quarter
+  if (angle & 0x4000) offset = 0x4000 - offset;  // 2nd and 4th quarter: mirrored
+  uint8_t index = offset >> 7;
+  int32_t value = fixedSinQuarter[index];
+  if (index < 128) value += ((fixedSinQuarter[index + 1] - value) * (int32_t)(offset & 127) + 64) >> 7;
+  return (angle & 0x8000) ? -value : value;
+}
+
+/// cos of angle (65536 = full turn), Q15
+inline int16_t cosFixed(uint16_t angle) { return sinFixed(angle + 16384); }
+
+/// floor(sqrt(x))
+inline uint16_t sqrtFixed(uint32_t x) {
+  uint32_t result = 0;
+  uint32_t bit = 1u << 30;
+  while (bit > x) bit >>= 2;
+  while (bit) {
+    if (x >= result + bit) {
+      x -= result + bit;
+      result = (result >> 1) + bit;
+    } else
+      result >>= 1;
+    bit >>= 2;
+  }
+  return result;
+}
+
+/// floor(sqrt(dx² + dy²)), |dx|, |dy| < 46341
+inline uint16_t hypotFixed(int32_t dx, int32_t dy) { return sqrtFixed((uint32_t)(dx * dx) + (uint32_t)(dy * dy)); }
+
+/// Angle of (x, y): -32768..32767 is -π..π (cast to uint16_t: 0..65535 counterclockwise from +x). |x|, |y| < 2^30.
+inline int16_t atan2Fixed(int32_t y, int32_t x) {
+  if (x == 0 && y == 0) return 0;
+  int32_t angle = 0;  // 1/262144 turn
+  if (x < 0) {        // rotate by half a turn into the right half plane
+    x = -x;
+    y = -y;
+    angle = 131072;
+  }
+  // scale up to 2^27 .. 2^28 so the shifts below keep precision (and the CORDIC gain of 1.65 fits)
+  uint32_t magnitude = (uint32_t)x | (uint32_t)(y < 0 ? -y : y);
+  int shift = __builtin_clz(magnitude) - 4;
+  if (shift > 0) {
+    x *= 1 << shift;
+    y *= 1 << shift;
+  } else if (shift < 0) {
+    x >>= -shift;
+    y >>= -shift;
+  }
+  for (int i = 0; i < 16; i++) {  // rotate (x, y) onto the x axis, adding up the rotations
+    int32_t nextX;
+    if (y > 0) {
+      nextX = x + (y >> i);
+      y -= x >> i;
+      angle += fixedAtanSteps[i];
+    } else {
+      nextX = x - (y >> i);
+      y += x >> i;
+      angle -= fixedAtanSteps[i];
+    }
+    x = nextX;
+  }
+  return (int16_t)(uint16_t)((angle + 2) >> 2);
+}
@@ -0,0 +1,65 @@
+/**
+    @title     MoonBase
+    @file      JuliaKernel.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/nodes/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    The per-pixel part of the Julia effect (E_WLED.h), rendered a band of rows at a time by JuliaEffect::loopRows:
+    z -> z^2 + c iterated in fixed point Q26 (as precise as float around 1, |a|, |b| stay below 32), integer
+    multiplies only. The start of a row is computed from the row, not accumulated over the rows before it, so a
+    band of rows renders exactly as the same rows of the whole frame: the effect is tile-safe.
+    This header has NO ESP32 / FastLED dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <cstdint>
+
+#define JULIA_SHIFT 26
+
+inline int32_t toJulia(float value) { return (int32_t)(value * (1 << JULIA_SHIFT)); }
+
+/// The values of a frame, set by JuliaEffect::loopFrame, all Q26.
+struct JuliaFrame {
+  int32_t xmin = 0;
+  int32_t ymin = 0;
+  int32_t stepX = 0;  ///< per column
+  int32_t stepY = 0;  ///< per row
+  int32_t re = 0;     ///< c
+  int32_t im = 0;
+  int maxIterations = 0;
+};
+
+/// Iterations of z -> z^2 + c from z = a + ib before |z|^2 exceeds 16, maxIterations if it stays within.
+inline int juliaIterations(int32_t a, int32_t b, const JuliaFrame& frame) {
+  const int64_t maxCalc = (int64_t)16 << JULIA_SHIFT;
+  int iter = 0;
+  while (iter < frame.maxIterations) {
+    int64_t aa = ((int64_t)a * a) >> JULIA_SHIFT;
+    int64_t bb = ((int64_t)b * b) >> JULIA_SHIFT;
+    if (aa + bb > maxCalc) break;  // |z|^2 = a^2 + b^2, no square root needed
+
+    // z -> z^2 + c where z = a + ib: (a^2 - b^2) + i(2ab)
+    b = (int32_t)(((int64_t)a * b) >> (JULIA_SHIFT - 1)) + frame.im;
+    a = (int32_t)(aa - bb) + frame.re;
+    iter++;
+  }
+  return iter;
+}
+
+/// Rows [rowStart, rowEnd) of cols columns: pixel(column, row, iterations) per pixel.
+template <typename Pixel>
+void juliaRows(const JuliaFrame& frame, uint16_t cols, uint16_t rowStart, uint16_t rowEnd, Pixel&& pixel) {
+  for (uint16_t row = rowStart; row < rowEnd; row++) {
+    int32_t y = frame.ymin + frame.stepY * row;
+    int32_t x = frame.xmin;
+    for (uint16_t column = 0; column < cols; column++) {
+      pixel(column, row, juliaIterations(x, y, frame));
+      x += frame.stepX;
+    }
+  }
+}
@@ -0,0 +1,182 @@
+/**
+    @title     MoonBase
+    @file      LightRuns.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/layers/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Runs of lights a layout adds at once (PhysicalLayer::addLights) instead of light by light:
+    LightGrid: a 1D, 2D or 3D grid wired axis by axis, optionally serpentine, in the order of the Wiring of the panel
+    and cube layouts. Its positions follow from the light number, so a virtual layer maps a grid by arithmetic
+    (gridInside, gridIsOneToOne) instead of one addLight per light.
+    Wiring: the nested loops of the panel and cube layouts (iterate), and the same lights as a LightGrid (grid).
+    lineLight / ringLight: the positions of lights along a line (addTube) and on a ring (RingLayout).
+    This header has NO ESP32 dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "Coord3D.h"
+
+struct LightGrid {
+  Coord3D origin;                      ///< the corner with the lowest coordinates
+  uint16_t size[3] = {1, 1, 1};        ///< lights along x, y and z
+  uint8_t axes[3] = {2, 1, 0};         ///< the axis of each wiring level, outer first: {2, 1, 0} is row by row, x fastest
+  bool inc[3] = {true, true, true};    ///< per axis: wired from low to high coordinates
+  bool snake[3] = {false, false, false};  ///< per level: reversed when the coordinate of the level above is odd (serpentine)
+
+  size_t count() const { return (size_t)size[0] * size[1] * size[2]; }
+
+  /// The corner with the highest coordinates.
+  Coord3D last() const { return Coord3D(origin.x + size[0] - 1, origin.y + size[1] - 1, origin.z + size[2] - 1); }
+
+  /// Position of light n, 0 the first wired.
+  Coord3D position(size_t n) const {
+    uint16_t counters[3];
+    uint32_t inner = (uint32_t)size[axes[1]] * size[axes[2]];
+    counters[0] = n / inner;
+    counters[1] = (n % inner) / size[axes[2]];
+    counters[2] = n % size[axes[2]];
+    return at(counters);
+  }
+
+  /// Calls fun(position) for count lights from light first, in wiring order.
+  template <typename Callback>
+  void forEach(size_t first, size_t count, Callback&& fun) const {
+    if (!count) return;
+    uint16_t counters[3];
+    uint32_t inner = (uint32_t)size[axes[1]] * size[axes[2]];
+    counters[0] = first / inner;
+    counters[1] = (first % inner) / size[axes[2]];
+    counters[2] = first % size[axes[2]];
+    for (size_t n = 0; n < count; n++) {
+      fun(at(counters));
+      if (++counters[2] == size[axes[2]]) {
+        counters[2] = 0;
+        if (++counters[1] == size[axes[1]]) {
+          counters[1] = 0;
+          counters[0]++;
+        }
+      }
+    }
+  }
+
+ private:
+  /// The position of the light counters[level] steps into each level.
+  Coord3D at(const uint16_t* counters) const {
+    int coords[3];
+    int previous = 0;  // coordinate of the level above, level 0 is never reversed (as Wiring::iterate)
+    for (uint8_t level = 0; level < 3; level++) {
+      uint8_t axis = axes[level];
+      bool increasing = inc[axis];
+      if (snake[level] && previous % 2 == 1) increasing = !increasing;
+      coords[axis] = increasing ? counters[level] : size[axis] - 1 - counters[level];
+      previous = coords[axis];
+    }
+    return Coord3D(origin.x + coords[0], origin.y + coords[1], origin.z + coords[2]);
+  }
+};
+
+/// The wiring of the panel and cube layouts (L_MoonLight.h): per level an axis, direction and serpentine.
+struct Wiring {
+  uint16_t size[3] = {16, 16, 16};       // panels of 16x16
+  uint8_t wiringOrder = 1;               // first Y, then X, then Z
+  bool inc[3] = {true, true};            // left, top, front
+  bool snake[3] = {false, true, false};  // snake on Y
+  uint8_t* axes;
+
+  template <typename Callback>
+  void iterate(int axis, int snaker, Callback&& fun) {
+    bool iInc = inc[axes[axis]];
+    if (snake[axis] && snaker % 2 == 1) iInc = !iInc;  // reverse order for snake
+    for (int j = iInc ? 0 : size[axes[axis]] - 1; iInc ? j < size[axes[axis]] : j >= 0; j += iInc ? 1 : -1) {
+      fun(j);
+    }
+  }
+
+  // The lights iterate() walks over dimensions (2: axes[0], axes[1], 3: all) levels, as a grid at origin
+  LightGrid grid(uint8_t dimensions, Coord3D origin = Coord3D()) const {
+    LightGrid grid;
+    grid.origin = origin;
+    uint8_t skip = 3 - dimensions;  // a 2D wiring is a grid with one plane: an outer level of size 1
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      grid.size[axis] = axis < dimensions ? size[axis] : 1;
+      grid.inc[axis] = inc[axis];
+    }
+    grid.axes[0] = 2;
+    for (uint8_t level = 0; level < dimensions; level++) {
+      grid.axes[level + skip] = axes[level];
+      grid.snake[level + skip] = snake[level];
+    }
+    return grid;
+  }
+};
+
+/// True if all lights of grid are in [start, end) (the physical window of a virtual layer).
+inline bool gridInside(const LightGrid& grid, Coord3D start, Coord3D end) {
+  Coord3D last = grid.last();
+  return grid.origin.x >= start.x && grid.origin.y >= start.y && grid.origin.z >= start.z && last.x < end.x && last.y < end.y && last.z < end.z;
+}
+
+/// True if the lights first .. first + count of grid are virtual lights firstIndex, firstIndex + 1, ... of a layer
+/// of size layerSize at start: row by row, x fastest, no reversals, full rows (and planes) unless it is one row.
+/// Then the layer keeps its one to one mapping, no mapping table.
+inline bool gridIsOneToOne(const LightGrid& grid, size_t first, size_t count, size_t firstIndex, Coord3D start, Coord3D layerSize) {
+  if (!count) return true;
+  if (grid.axes[0] != 2 || grid.axes[1] != 1 || grid.axes[2] != 0) return false;
+  if (!grid.inc[0] || !grid.inc[1] || !grid.inc[2]) return false;
+  if (grid.snake[1] && grid.size[2] > 1 && grid.size[1] > 1) return false;  // rows reversed in odd planes
+  if (grid.snake[2] && grid.size[1] > 1 && grid.size[0] > 1) return false;  // lights reversed in odd rows
+  bool oneRow = grid.size[1] == 1 && grid.size[2] == 1;
+  if (!oneRow && grid.size[0] != layerSize.x) return false;
+  if (grid.size[2] > 1 && grid.size[1] != layerSize.y) return false;
+  Coord3D position = grid.position(first) - start;
+  return (size_t)position.x + (size_t)position.y * layerSize.x + (size_t)position.z * layerSize.x * layerSize.y == firstIndex;
+}
+
+/// Light n of count along the line from from to to (both included), rounded to the nearest position (addTube).
+inline Coord3D lineLight(Coord3D from, Coord3D to, size_t n, size_t count) {
+  float t = count > 1 ? (float)n / (float)(count - 1) : 0.0f;
+  return Coord3D((int)(from.x + ((float)to.x - (float)from.x) * t + 0.5f), (int)(from.y + ((float)to.y - (float)from.y) * t + 0.5f), (int)(from.z + ((float)to.z - (float)from.z) * t + 0.5f));
+}
+
+/// Light n of a ring of count lights 1 cm apart (times scale) around center, the first at angleFirst degrees
+/// (RingLayout). position is set and true is returned if the light is on the part of the ring from angleFirst over
+/// rotation degrees (clockwise or not), false if not.
+inline bool ringLight(Coord3D center, uint16_t count, size_t n, uint16_t angleFirst, uint16_t rotation, bool clockwise, uint8_t scale, Coord3D& position) {
+  const double pi = 3.1415926535897932384626433832795;
+  const double twoPi = 6.283185307179586476925286766559;
+  float radius = count / twoPi;
+  float x = scale * center.x;
+  float y = scale * center.y;
+
+  float ledAngle = fmod(angleFirst + ((float)n / count) * 360.0, 360.0);  // the angle of this light
+  float angleRad = pi + (twoPi * n) / count + twoPi * angleFirst / 360.0;  // the angle to render it at
+  if (count != 1) {
+    x -= scale * sinf(angleRad) * radius;
+    y += scale * cosf(angleRad) * radius;
+  }
+
+  bool include = false;
+  if (rotation < 1.0 || rotation >= 360.0) {
+    include = true;  // full circle
+  } else {
+    float endAngle = clockwise ? fmod(angleFirst + rotation, 360.0) : fmod(angleFirst - rotation + 360.0, 360.0);
+    if (clockwise)
+      include = endAngle >= angleFirst ? ledAngle >= angleFirst && ledAngle <= endAngle   // no wrap: 180 + 90 = 270
+                                       : ledAngle >= angleFirst || ledAngle <= endAngle;  // wraps around 0: 270 + 180 = 90
+    else
+      include = endAngle <= angleFirst ? ledAngle <= angleFirst && ledAngle >= endAngle   // no wrap: 180 - 90 = 90
+                                       : ledAngle <= angleFirst || ledAngle >= endAngle;  // wraps around 0: 90 - 180 = 270
+  }
+
+  if (include) position = Coord3D((int)x, (int)y, scale * center.z);
+  return include;
+}
@@ -0,0 +1,386 @@
+/**
+    @title     MoonBase
+    @file      MappingDescriptor.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/layers/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Analytic virtual to physical mappings: a few numbers instead of a mapping table entry per virtual light.
+    GridWiring records the grids a layout adds (PhysicalLayer::addLights). If they are equal tiles (one panel or cube,
+    or panels) wired one after the other in the order of a grid of tiles, TileWiring gives the physical light at each
+    position: serpentine and reversed (mirrored) wiring are part of the grids, the first light is an offset.
+    MappingDescriptor is a virtual layer on a TileWiring: its window on the fixture, and per axis the copies folded
+    onto each virtual light (Mirror and Multiply modifiers). forEachRun() gives the physical lights of each virtual row
+    as runs: within a tile the physical index of the next light in a row is a fixed step away, alternating by a fixed
+    amount when the wiring snakes across the row.
+    This header has NO ESP32 dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "LightRuns.h"
+
+/// The number of the light at position (relative to grid.origin) in grid: the inverse of LightGrid::position().
+inline size_t gridLightNumber(const LightGrid& grid, Coord3D position) {
+  const int coords[3] = {position.x, position.y, position.z};
+  size_t n = 0;
+  int previous = 0;  // coordinate of the level above, level 0 is never reversed
+  for (uint8_t level = 0; level < 3; level++) {
+    uint8_t axis = grid.axes[level];
+    bool increasing = grid.inc[axis];
+    if (grid.snake[level] && previous % 2 == 1) increasing = !increasing;
+    n = n * grid.size[axis] + (increasing ? coords[axis] : grid.size[axis] - 1 - coords[axis]);
+    previous = coords[axis];
+  }
+  return n;
+}
+
+/// True if a and b have the same size and wiring (origins may differ).
+inline bool sameWiring(const LightGrid& a, const LightGrid& b) {
+  for (uint8_t i = 0; i < 3; i++)
+    if (a.size[i] != b.size[i] || a.axes[i] != b.axes[i] || a.inc[i] != b.inc[i] || a.snake[i] != b.snake[i]) return false;
+  return true;
+}
+
+/// The lights of a fixture as tiles wired as tile, one after the other in the order of tiles (size in tiles).
+struct TileWiring {
+  LightGrid tile;      ///< the wiring of each tile, origin is the corner of the first tile in the grid of tiles
+  LightGrid tiles;     ///< the order of the tiles, origin {0, 0, 0}
+  uint32_t first = 0;  ///< physical index of the first light of the first tile
+
+  /// Physical index of the light at position, UINT32_MAX if there is none.
+  uint32_t indexP(Coord3D position) const {
+    Coord3D relative = position - tile.origin;
+    const int coords[3] = {relative.x, relative.y, relative.z};
+    int inTile[3], tileCoords[3];
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      if (coords[axis] < 0 || coords[axis] >= tiles.size[axis] * tile.size[axis]) return UINT32_MAX;
+      tileCoords[axis] = coords[axis] / tile.size[axis];
+      inTile[axis] = coords[axis] % tile.size[axis];
+    }
+    return first + gridLightNumber(tiles, Coord3D(tileCoords[0], tileCoords[1], tileCoords[2])) * tile.count() + gridLightNumber(tile, Coord3D(inTile[0], inTile[1], inTile[2]));
+  }
+};
+
+/// Records the grids added during a layout pass and finds their TileWiring afterwards.
+class GridWiring {
+ public:
+  /// Forgets the grids of the previous layout.
+  void reset() {
+    _ranges.clear();
+    _lights = 0;
+    _valid = false;
+  }
+
+  /// Lights first .. first + count of grid were added as physical lights indexP, indexP + 1, ... Consecutive parts of
+  /// one grid (e.g. a cube plane by plane) are joined.
+  void add(const LightGrid& grid, size_t first, size_t count, uint32_t indexP) {
+    if (!count) return;
+    _lights += count;
+    if (!_ranges.empty()) {
+      Range& last = _ranges.back();
+      if (sameWiring(last.grid, grid) && last.grid.origin == grid.origin && last.first + last.count == first && last.indexP + last.count == indexP) {
+        last.count += count;
+        return;
+      }
+    }
+    _ranges.push_back({grid, (uint32_t)first, (uint32_t)count, indexP});
+  }
+
+  /// Lights added by add(). Equal to the number of lights added if none were added one by one.
+  size_t lights() const { return _lights; }
+
+  /// Calls fun(position, indexP) for each light added, in the order added.
+  template <typename Callback>
+  void forEachLight(Callback&& fun) const {
+    for (const Range& range : _ranges) {
+      uint32_t indexP = range.indexP;
+      range.grid.forEach(range.first, range.count, [&](Coord3D position) { fun(position, indexP++); });
+    }
+  }
+
+  /// After the layout pass: true if the nrOfLights lights of the fixture are equal whole grids, wired one after the
+  /// other in the order of a grid of tiles (any axis order, direction and serpentine). wiring() is then valid.
+  bool finish(size_t nrOfLights) {
+    _valid = false;
+    if (_ranges.empty() || _lights != nrOfLights) return false;  // lights added one by one too
+    TileWiring& wiring = _wiring;
+    wiring.tile = _ranges[0].grid;
+    wiring.first = _ranges[0].indexP;
+    size_t tileCount = wiring.tile.count();
+    Coord3D low = wiring.tile.origin, high = wiring.tile.origin;
+    for (size_t t = 0; t < _ranges.size(); t++) {
+      const Range& range = _ranges[t];
+      if (range.first != 0 || range.count != tileCount || !sameWiring(range.grid, wiring.tile) || range.indexP != wiring.first + t * tileCount) return false;
+      low = low.minimum(range.grid.origin);
+      high = high.maximum(range.grid.origin);
+    }
+    const int spans[3] = {high.x - low.x, high.y - low.y, high.z - low.z};
+    wiring.tiles = LightGrid();
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      if (spans[axis] % wiring.tile.size[axis]) return false;  // not on a grid of tiles
+      wiring.tiles.size[axis] = spans[axis] / wiring.tile.size[axis] + 1;
+    }
+    if (wiring.tiles.count() != _ranges.size()) return false;  // gaps or overlaps
+    wiring.tile.origin = low;
+
+    // the order of the tiles: one of the axis orders, directions and serpentines
+    static const uint8_t orders[6][3] = {{2, 1, 0}, {2, 0, 1}, {1, 2, 0}, {1, 0, 2}, {0, 2, 1}, {0, 1, 2}};
+    for (const uint8_t* order : orders) {
+      for (uint8_t directions = 0; directions < 8; directions++) {
+        for (uint8_t snakes = 0; snakes < 4; snakes++) {  // levels 1 and 2, level 0 is never reversed
+          for (uint8_t i = 0; i < 3; i++) {
+            wiring.tiles.axes[i] = order[i];
+            wiring.tiles.inc[i] = !(directions & (1 << i));
+          }
+          wiring.tiles.snake[1] = snakes & 1;
+          wiring.tiles.snake[2] = snakes & 2;
+          bool match = true;
+          for (size_t t = 0; t < _ranges.size() && match; t++) {
+            Coord3D position = wiring.tiles.position(t);
+            Coord3D origin = _ranges[t].grid.origin - low;
+            match = position.x * wiring.tile.size[0] == origin.x && position.y * wiring.tile.size[1] == origin.y && position.z * wiring.tile.size[2] == origin.z;
+          }
+          if (match) return _valid = true;
+        }
+      }
+    }
+    return false;
+  }
+
+  bool valid() const { return _valid; }
+  const TileWiring& wiring() const { return _wiring; }
+
+ private:
+  struct Range {
+    LightGrid grid;
+    uint32_t first;
+    uint32_t count;
+    uint32_t indexP;  ///< of light first
+  };
+  std::vector<Range> _ranges;
+  size_t _lights = 0;
+  TileWiring _wiring;
+  bool _valid = false;
+};
+
+/// Physical lights at(0), at(1), ... of a run of virtual lights in a row.
+struct MappingRun {
+  uint32_t indexP = 0;  ///< of the first light
+  int32_t step = 0;     ///< to the next light
+  int32_t odd = 0;      ///< added for odd lights (the wiring snakes across the row)
+  uint32_t at(uint32_t n) const { return indexP + (int32_t)n * step + ((n & 1) ? odd : 0); }
+
+  /// The run from light n on.
+  MappingRun from(uint32_t n) const {
+    MappingRun run = *this;
+    run.indexP = at(n);
+    if (n & 1) run.odd = -odd;
+    return run;
+  }
+
+  /// Calls fun(n, indexP) for the count lights of the run, two at a time (no multiply or parity test per light).
+  template <typename Callback>
+  void forEach(uint32_t count, Callback&& fun) const {
+    uint32_t even = indexP;
+    uint32_t n = 0;
+    for (; n + 1 < count; n += 2, even += 2 * step) {
+      fun(n, even);
+      fun(n + 1, even + step + odd);
+    }
+    if (n < count) fun(n, even);
+  }
+};
+
+/// A virtual layer on a TileWiring: virtual light (x, y, z) is the light at start + (x, y, z) of the fixture, and per
+/// folded axis its copies further in the window (copy c at c * size + x, odd copies reversed if mirrored).
+class MappingDescriptor {
+ public:
+  TileWiring wiring;
+  Coord3D start;                 ///< the window of the layer on the fixture (VirtualLayer::startPhy)
+  Coord3D window;                ///< its size (endPhy - startPhy)
+  Coord3D size;                  ///< the virtual size, smaller than window on folded axes
+  uint8_t copies[3] = {1, 1, 1};  ///< per axis: window positions per virtual position (Mirror: 2, Multiply: its factor)
+  bool mirror[3] = {false, false, false};  ///< per axis: odd copies reversed (Mirror, Multiply with mirror)
+
+  /// Each virtual light is at most one physical light: no copies.
+  bool unique() const { return copies[0] == 1 && copies[1] == 1 && copies[2] == 1; }
+
+  /// Calls fun(indexV, count, run) for the runs of each virtual row: virtual lights indexV .. indexV + count - 1 are
+  /// physical lights run.at(0) .. run.at(count - 1). Rows in order, the copies of a row one after the other.
+  template <typename Callback>
+  void forEachRun(Callback&& fun) const {
+    RowRuns runs;
+    for (int z = 0; z < size.z; z++) {
+      for (int y = 0; y < size.y; y++) {
+        uint32_t rowV = ((uint32_t)z * size.y + y) * size.x;
+        for (uint8_t cz = 0; cz < copies[2]; cz++) {
+          int qz = fold(2, z, cz);
+          if (qz < 0) continue;
+          for (uint8_t cy = 0; cy < copies[1]; cy++) {
+            int qy = fold(1, y, cy);
+            if (qy < 0) continue;
+            if (!runs.at(wiring, qy + start.y, qz + start.z)) continue;  // no tiles here
+            for (uint8_t cx = 0; cx < copies[0]; cx++) row(rowV, cx, runs, fun);
+          }
+        }
+      }
+    }
+  }
+
+  /// Calls fun(indexP) for the physical lights of virtual light indexV, only the first if onlyOne.
+  template <typename Callback>
+  void forEachIndexP(uint32_t indexV, Callback&& fun, bool onlyOne = false) const {
+    if (!size.x || !size.y || indexV >= (uint32_t)size.x * size.y * size.z) return;
+    const int v[3] = {(int)(indexV % size.x), (int)(indexV / size.x % size.y), (int)(indexV / size.x / size.y)};
+    for (uint8_t cz = 0; cz < copies[2]; cz++) {
+      int qz = fold(2, v[2], cz);
+      if (qz < 0) continue;
+      for (uint8_t cy = 0; cy < copies[1]; cy++) {
+        int qy = fold(1, v[1], cy);
+        if (qy < 0) continue;
+        for (uint8_t cx = 0; cx < copies[0]; cx++) {
+          int qx = fold(0, v[0], cx);
+          if (qx < 0) continue;
+          uint32_t indexP = wiring.indexP(start + Coord3D(qx, qy, qz));
+          if (indexP == UINT32_MAX) continue;
+          fun(indexP);
+          if (onlyOne) return;
+        }
+      }
+    }
+  }
+
+  /// The number of (virtual, physical) light pairs and of runs.
+  void count(size_t& lights, size_t& runs) const {
+    lights = runs = 0;
+    forEachRun([&](uint32_t, uint32_t n, const MappingRun&) {
+      lights += n;
+      runs++;
+    });
+  }
+
+  /// Sets copies and mirror to the folds for which the descriptor gives exactly the pairs of a mapping table:
+  /// mapped(indexV, indexP) true for each pair it gives, and pairs in total. False if no fold does (modifiers other
+  /// than Mirror and Multiply, lights not in the wiring): the table stays.
+  template <typename Mapped>
+  bool fit(size_t pairs, Mapped&& mapped) {
+    const int windows[3] = {window.x, window.y, window.z};
+    const int sizes[3] = {size.x, size.y, size.z};
+    uint8_t folded = 0;  // axes where the window is larger than the layer
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      if (sizes[axis] <= 0 || sizes[axis] > windows[axis]) return false;
+      copies[axis] = (windows[axis] + sizes[axis] - 1) / sizes[axis];
+      if (copies[axis] > 1) folded |= 1 << axis;
+    }
+    for (uint8_t mirrors = 0; mirrors < 8; mirrors++) {
+      if (mirrors & ~folded) continue;  // only folded axes mirror
+      for (uint8_t axis = 0; axis < 3; axis++) mirror[axis] = mirrors & (1 << axis);
+      bool match = true;
+      size_t found = 0;
+      forEachRun([&](uint32_t indexV, uint32_t n, const MappingRun& run) {
+        for (uint32_t i = 0; i < n && match; i++) match = mapped(indexV + i, run.at(i));
+        found += n;
+      });
+      if (match && found == pairs) return true;
+    }
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      copies[axis] = 1;
+      mirror[axis] = false;
+    }
+    return false;
+  }
+
+ private:
+  /// The runs of a row of the fixture along x: of the tiles it crosses and of the lights in a tile. The tiles run
+  /// only changes once per row of tiles: kept from the previous row.
+  struct RowRuns {
+    MappingRun tiles;
+    MappingRun lights;
+    int tileY = -1;
+    int tileZ = -1;
+
+    /// False if no tiles are at fixture coordinates y, z.
+    bool at(const TileWiring& wiring, int y, int z) {
+      const LightGrid& tile = wiring.tile;
+      y -= tile.origin.y;
+      z -= tile.origin.z;
+      if (y < 0 || z < 0 || y >= wiring.tiles.size[1] * tile.size[1] || z >= wiring.tiles.size[2] * tile.size[2]) return false;
+      if (y / tile.size[1] != tileY || z / tile.size[2] != tileZ) {
+        tileY = y / tile.size[1];
+        tileZ = z / tile.size[2];
+        tiles = gridRow(wiring.tiles, tileY, tileZ);
+      }
+      lights = gridRow(tile, y % tile.size[1], z % tile.size[2]);
+      return true;
+    }
+  };
+
+  /// Window coordinate of copy c of virtual coordinate v along axis, -1 if outside the window.
+  int fold(uint8_t axis, int v, uint8_t c) const {
+    int length = axis == 0 ? size.x : axis == 1 ? size.y : size.z;
+    int q = c * length + ((mirror[axis] && (c & 1)) ? length - 1 - v : v);
+    return q < (axis == 0 ? window.x : axis == 1 ? window.y : window.z) ? q : -1;
+  }
+
+  /// The runs of copy cx of virtual row rowV on the fixture row of runs: one per tile. Within a row of a grid the
+  /// light number is affine (with the odd lights shifted), so two runs along x, of the tiles and of the lights in a
+  /// tile, give all lights of the row.
+  template <typename Callback>
+  void row(uint32_t rowV, uint8_t cx, const RowRuns& runs, Callback&& fun) const {
+    const LightGrid& tile = wiring.tile;
+    const MappingRun& tiles = runs.tiles;
+    const MappingRun& lights = runs.lights;
+    uint32_t tileCount = tile.count();
+
+    int direction = (mirror[0] && (cx & 1)) ? -1 : 1;
+    int base = cx * size.x + (direction < 0 ? size.x - 1 : 0) + start.x - tile.origin.x;  // tile x of virtual x 0
+    int width = wiring.tiles.size[0] * tile.size[0];
+    int low = MAX(0, start.x - tile.origin.x);  // tile x covered by the window and the tiles
+    int high = MIN(width, start.x - tile.origin.x + window.x);
+    int first = MAX(direction > 0 ? low - base : base - high + 1, 0);
+    int last = MIN(direction > 0 ? high - base : base - low + 1, size.x);  // exclusive
+    if (first >= last) return;
+
+    // the first run can start inside a tile, the others enter their tile at its edge: one division per row
+    int tileX = base + direction * first;
+    int tileIndex = tileX / tile.size[0];
+    int inTile = tileX % tile.size[0];
+    MappingRun run = lights.from(inTile);
+    MappingRun entry = lights.from(direction > 0 ? 0 : tile.size[0] - 1);
+    run.step *= direction;
+    entry.step *= direction;
+    for (int x = first; x < last;) {
+      int count = MIN(direction > 0 ? tile.size[0] - inTile : inTile + 1, last - x);
+      MappingRun inRow = run;
+      inRow.indexP += wiring.first + tiles.at(tileIndex) * tileCount;
+      fun(rowV + x, (uint32_t)count, inRow);
+      x += count;
+      run = entry;
+      tileIndex += direction;
+      inTile = direction > 0 ? 0 : tile.size[0] - 1;
+    }
+  }
+
+  /// The light numbers along x of grid at y, z (relative to its origin) as a run.
+  static MappingRun gridRow(const LightGrid& grid, int y, int z) {
+    MappingRun run;
+    run.indexP = gridLightNumber(grid, Coord3D(0, y, z));
+    if (grid.size[0] > 1) {
+      int32_t second = (int32_t)gridLightNumber(grid, Coord3D(1, y, z)) - (int32_t)run.indexP;
+      if (grid.size[0] > 2) {
+        run.step = ((int32_t)gridLightNumber(grid, Coord3D(2, y, z)) - (int32_t)run.indexP) / 2;
+        run.odd = second - run.step;
+      } else
+        run.step = second;
+    }
+    return run;
+  }
+};
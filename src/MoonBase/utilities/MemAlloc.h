@@ -14,6 +14,8 @@
 #include <cstddef>
 
 #include "ArduinoJson.h"
+#include "MemBudget.h"
+#include "NodePool.h"
 
 // Fallback no-op macros when included standalone (real definitions come from PlatformFunctions.h)
 #ifndef EXT_LOGE
@@ -29,25 +31,81 @@
   #define MB_TAG "🌙"
 #endif
 
-extern int totalAllocatedMB;
+extern MemBudget memBudget;  // heap in use per MemTag, budgets and the degradation level
 
 bool isInPSRAM(void* ptr);
 
-// allocate, try PSRAM, else default, use calloc: zero-initialized (all bytes = 0)
+// heap free for allocMB (PSRAM and internal), for the degradation levels of memBudget
+inline size_t memFreeBytes() { return heap_caps_get_free_size(MALLOC_CAP_8BIT); }
+// internal RAM free (stacks, DMA, WiFi): degrades on its own reserve, PSRAM does not count for it
+inline size_t memFreeInternal() { return heap_caps_get_free_size(MALLOC_CAP_INTERNAL); }
+
+// false (and logged) if bytes more for tag (or for growing old) exceed its budget. JSON is always admitted, without
+// asking the heap how much is free
+inline bool memAdmit(MemTag tag, size_t bytes, const char* name, const void* old = nullptr) {
+  if (tag == MemJson) return true;
+  if (memBudget.admit(tag, bytes, memFreeBytes(), memFreeInternal(), old)) return true;
+  EXT_LOGW(MB_TAG, "%s of %d bytes not allocated: over the %s budget", name ? name : "x", bytes, memTagName(tag));
+  return false;
+}
+
+// allocate from the heap, try PSRAM, else default, use calloc: zero-initialized (all bytes = 0)
 template <typename T>
-T* allocMB(size_t n, const char* name = nullptr) {
+T* allocHeapMB(size_t n, const char* name = nullptr, MemTag tag = MemOther) {
+  if (!memAdmit(tag, n * sizeof(T), name)) return nullptr;
   T* res = (T*)heap_caps_calloc_prefer(n, sizeof(T), 2, MALLOC_CAP_SPIRAM, MALLOC_CAP_DEFAULT);  // calloc is malloc + memset(0);
   if (res) {
-    totalAllocatedMB += heap_caps_get_allocated_size(res);
-    // EXT_LOGD(MB_TAG, "Allocated %s: %d x %d bytes in %s s:%d (tot:%d)", name?name:"x", n, sizeof(T), isInPSRAM(res)?"PSRAM":"RAM", heap_caps_get_allocated_size(res), totalAllocatedMB);
-  } else
+    memBudget.allocated(res, heap_caps_get_allocated_size(res), tag);
+    // EXT_LOGD(MB_TAG, "Allocated %s: %d x %d bytes in %s s:%d (tot:%d)", name?name:"x", n, sizeof(T), isInPSRAM(res)?"PSRAM":"RAM", heap_caps_get_allocated_size(res), memBudget.total());
+  } else {
+    memBudget.failed(tag);
     EXT_LOGE(MB_TAG, "heap_caps_malloc for %s of %d x %d not succeeded", name ? name : "x", n, sizeof(T));
+  }
+  return res;
+}
+
+// allocate, zero-initialized: from the node pool of the running task if in a NodePoolScope (node objects and buffers), else the heap
+template <typename T>
+T* allocMB(size_t n, const char* name = nullptr, MemTag tag = MemOther) {
+  if (NodePool* pool = NodePoolScope::pool()) {
+    if (T* res = (T*)pool->allocate(n * sizeof(T), NodePoolScope::owner())) return res;
+    if (tag == MemOther) tag = MemNodes;  // a node buffer the pool could not hold
+  }
+  return allocHeapMB<T>(n, name, tag);
+}
+
+// resize a heap block, accounted for tag unless memBudget knows the block
+template <typename T>
+T* reallocHeapMB(T* p, size_t n, const char* name, MemTag tag) {
+  if (tag == MemOther && NodePoolScope::pool()) tag = MemNodes;  // as allocMB
+  size_t oldBytes = p ? heap_caps_get_allocated_size(p) : 0;
+  if (n * sizeof(T) > oldBytes && !memAdmit(tag, n * sizeof(T) - oldBytes, name, p)) return nullptr;
+  T* res = (T*)heap_caps_realloc_prefer(p, n * sizeof(T), 2, MALLOC_CAP_SPIRAM, MALLOC_CAP_DEFAULT);
+  if (res)
+    memBudget.reallocated(p, oldBytes, res, heap_caps_get_allocated_size(res), tag);
+  else
+    memBudget.failed(tag);
   return res;
 }
 
+// a pool block that grows moves to a bigger block of the pool (same owner), else to the heap
 template <typename T>
-T* reallocMB(T* p, size_t n, const char* name = nullptr) {
-  T* res = (T*)heap_caps_realloc_prefer(p, n * sizeof(T), 2, MALLOC_CAP_SPIRAM, MALLOC_CAP_DEFAULT);  // calloc is malloc + memset(0);
+T* reallocPoolMB(NodePool* pool, T* p, size_t n, const char* name) {
+  size_t blockSize = pool->blockSize(p);
+  if (n * sizeof(T) <= blockSize) return p;
+  T* res = (T*)pool->allocate(n * sizeof(T), pool->ownerOf(p));
+  if (!res) res = allocHeapMB<T>(n, name, MemNodes);
+  if (res) {
+    memcpy((void*)res, (void*)p, blockSize);
+    pool->free(p);
+  }
+  return res;
+}
+
+template <typename T>
+T* reallocMB(T* p, size_t n, const char* name = nullptr, MemTag tag = MemOther) {
+  if (NodePool* pool = NodePool::owning(p)) return reallocPoolMB(pool, p, n, name);
+  T* res = reallocHeapMB(p, n, name, tag);
   if (res) {
     // EXT_LOGD(MB_TAG, "Re-Allocated %s: %d x %d bytes in %s s:%d", name?name:"x", n, sizeof(T), isInPSRAM(res)?"PSRAM":"RAM", heap_caps_get_allocated_size(res));
   } else
@@ -56,8 +114,14 @@ T* reallocMB(T* p, size_t n, const char* name = nullptr) {
 }
 
 template <typename T>
-void reallocMB2(T*& p, size_t& pSize, size_t n, const char* name = nullptr) {
-  T* res = (T*)heap_caps_realloc_prefer(p, n * sizeof(T), 2, MALLOC_CAP_SPIRAM, MALLOC_CAP_DEFAULT);  // calloc is malloc + memset(0);
+void reallocMB2(T*& p, size_t& pSize, size_t n, const char* name = nullptr, MemTag tag = MemOther) {
+  T* res;
+  if (!p)
+    res = allocMB<T>(n, name, tag);
+  else if (NodePool* pool = NodePool::owning(p))
+    res = reallocPoolMB(pool, p, n, name);
+  else
+    res = reallocHeapMB(p, n, name, tag);
   if (res) {
     // EXT_LOGD(MB_TAG, "Re-Allocated %s: %d x %d bytes in %s s:%d", name?name:"x", n, sizeof(T), isInPSRAM(res)?"PSRAM":"RAM", heap_caps_get_allocated_size(res));
     p = res;
@@ -67,24 +131,27 @@ void reallocMB2(T*& p, size_t& pSize, size_t n, const char* name = nullptr) {
   }
 }
 
-// free memory
+// free memory, tag: for blocks memBudget does not track (MemJson)
 template <typename T>
-void freeMB(T*& p, const char* name = nullptr) {
-  if (p) {
-    totalAllocatedMB -= heap_caps_get_allocated_size(p);
-    // EXT_LOGD(MB_TAG, "free %s: x x %d bytes in %s, s:%d (tot:%d)", name?name:"x", sizeof(T), isInPSRAM(p)?"PSRAM":"RAM", heap_caps_get_allocated_size(p), totalAllocatedMB);
+void freeMB(T*& p, const char* name = nullptr, MemTag tag = MemOther) {
+  if (NodePool* pool = NodePool::owning(p)) {
+    pool->free((void*)p);
+    p = nullptr;
+  } else if (p) {
+    memBudget.freed(p, heap_caps_get_allocated_size(p), tag);
+    // EXT_LOGD(MB_TAG, "free %s: x x %d bytes in %s, s:%d (tot:%d)", name?name:"x", sizeof(T), isInPSRAM(p)?"PSRAM":"RAM", heap_caps_get_allocated_size(p), memBudget.total());
     heap_caps_free(p);
     p = nullptr;
   } else
     EXT_LOGW(MB_TAG, "Nothing to free for %s: pointer is null", name ? name : "x");
 }
 
-// allocate vector
+// allocate vector, from the heap: vectors of layers and modules outlive the node of a NodePoolScope
 template <typename T>
 struct VectorRAMAllocator {
   using value_type = T;
 
-  T* allocate(size_t n) { return allocMB<T>(n, "vector"); }
+  T* allocate(size_t n) { return allocHeapMB<T>(n, "vector"); }
   void deallocate(T* p, size_t n) { freeMB(p, "vector"); }
   T* reallocate(T* p, size_t n) { return reallocMB<T>(p, n, "vector"); }
 };
@@ -92,15 +159,66 @@ struct VectorRAMAllocator {
 // https://arduinojson.org/v7/api/jsondocument/
 struct JsonRAMAllocator : ArduinoJson::Allocator {
   //(uint8_t*): simulate 1 byte
-  void* allocate(size_t n) override { return allocMB<uint8_t>(n, "json"); }
-  void deallocate(void* p) override { freeMB(p, "json"); }
-  void* reallocate(void* p, size_t n) override { return reallocMB<uint8_t>((uint8_t*)p, n, "json"); }
+  void* allocate(size_t n) override { return allocHeapMB<uint8_t>(n, "json", MemJson); }  // not from a node pool: module state outlives nodes
+  void deallocate(void* p) override { freeMB(p, "json", MemJson); }
+  void* reallocate(void* p, size_t n) override { return reallocMB<uint8_t>((uint8_t*)p, n, "json", MemJson); }
   static Allocator* instance() {
     static JsonRAMAllocator allocator;
     return &allocator;
   }
 };
 
+// For a JsonDocument that lives shortly and is made again and again by one task (the control of a queued node command):
+// allocations are carved from a buffer allocated once, reset() before each document frees them all at once. What does
+// not fit goes to the heap as JsonRAMAllocator. Each block is preceded by its size, so the last block grows in place.
+class JsonArenaAllocator : public ArduinoJson::Allocator {
+ public:
+  explicit JsonArenaAllocator(size_t capacity) : _capacity(capacity) {}
+  ~JsonArenaAllocator() {
+    if (_buffer) freeMB(_buffer, "jsonArena", MemJson);
+  }
+
+  /// Frees all arena blocks: only when no document uses them any more.
+  void reset() { _used = 0; }
+
+  void* allocate(size_t n) override {
+    if (!_buffer) _buffer = allocHeapMB<uint8_t>(_capacity, "jsonArena", MemJson);
+    size_t needed = header + align(n);
+    if (!_buffer || _used + needed > _capacity) return JsonRAMAllocator::instance()->allocate(n);
+    uint8_t* block = _buffer + _used;
+    *(size_t*)block = n;
+    _used += needed;
+    return block + header;
+  }
+  void deallocate(void* p) override {
+    if (!owns(p)) JsonRAMAllocator::instance()->deallocate(p);  // arena blocks are freed by reset()
+  }
+  void* reallocate(void* p, size_t n) override {
+    if (!p) return allocate(n);
+    if (!owns(p)) return JsonRAMAllocator::instance()->reallocate(p, n);
+    size_t& size = *(size_t*)((uint8_t*)p - header);
+    if ((uint8_t*)p + align(size) == _buffer + _used && (uint8_t*)p - _buffer + align(n) <= _capacity) {  // the last block: in place
+      _used = (uint8_t*)p - _buffer + align(n);
+      size = n;
+      return p;
+    }
+    if (n <= size) return p;
+    void* res = allocate(n);
+    if (res) memcpy(res, p, size);
+    return res;
+  }
+
+  bool owns(const void* p) const { return _buffer && p >= _buffer && p < _buffer + _capacity; }
+  size_t used() const { return _used; }
+
+ private:
+  static constexpr size_t header = sizeof(size_t) > 8 ? sizeof(size_t) : 8;  // keeps blocks 8-byte aligned
+  static size_t align(size_t n) { return (n + 7) & ~(size_t)7; }
+  uint8_t* _buffer = nullptr;
+  size_t _capacity;
+  size_t _used = 0;
+};
+
 // allocate object
 template <typename T, typename... Args>
 T* allocMBObject(Args&&... args) {
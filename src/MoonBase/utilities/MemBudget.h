@@ -0,0 +1,267 @@
+/**
+    @title     MoonBase
+    @file      MemBudget.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/overview/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Heap accounting per subsystem (MemTag) for allocMB / reallocMB2 / freeMB (MemAlloc.h): bytes in use, high-water
+    mark, optional budget, failed and denied allocations. Blocks of the tracked tags (channelsD, virtualChannels,
+    mapping tables, node buffers, monitor) are remembered by pointer, so freeMB finds their tag without being told.
+    Degradation before OOM: as free heap drops below 3, 2 and 1 times the reserve, the level rises and subsystems
+    shed memory at their next safe point (monitor buffers, then caches and mapping tables, then no new nodes); it
+    drops again with half a reserve of hysteresis. An allocation that would cross a threshold raises the level before it is made.
+    The heap (PSRAM and internal) and the internal RAM alone (stacks, DMA, WiFi) each have their own reserve: the
+    level is that of the one with least free relative to its reserve, so a full internal RAM degrades on PSRAM boards.
+    JSON documents (MemJson) are many small blocks made and freed all the time: not admitted against a budget or the
+    levels, and accounted with relaxed atomics instead of the mutex.
+    This header has NO ESP32 dependencies and can be included in native unit tests (with a fake heap).
+**/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+enum MemTag : uint8_t {
+  MemOther,     ///< untagged allocations
+  MemChannels,  ///< channelsD of the physical layer
+  MemLayers,    ///< virtualChannels of the virtual layers
+  MemMapping,   ///< mapping tables
+  MemNodes,     ///< node pools and node buffers the pool could not hold
+  MemMonitor,   ///< monitor frames
+  MemJson,      ///< JSON documents (JsonRAMAllocator), freed by tag
+  MemTags
+};
+
+inline const char* memTagName(MemTag tag) {
+  static const char* names[MemTags] = {"other", "channels", "layers", "mapping", "nodes", "monitor", "json"};
+  return tag < MemTags ? names[tag] : "?";
+}
+
+/// Levels of degradation, each includes the ones before.
+enum MemDegradation : uint8_t {
+  MemDegradeNone,
+  MemDegradeMonitor,  ///< monitor buffers dropped, no monitor frames
+  MemDegradeCaches,   ///< polar caches dropped and not rebuilt, mapping tables over grids made analytic
+  MemDegradeNodes,    ///< no new effect or modifier nodes
+  MemDegradations
+};
+
+inline const char* memDegradationName(uint8_t level) {
+  static const char* names[MemDegradations] = {"none", "monitor off", "caches off", "no new nodes"};
+  return level < MemDegradations ? names[level] : "?";
+}
+
+struct MemTagStats {
+  size_t used = 0;
+  size_t peak = 0;       ///< high-water mark of used
+  size_t budget = 0;     ///< 0: no budget
+  uint32_t blocks = 0;   ///< live blocks
+  uint32_t failed = 0;   ///< the heap had no room
+  uint32_t denied = 0;   ///< over budget, not tried
+};
+
+#define MEM_BLOCKS_MAX 64  // tracked blocks; more are accounted as MemOther
+
+class MemBudget {
+ public:
+  /// Heap and internal RAM to keep free, the steps between degradation levels. internalReserve 0: not checked.
+  void setReserve(size_t reserve, size_t internalReserve = 0) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _reserve = reserve;
+    _internalReserve = internalReserve;
+  }
+  void setBudget(MemTag tag, size_t budget) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats[tag].budget = budget;
+  }
+
+  /// Before allocating bytes for tag (or growing old by bytes) with freeBytes of heap and freeInternal of internal RAM
+  /// free: false if it would exceed the budget of tag (of old if tracked). Raises the degradation level if it takes
+  /// the heap below a threshold (allocations prefer PSRAM: freeInternal is taken as is).
+  bool admit(MemTag tag, size_t bytes, size_t freeBytes, size_t freeInternal, const void* old = nullptr) {
+    if (tag == MemJson) return true;
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (MemBlock* block = findLocked(old)) tag = block->tag;
+    MemTagStats& stats = _stats[tag];
+    if (stats.budget && stats.used + bytes > stats.budget) {
+      stats.denied++;
+      return false;
+    }
+    raiseLocked(levelFor(freeBytes > bytes ? freeBytes - bytes : 0, freeInternal));
+    return true;
+  }
+
+  /// p of bytes is allocated for tag.
+  void allocated(const void* p, size_t bytes, MemTag tag) {
+    if (tag == MemJson) return jsonAdd(bytes);
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (tracked(tag) && !insertLocked(p, bytes, tag)) tag = MemOther;  // table full: freed as MemOther too
+    addLocked(tag, bytes);
+  }
+
+  /// p of bytes is freed; tag if p is not a tracked block.
+  void freed(const void* p, size_t bytes, MemTag tag = MemOther) {
+    if (tag == MemJson) return jsonSubtract(bytes);  // never a tracked block
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (MemBlock* block = findLocked(p)) {
+      tag = block->tag;
+      block->p = nullptr;
+    }
+    subtractLocked(tag, bytes);
+  }
+
+  /// old of oldBytes moved or resized to p of bytes; tag if old is not a tracked block (or is nullptr).
+  void reallocated(const void* old, size_t oldBytes, const void* p, size_t bytes, MemTag tag = MemOther) {
+    if (tag == MemJson) {
+      if (old) jsonSubtract(oldBytes);
+      return jsonAdd(bytes);
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (MemBlock* block = old ? findLocked(old) : nullptr) {
+      tag = block->tag;
+      block->p = p;
+      block->bytes = bytes;
+    } else if (!old && tracked(tag) && !insertLocked(p, bytes, tag)) {
+      tag = MemOther;
+    }
+    if (old) subtractLocked(tag, oldBytes);
+    addLocked(tag, bytes);
+  }
+
+  /// The heap had no room for an allocation for tag: the next level of degradation.
+  void failed(MemTag tag) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats[tag].failed++;
+    uint8_t level = _level;
+    if (level + 1 < MemDegradations) raiseLocked(level + 1);
+  }
+
+  /// Periodically, with freeBytes of heap and freeInternal of internal RAM free: raises the level, or lowers it by
+  /// one when both are half their reserve above the threshold of the level. True if the level changed.
+  bool update(size_t freeBytes, size_t freeInternal) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    uint8_t before = _level;
+    uint8_t level = levelFor(freeBytes, freeInternal);
+    if (level > _level)
+      raiseLocked(level);
+    else if (_level > MemDegradeNone && freeBytes >= threshold(_level, _reserve) + _reserve / 2 && freeInternal >= threshold(_level, _internalReserve) + _internalReserve / 2)
+      _level--;
+    return _level != before;
+  }
+
+  /// True if the degradation level is level or higher.
+  bool degraded(MemDegradation level) const { return _level >= level; }
+  uint8_t level() const { return _level; }
+  uint8_t peakLevel() const { return _peakLevel; }
+  uint32_t raised() const { return _raised; }  ///< times the level went up
+
+  MemTagStats stats(MemTag tag) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    MemTagStats stats = _stats[tag];
+    if (tag == MemJson) {
+      stats.used = _jsonUsed.load(std::memory_order_relaxed);
+      stats.peak = _jsonPeak.load(std::memory_order_relaxed);
+      stats.blocks = _jsonBlocks.load(std::memory_order_relaxed);
+    }
+    return stats;
+  }
+  size_t total() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t total = _jsonUsed.load(std::memory_order_relaxed);
+    for (const MemTagStats& stats : _stats) total += stats.used;
+    return total;
+  }
+
+ private:
+  struct MemBlock {
+    const void* p = nullptr;
+    size_t bytes = 0;
+    MemTag tag = MemOther;
+  };
+
+  /// MemOther is not worth a block, MemJson has many small blocks and is freed by tag.
+  static bool tracked(MemTag tag) { return tag != MemOther && tag != MemJson; }
+
+  /// Free heap below which level is engaged: 3 reserves for the monitor, 2 for the caches, 1 for new nodes.
+  static size_t threshold(uint8_t level, size_t reserve) { return level ? (size_t)(MemDegradations - level) * reserve : 0; }
+
+  static uint8_t reserveLevel(size_t freeBytes, size_t reserve) {
+    uint8_t level = MemDegradeNone;
+    while (level + 1 < MemDegradations && freeBytes < threshold(level + 1, reserve)) level++;
+    return level;
+  }
+
+  /// The higher level of the heap and the internal RAM.
+  uint8_t levelFor(size_t freeBytes, size_t freeInternal) const {
+    uint8_t heap = reserveLevel(freeBytes, _reserve), internal = reserveLevel(freeInternal, _internalReserve);
+    return heap > internal ? heap : internal;
+  }
+
+  void raiseLocked(uint8_t level) {
+    if (level <= _level) return;
+    _level = level;
+    _raised++;
+    if (level > _peakLevel) _peakLevel = level;
+  }
+
+  bool insertLocked(const void* p, size_t bytes, MemTag tag) {
+    for (MemBlock& block : _blocks) {
+      if (!block.p) {
+        block = {p, bytes, tag};
+        return true;
+      }
+    }
+    return false;
+  }
+
+  MemBlock* findLocked(const void* p) {
+    if (!p) return nullptr;
+    for (MemBlock& block : _blocks)
+      if (block.p == p) return &block;
+    return nullptr;
+  }
+
+  void addLocked(MemTag tag, size_t bytes) {
+    MemTagStats& stats = _stats[tag];
+    stats.used += bytes;
+    stats.blocks++;
+    if (stats.used > stats.peak) stats.peak = stats.used;
+  }
+
+  void subtractLocked(MemTag tag, size_t bytes) {
+    MemTagStats& stats = _stats[tag];
+    stats.used = bytes < stats.used ? stats.used - bytes : 0;
+    if (stats.blocks) stats.blocks--;
+  }
+
+  void jsonAdd(size_t bytes) {
+    size_t used = _jsonUsed.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    _jsonBlocks.fetch_add(1, std::memory_order_relaxed);
+    size_t peak = _jsonPeak.load(std::memory_order_relaxed);
+    while (used > peak && !_jsonPeak.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {}
+  }
+
+  void jsonSubtract(size_t bytes) {
+    _jsonUsed.fetch_sub(bytes, std::memory_order_relaxed);
+    _jsonBlocks.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  MemTagStats _stats[MemTags];  // of MemJson only failed: the rest are the atomics below
+  std::atomic<size_t> _jsonUsed{0};
+  std::atomic<size_t> _jsonPeak{0};
+  std::atomic<uint32_t> _jsonBlocks{0};
+  MemBlock _blocks[MEM_BLOCKS_MAX];
+  size_t _reserve = 0;
+  size_t _internalReserve = 0;
+  std::atomic<uint8_t> _level{MemDegradeNone};  // read without the mutex by the safe points
+  uint8_t _peakLevel = MemDegradeNone;
+  uint32_t _raised = 0;
+  mutable std::mutex _mutex;
+};
@@ -0,0 +1,262 @@
+/**
+    @title     MoonBase
+    @file      NodePool.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/nodes/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Size-class pool for node objects and their buffers, one per virtual layer, in a single block reserved once.
+    Switching effects allocates and frees nodes and buffers of many sizes all day; from the general heap that
+    fragments PSRAM until allocations fail. In the pool a freed block is reused by the next block of its size class
+    (sizes 32, 48, 64, 96, 128 ... bytes: at most 1/3 unused), and free blocks at the end are given back, so the pool
+    does not grow with the number of switches. Blocks carry the owner (node) that allocated them: releaseOwner()
+    frees what a replaced node left behind. Requests the pool can't serve return nullptr: the caller uses the heap.
+    allocMB / reallocMB2 / freeMB (MemAlloc.h) use the pool of the NodePoolScope of the running task.
+    This header has NO ESP32 / ArduinoJson dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+
+#define NODE_POOL_CLASSES 32  // 32 B .. 1.5 MB
+#define NODE_POOLS_MAX 8      // pools alive at the same time (layers)
+
+struct NodePoolStats {
+  size_t capacity = 0;
+  size_t reserved = 0;      // bytes of the region in use or in free lists (the footprint)
+  size_t reservedPeak = 0;  // high-water mark of reserved
+  size_t used = 0;          // bytes of live blocks (incl. headers)
+  size_t usedPeak = 0;      // high-water mark of used
+  uint32_t blocks = 0;      // live blocks
+  uint32_t allocations = 0;
+  uint32_t fallbacks = 0;  // requests served by the heap: too big or pool full
+  uint32_t leaked = 0;     // blocks freed by releaseOwner
+};
+
+class NodePool {
+ public:
+  NodePool() = default;
+  NodePool(const NodePool&) = delete;
+  NodePool& operator=(const NodePool&) = delete;
+  ~NodePool() { release(); }
+
+  /// Uses region (capacity bytes, 8-byte aligned, owned by the caller) for the pool. False if no pool slot is free.
+  bool init(void* region, size_t capacity) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_region || !region) return false;
+    for (auto& slot : _pools) {
+      NodePool* none = nullptr;
+      if (slot.compare_exchange_strong(none, this)) {
+        _region = (uint8_t*)region;
+        _capacity = capacity;
+        resetLocked();
+        _stats = NodePoolStats();
+        _stats.capacity = capacity;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Stops using the region and returns it (for the caller to free). All blocks must be freed before.
+  void* release() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto& slot : _pools) {
+      NodePool* self = this;
+      slot.compare_exchange_strong(self, nullptr);
+    }
+    void* region = _region;
+    _region = nullptr;
+    _capacity = 0;
+    return region;
+  }
+
+  bool active() const { return _region != nullptr; }
+  bool contains(const void* p) const { return _region && p >= _region && p < _region + _capacity; }
+
+  /// The pool p was allocated from, or nullptr (heap).
+  static NodePool* owning(const void* p) {
+    if (!p) return nullptr;
+    for (auto& slot : _pools) {
+      NodePool* pool = slot.load(std::memory_order_acquire);
+      if (pool && pool->contains(p)) return pool;
+    }
+    return nullptr;
+  }
+
+  /// An owner id for the blocks of a new node (never 0).
+  uint16_t newOwner() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (++_lastOwner == 0) _lastOwner = 1;
+    return _lastOwner;
+  }
+
+  /// A zeroed block of at least bytes, or nullptr if the pool can't serve it (the caller uses the heap).
+  void* allocate(size_t bytes, uint16_t owner) {
+    if (!_region) return nullptr;
+    std::lock_guard<std::mutex> lock(_mutex);
+    uint8_t cls = classOf(bytes);
+    void* p = cls < NODE_POOL_CLASSES ? allocateLocked(cls, owner) : nullptr;
+    if (!p) {
+      _stats.fallbacks++;
+      return nullptr;
+    }
+    memset(p, 0, classSize(cls));
+    return p;
+  }
+
+  void free(void* p) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    freeLocked(header(p));
+    trimLocked();
+  }
+
+  /// Usable bytes of block p.
+  size_t blockSize(const void* p) const { return classSize(header(p)->cls); }
+  uint16_t ownerOf(const void* p) const { return header(p)->owner; }
+
+  /// Frees all blocks of owner (what a node did not free in its destructor). Returns the number of blocks.
+  size_t releaseOwner(uint16_t owner) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t count = 0;
+    for (size_t offset = 0; offset < _top; offset += sizeof(Header) + classSize(at(offset)->cls)) {
+      Header* block = at(offset);
+      if (!block->free && block->owner == owner) {
+        freeLocked(block);
+        count++;
+      }
+    }
+    _stats.leaked += count;
+    trimLocked();
+    return count;
+  }
+
+  NodePoolStats stats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.reserved = _top;
+    return _stats;
+  }
+
+  static size_t classSize(uint8_t cls) { return (size_t)((cls & 1) ? 48 : 32) << (cls >> 1); }
+
+  /// The smallest class of at least bytes, NODE_POOL_CLASSES if too big.
+  static uint8_t classOf(size_t bytes) {
+    uint8_t cls = 0;
+    while (cls < NODE_POOL_CLASSES && classSize(cls) < bytes) cls++;
+    return cls;
+  }
+
+ private:
+  struct Header {
+    uint32_t prev;  // offset of the previous block, NONE for the first
+    uint16_t owner;
+    uint8_t cls;
+    uint8_t free;
+  };
+  static_assert(sizeof(Header) == 8, "payload stays 8-byte aligned");
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  Header* at(size_t offset) const { return (Header*)(_region + offset); }
+  static Header* header(const void* p) { return (Header*)p - 1; }
+  static void*& next(Header* block) { return *(void**)(block + 1); }  // free list link, in the payload
+
+  void resetLocked() {
+    _top = 0;
+    _last = NONE;
+    for (void*& head : _free) head = nullptr;
+  }
+
+  void* allocateLocked(uint8_t cls, uint16_t owner) {
+    Header* block;
+    if (_free[cls]) {  // reuse a block of this class
+      block = header(_free[cls]);
+      _free[cls] = next(block);
+    } else {  // carve a new block at the top
+      size_t size = sizeof(Header) + classSize(cls);
+      if (_top + size > _capacity) return nullptr;
+      block = at(_top);
+      block->prev = _last;
+      block->cls = cls;
+      _last = _top;
+      _top += size;
+      if (_top > _stats.reservedPeak) _stats.reservedPeak = _top;
+    }
+    block->owner = owner;
+    block->free = 0;
+    _stats.used += sizeof(Header) + classSize(cls);
+    if (_stats.used > _stats.usedPeak) _stats.usedPeak = _stats.used;
+    _stats.blocks++;
+    _stats.allocations++;
+    return block + 1;
+  }
+
+  void freeLocked(Header* block) {
+    if (block->free) return;  // double free
+    block->free = 1;
+    next(block) = _free[block->cls];
+    _free[block->cls] = block + 1;
+    _stats.used -= sizeof(Header) + classSize(block->cls);
+    _stats.blocks--;
+  }
+
+  // gives free blocks at the top back to the region: the next block of any class can use the space
+  void trimLocked() {
+    if (_stats.blocks == 0) {  // empty: the whole region is free again
+      resetLocked();
+      return;
+    }
+    while (_last != NONE && at(_last)->free) {
+      Header* block = at(_last);
+      for (void** link = &_free[block->cls]; *link; link = &next(header(*link)))
+        if (*link == block + 1) {
+          *link = next(block);
+          break;
+        }
+      _top = _last;
+      _last = block->prev;
+    }
+  }
+
+  uint8_t* _region = nullptr;
+  size_t _capacity = 0;
+  size_t _top = 0;      // end of the last block
+  uint32_t _last = NONE;  // offset of the last block
+  void* _free[NODE_POOL_CLASSES] = {};
+  uint16_t _lastOwner = 0;
+  NodePoolStats _stats;
+  std::mutex _mutex;
+
+  static inline std::atomic<NodePool*> _pools[NODE_POOLS_MAX] = {};
+};
+
+/// Allocations of allocMB / reallocMB2 (MemAlloc.h) of this task go to pool, for owner, while the scope lives.
+class NodePoolScope {
+ public:
+  NodePoolScope(NodePool* pool, uint16_t owner) : _prevPool(_pool), _prevOwner(_owner) {
+    _pool = owner ? pool : nullptr;  // owner 0: not a pool node
+    _owner = owner;
+  }
+  ~NodePoolScope() {
+    _pool = _prevPool;
+    _owner = _prevOwner;
+  }
+  NodePoolScope(const NodePoolScope&) = delete;
+  NodePoolScope& operator=(const NodePoolScope&) = delete;
+
+  static NodePool* pool() { return _pool; }
+  static uint16_t owner() { return _owner; }
+
+ private:
+  NodePool* _prevPool;
+  uint16_t _prevOwner;
+  static inline thread_local NodePool* _pool = nullptr;
+  static inline thread_local uint16_t _owner = 0;
+};
@@ -0,0 +1,114 @@
+/**
+    @title     MoonBase
+    @file      NodeRegistry.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/nodes/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Table of the node types a NodeManager can create: per type its name, dim, tags, category and a factory.
+    A module registers its types once, in the order of the UI list (addNodes), and addNode finds a type by a hash of the
+    alphanumeric characters of its name (binary search over the sorted hashes) instead of trying every type with
+    equalAZaz09 (checkAndAlloc). Aliases keep old names of renamed nodes working (presets saved with "Art-Net In").
+    This header has NO ESP32 / ArduinoJson dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+inline bool isNodeNameChar(char c) { return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'); }
+
+// FNV-1a over [0-9A-Za-z] only: names equal by nodeNameEqual have the same hash
+inline uint32_t nodeNameHash(const char* name) {
+  uint32_t h = 2166136261u;
+  for (; *name; name++)
+    if (isNodeNameChar(*name)) h = (h ^ (uint8_t)*name) * 16777619u;
+  return h;
+}
+
+// equalAZaz09 (PureFunctions.h), which needs ArduinoJson with it: compare ignoring non alphanumeric characters
+inline bool nodeNameEqual(const char* a, const char* b) {
+  while (true) {
+    while (*a && !isNodeNameChar(*a)) a++;
+    while (*b && !isNodeNameChar(*b)) b++;
+    if (*a != *b) return false;
+    if (!*a) return true;
+    a++;
+    b++;
+  }
+}
+
+template <typename Base>
+struct NodeType {
+  const char* name = nullptr;
+  uint8_t dim = 0;
+  const char* tags = "";
+  const char* category = "";
+  const char* board = nullptr;  // only available on this board preset, nullptr: all boards
+  Base* (*create)() = nullptr;
+};
+
+template <typename Base>
+class NodeRegistry {
+ public:
+  typedef NodeType<Base> Type;
+
+  /// Registers node type T (static name(), dim(), tags(), category()). False if a type with this name exists.
+  template <typename T>
+  bool add(Base* (*create)(), const char* board = nullptr) {
+    Type type;
+    type.name = T::name();
+    type.dim = T::dim();
+    type.tags = T::tags();
+    type.category = T::category();
+    type.board = board;
+    type.create = create;
+    if (find(type.name)) return false;
+    _types.push_back(type);
+    insert(type.name, (uint16_t)(_types.size() - 1));
+    return true;
+  }
+
+  /// An old name of a registered type: found by find() but not listed. False if name is taken or target unknown.
+  bool addAlias(const char* alias, const char* name) {
+    const Type* type = find(name);
+    if (!type || find(alias)) return false;
+    insert(alias, (uint16_t)(type - _types.data()));
+    return true;
+  }
+
+  /// The type with this name (case sensitive, ignoring non alphanumeric characters like the dim and tags), or nullptr.
+  const Type* find(const char* name) const {
+    if (!name) return nullptr;
+    uint32_t hash = nodeNameHash(name);
+    auto it = std::lower_bound(_index.begin(), _index.end(), hash, [](const Entry& entry, uint32_t h) { return entry.hash < h; });
+    for (; it != _index.end() && it->hash == hash; ++it)
+      if (nodeNameEqual(it->name, name)) return &_types[it->type];
+    return nullptr;
+  }
+
+  size_t size() const { return _types.size(); }
+  typename std::vector<Type>::const_iterator begin() const { return _types.begin(); }  // in registration (UI) order
+  typename std::vector<Type>::const_iterator end() const { return _types.end(); }
+
+ private:
+  struct Entry {
+    uint32_t hash;
+    uint16_t type;     // index in _types
+    const char* name;  // the type name or an alias
+  };
+
+  void insert(const char* name, uint16_t type) {
+    Entry entry{nodeNameHash(name), type, name};
+    _index.insert(std::upper_bound(_index.begin(), _index.end(), entry, [](const Entry& a, const Entry& b) { return a.hash < b.hash; }), entry);
+  }
+
+  std::vector<Type> _types;
+  std::vector<Entry> _index;  // sorted by hash
+};
@@ -0,0 +1,74 @@
+/**
+    @title     MoonBase
+    @file      PaletteLUT.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/overview/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    The 256 colors of a 16 entry palette, expanded once when the palette changes. ColorFromPalette(palette, index,
+    brightness) blends two entries for every pixel of every frame; color(index, brightness) is a table lookup and,
+    below full brightness, the same per channel scaling as FastLED's ColorFromPalette, so the result is identical.
+    Color: CRGB on the device (any struct with r, g, b), the 16 entries: CRGBPalette16 (48 bytes).
+    This header has NO ESP32 / FastLED dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+template <typename Color>
+class PaletteLUT {
+ public:
+  /// Expands the palette if its 16 entries differ from the last expansion: colorAt(i) gives the full brightness
+  /// color of index i (ColorFromPalette(palette, i) on the device). Only the colors blended from a changed entry are
+  /// rebuilt (31 per entry), so a palette transition changing a few entries per frame costs a few 31 color spans.
+  /// True if rebuilt.
+  template <typename Entries, typename ColorAt>
+  bool update(const Entries& entries, ColorAt colorAt) {
+    static_assert(sizeof(Entries) == sizeof(_source), "16 entries of 3 bytes");
+    if (_built && memcmp(&entries, _source, sizeof(_source)) == 0) return false;
+    const uint8_t* source = (const uint8_t*)&entries;
+    uint16_t changed = 0;  // bit per entry
+    for (int entry = 0; entry < 16; entry++)
+      if (!_built || memcmp(source + entry * 3, _source + entry * 3, 3) != 0) changed |= 1 << entry;
+    memcpy(_source, source, sizeof(_source));
+    for (int i = 0; i < 256; i++) {
+      int hi4 = i >> 4;  // color i blends entry hi4 with the next entry (i & 15 of 16)
+      if ((changed >> hi4) & 1 || ((i & 15) && (changed >> ((hi4 + 1) & 15)) & 1)) _colors[i] = colorAt((uint8_t)i);
+    }
+    _built = true;
+    _builds++;
+    return true;
+  }
+
+  const Color& operator[](uint8_t index) const { return _colors[index]; }
+
+  /// ColorFromPalette(palette, index, brightness) with linear blending.
+  Color color(uint8_t index, uint8_t brightness = 255) const {
+    Color color = _colors[index];
+    if (brightness != 255) {
+      color.r = scale(color.r, brightness);
+      color.g = scale(color.g, brightness);
+      color.b = scale(color.b, brightness);
+    }
+    return color;
+  }
+
+  /// FastLED ColorFromPalette brightness: brightness + 1, scale8 of nonzero channels, 0 is black.
+  static uint8_t scale(uint8_t channel, uint8_t brightness) {
+    if (!brightness || !channel) return 0;
+    return ((uint16_t)channel * (uint16_t)(brightness + 2)) >> 8;  // scale8(channel, brightness + 1), FASTLED_SCALE8_FIXED
+  }
+
+  uint32_t builds() const { return _builds; }
+
+ private:
+  Color _colors[256] = {};
+  uint8_t _source[48] = {};
+  bool _built = false;
+  uint32_t _builds = 0;
+};
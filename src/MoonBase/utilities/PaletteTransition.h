@@ -0,0 +1,80 @@
+/**
+    @title     MoonBase
+    @file      PaletteTransition.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/lightscontrol/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Crossfade of the 16 entries of the shared palette from the palette shown to a newly selected one over a duration.
+    Effects keep reading one palette (its 256 colors in PaletteLUT): step() writes a few entries per frame, each the
+    blend of old and new at the time of the frame, so the palette table only rebuilds the colors of those entries and
+    no effect blends its own output.
+    Color: CRGB on the device (any struct with r, g, b).
+    This header has NO ESP32 / FastLED dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <cstdint>
+
+#ifndef PALETTE_TRANSITION_ENTRIES
+  #define PALETTE_TRANSITION_ENTRIES 4  // entries blended per frame: every entry moves every 4th frame
+#endif
+
+template <typename Color>
+class PaletteTransition {
+ public:
+  /// Starts blending current (16 entries) towards target over durationMs from now. From the palette as shown, also
+  /// halfway a previous transition. durationMs 0: current becomes target at once.
+  void start(Color* current, const Color* target, uint32_t durationMs, uint32_t now) {
+    for (int i = 0; i < 16; i++) {
+      _from[i] = current[i];
+      _to[i] = target[i];
+    }
+    _start = now;
+    _duration = durationMs;
+    _next = 0;
+    _active = durationMs > 0;
+    if (!_active)
+      for (int i = 0; i < 16; i++) current[i] = target[i];
+  }
+
+  /// Stops a running transition, current keeps what was written so far.
+  void stop() { _active = false; }
+
+  /// Writes the blend of up to entries entries of current for time now, all of them when the duration passed (the
+  /// transition ends). False if no transition is running.
+  bool step(Color* current, uint32_t now, uint8_t entries = PALETTE_TRANSITION_ENTRIES) {
+    if (!_active) return false;
+    uint32_t elapsed = now - _start;
+    if (elapsed >= _duration) {
+      for (int i = 0; i < 16; i++) current[i] = _to[i];
+      _active = false;
+      return true;
+    }
+    uint8_t amount = (uint64_t)elapsed * 255 / _duration;  // of _to
+    for (uint8_t n = 0; n < entries && n < 16; n++) {
+      uint8_t i = (_next + n) & 15;
+      current[i].r = blend(_from[i].r, _to[i].r, amount);
+      current[i].g = blend(_from[i].g, _to[i].g, amount);
+      current[i].b = blend(_from[i].b, _to[i].b, amount);
+    }
+    _next = (_next + entries) & 15;
+    return true;
+  }
+
+  bool active() const { return _active; }
+
+  static uint8_t blend(uint8_t from, uint8_t to, uint8_t amount) { return ((uint16_t)from * (255 - amount) + (uint16_t)to * amount + 127) / 255; }
+
+ private:
+  Color _from[16] = {};
+  Color _to[16] = {};
+  uint32_t _start = 0;
+  uint32_t _duration = 0;
+  uint8_t _next = 0;  // first entry of the next step
+  bool _active = false;
+};
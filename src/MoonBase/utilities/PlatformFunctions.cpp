@@ -115,4 +115,4 @@ bool isInPSRAM(void* ptr) {
   #include "moonmanpng.h"
 #endif
 
-int totalAllocatedMB = 0;
+MemBudget memBudget;
@@ -0,0 +1,104 @@
+/**
+    @title     MoonBase
+    @file      PolarCache.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/nodes/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Angle and distance of every light from the centre of a layer, shared by the radial effects of the layer. They only
+    depend on the layer size: a table is built on first use after a size change (VirtualLayer invalidates the cache
+    before onSizeChanged), so effects don't compute atan2 / sqrt per light per frame.
+    Planes XY (2D effects) and XZ (3D effects radial around the vertical axis) hold angle and radius, the sphere holds
+    the 3D distance. Centre: (size.x / 2, size.y / 2, size.z / 2), between two lights for even sizes.
+    Not thread safe: tile-safe effects take the table in loopFrame(), before the row bands run.
+    This header has NO ESP32 / ArduinoJson dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "FixedMath.h"
+
+struct PolarCoord {
+  uint16_t angle;   // 65536 is a full turn, counterclockwise from +x (atan2Fixed)
+  uint16_t radius;  // distance from the centre in 1/16 light
+};
+
+enum PolarPlane : uint8_t { PolarXY, PolarXZ };
+
+/// Angle and radius of (a, b) in a width x height plane, as in the tables: for effects when the table is not there.
+inline PolarCoord polarCoord(int a, int b, uint16_t width, uint16_t height) {
+  int32_t da = 2 * a - width, db = 2 * b - height;  // half lights
+  return {(uint16_t)atan2Fixed(db, da), hypotFixed(da * 8, db * 8)};
+}
+
+template <template <typename> class Allocator = std::allocator>
+class PolarCache {
+ public:
+  /// Drops the tables (the layer size changed), they are built again on first use.
+  void invalidate() {
+    _planeSize[PolarXY] = _planeSize[PolarXZ] = 0;
+    _sphereSize = 0;
+  }
+
+  /// Drops the tables and gives their memory back (low on heap).
+  void release() {
+    invalidate();
+    for (auto& table : _planes) std::vector<PolarCoord, Allocator<PolarCoord>>().swap(table);
+    std::vector<uint16_t, Allocator<uint16_t>>().swap(_sphere);
+  }
+
+  /// Angle and radius of (a, b) in plane (x, y or x, z) of a width x height plane, index a + b * width.
+  const PolarCoord* plane(PolarPlane plane, uint16_t width, uint16_t height) {
+    uint32_t size = (uint32_t)width << 16 | height;
+    std::vector<PolarCoord, Allocator<PolarCoord>>& table = _planes[plane];
+    if (_planeSize[plane] != size || table.empty()) {
+      table.resize((size_t)width * height);
+      if (table.empty()) return nullptr;
+      PolarCoord* coord = table.data();
+      for (int b = 0; b < height; b++)
+        for (int a = 0; a < width; a++) *coord++ = polarCoord(a, b, width, height);
+      _planeSize[plane] = size;
+      _builds++;
+    }
+    return table.data();
+  }
+
+  /// Distance (1/16 light) of (x, y, z) from the centre, index x + y * width + z * width * height (XYZUnModified).
+  const uint16_t* sphere(uint16_t width, uint16_t height, uint16_t depth) {
+    uint64_t size = (uint64_t)width << 32 | (uint32_t)height << 16 | depth;
+    if (_sphereSize != size || _sphere.empty()) {
+      _sphere.resize((size_t)width * height * depth);
+      if (_sphere.empty()) return nullptr;
+      uint16_t* radius = _sphere.data();
+      for (int z = 0; z < depth; z++)
+        for (int y = 0; y < height; y++)
+          for (int x = 0; x < width; x++) {
+            uint32_t dx = 2 * x - width, dy = 2 * y - height, dz = 2 * z - depth;  // half lights, squared below
+            *radius++ = sqrtFixed((dx * dx + dy * dy + dz * dz) * 64);
+          }
+      _sphereSize = size;
+      _builds++;
+    }
+    return _sphere.data();
+  }
+
+  /// Tables built since construction (a rebuild per size change and table).
+  uint32_t builds() const { return _builds; }
+
+  /// Bytes of the tables.
+  size_t bytes() const { return (_planes[PolarXY].capacity() + _planes[PolarXZ].capacity()) * sizeof(PolarCoord) + _sphere.capacity() * sizeof(uint16_t); }
+
+ private:
+  std::vector<PolarCoord, Allocator<PolarCoord>> _planes[2];
+  std::vector<uint16_t, Allocator<uint16_t>> _sphere;
+  uint32_t _planeSize[2] = {0, 0};  // width << 16 | height the table was built for, 0: not built
+  uint64_t _sphereSize = 0;
+  uint32_t _builds = 0;
+};
@@ -0,0 +1,64 @@
+/**
+    @title     MoonBase
+    @file      ScriptExternals.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/livescripts/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    The externals of LiveScript (LiveScriptNode): added to the ESPLiveScript linker once per boot from a table.
+    parseExternal: the definition of an external ("CRGB getRGB(uint16_t)", "uint8_t width") split into return type,
+    name and parameters, as the linker takes them.
+    scriptFunctions: which of setup(), loop(), onLayout() and modifyPosition() a script defines.
+    This header has NO ESP32 / ESPLiveScript dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+struct ExternalSymbol {
+  std::string returnType;
+  std::string name;
+  std::string parameters;  ///< "uint8_t,uint8_t", empty for variables and functions without parameters
+  bool isFunction = false;
+};
+
+/// Splits definition into symbol. False if it is not "type name" or "type name(parameters)".
+inline bool parseExternal(const std::string& definition, ExternalSymbol& symbol) {
+  size_t firstSpace = definition.find(' ');
+  if (firstSpace == std::string::npos) return false;
+  symbol.returnType = definition.substr(0, firstSpace);
+  size_t openParen = definition.find('(', firstSpace + 1);
+  if (openParen == std::string::npos) {  // variable
+    symbol.isFunction = false;
+    symbol.name = definition.substr(firstSpace + 1);
+    symbol.parameters.clear();
+    return true;
+  }
+  size_t closeParen = definition.find(')', openParen + 1);
+  if (closeParen == std::string::npos) return false;
+  symbol.isFunction = true;
+  symbol.name = definition.substr(firstSpace + 1, openParen - firstSpace - 1);
+  symbol.parameters = definition.substr(openParen + 1, closeParen - openParen - 1);
+  return true;
+}
+
+#define SCRIPT_SETUP 1     // the script defines setup()
+#define SCRIPT_LOOP 2      // loop()
+#define SCRIPT_ONLAYOUT 4  // onLayout()
+#define SCRIPT_MODIFY 8    // modifyPosition(
+
+/// The SCRIPT_ flags of the functions source defines.
+inline uint8_t scriptFunctions(const std::string& source) {
+  uint8_t functions = 0;
+  if (source.find("setup()") != std::string::npos) functions |= SCRIPT_SETUP;
+  if (source.find("loop()") != std::string::npos) functions |= SCRIPT_LOOP;
+  if (source.find("onLayout()") != std::string::npos) functions |= SCRIPT_ONLAYOUT;
+  if (source.find("modifyPosition(") != std::string::npos) functions |= SCRIPT_MODIFY;
+  return functions;
+}
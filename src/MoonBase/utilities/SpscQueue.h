@@ -0,0 +1,82 @@
+/**
+    @title     MoonBase
+    @file      SpscQueue.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonbase/overview/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Lock-free single-producer / single-consumer ring buffer.
+    No ESP32/Arduino dependencies — safe for native unit tests.
+**/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/// Fixed-capacity lock-free queue for exactly one producer task and one consumer task.
+/// Capacity must be a power of two; one slot is never used, so N - 1 items fit.
+/// push() is only called by the producer, pop()/drain() only by the consumer.
+/// Used to hand control changes from the HTTP task to effectTask / driverTask without a mutex per node call.
+template <typename T, size_t N>
+class SpscQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+ public:
+  /// Producer: append an item. Returns false (item not queued) when the queue is full.
+  bool push(const T& item) {
+    const size_t head = _head.load(std::memory_order_relaxed);
+    const size_t next = (head + 1) & (N - 1);
+    if (next == _tail.load(std::memory_order_acquire)) {
+      _dropped++;
+      return false;  // full
+    }
+    _items[head] = item;
+    _head.store(next, std::memory_order_release);  // publish the item to the consumer
+    return true;
+  }
+
+  /// Consumer: take the oldest item. Returns false when the queue is empty.
+  bool pop(T& item) {
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail == _head.load(std::memory_order_acquire)) return false;  // empty
+    item = _items[tail];
+    _tail.store((tail + 1) & (N - 1), std::memory_order_release);  // hand the slot back to the producer
+    return true;
+  }
+
+  /// Consumer: pop every queued item and pass it to fun. Returns the number of items processed.
+  template <typename Fun>
+  size_t drain(Fun&& fun) {
+    size_t count = 0;
+    T item;
+    while (pop(item)) {
+      fun(item);
+      count++;
+    }
+    return count;
+  }
+
+  /// Either side: true when nothing is queued (snapshot, may change immediately after).
+  bool empty() const { return _tail.load(std::memory_order_acquire) == _head.load(std::memory_order_acquire); }
+
+  /// Either side: number of queued items (snapshot).
+  size_t size() const { return (_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire)) & (N - 1); }
+
+  /// Maximum number of items the queue can hold.
+  static constexpr size_t capacity() { return N - 1; }
+
+  /// Number of push() calls rejected because the queue was full (producer side counter).
+  uint32_t dropped() const { return _dropped; }
+
+ private:
+  T _items[N] = {};
+  // head and tail on separate cache lines so producer and consumer don't invalidate each other's line
+  alignas(32) std::atomic<size_t> _head{0};  // next slot to write (owned by producer)
+  alignas(32) std::atomic<size_t> _tail{0};  // next slot to read (owned by consumer)
+  uint32_t _dropped = 0;
+};
@@ -0,0 +1,120 @@
+/**
+    @title     MoonBase
+    @file      StatePath.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/modules/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Path-addressed module state updates, e.g. nodes[3].controls[5].value = 42: the value is found by walking
+    the path (O(depth)) instead of comparing the whole state (ModuleState::compareRecursive).
+    The parser has no ArduinoJson dependency; applyStatePath() in the second part needs it. Safe for native unit tests.
+**/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#define STATE_PATH_MAX_DEPTH 4      // nodes[3].controls[5].value is 3 steps
+#define STATE_PATH_MAX_KEY_LENGTH 23
+
+/// One step of a path: a key, optionally followed by an array index (UINT8_MAX = none).
+struct StatePathStep {
+  char key[STATE_PATH_MAX_KEY_LENGTH + 1] = "";
+  uint8_t index = UINT8_MAX;
+};
+
+/// Parsed path: key[index].key[index]...key, the last step is the value (control) name.
+struct StatePath {
+  StatePathStep steps[STATE_PATH_MAX_DEPTH];
+  uint8_t depth = 0;
+
+  /// Name of the value the path points to.
+  const char* name() const { return depth ? steps[depth - 1].key : ""; }
+
+  /// Fills parent/index like UpdatedItem: rows of the first array are level 0, rows of an array in such a row level 1.
+  void location(const char* parent[2], uint8_t index[2]) const {
+    parent[0] = parent[1] = "";
+    index[0] = index[1] = UINT8_MAX;
+    for (uint8_t s = 0; s < depth && s < 2; s++) {
+      if (steps[s].index == UINT8_MAX) break;
+      parent[s] = steps[s].key;
+      index[s] = steps[s].index;
+    }
+  }
+};
+
+/// Parses text like "nodes[3].controls[5].value" into path. False if malformed, too deep, a key is too long
+/// or an index is not below UINT8_MAX (the index range of UpdatedItem).
+inline bool parseStatePath(const char* text, StatePath& path) {
+  path.depth = 0;
+  if (!text || !*text) return false;
+  const char* p = text;
+  while (true) {
+    if (path.depth >= STATE_PATH_MAX_DEPTH) return false;
+    StatePathStep& step = path.steps[path.depth++];
+    size_t length = 0;
+    while (*p && *p != '.' && *p != '[') {
+      if (length >= STATE_PATH_MAX_KEY_LENGTH) return false;
+      step.key[length++] = *p++;
+    }
+    step.key[length] = '\0';
+    if (length == 0) return false;
+    step.index = UINT8_MAX;
+    if (*p == '[') {
+      p++;
+      uint16_t index = 0;
+      if (*p < '0' || *p > '9') return false;
+      while (*p >= '0' && *p <= '9') {
+        index = index * 10 + (*p++ - '0');
+        if (index >= UINT8_MAX) return false;
+      }
+      if (*p++ != ']') return false;
+      step.index = index;
+    }
+    if (*p == '\0') return true;
+    if (*p++ != '.') return false;
+  }
+}
+
+// ============================================================
+// Apply a path update to a state (requires ArduinoJson)
+// ============================================================
+
+#include "ArduinoJson.h"
+
+enum class StatePathResult : uint8_t { changed, unchanged, invalid };
+
+/// Sets the value at path in state, with the rules of ModuleState::compareRecursive for one value:
+/// - every step but the last selects an existing row: key[index] (no rows are added or removed)
+/// - the last step is a key in that row (created if missing), not "p" (pointer) and not an array (rows change as a whole)
+/// - objects (e.g. coord3D) are compared and replaced as a whole
+/// onChange(const StatePath& path, JsonVariant oldValue, JsonVariant value) is called once if the value changed;
+/// oldValue is a copy, valid during the call.
+template <typename OnChange>
+StatePathResult applyStatePath(JsonObject state, const StatePath& path, JsonVariantConst value, OnChange&& onChange) {
+  if (path.depth == 0 || value.isNull() || value.is<JsonArrayConst>()) return StatePathResult::invalid;
+  JsonObject row = state;
+  for (uint8_t s = 0; s + 1 < path.depth; s++) {
+    const StatePathStep& step = path.steps[s];
+    if (step.index == UINT8_MAX) return StatePathResult::invalid;
+    JsonArray rows = row[step.key].as<JsonArray>();
+    if (rows.isNull() || step.index >= rows.size()) return StatePathResult::invalid;
+    row = rows[step.index].as<JsonObject>();
+    if (row.isNull()) return StatePathResult::invalid;
+  }
+  const StatePathStep& leaf = path.steps[path.depth - 1];
+  if (leaf.index != UINT8_MAX || strcmp(leaf.key, "p") == 0) return StatePathResult::invalid;
+  JsonVariant stateValue = row[leaf.key];
+  if (stateValue.is<JsonArray>()) return StatePathResult::invalid;
+  if (stateValue == value) return StatePathResult::unchanged;
+
+  JsonDocument oldValue;
+  oldValue.set(stateValue);
+  row[leaf.key] = value;
+  onChange(path, oldValue.as<JsonVariant>(), row[leaf.key].as<JsonVariant>());
+  return StatePathResult::changed;
+}
@@ -0,0 +1,54 @@
+/**
+    @title     MoonBase
+    @file      TaskBindings.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/livescripts/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Which object (LiveScriptNode) a task (script task) works for, for functions called from that task without an
+    object (the externals of LiveScript). bind / unbind when the task starts and before it is deleted, find scans the
+    few entries. Callers cache the result per task in a thread_local, so the scan runs once per task, not per call.
+    Handle: TaskHandle_t on the device, anything comparable in native tests.
+    This header has NO ESP32 dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <cstdint>
+
+template <typename Handle, typename Target, uint8_t capacity>
+class TaskBindings {
+ public:
+  /// False if all entries are taken.
+  bool bind(Handle task, Target* target) {
+    for (Entry& entry : _entries)
+      if (!entry.target) {
+        entry.task = task;
+        entry.target = target;
+        return true;
+      }
+    return false;
+  }
+
+  void unbind(Handle task) {
+    for (Entry& entry : _entries)
+      if (entry.target && entry.task == task) entry = Entry();
+  }
+
+  /// The target of task, nullptr if not bound.
+  Target* find(Handle task) const {
+    for (const Entry& entry : _entries)
+      if (entry.target && entry.task == task) return entry.target;
+    return nullptr;
+  }
+
+ private:
+  struct Entry {
+    Handle task = Handle();
+    Target* target = nullptr;
+  };
+  Entry _entries[capacity];
+};
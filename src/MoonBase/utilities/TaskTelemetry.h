@@ -0,0 +1,230 @@
+/**
+    @title     MoonBase
+    @file      TaskTelemetry.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonbase/tasks/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Telemetry of the tasks for ModuleTasks, sampled once a second:
+    CpuWindow: CPU % per task and load per core over the last window, from the cumulative run time counters of
+    uxTaskGetSystemState (which wrap): the difference since the previous sample, not the total since boot.
+    WaitPoint: time a task spends blocked at a point of the frame pipeline (swapMutex, channelsDFreeSemaphore),
+    added lock-free by the task, taken per window.
+    TelemetryRing: the last TELEMETRY_SECONDS samples of a fixed set of columns, with min / avg / max and CSV.
+    This header has NO ESP32 dependencies and can be included in native unit tests.
+**/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+#define TELEMETRY_SECONDS 60
+#define TELEMETRY_UNKNOWN UINT16_MAX  // no value for this window (a task not seen in the previous sample)
+
+/// A task as uxTaskGetSystemState reports it.
+struct TaskRunTime {
+  uintptr_t id = 0;      ///< the task handle
+  uint32_t counter = 0;  ///< ulRunTimeCounter, cumulative
+  int8_t idleCore = -1;  ///< the core of an idle task, -1 for other tasks
+};
+
+/// CPU use in permille of one core per task and per core, over the window between two samples.
+template <size_t MaxTasks>
+class CpuWindow {
+ public:
+  /// count tasks sampled at total (cumulative run time, as the task counters): permille[n] is the share of a core task
+  /// n used since the previous sample, TELEMETRY_UNKNOWN if it was not in it. Wrapping counters are fine, as long as
+  /// the window is shorter than a wrap.
+  void update(const TaskRunTime* tasks, size_t count, uint32_t total, uint16_t* permille) {
+    uint32_t window = _sampled ? total - _total : 0;
+    for (uint16_t& load : _coreLoad) load = TELEMETRY_UNKNOWN;
+    for (size_t n = 0; n < count; n++) {
+      permille[n] = TELEMETRY_UNKNOWN;
+      size_t previous = find(tasks[n].id);
+      if (window && previous < _count) {
+        uint64_t used = (uint64_t)(uint32_t)(tasks[n].counter - _counters[previous]) * 1000 / window;
+        permille[n] = used < 1000 ? used : 1000;
+        if (tasks[n].idleCore >= 0 && tasks[n].idleCore < 2) _coreLoad[tasks[n].idleCore] = 1000 - permille[n];
+      }
+    }
+    _count = count < MaxTasks ? count : MaxTasks;
+    for (size_t n = 0; n < _count; n++) {
+      _ids[n] = tasks[n].id;
+      _counters[n] = tasks[n].counter;
+    }
+    _total = total;
+    _sampled = true;
+  }
+
+  /// Permille of core (0 or 1) not spent in its idle task in the last window, TELEMETRY_UNKNOWN if not known.
+  uint16_t coreLoad(uint8_t core) const { return core < 2 ? _coreLoad[core] : TELEMETRY_UNKNOWN; }
+
+ private:
+  size_t find(uintptr_t id) const {
+    for (size_t n = 0; n < _count; n++)
+      if (_ids[n] == id) return n;
+    return _count;
+  }
+
+  uintptr_t _ids[MaxTasks] = {};
+  uint32_t _counters[MaxTasks] = {};
+  size_t _count = 0;
+  uint32_t _total = 0;
+  bool _sampled = false;
+  uint16_t _coreLoad[2] = {TELEMETRY_UNKNOWN, TELEMETRY_UNKNOWN};
+};
+
+/// Time blocked at one point of the frame pipeline: add() by the task that waits, take() once per window.
+class WaitPoint {
+ public:
+  struct Window {
+    uint32_t us = 0;     ///< total wait
+    uint32_t count = 0;  ///< waits
+    uint32_t maxUs = 0;  ///< longest wait
+  };
+
+  void add(uint32_t us) {
+    _us.fetch_add(us, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    uint32_t max = _maxUs.load(std::memory_order_relaxed);
+    while (us > max && !_maxUs.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+    }
+  }
+
+  /// The waits since the previous take.
+  Window take() {
+    Window window;
+    window.us = _us.exchange(0, std::memory_order_relaxed);
+    window.count = _count.exchange(0, std::memory_order_relaxed);
+    window.maxUs = _maxUs.exchange(0, std::memory_order_relaxed);
+    return window;
+  }
+
+  /// Permille of windowUs spent waiting.
+  static uint16_t permille(const Window& window, uint32_t windowUs) {
+    if (!windowUs) return TELEMETRY_UNKNOWN;
+    uint64_t waited = (uint64_t)window.us * 1000 / windowUs;
+    return waited < 1000 ? waited : 1000;
+  }
+
+ private:
+  std::atomic<uint32_t> _us{0};
+  std::atomic<uint32_t> _count{0};
+  std::atomic<uint32_t> _maxUs{0};
+};
+
+struct TelemetryColumn {
+  const char* name;
+  uint8_t decimals;  ///< values are stored times 10^decimals (permille as a percentage: 1)
+};
+
+/// The last Size samples of Columns values each, one per second, oldest first. TELEMETRY_UNKNOWN values are left
+/// out of min / avg / max and empty in the CSV.
+template <size_t Columns, size_t Size = TELEMETRY_SECONDS>
+class TelemetryRing {
+ public:
+  struct Summary {
+    uint16_t min = TELEMETRY_UNKNOWN;
+    uint16_t avg = TELEMETRY_UNKNOWN;  ///< rounded
+    uint16_t max = TELEMETRY_UNKNOWN;
+  };
+
+  void push(uint32_t second, const uint16_t* values) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t slot = (_first + _count) % Size;
+    if (_count == Size)
+      _first = (_first + 1) % Size;
+    else
+      _count++;
+    _seconds[slot] = second;
+    for (size_t column = 0; column < Columns; column++) _values[slot][column] = values[column];
+  }
+
+  size_t count() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _count;
+  }
+
+  /// Value of column in sample n, 0 the oldest.
+  uint16_t at(size_t n, size_t column) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _values[(_first + n) % Size][column];
+  }
+
+  /// The most recent value of column.
+  uint16_t last(size_t column) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _count ? _values[(_first + _count - 1) % Size][column] : TELEMETRY_UNKNOWN;
+  }
+
+  Summary summary(size_t column) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Summary summary;
+    uint32_t sum = 0, known = 0;
+    for (size_t n = 0; n < _count; n++) {
+      uint16_t value = _values[(_first + n) % Size][column];
+      if (value == TELEMETRY_UNKNOWN) continue;
+      if (!known || value < summary.min) summary.min = value;
+      if (!known || value > summary.max) summary.max = value;
+      sum += value;
+      known++;
+    }
+    if (known) summary.avg = (sum + known / 2) / known;
+    return summary;
+  }
+
+  /// Writes the samples as CSV, a header line first ("second" and the column names), one write(line, length) per line.
+  /// The ring is not locked while writing (a slow HTTP client): a second pushed meanwhile is appended, none repeated.
+  template <typename Write>
+  void csv(const TelemetryColumn* columns, Write&& write) const {
+    char line[32 + Columns * 24];
+    size_t length = snprintf(line, sizeof(line), "second");
+    for (size_t column = 0; column < Columns; column++) length += snprintf(line + length, sizeof(line) - length, ",%s", columns[column].name);
+    length += snprintf(line + length, sizeof(line) - length, "\n");
+    write(line, length);
+
+    bool any = false;
+    uint32_t written = 0;  // the last second written
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        size_t n = 0;
+        while (n < _count && any && _seconds[(_first + n) % Size] <= written) n++;
+        if (n == _count) break;
+        size_t slot = (_first + n) % Size;
+        length = snprintf(line, sizeof(line), "%u", (unsigned)_seconds[slot]);
+        for (size_t column = 0; column < Columns; column++) {
+          length += snprintf(line + length, sizeof(line) - length, ",");
+          length += format(line + length, sizeof(line) - length, _values[slot][column], columns[column].decimals);
+        }
+        length += snprintf(line + length, sizeof(line) - length, "\n");
+        written = _seconds[slot];
+        any = true;
+      }
+      write(line, length);
+    }
+  }
+
+  /// value stored times 10^decimals as text ("12.5"), empty if unknown.
+  static size_t format(char* text, size_t size, uint16_t value, uint8_t decimals) {
+    if (value == TELEMETRY_UNKNOWN) return 0;
+    if (!decimals) return snprintf(text, size, "%u", (unsigned)value);
+    unsigned scale = 1;
+    for (uint8_t n = 0; n < decimals; n++) scale *= 10;
+    return snprintf(text, size, "%u.%0*u", (unsigned)(value / scale), (int)decimals, (unsigned)(value % scale));
+  }
+
+ private:
+  uint32_t _seconds[Size] = {};
+  uint16_t _values[Size][Columns] = {};
+  size_t _first = 0;
+  size_t _count = 0;
+  mutable std::mutex _mutex;
+};
@@ -0,0 +1,173 @@
+/**
+    @title     MoonLight
+    @file      MonitorCodec.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/lightscontrol/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Compressed monitor stream: the channels sent to Monitor.svelte, as keyframes and XOR deltas against
+    the previous frame, run-length coded, optionally downsampled (every step-th light).
+    Decoder counterpart: decodeMonitorFrame() in interface/src/routes/moonbase/monitor/monitor.ts.
+    This header has NO ESP32, FreeRTOS, or FastLED dependencies and can be included in native unit tests.
+
+    Frame (little endian):
+      0: 'M' | 1: flags (bit 0 = keyframe) | 2: channelsPerLight | 3: step | 4-7: length | RLE payload
+    length: bytes of the downsampled frame (ceil(nrOfLights / step) × channelsPerLight)
+    payload: decoded to length bytes; a keyframe holds the channels, a delta frame channels XOR previous frame
+    RLE:  c < 0x80:  c + 1 literal bytes follow
+          c < 0xFF:  next byte repeated c - 0x80 + 3 times (3..129)
+          c == 0xFF: varint count (LEB128), then the byte repeated count times (long runs, e.g. unchanged lights)
+    A frame is never 47 bytes (headerPrimeNumber, the size of the LightsHeader message): it is padded to 48.
+**/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#define MONITOR_FRAME_HEADER 8
+#define MONITOR_FLAG_KEYFRAME 0x01
+
+/// Bytes of the downsampled frame.
+inline size_t monitorFrameLength(uint32_t nrOfLights, uint8_t channelsPerLight, uint8_t step) {
+  if (step < 1) step = 1;
+  return (size_t)((nrOfLights + step - 1) / step) * channelsPerLight;
+}
+
+/// Worst case size of an encoded frame of length bytes (all literals, + padding byte).
+inline size_t monitorMaxEncodedSize(size_t length) { return MONITOR_FRAME_HEADER + length + (length + 127) / 128 + 1; }
+
+/// Encodes frames against the previous one. Owns no memory: previous (monitorFrameLength bytes, the frame
+/// as the client holds it) and out (monitorMaxEncodedSize bytes) are passed in by the caller.
+class MonitorEncoder {
+ public:
+  uint16_t keyframeInterval = 50;  // a keyframe at least every this many frames, so new or lagging clients catch up
+
+  /// Next frame is a keyframe (new client, new layout, other step).
+  void requestKeyframe() { _framesSinceKey = UINT16_MAX; }
+
+  /// Encodes channels (nrOfLights × channelsPerLight bytes) into out, updating previous. Returns the frame size.
+  size_t encode(const uint8_t* channels, uint32_t nrOfLights, uint8_t channelsPerLight, uint8_t step, uint8_t* previous, uint8_t* out) {
+    if (step < 1) step = 1;
+    size_t length = monitorFrameLength(nrOfLights, channelsPerLight, step);
+    bool keyframe = _framesSinceKey >= keyframeInterval;
+    _framesSinceKey = keyframe ? 0 : _framesSinceKey + 1;
+
+    out[0] = 'M';
+    out[1] = keyframe ? MONITOR_FLAG_KEYFRAME : 0;
+    out[2] = channelsPerLight;
+    out[3] = step;
+    out[4] = length;
+    out[5] = length >> 8;
+    out[6] = length >> 16;
+    out[7] = length >> 24;
+    _out = out + MONITOR_FRAME_HEADER;
+    _literals = 0;
+    _runLength = 0;
+
+    size_t i = 0;
+    for (uint32_t light = 0; light < nrOfLights; light += step) {
+      const uint8_t* channel = &channels[(size_t)light * channelsPerLight];
+      for (uint8_t c = 0; c < channelsPerLight; c++, i++) {
+        uint8_t value = channel[c];
+        put(keyframe ? value : value ^ previous[i]);
+        previous[i] = value;
+      }
+    }
+    flushRun();
+    flushLiterals();
+
+    size_t size = _out - out;
+    if (size == 47) out[size++] = 0;  // 47 bytes is the LightsHeader message, trailing bytes are ignored by the decoder
+    return size;
+  }
+
+ private:
+  uint16_t _framesSinceKey = UINT16_MAX;
+  uint8_t* _out = nullptr;
+  uint8_t _literal[128];
+  uint8_t _literals = 0;
+  uint8_t _runValue = 0;
+  uint32_t _runLength = 0;
+
+  void put(uint8_t value) {
+    if (_runLength && value == _runValue) {
+      _runLength++;
+      return;
+    }
+    flushRun();
+    _runValue = value;
+    _runLength = 1;
+  }
+
+  void flushRun() {
+    if (_runLength >= 3) {
+      flushLiterals();
+      if (_runLength <= 129) {
+        *_out++ = 0x80 + _runLength - 3;
+      } else {
+        *_out++ = 0xFF;
+        uint32_t count = _runLength;
+        do {
+          *_out++ = (count & 0x7F) | (count > 0x7F ? 0x80 : 0);
+          count >>= 7;
+        } while (count);
+      }
+      *_out++ = _runValue;
+    } else {
+      for (uint32_t r = 0; r < _runLength; r++) {
+        _literal[_literals++] = _runValue;
+        if (_literals == 128) flushLiterals();
+      }
+    }
+    _runLength = 0;
+  }
+
+  void flushLiterals() {
+    if (!_literals) return;
+    *_out++ = _literals - 1;
+    memcpy(_out, _literal, _literals);
+    _out += _literals;
+    _literals = 0;
+  }
+};
+
+/// Decodes a frame into frame (frameSize bytes, the previous frame for delta frames). Returns the decoded length,
+/// 0 if the data is not a valid frame or does not fit. Native counterpart of decodeMonitorFrame() in monitor.ts.
+inline size_t decodeMonitorFrame(const uint8_t* data, size_t size, uint8_t* frame, size_t frameSize) {
+  if (size < MONITOR_FRAME_HEADER || data[0] != 'M') return 0;
+  bool keyframe = data[1] & MONITOR_FLAG_KEYFRAME;
+  size_t length = data[4] | (data[5] << 8) | (data[6] << 16) | ((size_t)data[7] << 24);
+  if (length > frameSize) return 0;
+  size_t in = MONITOR_FRAME_HEADER, out = 0;
+  while (out < length && in < size) {
+    uint8_t c = data[in++];
+    size_t count;
+    if (c < 0x80) {  // literals
+      count = c + 1;
+      if (in + count > size || out + count > length) return 0;
+      for (size_t k = 0; k < count; k++, out++) frame[out] = keyframe ? data[in + k] : frame[out] ^ data[in + k];
+      in += count;
+      continue;
+    }
+    if (c < 0xFF) {
+      count = c - 0x80 + 3;
+    } else {
+      count = 0;
+      for (uint8_t shift = 0;; shift += 7) {
+        if (in >= size || shift > 28) return 0;
+        uint8_t b = data[in++];
+        count |= (size_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+      }
+    }
+    if (in >= size || out + count > length) return 0;
+    uint8_t value = data[in++];
+    for (size_t k = 0; k < count; k++, out++) frame[out] = keyframe ? value : frame[out] ^ value;
+  }
+  return out == length ? length : 0;
+}
@@ -34,6 +34,9 @@ PhysicalLayer::PhysicalLayer() : ledPins{}, ledPinsAssigned{}, ledsPerPin{} {
 
   if (effectsMutex == nullptr) EXT_LOGE(ML_TAG, "Failed to create effectsMutex");
   if (driversMutex == nullptr) EXT_LOGE(ML_TAG, "Failed to create driversMutex");
+  if (commandsProducerMutex == nullptr) EXT_LOGE(ML_TAG, "Failed to create commandsProducerMutex");
+  if (paletteMutex == nullptr) EXT_LOGE(ML_TAG, "Failed to create paletteMutex");
+  if (overridesMutex == nullptr) EXT_LOGE(ML_TAG, "Failed to create overridesMutex");
 }
 
 PhysicalLayer::~PhysicalLayer() {
@@ -45,6 +48,53 @@ PhysicalLayer::~PhysicalLayer() {
     vSemaphoreDelete(driversMutex);
     driversMutex = NULL;
   }
+  if (commandsProducerMutex) {
+    vSemaphoreDelete(commandsProducerMutex);
+    commandsProducerMutex = NULL;
+  }
+  if (paletteMutex) {
+    vSemaphoreDelete(paletteMutex);
+    paletteMutex = NULL;
+  }
+  if (overridesMutex) {
+    vSemaphoreDelete(overridesMutex);
+    overridesMutex = NULL;
+  }
+}
+
+void PhysicalLayer::queueNodeCommand(const NodeCommand& command) {
+  if (!command.node || !command.node->layerMutex) return;
+  SpscQueue<NodeCommand, 32>& commands = (command.node->layerMutex == &driversMutex) ? driversCommands : effectsCommands;
+
+  xSemaphoreTake(commandsProducerMutex, portMAX_DELAY);
+  bool queued = commands.push(command);
+  xSemaphoreGive(commandsProducerMutex);
+
+  if (!queued) {
+    // queue full (render task stalled?): apply directly, the same way as before the queue existed
+    EXT_LOGW(ML_TAG, "node command queue full (dropped %d), applying directly", commands.dropped());
+    xSemaphoreTake(*command.node->layerMutex, portMAX_DELAY);
+    applyNodeCommands(commands);  // keep the order: older queued commands first
+    command.node->applyCommand(command, &commands == &driversCommands ? driversCommandsArena : effectsCommandsArena);
+    xSemaphoreGive(*command.node->layerMutex);
+  }
+}
+
+void PhysicalLayer::applyNodeCommands(SpscQueue<NodeCommand, 32>& commands) {
+  JsonArenaAllocator& arena = &commands == &driversCommands ? driversCommandsArena : effectsCommandsArena;
+  commands.drain([&arena](const NodeCommand& command) { command.node->applyCommand(command, arena); });
+}
+
+void PhysicalLayer::setPalette(const CRGBPalette16& target, uint32_t durationMs) {
+  xSemaphoreTake(paletteMutex, portMAX_DELAY);
+  paletteTransition.start(palette.entries, target.entries, durationMs, millis());
+  xSemaphoreGive(paletteMutex);
+}
+
+void PhysicalLayer::stopPaletteTransition() {
+  xSemaphoreTake(paletteMutex, portMAX_DELAY);
+  paletteTransition.stop();
+  xSemaphoreGive(paletteMutex);
 }
 
 VirtualLayer* PhysicalLayer::ensureLayer(uint8_t index) {
@@ -68,16 +118,49 @@ void PhysicalLayer::setup() {
 }
 
 void PhysicalLayer::loop() {
-  if (!lights.channelsD || lights.header.nrOfChannels == 0) return;  // no layout yet or alloc failed
+  // One mutex take per frame: apply the control changes queued since the last frame, then run
+  // all effect nodes lock-free. NodeManager takes effectsMutex only to add or remove nodes.
+  xSemaphoreTake(effectsMutex, portMAX_DELAY);
+  applyNodeCommands(effectsCommands);
+  if (paletteTransition.active()) {
+    xSemaphoreTake(paletteMutex, portMAX_DELAY);
+    paletteTransition.step(palette.entries, millis());
+    xSemaphoreGive(paletteMutex);
+  }
+  paletteLUT.update(palette, [this](uint8_t index) { return ColorFromPalette(palette, index); });  // a 48 byte compare if unchanged
+
+  if (!lights.channelsD || lights.header.nrOfChannels == 0) {  // no layout yet or alloc failed
+    xSemaphoreGive(effectsMutex);
+    return;
+  }
+
+  // start or stop the helper render workers here, on effectTask, so they inherit its priority and pick the other core(s)
+  if (parallelRender != (renderWorkers.nrOfWorkers() > 1)) {
+    if (parallelRender) {
+      uint8_t nrOfWorkers = renderWorkers.begin(portNUM_PROCESSORS - 1, EFFECTS_STACK_SIZE);
+      EXT_LOGI(ML_TAG, "multi-core rendering on %d workers", nrOfWorkers);
+      if (nrOfWorkers < 2) parallelRender = false;  // single core or task creation failed
+    } else {
+      renderWorkers.end();
+      EXT_LOGI(ML_TAG, "multi-core rendering off");
+    }
+  }
 
   // Effects write to per-layer virtualChannels; channelsD is zeroed and composited
   // in compositeLayers(), called from main.cpp after channelsDFreeSemaphore is signalled.
 
+  if (renderWorkers.nrOfWorkers() > 1) {
+    loopParallel();
+  } else {
+    for (uint8_t i = 0; i < activeLayerCount && i < layers.size(); i++) {
+      VirtualLayer* layer = layers[i];
+      if (layer) layer->loop();  // defensive, should not happen with sequential creation
+    }
+  }
+
   for (uint8_t i = 0; i < activeLayerCount && i < layers.size(); i++) {
     VirtualLayer* layer = layers[i];
-    if (!layer) continue;  // defensive, should not happen with sequential creation
-  
-    layer->loop();
+    if (!layer) continue;
 
     // Step transition animation: move transitionBrightness toward transitionTarget one step per frame
     if (layer->transitionStep != 0) {
@@ -90,6 +173,45 @@ void PhysicalLayer::loop() {
       layer->transitionBrightness = (uint8_t)next;
     }
   }
+
+  xSemaphoreGive(effectsMutex);
+}
+
+void PhysicalLayer::loopParallel() {
+  uint8_t nrOfLayers = MIN(activeLayerCount, MIN(layers.size(), sizeof(renderLoads) / sizeof(renderLoads[0])));
+
+  // fade and brightness reset on effectTask, then estimate the work per layer
+  for (uint8_t i = 0; i < nrOfLayers; i++) {
+    VirtualLayer* layer = layers[i];
+    RenderLoad& load = renderLoads[i];
+    load = RenderLoad();
+    if (!layer || !layer->prepareFrame()) continue;  // cost 0: nothing to render
+    uint8_t nrOfNodesOn = 0;
+    for (Node* node : layer->nodes) nrOfNodesOn += node->on;
+    load.cost = MAX(layer->nrOfLights, 1) * MAX(nrOfNodesOn, 1);
+    load.rows = MAX(layer->size.y, 1);
+    load.tileable = layer->isTileable();
+    load.pinned = layer->hasLiveScript();
+  }
+
+  uint8_t nrOfJobs = planRender(renderLoads, nrOfLayers, renderWorkers.nrOfWorkers(), renderJobs, RENDER_MAX_JOBS);
+
+  // per-frame state of tiled layers (time, positions) is advanced once, before any tile of it runs
+  for (uint8_t j = 0; j < nrOfJobs; j++) {
+    if (renderJobs[j].tiled && renderJobs[j].rowStart == 0) layers[renderJobs[j].layer]->prepareTiles();
+  }
+
+  auto work = [this, nrOfJobs](uint8_t worker) {
+    for (uint8_t j = 0; j < nrOfJobs; j++) {
+      const RenderJob& job = renderJobs[j];
+      if (job.worker != worker) continue;
+      if (job.tiled)
+        layers[job.layer]->loopTile(job.rowStart, job.rowEnd);
+      else
+        layers[job.layer]->loopNodes();
+    }
+  };
+  renderWorkers.run(work);  // returns when all workers are done: the barrier before compositeLayers()
 }
 
 void PhysicalLayer::compositeLayers() {
@@ -102,6 +224,31 @@ void PhysicalLayer::compositeLayers() {
     if (!layer) continue;
     layer->compositeTo(lights.channelsD, lights.header);
   }
+
+  if (!channelOverrides.empty()) {  // no lock when nothing is overridden, the usual case
+    xSemaphoreTake(overridesMutex, portMAX_DELAY);
+    channelOverrides.apply(lights.channelsD, lights.header.nrOfChannels);
+    xSemaphoreGive(overridesMutex);
+  }
+}
+
+bool PhysicalLayer::overrideChannel(uint32_t channel, uint8_t value, uint8_t mode) {
+  xSemaphoreTake(overridesMutex, portMAX_DELAY);
+  bool set = channelOverrides.set(channel, value, mode);
+  xSemaphoreGive(overridesMutex);
+  return set;
+}
+
+void PhysicalLayer::releaseChannel(uint32_t channel) {
+  xSemaphoreTake(overridesMutex, portMAX_DELAY);
+  channelOverrides.release(channel);
+  xSemaphoreGive(overridesMutex);
+}
+
+void PhysicalLayer::releaseChannels() {
+  xSemaphoreTake(overridesMutex, portMAX_DELAY);
+  channelOverrides.clear();
+  xSemaphoreGive(overridesMutex);
 }
 
 void PhysicalLayer::loop20ms() {
@@ -113,6 +260,10 @@ void PhysicalLayer::loop20ms() {
 }
 
 void PhysicalLayer::loopDrivers() {
+  // One mutex take per frame, see loop(): queued control changes first, then mapping and driver nodes lock-free
+  xSemaphoreTake(driversMutex, portMAX_DELAY);
+  applyNodeCommands(driversCommands);
+
   // run mapping in the drivers task
 
   if (requestMapPhysical) {
@@ -128,7 +279,10 @@ void PhysicalLayer::loopDrivers() {
   if (requestMapVirtual) {
     // wait until monitor has consumed the positions from pass 1 before running pass 2,
     // because pass 2 writes to channelsD which pass 1 used to store position data
-    if (lights.header.isPositions == 2) return;  // will retry next loopDrivers() iteration
+    if (lights.header.isPositions == 2) {  // will retry next loopDrivers() iteration
+      xSemaphoreGive(driversMutex);
+      return;
+    }
 
     EXT_LOGD(ML_TAG, "mapLayout virtual requested");
 
@@ -142,41 +296,36 @@ void PhysicalLayer::loopDrivers() {
   if (prevSize != lights.header.size) EXT_LOGD(ML_TAG, "onSizeChanged P %d,%d,%d -> %d,%d,%d", prevSize.x, prevSize.y, prevSize.z, lights.header.size.x, lights.header.size.y, lights.header.size.z);
 
   for (Node* node : nodes) {
-    if (prevSize != lights.header.size) {
-      xSemaphoreTake(*node->layerMutex, portMAX_DELAY);
-      node->onSizeChanged(prevSize);
-      xSemaphoreGive(*node->layerMutex);
-    }
+    if (prevSize != lights.header.size) node->onSizeChanged(prevSize);
     if (node->on) {
-      xSemaphoreTake(*node->layerMutex, portMAX_DELAY);
       node->loop();
-      xSemaphoreGive(*node->layerMutex);
       addYield(10);
     }
   }
 
   prevSize = lights.header.size;
+
+  xSemaphoreGive(driversMutex);
 }
 
 void PhysicalLayer::loop20msDrivers() {
   // runs the loop of all effects / nodes in the layer
+  xSemaphoreTake(driversMutex, portMAX_DELAY);
   for (Node* node : nodes) {
     if (node->on) {
-      xSemaphoreTake(*node->layerMutex, portMAX_DELAY);
       node->loop20ms();
-      xSemaphoreGive(*node->layerMutex);
       addYield(10);
     }
   }
+  xSemaphoreGive(driversMutex);
 }
 
 void PhysicalLayer::mapLayout() {
+  // caller holds driversMutex (loopDrivers or the monitor pass in ModuleEffects)
   onLayoutPre();
   for (Node* node : nodes) {
     if (node->on) {  // && node->hasOnLayout
-      xSemaphoreTake(*node->layerMutex, portMAX_DELAY);
       node->onLayout();
-      xSemaphoreGive(*node->layerMutex);
     }
   }
   onLayoutPost();
@@ -213,6 +362,7 @@ void PhysicalLayer::onLayoutPre() {
     }
   } else if (pass == 2) {
     indexP = 0;
+    gridWiring.reset();
     for (VirtualLayer* layer : layers) {
       if (layer) layer->onLayoutPre();
     }
@@ -239,21 +389,7 @@ void PhysicalLayer::addLight(Coord3D position) {
 
   if (pass == 1) {
     // EXT_LOGD(ML_TAG, "%d,%d,%d", position.x, position.y, position.z);
-    // Grow channelsD on demand as lights are added (doubling strategy, limited by system memory).
-    // Avoids one large upfront allocation; for unchanged layouts: zero reallocs.
-    size_t needed = ((size_t)lights.header.nrOfLights + 1) * 3;
-    if (needed > channelsDCapacity) {
-      size_t oldCapacity = channelsDCapacity;
-      size_t newCapacity = MAX(needed, oldCapacity > 0 ? oldCapacity * 2 : (size_t)768);
-      reallocMB2<uint8_t>(lights.channelsD, channelsDCapacity, newCapacity, "channelsD");
-      if (lights.channelsD && channelsDCapacity > oldCapacity) {
-        memset(lights.channelsD + oldCapacity, 0, channelsDCapacity - oldCapacity);
-        EXT_LOGD(ML_TAG, "channelsD grown from %d to %d bytes in %s", oldCapacity, (int)channelsDCapacity, isInPSRAM(lights.channelsD) ? "PSRAM" : "RAM");
-      } else if (!lights.channelsD) {
-        EXT_LOGE(ML_TAG, "failed to grow channelsD to %zu bytes", newCapacity);
-        channelsDCapacity = 0;
-      }
-    }
+    growChannelsD(lights.header.nrOfLights + 1);
     if (lights.channelsD && lights.header.nrOfLights < channelsDCapacity / 3) {
       packCoord3DInto3Bytes(&lights.channelsD[lights.header.nrOfLights * 3], position);  // positions in channelsD
     }
@@ -275,6 +411,87 @@ void PhysicalLayer::addLight(Coord3D position) {
   }
 }
 
+bool PhysicalLayer::growChannelsD(nrOfLights_t nrOfLights) {
+  // Grow channelsD on demand as lights are added (doubling strategy, limited by system memory).
+  // Avoids one large upfront allocation; for unchanged layouts: zero reallocs.
+  size_t needed = (size_t)nrOfLights * 3;
+  if (needed > channelsDCapacity) {
+    size_t oldCapacity = channelsDCapacity;
+    size_t newCapacity = MAX(needed, oldCapacity > 0 ? oldCapacity * 2 : (size_t)768);
+    reallocMB2<uint8_t>(lights.channelsD, channelsDCapacity, newCapacity, "channelsD", MemChannels);
+    if (lights.channelsD && channelsDCapacity > oldCapacity) {
+      memset(lights.channelsD + oldCapacity, 0, channelsDCapacity - oldCapacity);
+      EXT_LOGD(ML_TAG, "channelsD grown from %d to %d bytes in %s", oldCapacity, (int)channelsDCapacity, isInPSRAM(lights.channelsD) ? "PSRAM" : "RAM");
+    } else if (!lights.channelsD) {
+      EXT_LOGE(ML_TAG, "failed to grow channelsD to %zu bytes", newCapacity);
+      channelsDCapacity = 0;
+    }
+  }
+  return lights.channelsD != nullptr;
+}
+
+void PhysicalLayer::addLights(const Coord3D* positions, size_t count) {
+  if (pass != 1) {
+    for (size_t n = 0; n < count; n++) addLight(positions[n]);  // each light fans out to the virtual layers
+    return;
+  }
+
+  if (safeModeMB) count = MIN(count, lights.header.nrOfLights < 1024 ? 1024 - lights.header.nrOfLights : 0);
+  growChannelsD(lights.header.nrOfLights + count);  // once for all
+  for (size_t n = 0; n < count; n++) {
+    Coord3D position = positions[n].maximum(Coord3D(0, 0, 0));
+    if (lights.channelsD && lights.header.nrOfLights < channelsDCapacity / 3) packCoord3DInto3Bytes(&lights.channelsD[lights.header.nrOfLights * 3], position);
+    lights.header.size = lights.header.size.maximum(position);
+    lights.header.nrOfLights++;
+  }
+}
+
+void PhysicalLayer::addLights(const LightGrid& grid, size_t first, size_t count) {
+  if (first >= grid.count()) return;
+  count = MIN(count, grid.count() - first);
+  if (grid.origin.x < 0 || grid.origin.y < 0 || grid.origin.z < 0) {  // clamped per light
+    grid.forEach(first, count, [this](Coord3D position) { addLight(position); });
+    return;
+  }
+
+  if (pass == 1) {
+    if (safeModeMB) count = MIN(count, lights.header.nrOfLights < 1024 ? 1024 - lights.header.nrOfLights : 0);
+    growChannelsD(lights.header.nrOfLights + count);
+    nrOfLights_t index = lights.header.nrOfLights;
+    size_t positions = lights.channelsD ? channelsDCapacity / 3 : 0;
+    Coord3D size = lights.header.size;
+    grid.forEach(first, count, [&](Coord3D position) {
+      if (index < positions) packCoord3DInto3Bytes(&lights.channelsD[index * 3], position);
+      size = size.maximum(position);
+      index++;
+    });
+    lights.header.size = size;
+    lights.header.nrOfLights = index;
+  } else {  // pass == 2
+    if (safeModeMB && lights.header.nrOfLights > 1023) return;
+
+    nrOfLights_t firstIndexP = indexP;
+    for (VirtualLayer* layer : layers) {
+      if (layer && !layer->canAddLights(grid)) {  // modifiers or part of the grid: light by light
+        grid.forEach(first, count, [this](Coord3D position) { addLight(position); });
+        gridWiring.add(grid, first, indexP - firstIndexP, firstIndexP);  // after the lights: deferred layers rebuild from the grids before
+        return;
+      }
+    }
+
+    bool anyCovered = false;
+    for (VirtualLayer* layer : layers) {
+      if (layer) anyCovered |= layer->addLights(grid, first, count);
+    }
+    if (!anyCovered && lights.channelsD) {  // as addLight(): no stale values of a previous layout
+      uint8_t cpl = lights.header.channelsPerLight;
+      memset(&lights.channelsD[indexP * cpl], 0, count * cpl);
+    }
+    indexP += count;
+    gridWiring.add(grid, first, count, firstIndexP);
+  }
+}
+
 void PhysicalLayer::nextPin(uint8_t ledPinDIO) {
   if (pass == 1 && !monitorPass) {
     nrOfLights_t prevNrOfLights = 0;
@@ -314,7 +531,7 @@ void PhysicalLayer::onLayoutPost() {
     size_t needed = (size_t)lights.header.nrOfChannels;
     if (needed > 0 && needed != channelsDCapacity) {
       size_t oldCapacity = channelsDCapacity;
-      reallocMB2<uint8_t>(lights.channelsD, channelsDCapacity, needed, "channelsD");
+      reallocMB2<uint8_t>(lights.channelsD, channelsDCapacity, needed, "channelsD", MemChannels);
       if (lights.channelsD) {
         if (channelsDCapacity > oldCapacity)
           memset(lights.channelsD + oldCapacity, 0, channelsDCapacity - oldCapacity);
@@ -328,6 +545,10 @@ void PhysicalLayer::onLayoutPost() {
     // ledsDriver.init(lights, sortedPins); //init the driver with the sorted pins and lights
   } else if (pass == 2) {
     EXT_LOGD(ML_TAG, "pass %d indexP: %d", pass, indexP);
+    if (gridWiring.finish(indexP)) {
+      const TileWiring& wiring = gridWiring.wiring();
+      EXT_LOGD(ML_TAG, "wiring: %d x %d x %d tiles of %d x %d x %d", wiring.tiles.size[0], wiring.tiles.size[1], wiring.tiles.size[2], wiring.tile.size[0], wiring.tile.size[1], wiring.tile.size[2]);
+    }
     for (VirtualLayer* layer : layers) {
       if (layer) layer->onLayoutPost();
     }
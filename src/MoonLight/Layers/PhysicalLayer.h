@@ -18,6 +18,14 @@
   #include "FastLED.h"
   #include "MoonBase/utilities/PlatformFunctions.h"
   #include "LightsHeader.h"  // pure types: nrOfLights_t, LightsHeader, Lights — no ESP32 deps
+  #include "MoonBase/utilities/PaletteLUT.h"         // pure: 256 colors of the palette
+  #include "MoonBase/utilities/PaletteTransition.h"  // pure: palette crossfade
+  #include "MoonBase/utilities/SpscQueue.h"
+  #include "MoonBase/utilities/ControlTable.h"  // pure: CONTROL_NAME_MAX
+  #include "MoonBase/utilities/ChannelOverrides.h"  // pure: sorted channel overrides
+  #include "MoonBase/utilities/LightRuns.h"         // pure: grids, lines and rings of lights
+  #include "MoonBase/utilities/MappingDescriptor.h"  // pure: the wiring of grids, analytic mappings
+  #include "RenderScheduler.h"  // pure: planRender, RenderWorkers — no FastLED deps
 
 // #include "VirtualLayer.h"
 
@@ -26,6 +34,24 @@ class VirtualLayer;
 class Node;
 class Modifier;
 
+// A control change for a node, queued by the task handling UI/state updates and applied by the
+// task that runs the node (effectTask or driverTask) at the start of its next frame.
+// The value is copied when queued: the render tasks never read the module's JsonDocument, which the HTTP task keeps changing.
+struct NodeCommand {
+  Node* node = nullptr;
+  bool isOnChange = false;  // true: nodes[i].on changed (onUpdate only), false: nodes[i].controls[j].value changed (updateControl + onUpdate)
+  bool isText = false;      // the value is in text, else in number (or coord for coord3D controls)
+  bool isCoord = false;
+  uintptr_t pointer = 0;  // control["p"] when queued: the variable the control was bound to
+  char type[12] = {};     // control["type"], size and max: for controls not in the node's controlTable (::updateControl)
+  uint8_t size = 0;
+  int32_t max = -1;       // -1: no max
+  double number = 0;      // numbers, checkboxes and on
+  Coord3D coord;
+  char name[CONTROL_NAME_MAX] = {};
+  char text[32] = {};  // text controls of nodes are at most 32 bytes (Char<32>)
+};
+
 // ----------------------------------------------------------------------------
 // PhysicalLayer — top-level owner of the Lights data and all VirtualLayers.
 // Manages the layout mapping pipeline (pass 1 = physical, pass 2 = virtual),
@@ -43,6 +69,24 @@ class PhysicalLayer {
   // Shared colour palette, used by effects that don't define their own.
   CRGBPalette16 palette = PartyColors_p;
 
+  // The 256 colors of palette, expanded at the start of a frame when palette changed (palette select, audio
+  // palettes, palette LiveScripts). Effects use colorFromPalette() instead of ColorFromPalette(layerP.palette, ...).
+  PaletteLUT<CRGB> paletteLUT;
+
+  // ColorFromPalette(palette, index, brightness) (LINEARBLEND) as a lookup.
+  CRGB colorFromPalette(uint8_t index, uint8_t brightness = 255) const { return paletteLUT.color(index, brightness); }
+
+  // Crossfade of palette to the palette selected in Lights Control (also by group sync), stepped by loop() a few
+  // entries per frame. paletteMutex serialises setPalette / stopPaletteTransition with the steps.
+  PaletteTransition<CRGB> paletteTransition;
+  SemaphoreHandle_t paletteMutex = xSemaphoreCreateMutex();
+
+  // Blend palette to target over durationMs, starting from the palette as shown (0: at once).
+  void setPalette(const CRGBPalette16& target, uint32_t durationMs);
+
+  // Stop blending, before a writer takes over the palette entries (palette LiveScripts, audio palettes).
+  void stopPaletteTransition();
+
   // Layout remap request flags, consumed at the start of loopDrivers().
   // IMPORTANT: setting requestMapPhysical (pass 1) automatically triggers
   // requestMapVirtual (pass 2) in loopDrivers() — pass 2 must always follow
@@ -58,13 +102,49 @@ class PhysicalLayer {
   // Current physical light index, incremented by addLight() during pass 2.
   nrOfLights_t indexP = 0;
 
+  // The grids added by addLights() during pass 2. After it, gridWiring.valid() if all lights are equal tiles
+  // (panels, a cube) wired one after the other: virtual layers then map them analytically (MappingDescriptor.h).
+  GridWiring gridWiring;
+
   // Previous size, used to detect size changes and trigger onSizeChanged().
   Coord3D prevSize;
 
   // Mutexes protecting the effects and drivers task respectively.
+  // Taken once per frame by loop() / loopDrivers() (not per node call): inside it queued node commands
+  // are applied and all nodes run. Other tasks only take it to add/remove nodes or run a monitor pass.
   SemaphoreHandle_t effectsMutex = xSemaphoreCreateMutex();
   SemaphoreHandle_t driversMutex = xSemaphoreCreateMutex();
 
+  // Control changes waiting to be applied by effectTask / driverTask (one queue per consumer task).
+  SpscQueue<NodeCommand, 32> effectsCommands;
+  SpscQueue<NodeCommand, 32> driversCommands;
+
+  // The JSON control onUpdate gets per applied command, carved from a buffer per consumer task: no heap allocation per
+  // control change on the render tasks (JsonArenaAllocator, MemAlloc.h).
+  JsonArenaAllocator effectsCommandsArena{1536};
+  JsonArenaAllocator driversCommandsArena{1536};
+
+  // Serialises producers (HTTP, SvelteKit loop, ...) so each command queue keeps a single producer.
+  // Only taken on control changes, never by the render tasks.
+  SemaphoreHandle_t commandsProducerMutex = xSemaphoreCreateMutex();
+
+  // Queue a control change for the task running command.node. When the queue is full the command is
+  // applied directly under the node's layerMutex (the pre-queue behaviour).
+  void queueNodeCommand(const NodeCommand& command);
+
+  // Apply all queued commands of one queue. Caller must hold the matching layerMutex
+  // (effectsMutex for effectsCommands, driversMutex for driversCommands).
+  void applyNodeCommands(SpscQueue<NodeCommand, 32>& commands);
+
+  // Multi-core rendering (Lights Control multiCore, dual-core ESP32 only): set by the UI, applied by loop() on effectTask,
+  // which starts/stops the helper render task(s) so they inherit its priority and run on the other core.
+  // Only layers with tile-safe effects are rendered on the helpers (large ones split into row bands), the others stay on
+  // effectTask: effects that are not tile-safe share globals. Off by default.
+  bool parallelRender = false;
+  RenderWorkers renderWorkers;
+  RenderLoad renderLoads[16];  // per layer slot, members to keep them off the effectTask stack
+  RenderJob renderJobs[RENDER_MAX_JOBS];
+
   PhysicalLayer();
   ~PhysicalLayer();
 
@@ -82,11 +162,31 @@ class PhysicalLayer {
   // after channelsDFreeSemaphore confirms the driver has finished reading channelsD.
   void loop();
 
+  // Render all layers of one frame on renderWorkers (effectTask is worker 0). Returns after all workers
+  // finished (barrier), so compositeLayers() sees complete virtualChannels. Caller holds effectsMutex.
+  void loopParallel();
+
   // Composite all virtual layers into channelsD.
   // Called from effectTask under swapMutex after channelsDFreeSemaphore confirms the driver
-  // has finished reading channelsD. Zeroes the buffer first so additive blending starts clean.
+  // has finished reading channelsD. Zeroes the buffer first so additive blending starts clean,
+  // applies channelOverrides last.
   void compositeLayers();
 
+  // Physical channels held by the Channels module, Network In (override mode) or a LiveScript while effects keep
+  // running: applied by compositeLayers() after the layers. overridesMutex serialises the writers with it, and is
+  // not taken when there are no overrides.
+  ChannelOverrides<128> channelOverrides;
+  SemaphoreHandle_t overridesMutex = xSemaphoreCreateMutex();
+
+  // Hold channel (index in channelsD) at value, mode a ChannelOverrideMode. False if 128 channels are held already.
+  bool overrideChannel(uint32_t channel, uint8_t value, uint8_t mode = OverrideSet);
+
+  // Give channel back to the effects.
+  void releaseChannel(uint32_t channel);
+
+  // Give all channels back to the effects.
+  void releaseChannels();
+
   // Run 20 ms periodic updates across all virtual layers (called from effectTask(), Core 0).
   void loop20ms();
 
@@ -116,6 +216,32 @@ class PhysicalLayer {
   // Pass 2: forward to all virtual layers to build their mapping tables.
   void addLight(Coord3D position);
 
+  // Register count lights at once, as addLight() for each. Pass 1 grows channelsD once for all of them.
+  void addLights(const Coord3D* positions, size_t count);
+
+  // Register lights first .. first + count of grid (default all), as addLight() for each. Pass 1 takes the size from
+  // the grid's corners, pass 2 lets each virtual layer map the grid by arithmetic (VirtualLayer::addLights) unless a
+  // layer has modifiers or only holds part of the grid.
+  void addLights(const LightGrid& grid, size_t first = 0, size_t count = SIZE_MAX);
+
+  // Register the lights generate(n, position) returns true for, n from 0 to count, in chunks (lines, rings).
+  template <typename Generator>
+  void addLights(size_t count, Generator&& generate) {
+    Coord3D chunk[32];
+    size_t used = 0;
+    for (size_t n = 0; n < count; n++) {
+      if (!generate(n, chunk[used])) continue;
+      if (++used == 32) {
+        addLights(chunk, used);
+        used = 0;
+      }
+    }
+    if (used) addLights(chunk, used);
+  }
+
+  // Pass 1: grow channelsD (doubling) to hold the positions of nrOfLights lights. False if out of memory.
+  bool growChannelsD(nrOfLights_t nrOfLights);
+
   // Signal that the next lights added belong to the next LED pin.
   // ledPin: explicit pin override (UINT8_MAX = use sequential order).
   void nextPin(uint8_t ledPin = UINT8_MAX);
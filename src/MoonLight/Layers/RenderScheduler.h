@@ -0,0 +1,294 @@
+/**
+    @title     MoonLight
+    @file      RenderScheduler.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/architecture/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    Multi-core render scheduling: splits one effect frame into jobs (whole layers or row tiles)
+    and runs them on effectTask plus helper workers, with a barrier at the end.
+    On ESP32 the helpers are FreeRTOS tasks pinned to the other core(s); on host they are
+    std::threads, so the scheduler can be tested natively. No FastLED dependencies.
+**/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef ARDUINO
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/semphr.h>
+  #include <freertos/task.h>
+#else
+  #include <condition_variable>
+  #include <mutex>
+  #include <thread>
+#endif
+
+// Maximum number of workers including the calling task (effectTask = worker 0).
+#define RENDER_MAX_WORKERS 4
+// Maximum number of jobs in one frame plan: 16 layers, each tiled into at most one band per worker.
+#define RENDER_MAX_JOBS (16 * RENDER_MAX_WORKERS)
+
+// ----------------------------------------------------------------------------
+// Plan: which worker renders which layer (or which rows of a layer)
+// ----------------------------------------------------------------------------
+
+/// Render work of one layer for this frame, input for planRender().
+/// Only tile-safe work leaves worker 0: effects that are not tile-safe share globals (random16 seed, static buffers),
+/// so layers that are not tileable run on effectTask one after the other, as without multi-core rendering.
+struct RenderLoad {
+  uint32_t cost = 0;      // estimated work, e.g. nrOfLights × active effects; 0 = nothing to render
+  uint16_t rows = 1;      // number of rows (size.y) the layer can be split in
+  bool tileable = false;  // all active effects are tile-safe (see Node::isTileSafe()) and no modifiers
+  bool pinned = false;    // must run on worker 0 (e.g. LiveScript nodes synchronising with effectTask)
+};
+
+/// One unit of work: a whole layer, or rows [rowStart, rowEnd) of a tileable layer (all rows if it is not split).
+struct RenderJob {
+  uint8_t layer = 0;
+  uint8_t worker = 0;
+  bool tiled = false;  // false: whole layer (VirtualLayer::loopNodes, worker 0), true: row tile (VirtualLayer::loopTile)
+  uint16_t rowStart = 0;
+  uint16_t rowEnd = 0;  // exclusive
+  uint32_t cost = 0;
+};
+
+/// Distribute the layers of one frame over nrOfWorkers workers.
+/// Tileable layers with at least minTileCost work are split into one row band per worker, then the jobs of tileable
+/// layers are assigned longest-first to the least loaded worker. Pinned and not tileable layers always run on worker 0.
+/// Returns the number of jobs written to jobs (at most maxJobs). Jobs of layers that did not fit are dropped,
+/// so callers size jobs with RENDER_MAX_JOBS.
+inline uint8_t planRender(const RenderLoad* loads, uint8_t nrOfLayers, uint8_t nrOfWorkers, RenderJob* jobs, uint8_t maxJobs, uint32_t minTileCost = 1024) {
+  if (nrOfWorkers < 1) nrOfWorkers = 1;
+  if (nrOfWorkers > RENDER_MAX_WORKERS) nrOfWorkers = RENDER_MAX_WORKERS;
+
+  uint8_t nrOfJobs = 0;
+  for (uint8_t l = 0; l < nrOfLayers; l++) {
+    const RenderLoad& load = loads[l];
+    if (load.cost == 0) continue;
+    bool helpers = load.tileable && !load.pinned;  // may run off worker 0
+    uint8_t tiles = (nrOfWorkers > 1 && helpers && load.cost >= minTileCost) ? nrOfWorkers : 1;
+    if (tiles > load.rows) tiles = load.rows > 0 ? load.rows : 1;
+    for (uint8_t t = 0; t < tiles && nrOfJobs < maxJobs; t++) {
+      RenderJob& job = jobs[nrOfJobs++];
+      job.layer = l;
+      job.worker = 0;
+      job.tiled = helpers;  // also one tile: loopFrame() stays on effectTask (prepareTiles), only loopRows() moves
+      job.rowStart = (uint32_t)load.rows * t / tiles;
+      job.rowEnd = (uint32_t)load.rows * (t + 1) / tiles;
+      job.cost = tiles > 1 ? (uint64_t)load.cost * (job.rowEnd - job.rowStart) / load.rows : load.cost;
+    }
+  }
+
+  // longest processing time first: sort by cost, descending (insertion sort, stable, few jobs)
+  for (uint8_t i = 1; i < nrOfJobs; i++) {
+    RenderJob job = jobs[i];
+    uint8_t j = i;
+    while (j > 0 && jobs[j - 1].cost < job.cost) {
+      jobs[j] = jobs[j - 1];
+      j--;
+    }
+    jobs[j] = job;
+  }
+
+  uint64_t workerLoad[RENDER_MAX_WORKERS] = {};
+  for (uint8_t i = 0; i < nrOfJobs; i++) {  // worker 0 jobs first so the others can balance around them
+    if (!jobs[i].tiled) workerLoad[0] += jobs[i].cost;
+  }
+  for (uint8_t i = 0; i < nrOfJobs; i++) {
+    RenderJob& job = jobs[i];
+    if (!job.tiled) continue;  // worker 0
+    uint8_t best = 0;
+    for (uint8_t w = 1; w < nrOfWorkers; w++) {
+      if (workerLoad[w] < workerLoad[best]) best = w;
+    }
+    job.worker = best;
+    workerLoad[best] += job.cost;
+  }
+  return nrOfJobs;
+}
+
+/// Estimated duration of a plan: the cost of the busiest worker.
+inline uint64_t planMakespan(const RenderJob* jobs, uint8_t nrOfJobs) {
+  uint64_t workerLoad[RENDER_MAX_WORKERS] = {};
+  uint64_t makespan = 0;
+  for (uint8_t i = 0; i < nrOfJobs; i++) {
+    workerLoad[jobs[i].worker] += jobs[i].cost;
+    if (workerLoad[jobs[i].worker] > makespan) makespan = workerLoad[jobs[i].worker];
+  }
+  return makespan;
+}
+
+// ----------------------------------------------------------------------------
+// Workers: the calling task is worker 0, helpers are workers 1..n
+// ----------------------------------------------------------------------------
+
+/// Pool of helper workers that run one function per frame together with the calling task.
+/// run() returns when all workers have finished (the barrier before compositeLayers()).
+/// begin()/end() and run() must not be called concurrently (PhysicalLayer holds effectsMutex for all three).
+class RenderWorkers {
+ public:
+  RenderWorkers() = default;
+  ~RenderWorkers() { end(); }
+
+  RenderWorkers(const RenderWorkers&) = delete;
+  RenderWorkers& operator=(const RenderWorkers&) = delete;
+
+  /// Start nrOfHelpers helpers (capped at RENDER_MAX_WORKERS - 1). Returns the number of workers including the caller.
+  uint8_t begin(uint8_t nrOfHelpers, uint32_t stackSize = 4096) {
+    end();
+    if (nrOfHelpers > RENDER_MAX_WORKERS - 1) nrOfHelpers = RENDER_MAX_WORKERS - 1;
+#ifdef ARDUINO
+    _done = xSemaphoreCreateCounting(RENDER_MAX_WORKERS, 0);
+    if (!_done) return 1;
+    UBaseType_t priority = uxTaskPriorityGet(nullptr);  // same priority as effectTask
+    BaseType_t callerCore = xPortGetCoreID();
+    for (uint8_t h = 0; h < nrOfHelpers; h++) {
+      _helpers[h].pool = this;
+      _helpers[h].worker = h + 1;
+      BaseType_t core = (callerCore + 1 + h) % portNUM_PROCESSORS;  // spread over the other cores first
+      if (xTaskCreatePinnedToCore(helperTask, "AppRender", stackSize, &_helpers[h], priority, &_helpers[h].handle, core) != pdPASS) break;
+      _nrOfHelpers++;
+    }
+#else
+    (void)stackSize;
+    _stop = false;
+    for (uint8_t h = 0; h < nrOfHelpers; h++) {
+      _helpers[h].pool = this;
+      _helpers[h].worker = h + 1;
+      _helpers[h].generation = _generation;  // set before the thread starts so it can't miss the first run()
+      _helpers[h].thread = std::thread(helperThread, &_helpers[h]);
+      _nrOfHelpers++;
+    }
+#endif
+    return nrOfWorkers();
+  }
+
+  /// Stop and join all helpers.
+  void end() {
+#ifdef ARDUINO
+    if (_nrOfHelpers) {
+      _fun = nullptr;  // a notification without function = stop
+      for (uint8_t h = 0; h < _nrOfHelpers; h++) xTaskNotifyGive(_helpers[h].handle);
+      for (uint8_t h = 0; h < _nrOfHelpers; h++) xSemaphoreTake(_done, portMAX_DELAY);  // helper deletes itself after giving
+    }
+    if (_done) {
+      vSemaphoreDelete(_done);
+      _done = nullptr;
+    }
+#else
+    if (_nrOfHelpers) {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+        _generation++;
+      }
+      _start.notify_all();
+      for (uint8_t h = 0; h < _nrOfHelpers; h++) _helpers[h].thread.join();
+    }
+#endif
+    _nrOfHelpers = 0;
+  }
+
+  /// Number of workers including the calling task.
+  uint8_t nrOfWorkers() const { return _nrOfHelpers + 1; }
+
+  /// Run fun(worker) on every worker; the caller runs worker 0. Returns after all workers are done.
+  template <typename Fun>
+  void run(Fun& fun) {
+    runRaw([](void* context, uint8_t worker) { (*static_cast<Fun*>(context))(worker); }, &fun);
+  }
+
+ private:
+  typedef void (*WorkFun)(void* context, uint8_t worker);
+
+  struct Helper {
+    RenderWorkers* pool = nullptr;
+    uint8_t worker = 0;
+#ifdef ARDUINO
+    TaskHandle_t handle = nullptr;
+#else
+    std::thread thread;
+    uint32_t generation = 0;  // last run() generation seen
+#endif
+  };
+
+  Helper _helpers[RENDER_MAX_WORKERS - 1];
+  uint8_t _nrOfHelpers = 0;
+  WorkFun _fun = nullptr;
+  void* _context = nullptr;
+
+#ifdef ARDUINO
+  SemaphoreHandle_t _done = nullptr;  // each helper gives once per run()
+
+  static void helperTask(void* parameter) {
+    Helper* helper = static_cast<Helper*>(parameter);
+    RenderWorkers* pool = helper->pool;
+    while (true) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      WorkFun fun = pool->_fun;
+      if (!fun) break;
+      fun(pool->_context, helper->worker);
+      xSemaphoreGive(pool->_done);
+    }
+    xSemaphoreGive(pool->_done);
+    vTaskDelete(nullptr);
+  }
+
+  void runRaw(WorkFun fun, void* context) {
+    _fun = fun;
+    _context = context;
+    for (uint8_t h = 0; h < _nrOfHelpers; h++) xTaskNotifyGive(_helpers[h].handle);
+    fun(context, 0);
+    for (uint8_t h = 0; h < _nrOfHelpers; h++) xSemaphoreTake(_done, portMAX_DELAY);  // barrier
+  }
+#else
+  std::mutex _mutex;
+  std::condition_variable _start;
+  std::condition_variable _finished;
+  uint32_t _generation = 0;
+  uint8_t _pending = 0;
+  bool _stop = false;
+
+  static void helperThread(Helper* helper) {
+    RenderWorkers* pool = helper->pool;
+    while (true) {
+      WorkFun fun;
+      void* context;
+      {
+        std::unique_lock<std::mutex> lock(pool->_mutex);
+        pool->_start.wait(lock, [&] { return pool->_generation != helper->generation; });
+        helper->generation = pool->_generation;
+        if (pool->_stop) return;
+        fun = pool->_fun;
+        context = pool->_context;
+      }
+      fun(context, helper->worker);
+      {
+        std::lock_guard<std::mutex> lock(pool->_mutex);
+        pool->_pending--;
+      }
+      pool->_finished.notify_one();
+    }
+  }
+
+  void runRaw(WorkFun fun, void* context) {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _fun = fun;
+      _context = context;
+      _pending = _nrOfHelpers;
+      _generation++;
+    }
+    _start.notify_all();
+    fun(context, 0);
+    std::unique_lock<std::mutex> lock(_mutex);
+    _finished.wait(lock, [&] { return _pending == 0; });  // barrier
+  }
+#endif
+};
@@ -28,7 +28,7 @@ VirtualLayer::~VirtualLayer() {
 
   for (Node* node : nodes) {
     // node->destructor();
-    delete node;
+    freeMBObject(node);  // allocMBObject'ed, maybe in nodePool
   }
   nodes.clear();
 
@@ -40,35 +40,46 @@ VirtualLayer::~VirtualLayer() {
   // clear mapping table
   freeMB(mappingTable);
   freeMB(virtualChannels);
+
+  uint8_t* poolRegion = (uint8_t*)nodePool.release();
+  if (poolRegion) freeMB(poolRegion, "nodePool");
 }
 
 void VirtualLayer::setup() {
   // no node setup here as done in addNode !
 }
 
+void VirtualLayer::ensureNodePool() {
+  if (nodePool.active() || !psramFound()) return;  // without PSRAM a reserved block costs more heap than fragmentation
+  uint8_t* region = allocHeapMB<uint8_t>(NODE_POOL_SIZE, "nodePool", MemNodes);
+  if (region && !nodePool.init(region, NODE_POOL_SIZE)) freeMB(region, "nodePool");
+}
+
 void VirtualLayer::loop() {
-  if (nodes.empty()) return;  // skip empty layers (no effects assigned)
+  if (!prepareFrame()) return;
+  loopNodes();
+  // brightness is applied in compositeTo(), not here
+};
 
-  // Consume fadeBy: scale virtualChannels before running effects this frame
+bool VirtualLayer::prepareFrame() {
+  if (nodes.empty()) return false;  // skip empty layers (no effects assigned)
+
+  // fadeBy left over: the previous frame was not composited (compositeTo fades while compositing)
   if (fadeBy > 0 && virtualChannels) {
-    uint8_t cpl = layerP->lights.header.channelsPerLight;
-    if (cpl == 3 && nrOfLights < UINT16_MAX) {
-      fastled_fadeToBlackBy(reinterpret_cast<CRGB*>(virtualChannels), (uint16_t)nrOfLights, fadeBy);
-    } else {
-      uint8_t scale = 255 - fadeBy;
-      for (nrOfLights_t i = 0; i < nrOfLights; i++) {
-        uint8_t* vch = &virtualChannels[i * cpl];
-        reinterpret_cast<CRGB*>(&vch[layerP->lights.header.offsetRGBW])->nscale8(scale);
-        if (layerP->lights.header.offsetWhite  != UINT8_MAX) vch[layerP->lights.header.offsetRGBW + 3] = scale8(vch[layerP->lights.header.offsetRGBW + 3], scale);
-        if (layerP->lights.header.offsetWhite2 != UINT8_MAX) vch[layerP->lights.header.offsetRGBW + 4] = scale8(vch[layerP->lights.header.offsetRGBW + 4], scale);
-        if (layerP->lights.header.offsetRGBW1  != UINT8_MAX) { reinterpret_cast<CRGB*>(&vch[layerP->lights.header.offsetRGBW1])->nscale8(scale); vch[layerP->lights.header.offsetRGBW1 + 3] = scale8(vch[layerP->lights.header.offsetRGBW1 + 3], scale); }
-        if (layerP->lights.header.offsetRGBW2  != UINT8_MAX) { reinterpret_cast<CRGB*>(&vch[layerP->lights.header.offsetRGBW2])->nscale8(scale); vch[layerP->lights.header.offsetRGBW2 + 3] = scale8(vch[layerP->lights.header.offsetRGBW2 + 3], scale); }
-        if (layerP->lights.header.offsetRGBW3  != UINT8_MAX) { reinterpret_cast<CRGB*>(&vch[layerP->lights.header.offsetRGBW3])->nscale8(scale); vch[layerP->lights.header.offsetRGBW3 + 3] = scale8(vch[layerP->lights.header.offsetRGBW3 + 3], scale); }
-      }
-    }
+    setFadeFactors(fadeBy);
+    fadeFactors.fade(virtualChannels, nrOfLights);
   }
   fadeBy = 0;
 
+  if (memBudget.degraded(MemDegradeCaches)) {  // low on heap, before effects run
+    if (polarCache.bytes()) polarCache.release();
+    if (mappingTable && layerP->gridWiring.valid() && !mappingShrinkRequested) {  // remap: analytic if it fits
+      mappingShrinkRequested = true;
+      layerP->requestMapVirtual = true;
+    }
+  } else
+    mappingShrinkRequested = false;  // tried again the next time the level rises
+
   // Reset dimmer channels to default before effects run (or to 0 when brightness==0 to avoid
   // stale values reaching compositeTo() when effects are skipped by the early-return below).
   if (layerP->lights.header.offsetBrightness != UINT8_MAX) {
@@ -78,26 +89,66 @@ void VirtualLayer::loop() {
     }
   }
 
-  if (brightness == 0) return;  // compositeTo() will output black — skip running effects
+  return brightness != 0;  // compositeTo() will output black — skip running effects
+}
 
+void VirtualLayer::loopNodes() {
   // for virtual nodes
-  if (prevSize != size) EXT_LOGD(ML_TAG, "onSizeChanged V %d,%d,%d -> %d,%d,%d", prevSize.x, prevSize.y, prevSize.z, size.x, size.y, size.z);
+  if (prevSize != size) {
+    EXT_LOGD(ML_TAG, "onSizeChanged V %d,%d,%d -> %d,%d,%d", prevSize.x, prevSize.y, prevSize.z, size.x, size.y, size.z);
+    polarCache.invalidate();
+  }
+  // no per-node locking: PhysicalLayer::loop() holds effectsMutex for the whole frame
   for (Node* node : nodes) {
     if (prevSize != size) {
-      xSemaphoreTake(*node->layerMutex, portMAX_DELAY);
+      NodePoolScope poolScope(&nodePool, node->poolOwner);  // buffers of the node from the layer pool
       node->onSizeChanged(prevSize);
-      xSemaphoreGive(*node->layerMutex);
     }
     if (node->on) {
-      xSemaphoreTake(*node->layerMutex, portMAX_DELAY);
       node->loop();
-      xSemaphoreGive(*node->layerMutex);
       addYield(10);
     }
   }
   prevSize = size;
-  // brightness is applied in compositeTo(), not here
-};
+}
+
+bool VirtualLayer::isTileable() const {
+  bool anyOn = false;
+  for (Node* node : nodes) {
+    if (!node->on) continue;
+    if (node->hasModifier() || !node->isTileSafe()) return false;  // modifiers may map rows onto each other
+    anyOn = true;
+  }
+  return anyOn;
+}
+
+bool VirtualLayer::hasLiveScript() const {
+  for (Node* node : nodes) {
+    if (node->on && node->isLiveScriptNode()) return true;
+  }
+  return false;
+}
+
+void VirtualLayer::prepareTiles() {
+  if (prevSize != size) {
+    EXT_LOGD(ML_TAG, "onSizeChanged V %d,%d,%d -> %d,%d,%d", prevSize.x, prevSize.y, prevSize.z, size.x, size.y, size.z);
+    polarCache.invalidate();
+  }
+  for (Node* node : nodes) {
+    if (prevSize != size) {
+      NodePoolScope poolScope(&nodePool, node->poolOwner);
+      node->onSizeChanged(prevSize);
+    }
+    if (node->on) node->loopFrame();
+  }
+  prevSize = size;
+}
+
+void VirtualLayer::loopTile(uint16_t rowStart, uint16_t rowEnd) {
+  for (Node* node : nodes) {
+    if (node->on) node->loopRows(rowStart, rowEnd);
+  }
+}
 
 void VirtualLayer::loop20ms() {
   for (Node* node : nodes) {
@@ -163,27 +214,38 @@ void VirtualLayer::fill_solid(const CRGB& color) {
 }
 
 
-void VirtualLayer::createMappingTableAndAddOneToOne() {
+void VirtualLayer::createMappingTableAndAddOneToOne(nrOfLights_t indexP) {
   if (mappingTableSize != size.x * size.y * size.z) {
     EXT_LOGD(ML_TAG, "Allocating mappingTable: nrOfLights=%d, sizeof(PhysMap)=%d, total bytes=%d", size.x * size.y * size.z, sizeof(PhysMap), size.x * size.y * size.z * sizeof(PhysMap));
-    reallocMB2<PhysMap>(mappingTable, mappingTableSize, size.x * size.y * size.z, "mappingTable");
+    reallocMB2<PhysMap>(mappingTable, mappingTableSize, size.x * size.y * size.z, "mappingTable", MemMapping);
   }
 
   if (mappingTable && mappingTableSize) memset(mappingTable, 0, mappingTableSize * sizeof(PhysMap));  // on layout, set mappingTable to default PhysMap
 
   // EXT_LOGD(ML_TAG, "Filling mappingTable < %d", layerP->indexP);
 
-  for (nrOfLights_t indexV = 0; indexV < MIN(layerP->indexP, mappingTableSize); indexV++) {
+  for (nrOfLights_t indexV = 0; indexV < MIN(indexP, mappingTableSize); indexV++) {
     addIndexP(mappingTable[indexV], indexV);
   }
 }
 
+void VirtualLayer::createDeferredMappingTable() {
+  mappingDeferred = false;
+  createMappingTableAndAddOneToOne(0);
+  layerP->gridWiring.forEachLight([&](Coord3D position, uint32_t indexP) {  // all inside the window (canAddLights)
+    nrOfLights_t indexV = XYZUnModified(position - startPhy);
+    if (indexV < mappingTableSize) addIndexP(mappingTable[indexV], indexP);
+  });
+}
+
 void VirtualLayer::onLayoutPre() {
   if (nodes.empty()) return;  // skip layout for empty layers (no effects assigned)
 
   // resetMapping
 
   nrOfLights = 0;
+  analyticMapping = false;
+  mappingDeferred = false;
 
   // apply percentage bounds to compute the virtual layer's window into the physical fixture
   computeLayerBounds(layerP->lights.header.size, startPct, endPct, startPhy, endPhy);
@@ -218,6 +280,7 @@ void VirtualLayer::onLayoutPre() {
 
 bool VirtualLayer::addLight(Coord3D position) {
   if (nodes.empty()) return false;  // skip layout for empty layers
+  if (mappingDeferred) createDeferredMappingTable();  // a light that is no grid
 
   // filter: positions outside the percentage-based bounds are blacked out (unmapped)
   bool outsideBounds = isOutsideLayerBounds(position, startPhy, endPhy);
@@ -226,7 +289,7 @@ bool VirtualLayer::addLight(Coord3D position) {
     // treat as unmapped — same as modifier setting position to UINT16_MAX
     if (oneToOneMapping) {
       oneToOneMapping = false;
-      createMappingTableAndAddOneToOne();
+      createMappingTableAndAddOneToOne(layerP->indexP);
     }
     return false;  // this layer did not cover the pixel
   }
@@ -245,7 +308,7 @@ bool VirtualLayer::addLight(Coord3D position) {
 
     if (oneToOneMapping && layerP->indexP != indexV) {
       oneToOneMapping = false;
-      createMappingTableAndAddOneToOne();
+      createMappingTableAndAddOneToOne(layerP->indexP);
     }
 
     nrOfLights = MAX(nrOfLights, indexV + 1);
@@ -259,7 +322,7 @@ bool VirtualLayer::addLight(Coord3D position) {
     if (oneToOneMapping) {
       // we found an irregularity, create the mapping table
       oneToOneMapping = false;
-      createMappingTableAndAddOneToOne();
+      createMappingTableAndAddOneToOne(layerP->indexP);
     }
     // modifier rejected this pixel (position.x == UINT16_MAX): leave channelsD untouched.
     // compositeLayers() zeroes channelsD before every composite step, so no explicit clear needed here.
@@ -267,6 +330,40 @@ bool VirtualLayer::addLight(Coord3D position) {
   return true;  // this layer covered the pixel
 }
 
+bool VirtualLayer::canAddLights(const LightGrid& grid) const {
+  if (nodes.empty()) return true;  // addLights() skips the layer
+  for (Node* node : nodes)
+    if (node->on && node->hasModifier()) return false;  // positions known only after modifyPosition
+  return gridInside(grid, startPhy, endPhy);
+}
+
+bool VirtualLayer::addLights(const LightGrid& grid, size_t first, size_t count) {
+  if (nodes.empty()) return false;  // skip layout for empty layers
+
+  nrOfLights_t indexP = layerP->indexP;  // of light first
+  if (oneToOneMapping && gridIsOneToOne(grid, first, count, indexP, startPhy, size)) {
+    nrOfLights = MAX(nrOfLights, (nrOfLights_t)(indexP + count));  // e.g. a panel filling the layer: nothing to map
+    return true;
+  }
+
+  // as addLight() per light (no modifiers, inside the window), without the calls. If all lights so far are grids the
+  // table waits for onLayoutPost(): panels and cubes need none (analytic mapping)
+  grid.forEach(first, count, [&](Coord3D position) {
+    nrOfLights_t indexV = XYZUnModified(position - startPhy);
+    if (oneToOneMapping && indexP != indexV) {
+      oneToOneMapping = false;
+      if (layerP->gridWiring.lights() == layerP->indexP)
+        mappingDeferred = true;
+      else
+        createMappingTableAndAddOneToOne(indexP);
+    }
+    nrOfLights = MAX(nrOfLights, indexV + 1);
+    if (!oneToOneMapping && !mappingDeferred && indexV < mappingTableSize) addIndexP(mappingTable[indexV], indexP);
+    indexP++;
+  });
+  return true;
+}
+
 void VirtualLayer::onLayoutPost() {
   if (nodes.empty()) return;  // skip layout for empty layers
 
@@ -289,7 +386,8 @@ void VirtualLayer::onLayoutPost() {
     }
   } else {
     EXT_LOGI(ML_TAG, "!oneToOne mapping !");
-    for (size_t indexV = 0; indexV < MIN(nrOfLights, mappingTableSize); indexV++) {
+    if (mappingDeferred && !findAnalyticMapping(0)) createDeferredMappingTable();  // grids, but not as tiles
+    for (size_t indexV = 0; indexV < MIN(nrOfLights, mappingTableSize); indexV++) {  // no table if analytic
       PhysMap& map = mappingTable[indexV];
       switch (map.mapType) {
       case m_zeroLights:
@@ -315,17 +413,77 @@ void VirtualLayer::onLayoutPost() {
 
   EXT_LOGI(ML_TAG, "V:%d x %d x %d = v:%d = 1:0:%d + 1:1:%d + mti:%d (1:m:%d)", size.x, size.y, size.z, nrOfLights, nrOfZeroLights, nrOfOneLight, mappingTableIndexesSizeUsed, nrOfMoreLights);
 
+  if (!oneToOneMapping && !analyticMapping) findAnalyticMapping(nrOfOneLight + nrOfMoreLights);
+
   // Allocate (or reuse) the per-layer virtual pixel buffer now that nrOfLights is final.
   size_t needed = (size_t)nrOfLights * layerP->lights.header.channelsPerLight;
   if (needed > virtualChannelsByteSize) {
     bool firstAlloc = (virtualChannelsByteSize == 0);
     freeMB(virtualChannels);
-    virtualChannels = allocMB<uint8_t>(needed);
+    virtualChannels = allocMB<uint8_t>(needed, "virtualChannels", MemLayers);
     virtualChannelsByteSize = virtualChannels ? needed : 0;
     EXT_LOGD(ML_TAG, "virtualChannels: %d bytes in %s", (int)needed, isInPSRAM(virtualChannels) ? "PSRAM" : "RAM");
     if (firstAlloc) { transitionBrightness = 0; startTransition(255, 500); }  // fade in when layer first comes to life
   }
   if (virtualChannels) memset(virtualChannels, 0, virtualChannelsByteSize);
+  fadeBlocks.reset(nrOfLights);  // all black
+}
+
+bool VirtualLayer::findAnalyticMapping(nrOfLights_t pairs) {
+  if (!layerP->gridWiring.valid() || layerP->lights.header.lightPreset == lightPreset_RGB2040) return false;  // RGB2040: presetCorrection per light
+  // the runs are 5-10% slower than the table: trade time for memory only for large tables or when low on heap
+  if ((size_t)nrOfLights * sizeof(PhysMap) < ANALYTIC_MAPPING_TABLE_BYTES && !memBudget.degraded(MemDegradeCaches)) return false;
+
+  mapping.wiring = layerP->gridWiring.wiring();
+  mapping.start = startPhy;
+  mapping.window = endPhy - startPhy;
+  mapping.size = size;
+  if (mappingDeferred) {  // no modifiers, the whole layer is grids: the mapping is the wiring
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      mapping.copies[axis] = 1;
+      mapping.mirror[axis] = false;
+    }
+  } else if (!mappingTable || !mapping.fit(pairs, [&](uint32_t indexV, uint32_t indexP) {
+               if (indexV >= mappingTableSize) return false;
+               const PhysMap& map = mappingTable[indexV];
+               if (map.mapType == m_oneLight) return map.indexP == indexP;
+               if (map.mapType != m_moreLights) return false;
+               for (nrOfLights_t mapped : mappingTableIndexes[map.indexesIndex])
+                 if (mapped == indexP) return true;
+               return false;
+             }))
+    return false;  // other modifiers: keep the table
+
+  size_t lights, runs;
+  mapping.count(lights, runs);
+  if (runs * 4 > lights) return false;  // runs of less than 4 lights (e.g. a reversed column): the table is faster
+
+  mappingEachLightOnce = mapping.unique() && lights == nrOfLights;
+  analyticMapping = true;
+  mappingDeferred = false;
+  if (mappingTable) {
+    freeMB(mappingTable);
+    mappingTableSize = 0;
+  }
+  mappingTableIndexes.clear();
+  mappingTableIndexesSizeUsed = 0;
+  allOneLight = true;
+  const TileWiring& wiring = mapping.wiring;
+  EXT_LOGI(ML_TAG, "analytic mapping: %d lights in %d runs, %d x %d x %d tiles of %d x %d x %d, copies %d,%d,%d", (int)lights, (int)runs, wiring.tiles.size[0], wiring.tiles.size[1], wiring.tiles.size[2], wiring.tile.size[0], wiring.tile.size[1], wiring.tile.size[2], mapping.copies[0], mapping.copies[1], mapping.copies[2]);
+  return true;
+}
+
+void VirtualLayer::setFadeFactors(uint8_t amount) {
+  const LightsHeader& header = layerP->lights.header;
+  uint8_t channels[17];  // RGB, 2 whites, 3 RGBW blocks
+  uint8_t nrOfChannels = 0;
+  for (uint8_t c = 0; c < 3; c++) channels[nrOfChannels++] = header.offsetRGBW + c;
+  if (header.offsetWhite != UINT8_MAX) channels[nrOfChannels++] = header.offsetRGBW + 3;
+  if (header.offsetWhite2 != UINT8_MAX) channels[nrOfChannels++] = header.offsetRGBW + 4;
+  for (uint8_t offset : {header.offsetRGBW1, header.offsetRGBW2, header.offsetRGBW3})
+    if (offset != UINT8_MAX)
+      for (uint8_t c = 0; c < 4; c++) channels[nrOfChannels++] = offset + c;
+  fadeFactors.set(header.channelsPerLight, channels, nrOfChannels, amount);
 }
 
 void VirtualLayer::compositeTo(uint8_t* dest, const LightsHeader& header) {
@@ -333,41 +491,127 @@ void VirtualLayer::compositeTo(uint8_t* dest, const LightsHeader& header) {
   uint8_t cpl = header.channelsPerLight;
   uint8_t b = scale8(brightness, transitionBrightness);
 
+  // The fade requested this frame, applied to each light right after it is composited: one read and write of
+  // virtualChannels per frame instead of a separate pass in prepareFrame()
+  uint8_t fade = fadeBy;
+  fadeBy = 0;
+
   // Fast path for pure RGB (cpl==3): no white/control channels to check.
   // When oneToOneMapping is also true this is the tightest possible loop —
   // avoids forEachLightIndex dispatch and all UINT8_MAX-guarded branches.
+  // Per block of FADE_BLOCK lights: a block black after the last composite and still black adds nothing, skip it.
   if (cpl == 3) {
+    if (analyticMapping) {
+      compositeRunsRGB(dest, b, fade);
+      return;
+    }
     CRGB* src = reinterpret_cast<CRGB*>(virtualChannels);
     CRGB* dst = reinterpret_cast<CRGB*>(dest);
-    if (oneToOneMapping) {
-      if (b == 255) {
-        for (nrOfLights_t i = 0; i < nrOfLights; i++) dst[i] += src[i];
+    for (nrOfLights_t first = 0; first < nrOfLights; first += FADE_BLOCK) {
+      nrOfLights_t last = MIN(first + FADE_BLOCK, nrOfLights);
+      size_t block = first / FADE_BLOCK;
+      if (fadeBlocks.black(block) && fadeIsBlack(&virtualChannels[first * 3], (last - first) * 3)) continue;
+
+      bool black;
+      if (oneToOneMapping) {
+        black = compositeFadeRGB(&virtualChannels[first * 3], &dest[first * 3], (last - first) * 3, b, fade);
       } else {
-        for (nrOfLights_t i = 0; i < nrOfLights; i++) { CRGB c = src[i]; c.nscale8_video(b); dst[i] += c; }
+        uint8_t any = 0;
+        for (nrOfLights_t indexV = first; indexV < last; indexV++) {
+          CRGB color = src[indexV];
+          if (fade) src[indexV].nscale8(255 - fade);
+          any |= src[indexV].r | src[indexV].g | src[indexV].b;
+          if (allOneLight) {
+            // Serpentine / shifted panel fast path: all mapped entries are m_oneLight —
+            // direct table access, no switch dispatch, no forEachLightIndex overhead.
+            if (mappingTable[indexV].mapType != m_oneLight) continue;  // skip unmapped pixels
+            if (b < 255) color.nscale8_video(b);
+            nrOfLights_t indexP = mappingTable[indexV].indexP;
+            presetCorrection(indexP);
+            dst[indexP] += color;
+          } else {
+            // General 1:N path (e.g. modifiers that map 1D rings to 2D grid positions).
+            if (b < 255) color.nscale8_video(b);
+            forEachLightIndex(indexV, [&](nrOfLights_t indexP) { dst[indexP] += color; });
+          }
+        }
+        black = !any;
       }
-    } else if (allOneLight) {
-      // Serpentine / shifted panel fast path: all mapped entries are m_oneLight —
-      // direct table access, no switch dispatch, no forEachLightIndex overhead.
-      for (nrOfLights_t indexV = 0; indexV < nrOfLights; indexV++) {
-        if (mappingTable[indexV].mapType != m_oneLight) continue;  // skip unmapped pixels
-        CRGB color = src[indexV];
-        if (b < 255) color.nscale8_video(b);
-        nrOfLights_t indexP = mappingTable[indexV].indexP;
-        presetCorrection(indexP);
-        dst[indexP] += color;
+      fadeBlocks.set(block, black);
+    }
+    return;
+  }
+
+  if (fade) setFadeFactors(fade);
+
+  // General path for multi-channel lights (cpl > 3: RGBW, moving heads, etc.)
+  // Primary RGB: color, the effective brightness applied. Composites the light at vch into the light at dst.
+  auto compositeLight = [&](uint8_t* vch, const CRGB& color, uint8_t* dst) {
+    // Color channels: additive compositing (saturates at 255)
+    *reinterpret_cast<CRGB*>(&dst[header.offsetRGBW]) += color;
+
+    if (header.offsetWhite  != UINT8_MAX) {
+      uint8_t w = vch[header.offsetRGBW + 3];  // canonical white slot: setWhite() writes here
+      if (b < 255) w = scale8(w, b);
+      dst[header.offsetWhite] = qadd8(dst[header.offsetWhite], w);  // driver wire-order destination
+      if (header.offsetWhite2 != UINT8_MAX) {
+        uint8_t w = vch[header.offsetRGBW + 4];  // canonical second-white slot
+        if (b < 255) w = scale8(w, b);
+        dst[header.offsetWhite2] = qadd8(dst[header.offsetWhite2], w);
       }
-    } else {
-      // General 1:N path (e.g. modifiers that map 1D rings to 2D grid positions).
-      for (nrOfLights_t indexV = 0; indexV < nrOfLights; indexV++) {
-        CRGB color = src[indexV];
-        if (b < 255) color.nscale8_video(b);
-        forEachLightIndex(indexV, [&](nrOfLights_t indexP) { dst[indexP] += color; });
+    }
+    if (header.offsetRGBW1 != UINT8_MAX) {
+      CRGB c = *reinterpret_cast<CRGB*>(&vch[header.offsetRGBW1]);
+      if (b < 255) c.nscale8_video(b);
+      *reinterpret_cast<CRGB*>(&dst[header.offsetRGBW1]) += c;
+      uint8_t w = vch[header.offsetRGBW1 + 3];
+      if (b < 255) w = scale8(w, b);
+      dst[header.offsetRGBW1 + 3] = qadd8(dst[header.offsetRGBW1 + 3], w);
+      if (header.offsetRGBW2 != UINT8_MAX) {
+        CRGB c = *reinterpret_cast<CRGB*>(&vch[header.offsetRGBW2]);
+        if (b < 255) c.nscale8_video(b);
+        *reinterpret_cast<CRGB*>(&dst[header.offsetRGBW2]) += c;
+        uint8_t w = vch[header.offsetRGBW2 + 3];
+        if (b < 255) w = scale8(w, b);
+        dst[header.offsetRGBW2 + 3] = qadd8(dst[header.offsetRGBW2 + 3], w);
+        if (header.offsetRGBW3 != UINT8_MAX) {
+          CRGB c = *reinterpret_cast<CRGB*>(&vch[header.offsetRGBW3]);
+          if (b < 255) c.nscale8_video(b);
+          *reinterpret_cast<CRGB*>(&dst[header.offsetRGBW3]) += c;
+          uint8_t w = vch[header.offsetRGBW3 + 3];
+          if (b < 255) w = scale8(w, b);
+          dst[header.offsetRGBW3 + 3] = qadd8(dst[header.offsetRGBW3 + 3], w);
+        }
       }
     }
+
+    // Control channels (brightness, pan, tilt, zoom, rotate, gobo): copy — last layer wins.
+    // Additive semantics don't apply to positional/control signals.
+    // Brightness channels: setBrightness() already bakes in globalBrightness and layer brightness,
+    // so only transitionBrightness needs to be applied here to keep dimmer channels in sync with
+    // the layer fade-in/out without double-scaling.
+    if (header.offsetBrightness  != UINT8_MAX) dst[header.offsetBrightness]  = transitionBrightness < 255 ? scale8(vch[header.offsetBrightness],  transitionBrightness) : vch[header.offsetBrightness];
+    if (header.offsetBrightness2 != UINT8_MAX) dst[header.offsetBrightness2] = transitionBrightness < 255 ? scale8(vch[header.offsetBrightness2], transitionBrightness) : vch[header.offsetBrightness2];
+    if (header.offsetPan         != UINT8_MAX) dst[header.offsetPan]         = vch[header.offsetPan];
+    if (header.offsetTilt        != UINT8_MAX) dst[header.offsetTilt]        = vch[header.offsetTilt];
+    if (header.offsetZoom        != UINT8_MAX) dst[header.offsetZoom]        = vch[header.offsetZoom];
+    if (header.offsetRotate      != UINT8_MAX) dst[header.offsetRotate]      = vch[header.offsetRotate];
+    if (header.offsetGobo        != UINT8_MAX) dst[header.offsetGobo]        = vch[header.offsetGobo];
+  };
+
+  if (analyticMapping) {  // run by run, then the fade (a light can have copies)
+    mapping.forEachRun([&](uint32_t indexV, uint32_t count, const MappingRun& run) {
+      run.forEach(count, [&](uint32_t n, uint32_t indexP) {
+        uint8_t* vch = &virtualChannels[(indexV + n) * cpl];
+        CRGB color = *reinterpret_cast<CRGB*>(&vch[header.offsetRGBW]);
+        if (b < 255) color.nscale8_video(b);
+        compositeLight(vch, color, &dest[indexP * cpl]);
+      });
+    });
+    if (fade) fadeFactors.fade(virtualChannels, nrOfLights);
     return;
   }
 
-  // General path for multi-channel lights (cpl > 3: RGBW, moving heads, etc.)
   for (nrOfLights_t indexV = 0; indexV < nrOfLights; indexV++) {
     uint8_t* vch = &virtualChannels[indexV * cpl];
 
@@ -375,82 +619,172 @@ void VirtualLayer::compositeTo(uint8_t* dest, const LightsHeader& header) {
     CRGB color = *reinterpret_cast<CRGB*>(&vch[header.offsetRGBW]);
     if (b < 255) color.nscale8_video(b);
 
-    forEachLightIndex(indexV, [&](nrOfLights_t indexP) {
-      uint8_t* dst = &dest[indexP * cpl];
+    forEachLightIndex(indexV, [&](nrOfLights_t indexP) { compositeLight(vch, color, &dest[indexP * cpl]); });
 
-      // Color channels: additive compositing (saturates at 255)
-      *reinterpret_cast<CRGB*>(&dst[header.offsetRGBW]) += color;
+    if (fade) fadeFactors.fade(vch, 1);
+  }
+}
 
-      if (header.offsetWhite  != UINT8_MAX) {
-        uint8_t w = vch[header.offsetRGBW + 3];  // canonical white slot: setWhite() writes here
-        if (b < 255) w = scale8(w, b);
-        dst[header.offsetWhite] = qadd8(dst[header.offsetWhite], w);  // driver wire-order destination
-        if (header.offsetWhite2 != UINT8_MAX) {
-          uint8_t w = vch[header.offsetRGBW + 4];  // canonical second-white slot
-          if (b < 255) w = scale8(w, b);
-          dst[header.offsetWhite2] = qadd8(dst[header.offsetWhite2], w);
-        }
-      }
-      if (header.offsetRGBW1 != UINT8_MAX) {
-        CRGB c = *reinterpret_cast<CRGB*>(&vch[header.offsetRGBW1]);
-        if (b < 255) c.nscale8_video(b);
-        *reinterpret_cast<CRGB*>(&dst[header.offsetRGBW1]) += c;
-        uint8_t w = vch[header.offsetRGBW1 + 3];
-        if (b < 255) w = scale8(w, b);
-        dst[header.offsetRGBW1 + 3] = qadd8(dst[header.offsetRGBW1 + 3], w);
-        if (header.offsetRGBW2 != UINT8_MAX) {
-          CRGB c = *reinterpret_cast<CRGB*>(&vch[header.offsetRGBW2]);
-          if (b < 255) c.nscale8_video(b);
-          *reinterpret_cast<CRGB*>(&dst[header.offsetRGBW2]) += c;
-          uint8_t w = vch[header.offsetRGBW2 + 3];
-          if (b < 255) w = scale8(w, b);
-          dst[header.offsetRGBW2 + 3] = qadd8(dst[header.offsetRGBW2 + 3], w);
-          if (header.offsetRGBW3 != UINT8_MAX) {
-            CRGB c = *reinterpret_cast<CRGB*>(&vch[header.offsetRGBW3]);
-            if (b < 255) c.nscale8_video(b);
-            *reinterpret_cast<CRGB*>(&dst[header.offsetRGBW3]) += c;
-            uint8_t w = vch[header.offsetRGBW3 + 3];
-            if (b < 255) w = scale8(w, b);
-            dst[header.offsetRGBW3 + 3] = qadd8(dst[header.offsetRGBW3 + 3], w);
-          }
-        }
+void VirtualLayer::compositeRunsRGB(uint8_t* dest, uint8_t b, uint8_t fade) {
+  CRGB* src = reinterpret_cast<CRGB*>(virtualChannels);
+  // Runs come in order of the virtual lights: the lights of a block of FADE_BLOCK lights one after the other. With
+  // each light composited once the fade is applied on the way (as compositeTo), else afterwards per block.
+  bool fadeNow = mappingEachLightOnce;
+  size_t open = SIZE_MAX;  // the block of the last run
+  bool skip = false;       // black after the last composite and still black
+  uint8_t any = 0;
+  mapping.forEachRun([&](uint32_t indexV, uint32_t count, const MappingRun& run) {
+    for (uint32_t n = 0; n < count;) {
+      nrOfLights_t light = indexV + n;
+      size_t block = light / FADE_BLOCK;
+      uint32_t chunk = MIN(count - n, (uint32_t)((block + 1) * FADE_BLOCK - light));
+      if (block != open) {
+        if (fadeNow && open != SIZE_MAX && !skip) fadeBlocks.set(open, !any);
+        open = block;
+        any = 0;
+        nrOfLights_t first = block * FADE_BLOCK;
+        nrOfLights_t last = MIN(first + FADE_BLOCK, nrOfLights);
+        skip = fadeBlocks.black(block) && fadeIsBlack(&virtualChannels[first * 3], (last - first) * 3);
       }
+      if (!skip)  // step 1 without odd (wired as the virtual row) is a 1:1 layer, else two lights per iteration
+        any |= !compositeFadeRGBRun(&virtualChannels[light * 3], &dest[run.at(n) * 3], chunk, run.step, (n & 1) ? -run.odd : run.odd, b, fadeNow ? fade : 0);
+      n += chunk;
+    }
+  });
+  if (fadeNow) {
+    if (open != SIZE_MAX && !skip) fadeBlocks.set(open, !any);
+    return;
+  }
 
-      // Control channels (brightness, pan, tilt, zoom, rotate, gobo): copy — last layer wins.
-      // Additive semantics don't apply to positional/control signals.
-      // Brightness channels: setBrightness() already bakes in globalBrightness and layer brightness,
-      // so only transitionBrightness needs to be applied here to keep dimmer channels in sync with
-      // the layer fade-in/out without double-scaling.
-      if (header.offsetBrightness  != UINT8_MAX) dst[header.offsetBrightness]  = transitionBrightness < 255 ? scale8(vch[header.offsetBrightness],  transitionBrightness) : vch[header.offsetBrightness];
-      if (header.offsetBrightness2 != UINT8_MAX) dst[header.offsetBrightness2] = transitionBrightness < 255 ? scale8(vch[header.offsetBrightness2], transitionBrightness) : vch[header.offsetBrightness2];
-      if (header.offsetPan         != UINT8_MAX) dst[header.offsetPan]         = vch[header.offsetPan];
-      if (header.offsetTilt        != UINT8_MAX) dst[header.offsetTilt]        = vch[header.offsetTilt];
-      if (header.offsetZoom        != UINT8_MAX) dst[header.offsetZoom]        = vch[header.offsetZoom];
-      if (header.offsetRotate      != UINT8_MAX) dst[header.offsetRotate]      = vch[header.offsetRotate];
-      if (header.offsetGobo        != UINT8_MAX) dst[header.offsetGobo]        = vch[header.offsetGobo];
-    });
+  // copies, or lights not mapped: fade each light once
+  for (nrOfLights_t first = 0; first < nrOfLights; first += FADE_BLOCK) {
+    nrOfLights_t last = MIN(first + FADE_BLOCK, nrOfLights);
+    size_t block = first / FADE_BLOCK;
+    if (fadeBlocks.black(block) && fadeIsBlack(&virtualChannels[first * 3], (last - first) * 3)) continue;
+    any = 0;
+    for (nrOfLights_t indexV = first; indexV < last; indexV++) {
+      if (fade) src[indexV].nscale8(255 - fade);
+      any |= src[indexV].r | src[indexV].g | src[indexV].b;
+    }
+    fadeBlocks.set(block, !any);
   }
 }
 
 bool VirtualLayer::isMapped(nrOfLights_t indexV) const {
+  if (analyticMapping) {
+    bool mapped = false;
+    mapping.forEachIndexP(indexV, [&](uint32_t) { mapped = true; }, true);
+    return mapped;
+  }
   return oneToOneMapping || (indexV < mappingTableSize && (mappingTable[indexV].mapType == m_oneLight || mappingTable[indexV].mapType == m_moreLights));
 }
 
-void VirtualLayer::blur1d(fract8 blur_amount, nrOfLights_t x) {
-  const uint8_t keep = 255 - blur_amount;
-  const uint8_t seep = blur_amount >> 1;
+bool VirtualLayer::drawOnBuffer() const {
+  if (!virtualChannels || (size_t)size.x * size.y * size.z > nrOfLights) return false;
+  for (Node* node : nodes)
+    if (node->on && node->hasModifyXYZ()) return false;
+  return true;
+}
+
+void VirtualLayer::fillGradient(nrOfLights_t first, nrOfLights_t count, int stride, uint8_t startIndex, int16_t step, uint8_t brightness) {
+  if (stride <= 0 || first >= nrOfLights) return;
+  count = MIN(count, (nrOfLights - first + stride - 1) / stride);  // lights up to nrOfLights
+  if (virtualChannels) {
+    ChannelView view = {virtualChannels, layerP->lights.header.channelsPerLight, layerP->lights.header.offsetRGBW, size.x, size.y, size.z};
+    ::fillGradient(view, first, count, stride, startIndex, step, [&](uint8_t index) { return layerP->colorFromPalette(index, brightness); });
+  } else {
+    uint16_t index = startIndex << 4;
+    for (nrOfLights_t i = 0; i < count; i++, index += step) setRGB(first + i * stride, layerP->colorFromPalette(index >> 4, brightness));
+  }
+}
+
+void VirtualLayer::fillRowGradient(int y, uint8_t startIndex, int16_t step, uint8_t brightness) {
+  if (y < 0 || y >= size.y) return;
+  if (drawOnBuffer())
+    fillGradient(y * size.x, size.x, 1, startIndex, step, brightness);
+  else {
+    uint16_t index = startIndex << 4;
+    for (int x = 0; x < size.x; x++, index += step) setRGB(Coord3D(x, y), layerP->colorFromPalette(index >> 4, brightness));
+  }
+}
+
+void VirtualLayer::fillColumnGradient(int x, uint8_t startIndex, int16_t step, uint8_t brightness) {
+  if (x < 0 || x >= size.x) return;
+  if (drawOnBuffer())
+    fillGradient(x, size.y, size.x, startIndex, step, brightness);
+  else {
+    uint16_t index = startIndex << 4;
+    for (int y = 0; y < size.y; y++, index += step) setRGB(Coord3D(x, y), layerP->colorFromPalette(index >> 4, brightness));
+  }
+}
+
+void VirtualLayer::fillIndexes(nrOfLights_t first, nrOfLights_t count, const uint8_t* indexes, uint8_t brightness) {
+  if (!indexes || first >= nrOfLights) return;
+  count = MIN(count, nrOfLights - first);
+  if (virtualChannels) {
+    ChannelView view = {virtualChannels, layerP->lights.header.channelsPerLight, layerP->lights.header.offsetRGBW, size.x, size.y, size.z};
+    ::fillIndexes(view, first, count, indexes, [&](uint8_t index) { return layerP->colorFromPalette(index, brightness); });
+  } else
+    for (nrOfLights_t i = 0; i < count; i++) setRGB(first + i, layerP->colorFromPalette(indexes[i], brightness));
+}
+
+void VirtualLayer::copyRect(int x, int y, int width, int height, int toX, int toY) {
+  if (drawOnBuffer()) {
+    ChannelView view = {virtualChannels, layerP->lights.header.channelsPerLight, layerP->lights.header.offsetRGBW, size.x, size.y, size.z};
+    ::copyRect(view, x, y, width, height, toX, toY);
+    return;
+  }
+  // light by light (z = 0), in the order that reads a light before it is overwritten
+  bool down = toY > y, right = toX > x;
+  for (int r = 0; r < height; r++) {
+    int row = down ? height - 1 - r : r;
+    for (int c = 0; c < width; c++) {
+      int col = right ? width - 1 - c : c;
+      Coord3D from(x + col, y + row), to(toX + col, toY + row);
+      if (from.x < 0 || from.y < 0 || from.x >= size.x || from.y >= size.y) continue;
+      if (to.x < 0 || to.y < 0 || to.x >= size.x || to.y >= size.y) continue;
+      setRGB(to, getRGB(from));
+    }
+  }
+}
+
+void VirtualLayer::shift(int dx, int dy) {
+  if (drawOnBuffer()) {
+    ChannelView view = {virtualChannels, layerP->lights.header.channelsPerLight, layerP->lights.header.offsetRGBW, size.x, size.y, size.z};
+    shiftLights(view, dx, dy);
+    return;
+  }
+  copyRect(0, 0, size.x, size.y, dx, dy);
+  for (int y = 0; y < size.y; y++)
+    for (int x = 0; x < size.x; x++)
+      if (x < dx || x >= size.x + dx || y < dy || y >= size.y + dy) setRGB(Coord3D(x, y), CRGB::Black);
+}
+
+void VirtualLayer::blurLineXYZ(Coord3D first, Coord3D step, int length, uint8_t keep, uint8_t seep) {
   CRGB carryover = CRGB::Black;
-  for (nrOfLights_t row = 0; row < size.y; ++row) {
-    CRGB cur = getRGB(Coord3D(x, row));
+  Coord3D pos = first;
+  for (int i = 0; i < length; i++) {
+    CRGB cur = getRGB(pos);
     CRGB part = cur;
     part.nscale8(seep);
     cur.nscale8(keep);
     cur += carryover;
-    if (row) addRGB(Coord3D(x, row - 1), part);
-    setRGB(Coord3D(x, row), cur);
+    if (i) addRGB(pos - step, part);
+    setRGB(pos, cur);
     carryover = part;
+    if (i < length - 1) pos += step;
   }
-  if (size.y) addRGB(Coord3D(x, size.y - 1), carryover);
+  if (length) addRGB(pos, carryover);
+}
+
+void VirtualLayer::blur1d(fract8 blur_amount, nrOfLights_t x) {
+  const uint8_t keep = 255 - blur_amount;
+  const uint8_t seep = blur_amount >> 1;
+  if (drawOnBuffer()) {
+    const uint8_t cpl = layerP->lights.header.channelsPerLight;
+    if (x < size.x) blurLine(&virtualChannels[x * cpl + layerP->lights.header.offsetRGBW], (size_t)size.x * cpl, size.y, keep, seep);
+  } else
+    blurLineXYZ(Coord3D(x, 0), Coord3D(0, 1), size.y, keep, seep);
 }
 
 void VirtualLayer::blur2d(fract8 blur_amount) {
@@ -461,38 +795,43 @@ void VirtualLayer::blur2d(fract8 blur_amount) {
 void VirtualLayer::blurRows(fract8 blur_amount) {
   uint8_t keep = 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
-  for (nrOfLights_t row = 0; row < size.y; row++) {
-    CRGB carryover = CRGB::Black;
-    for (nrOfLights_t col = 0; col < size.x; col++) {
-      CRGB cur = getRGB(Coord3D(col, row));
-      CRGB part = cur;
-      part.nscale8(seep);
-      cur.nscale8(keep);
-      cur += carryover;
-      if (col) addRGB(Coord3D(col - 1, row), part);
-      setRGB(Coord3D(col, row), cur);
-      carryover = part;
-    }
-    if (size.x) addRGB(Coord3D(size.x - 1, row), carryover);
-  }
+  if (drawOnBuffer()) {
+    const uint8_t cpl = layerP->lights.header.channelsPerLight;
+    uint8_t* row = &virtualChannels[layerP->lights.header.offsetRGBW];
+    for (nrOfLights_t y = 0; y < size.y; y++, row += (size_t)size.x * cpl) blurLine(row, cpl, size.x, keep, seep);
+  } else
+    for (nrOfLights_t row = 0; row < size.y; row++) blurLineXYZ(Coord3D(0, row), Coord3D(1, 0), size.x, keep, seep);
 }
 
 void VirtualLayer::blurColumns(fract8 blur_amount) {
   uint8_t keep = 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
-  for (nrOfLights_t col = 0; col < size.x; ++col) {
-    CRGB carryover = CRGB::Black;
-    for (nrOfLights_t row = 0; row < size.y; row++) {
-      CRGB cur = getRGB(Coord3D(col, row));
-      CRGB part = cur;
-      part.nscale8(seep);
-      cur.nscale8(keep);
-      cur += carryover;
-      if (row) addRGB(Coord3D(col, row - 1), part);
-      setRGB(Coord3D(col, row), cur);
-      carryover = part;
-    }
-    if (size.y) addRGB(Coord3D(col, size.y - 1), carryover);
+  if (drawOnBuffer()) {
+    const uint8_t cpl = layerP->lights.header.channelsPerLight;  // all columns at once, row after row
+    blurLines(&virtualChannels[layerP->lights.header.offsetRGBW], cpl, size.x, (size_t)size.x * cpl, size.y, keep, seep);
+  } else
+    for (nrOfLights_t col = 0; col < size.x; ++col) blurLineXYZ(Coord3D(col, 0), Coord3D(0, 1), size.y, keep, seep);
+}
+
+void VirtualLayer::blur3d(fract8 blur_amount) {
+  uint8_t keep = 255 - blur_amount;
+  uint8_t seep = blur_amount >> 1;
+  if (drawOnBuffer()) {
+    const uint8_t cpl = layerP->lights.header.channelsPerLight;
+    const size_t plane = (size_t)size.x * size.y * cpl;
+    uint8_t* rgb = &virtualChannels[layerP->lights.header.offsetRGBW];
+    for (int z = 0; z < size.z; z++) {
+      for (int y = 0; y < size.y; y++) blurLine(rgb + z * plane + (size_t)y * size.x * cpl, cpl, size.x, keep, seep);  // x
+      blurLines(rgb + z * plane, cpl, size.x, (size_t)size.x * cpl, size.y, keep, seep);                              // y
+    }
+    blurLines(rgb, cpl, (uint32_t)size.x * size.y, plane, size.z, keep, seep);  // z: all lights of a plane at once
+  } else {
+    for (int z = 0; z < size.z; z++) {
+      for (int y = 0; y < size.y; y++) blurLineXYZ(Coord3D(0, y, z), Coord3D(1, 0, 0), size.x, keep, seep);
+      for (int x = 0; x < size.x; x++) blurLineXYZ(Coord3D(x, 0, z), Coord3D(0, 1, 0), size.y, keep, seep);
+    }
+    for (int y = 0; y < size.y; y++)
+      for (int x = 0; x < size.x; x++) blurLineXYZ(Coord3D(x, y, 0), Coord3D(0, 0, 1), size.z, keep, seep);
   }
 }
 
@@ -17,10 +17,24 @@
 
   #include <vector>
 
+  #include "MoonBase/utilities/BlurKernels.h"
+  #include "MoonBase/utilities/BulkDraw.h"
+  #include "MoonBase/utilities/FadeKernels.h"
   #include "MoonBase/utilities/LayerFunctions.h"
+  #include "MoonBase/utilities/LightRuns.h"
+  #include "MoonBase/utilities/MappingDescriptor.h"
+  #include "MoonBase/utilities/NodePool.h"
+  #include "MoonBase/utilities/PolarCache.h"
   #include "PhysMap.h"  // pure types: MapTypeEnum, PhysMap — no ESP32 deps
   #include "PhysicalLayer.h"
 
+  #ifndef NODE_POOL_SIZE
+    #define NODE_POOL_SIZE (256 * 1024)  // per layer, PSRAM boards only
+  #endif
+  #ifndef ANALYTIC_MAPPING_TABLE_BYTES
+    #define ANALYTIC_MAPPING_TABLE_BYTES (128 * 1024)  // mapping tables this big are replaced by an analytic mapping
+  #endif
+
 // ----------------------------------------------------------------------------
 // VirtualLayer — a logical 3-D grid of virtual pixels mapped to physical lights.
 // Effects and modifiers operate on virtual pixels; this layer translates them
@@ -58,6 +72,14 @@ class VirtualLayer {
   // Effect / modifier / layout nodes assigned to this virtual layer.
   std::vector<Node*, VectorRAMAllocator<Node*>> nodes;
 
+  // Node objects of this layer and the buffers they allocate in setup() / onSizeChanged(): a size-class pool in one
+  // PSRAM block, so switching effects doesn't fragment the heap (NodePool.h). Reserved by the first addNode.
+  NodePool nodePool;
+
+  // Angle and distance of every light from the centre, shared by the radial effects of this layer. Built on first
+  // use, invalidated when the size changes (before onSizeChanged). Use polarXY() / polarXZ() / sphereRadius().
+  PolarCache<VectorRAMAllocator> polarCache;
+
   // Dimensionality of the current effect (1D / 2D / 3D).
   uint8_t effectDimension = _3D;
 
@@ -75,6 +97,22 @@ class VirtualLayer {
   // bypasses the forEachLightIndex switch. Set false as soon as any m_moreLights entry is created.
   bool allOneLight = true;
 
+  // When true, the mapping is the fixture's wiring seen through this layer (MappingDescriptor.h: serpentine, tiled
+  // and reversed panels and cubes, a window, Mirror / Multiply folds) and there is no mappingTable: compositeTo()
+  // computes the physical lights of each virtual row as runs. Set by onLayoutPost(), only when the table would be
+  // ANALYTIC_MAPPING_TABLE_BYTES or more or memBudget is short of heap: the runs cost more time per frame than the table.
+  bool analyticMapping = false;
+  MappingDescriptor mapping;
+  bool mappingEachLightOnce = false;  // no copies and every virtual light mapped: compositeTo() fades while compositing
+
+  // Set by addLights() when a grid breaks the 1:1 mapping and all lights so far were grids: the mapping table is
+  // only built if onLayoutPost() finds no analytic mapping (or a light is added one by one).
+  bool mappingDeferred = false;
+
+  // Set by prepareFrame() when memBudget sheds caches and the layer has a mapping table over grids: the mapping is
+  // done again, analytic if it fits (findAnalyticMapping). Once per time the level rises.
+  bool mappingShrinkRequested = false;
+
   // Per-layer brightness (0–255). Scales pixel output within this layer. Default 255 = full.
   uint8_t brightness = 255;
 
@@ -85,9 +123,17 @@ class VirtualLayer {
   uint8_t transitionTarget     = 255;  // value to animate toward; animation stops here
   int16_t transitionStep       = 0;    // signed delta added per frame; 0 = idle
 
-  // Fade amount requested by effects this frame (consumed by PhysicalLayer::loop() next frame).
+  // Fade amount requested by effects this frame. Applied by compositeTo() while it reads virtualChannels, or by
+  // prepareFrame() of the next frame if the layer was not composited.
   uint8_t fadeBy = 0;
 
+  // Blocks of FADE_BLOCK lights black after the last composite: compositeTo() only checks them (RGB lights).
+  FadeBlocks<VectorRAMAllocator> fadeBlocks;
+
+  // Factor per channel of the fade of multi-channel lights (colors and whites faded, control channels kept).
+  FadeFactors fadeFactors;
+  void setFadeFactors(uint8_t amount);
+
   // Per-layer virtual pixel buffer. Effects write here (indexed by virtual pixel index, not
   // physical). compositeTo() maps virtualChannels → physical channelsD after all layers render.
   // Allocated in onLayoutPost(), freed in destructor. nullptr until first layout completes.
@@ -108,16 +154,37 @@ class VirtualLayer {
   // No per-node setup here — nodes are set up by addNode() individually.
   void setup();
 
+  // Reserves the region of nodePool (NODE_POOL_SIZE), if not done yet and the board has PSRAM.
+  void ensureNodePool();
+
   // Run one effect frame: apply fade, update brightness channels, loop all effect nodes.
   // Called from effectTask (Core 0) every frame.
   void loop();
 
+  // loop() in phases, for multi-core rendering (PhysicalLayer::loopParallel()).
+  // prepareFrame(): fade + brightness channels, on effectTask; false if no effects should run this frame.
+  // Then either loopNodes() (whole layer, on any one worker) or prepareTiles() on effectTask followed by
+  // loopTile() for each row band (on any worker, bands of one layer run concurrently).
+  bool prepareFrame();
+  void loopNodes();
+  void prepareTiles();
+  void loopTile(uint16_t rowStart, uint16_t rowEnd);
+
+  // True if all active nodes are tile-safe effects (no modifiers): rows can be rendered in parallel.
+  bool isTileable() const;
+
+  // True if an active LiveScript node runs on this layer (its frame sync with effectTask must stay on effectTask).
+  bool hasLiveScript() const;
+
   // Composite virtualChannels into dest[], applying per-layer brightness and the physical
   // mapping (forEachLightIndex). Uses additive compositing (saturates at 255) so multiple
   // layers at full brightness sum correctly, and overlapping layers at reduced brightness
   // crossfade naturally. Called by PhysicalLayer::loop() after each layer->loop().
   void compositeTo(uint8_t* dest, const LightsHeader& header);
 
+  // compositeTo() of RGB lights with an analytic mapping: run by run, rows wired as the virtual row as one block.
+  void compositeRunsRGB(uint8_t* dest, uint8_t brightness, uint8_t fade);
+
   // Run 20 ms periodic updates for all nodes (called from SvelteKit task, Core 1).
   void loop20ms();
 
@@ -129,6 +196,14 @@ class VirtualLayer {
   // NOTE: position is passed by reference because modifiers may alter it in-place.
   nrOfLights_t XYZ(Coord3D& position);
 
+  // Angle and radius (1/16 light) from the centre per light of the x,y plane (index x + y * size.x) or the x,z plane
+  // (index x + z * size.x), distance per light in 3D (index XYZUnModified). nullptr if out of memory or while
+  // memBudget sheds caches: effects then compute the light's coordinates (polarCoord). Tile-safe effects take them
+  // in loopFrame().
+  const PolarCoord* polarXY() { return memBudget.degraded(MemDegradeCaches) ? nullptr : polarCache.plane(PolarXY, size.x, size.y); }
+  const PolarCoord* polarXZ() { return memBudget.degraded(MemDegradeCaches) ? nullptr : polarCache.plane(PolarXZ, size.x, size.z); }
+  const uint16_t* sphereRadius() { return memBudget.degraded(MemDegradeCaches) ? nullptr : polarCache.sphere(size.x, size.y, size.z); }
+
   // Map a 3-D virtual coordinate to a flat virtual index without applying modifiers.
   // Inline for hot-path use by effects that skip XYZ modifier processing.
   nrOfLights_t XYZUnModified(const Coord3D& position) const { return position.x + position.y * size.x + position.z * size.x * size.y; }
@@ -144,7 +219,9 @@ class VirtualLayer {
   // ----------------------------------------------------------------------------
   template <typename Callback>
   void forEachLightIndex(const nrOfLights_t indexV, Callback&& callback, bool onlyOne = false) {
-    if (indexV < mappingTableSize) {
+    if (analyticMapping) {
+      mapping.forEachIndexP(indexV, [&](uint32_t indexP) { callback((nrOfLights_t)indexP); }, onlyOne);  // no RGB2040 (onLayoutPost)
+    } else if (indexV < mappingTableSize) {
       switch (mappingTable[indexV].mapType) {
       case m_oneLight: {
         nrOfLights_t indexP = mappingTable[indexV].indexP;
@@ -348,8 +425,8 @@ class VirtualLayer {
   // Frame-level fill / fade operations
   // ----------------------------------------------------------------------------
 
-  // Schedule a fade-to-black for this layer. Applied to virtualChannels at the start of the
-  // next loop() call, before effects run, so trail effects accumulate correctly.
+  // Schedule a fade-to-black for this layer. Applied to virtualChannels when this frame is composited
+  // (compositeTo), so the next frame's effects draw on the faded buffer and trails accumulate correctly.
   void fadeToBlackBy(uint8_t amount = 255) { fadeBy = fadeBy ? MIN(fadeBy, amount) : amount; }
 
   // Start an animated brightness transition toward target (0=invisible, 255=full).
@@ -378,9 +455,16 @@ class VirtualLayer {
   // Reset mapping state and apply modifier sizes before addLight() calls.
   void onLayoutPre();
 
-  // Allocate (or reuse) the mapping table and seed it with a 1:1 mapping.
-  // Called internally when a non-1:1 mapping is first detected.
-  void createMappingTableAndAddOneToOne();
+  // Allocate (or reuse) the mapping table and seed it with a 1:1 mapping of the lights before physical light indexP.
+  // Called internally when a non-1:1 mapping is first detected (at indexP).
+  void createMappingTableAndAddOneToOne(nrOfLights_t indexP);
+
+  // Build the mapping table of a deferred mapping from the grids added so far (PhysicalLayer::gridWiring).
+  void createDeferredMappingTable();
+
+  // onLayoutPost(): replace the mapping table (of pairs virtual, physical lights) by a MappingDescriptor if one gives
+  // the same mapping, or set one for a deferred mapping. False if none does.
+  bool findAnalyticMapping(nrOfLights_t pairs);
 
   // Finalise the mapping table after all addLight() calls; log mapping statistics.
   void onLayoutPost();
@@ -390,6 +474,13 @@ class VirtualLayer {
   // Returns true if this layer covered the physical pixel (used by PhysicalLayer to zero unclaimed pixels).
   bool addLight(Coord3D position);
 
+  // True if addLights() can map grid: no modifier on and the grid inside the layer's window (or no nodes).
+  bool canAddLights(const LightGrid& grid) const;
+
+  // Register lights first .. first + count of grid from physical light layerP->indexP on, as addLight() for each
+  // but by arithmetic: no modifier calls, and no mapping table if the grid continues the 1:1 mapping.
+  bool addLights(const LightGrid& grid, size_t first, size_t count);
+
   // Returns true if the virtual light at indexV has at least one physical light mapped to it.
   bool isMapped(nrOfLights_t indexV) const;
 
@@ -410,6 +501,27 @@ class VirtualLayer {
   // Blur every column independently (vertical 1-D blur).
   void blurColumns(fract8 blur_amount);
 
+  // 3-D blur: blur all lines along x, y and z of the whole virtual grid.
+  void blur3d(fract8 blur_amount);
+
+  // Blurs and bulk drawing run on virtualChannels (BlurKernels.h, BulkDraw.h) when every light of the grid is in it
+  // and no modifier moves positions per frame (hasModifyXYZ); otherwise light by light through getRGB / setRGB.
+  bool drawOnBuffer() const;
+  void blurLineXYZ(Coord3D first, Coord3D step, int length, uint8_t keep, uint8_t seep);
+
+  // Bulk drawing: a span of lights in one call (used by LiveScript, one external call per span instead of per light).
+  // Palette gradient over count lights from index first (stride lights apart), index from startIndex, step in 1/16
+  // palette index per light (4096 / count spans the palette once).
+  void fillGradient(nrOfLights_t first, nrOfLights_t count, int stride, uint8_t startIndex, int16_t step, uint8_t brightness = 255);
+  // Palette gradient along row y / column x (z = 0).
+  void fillRowGradient(int y, uint8_t startIndex, int16_t step, uint8_t brightness = 255);
+  void fillColumnGradient(int x, uint8_t startIndex, int16_t step, uint8_t brightness = 255);
+  // Palette colors of count lights from index first, one palette index per light (a per-light expression).
+  void fillIndexes(nrOfLights_t first, nrOfLights_t count, const uint8_t* indexes, uint8_t brightness = 255);
+  // Copy the width x height rectangle at (x, y) to (toX, toY), clipped; shift moves the whole layer, black moves in.
+  void copyRect(int x, int y, int width, int height, int toX, int toY);
+  void shift(int dx, int dy);
+
   // Draw a 2-D line between (x0,y0) and (x1,y1).
   // soft = true: Xiaolin Wu anti-aliasing; depth: shorten line (255 = full length).
   void drawLine(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, CRGB color, bool soft = false, uint8_t depth = UINT8_MAX);
@@ -0,0 +1,60 @@
+/**
+    @title     MoonLight
+    @file      DriverNodeTypes.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/nodes/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    The node types of ModuleDrivers.h, in the order of the UI list: included by ModuleDrivers.h (nodeTypes) and by
+    test_node_registry.cpp, which checks the names without the node classes (FastLED, ESP32).
+    The includer defines NODE(Class, name), BOARD_NODE(Class, name, board) (only on that board preset) and
+    ALIAS(oldName, name) (renamed nodes, presets keep working); they are undefined at the end of this list.
+    name is the name() of Class: NodeManager::registerNode logs an error at boot when they differ.
+    No #pragma once: included once per use.
+**/
+
+// Layouts, Most used first
+NODE(PanelLayout, "Panel")
+NODE(PanelsLayout, "Panels")
+NODE(CubeLayout, "Cube")
+NODE(HumanSizedCubeLayout, "Human Sized Cube")
+NODE(TorontoBarGourdsLayout, "Toronto Bar Gourds")
+NODE(RingLayout, "Ring")
+NODE(Rings16Layout, "16 Rings")
+NODE(Rings241Layout, "Rings 241")
+NODE(CarLightsLayout, "Car Lights")
+NODE(WheelLayout, "Wheel")
+NODE(SpiralLayout, "Spiral")
+NODE(SingleRowLayout, "Single Row")
+NODE(SingleColumnLayout, "Single Column")
+NODE(TubesLayout, "Tubes")
+
+// Drivers, Most used first
+NODE(ParallelLEDDriver, "Parallel LED Driver")
+NODE(FastLEDDriver, "FastLED Driver")
+NODE(FastLEDAudioDriver, "FastLED Audio")
+NODE(NetworkInDriver, "Network In")
+NODE(NetworkOutDriver, "Network Out")
+NODE(DMXInDriver, "DMX In")
+NODE(DMXOutDriver, "DMX Out")
+NODE(WLEDAudioDriver, "WLED Audio")
+NODE(IRDriver, "Infrared Driver")
+NODE(IMUDriver, "IMU driver")
+// NODE(HUB75Driver, "HUB75 Driver")
+
+// board preset specific
+BOARD_NODE(SE16Layout, "SE16", BoardName::SE16V1)
+BOARD_NODE(LightCrafter16Layout, "LightCrafter16", BoardName::LightCrafter16)
+
+// Migration: Art-Net In / Art-Net Out were renamed to Network In / Network Out, Audio Sync to WLED Audio.
+// equalAZaz09 strips punctuation, so "ArtNetIn" != "NetworkIn" — keep the old names as aliases.
+ALIAS("ArtNetIn", "Network In")
+ALIAS("ArtNetOut", "Network Out")
+ALIAS("AudioSync", "WLED Audio")
+
+#undef NODE
+#undef BOARD_NODE
+#undef ALIAS
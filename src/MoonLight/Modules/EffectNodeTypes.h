@@ -0,0 +1,133 @@
+/**
+    @title     MoonLight
+    @file      EffectNodeTypes.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/develop/nodes/
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact us for more information.
+
+    The node types of ModuleEffects.h, in the order of the UI list: included by ModuleEffects.h (nodeTypes) and by
+    test_node_registry.cpp, which checks the names without the node classes (FastLED, ESP32).
+    The includer defines NODE(Class, name), BOARD_NODE(Class, name, board) (only on that board preset) and
+    ALIAS(oldName, name) (renamed nodes, presets keep working); they are undefined at the end of this list.
+    name is the name() of Class: NodeManager::registerNode logs an error at boot when they differ.
+    No #pragma once: included once per use.
+**/
+
+// keep the order the same as in https://moonmodules.org/MoonLight/moonlight/effects
+
+// MoonLight effects, Solid first then alphabetically
+NODE(SolidEffect, "Solid")
+NODE(AudioRingsEffect, "Audio Rings")
+NODE(LinesEffect, "Lines")
+NODE(FireEffect, "Fire")
+NODE(FixedRectangleEffect, "Fixed Rectangle")
+#if USE_M5UNIFIED
+NODE(MoonManEffect, "Moon Man")
+#endif
+NODE(FreqSawsEffect, "Frequency Saws")
+NODE(MarioTestEffect, "Mario Test")
+NODE(ParticlesEffect, "Particles")
+NODE(PixelMapEffect, "Pixel Map")
+NODE(PraxisEffect, "Praxis")
+NODE(RadarEffect, "Radar")
+NODE(RandomEffect, "Random")
+NODE(RingRandomFlowEffect, "Ring Random Flow")
+NODE(RipplesEffect, "Ripples")
+NODE(RubiksCubeEffect, "Rubik's Cube")
+NODE(ScrollingTextEffect, "Scrolling Text")
+NODE(SinusEffect, "Sinus")
+NODE(SphereMoveEffect, "Sphere Move")
+NODE(SpiralFireEffect, "Spiral Fire")
+NODE(StarFieldEffect, "StarField")
+NODE(StarSkyEffect, "Star Sky")
+NODE(VUMeterEffect, "VU Meter")
+NODE(WaveEffect, "Wave")
+
+// MoonModules effects, alphabetically
+NODE(GameOfLifeEffect, "Game Of Life")
+NODE(GEQ3DEffect, "GEQ 3D")
+NODE(PaintBrushEffect, "Paintbrush")
+
+// WLED effects, alphabetically
+NODE(BlackholeEffect, "Blackhole")
+NODE(BlinkRainbowEffect, "Blink Rainbow")
+NODE(BlurzEffect, "Blurz")
+NODE(BouncingBallsEffect, "Bouncing Balls")
+NODE(ColorTwinkleEffect, "Color Twinkle")
+NODE(DistortionWavesEffect, "Distortion Waves")
+NODE(DJLightEffect, "DJ Light")
+NODE(DNAEffect, "DNA")
+NODE(DripEffect, "Drip")
+NODE(FireworksEffect, "Fireworks")
+NODE(FlowEffect, "Flow")
+NODE(FrizzlesEffect, "Frizzles")
+NODE(FunkyPlankEffect, "Funky Plank")
+NODE(GEQEffect, "GEQ")
+NODE(HeartBeatEffect, "Heartbeat")
+NODE(JuliaEffect, "Julia")
+NODE(LissajousEffect, "Lissajous")
+NODE(MeteorEffect, "Meteor")
+NODE(Noise2DEffect, "Noise 2D")
+NODE(NoisefireEffect, "Noise Fire")
+NODE(NoisemoveEffect, "Noise Move")
+NODE(OctopusEffect, "Octopus")
+NODE(OscillateEffect, "Oscillate")
+NODE(PacManEffect, "PacMan")
+NODE(PhasedNoiseEffect, "Phased Noise")
+NODE(PlasmaEffect, "Plasma")
+NODE(PoliceEffect, "Police")
+NODE(PopCornEffect, "Popcorn")
+NODE(RainEffect, "Rain")
+NODE(TetrixEffect, "Tetrix")
+NODE(WaverlyEffect, "Waverly")
+
+NODE(FreqmapEffect, "Freq Map")
+NODE(FreqMatrixEffect, "Freq Matrix")
+NODE(FreqpixelsEffect, "Freq Pixels")
+NODE(FreqwaveEffect, "Freq Wave")
+NODE(GravfreqEffect, "Grav Freq")
+NODE(GravimeterEffect, "Gravimeter")
+NODE(GravcenterEffect, "Grav Center")
+NODE(GravcentricEffect, "Grav Centric")
+NODE(MidnoiseEffect, "Midnoise")
+NODE(NoiseMeterEffect, "Noise Meter")
+NODE(PixelwaveEffect, "Pixelwave")
+NODE(PlasmoidEffect, "Plasmoid")
+NODE(PuddlepeakEffect, "Puddle Peak")
+NODE(PuddlesEffect, "Puddles")
+NODE(RipplepeakEffect, "Ripple Peak")
+NODE(RocktavesEffect, "Rocktaves")
+NODE(WaterfallEffect, "Waterfall")
+
+// FastLED effects
+NODE(ColorTrailsEffect, "Color Trails")
+NODE(RainbowEffect, "Rainbow")
+NODE(FLAudioEffect, "FLAudio")
+NODE(FixedPointCanvasDemoEffect, "Fixed-Point Canvas Demo")
+
+// Moving head effects, alphabetically
+NODE(AmbientMoveEffect, "Ambient Move")
+NODE(FreqColorsEffect, "Freq Colors")
+NODE(Troy1ColorEffect, "Troy1 Color")
+NODE(Troy1MoveEffect, "Troy1 Move")
+NODE(Troy2ColorEffect, "Troy2 Color")
+NODE(Troy2MoveEffect, "Troy2 Move")
+NODE(WowiMoveEffect, "Wowi Move")
+
+// Modifiers, most used first
+NODE(MultiplyModifier, "Multiply")
+NODE(MirrorModifier, "Mirror")
+NODE(TransposeModifier, "Transpose")
+NODE(CircleModifier, "Circle")
+NODE(BlockModifier, "Block")
+NODE(RotateModifier, "Rotate")
+NODE(CheckerboardModifier, "Checkerboard")
+NODE(PinwheelModifier, "Pinwheel")
+NODE(RippleXZModifier, "RippleXZ")
+
+#undef NODE
+#undef BOARD_NODE
+#undef ALIAS
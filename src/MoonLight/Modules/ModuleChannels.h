@@ -58,6 +58,10 @@ class ModuleChannels : public Module {
     bool group = _state.data["group"];
 
     if (updatedItem.name == "view" || updatedItem.name == "group") {
+      if (pinned != UINT16_MAX) {  // indexes of another view or grouping
+        holdChannels(pinned, pinnedGroup, false);
+        pinned = UINT16_MAX;
+      }
       uint16_t count = view == 0 ? layerP.lights.header.nrOfLights : layerP.layers[view - 1]->nrOfLights;
       if (!group) count *= layerP.lights.header.channelsPerLight;
       if (count > 512) count = 512;
@@ -77,13 +81,19 @@ class ModuleChannels : public Module {
         if (!layerP.lights.channelsD) return; // to avoid crash during init
         // EXT_LOGD(ML_TAG, "handle %s[%d]%s[%d].%s = %s -> %s", updatedItem.parent[0].c_str(), updatedItem.index[0], updatedItem.parent[1].c_str(), updatedItem.index[1], updatedItem.name.c_str(), updatedItem.oldValue.c_str(), updatedItem.value.as<String>().c_str());
         uint16_t select = updatedItem.value["select"];
-        uint8_t value = updatedItem.value["action"] == "mouseenter" ? 255 : 0;
-        if (view == 0) {  // physical layer
-          if (group)
-            for (uint8_t i = 0; i < layerP.lights.header.channelsPerLight; i++) layerP.lights.channelsD[select * layerP.lights.header.channelsPerLight + i] = value;
-          else
-            layerP.lights.channelsD[select] = value;
+        if (view == 0) {  // physical layer: held as channel overrides, effects keep running
+          const char* action = updatedItem.value["action"];
+          if (equal(action, "click")) {  // pin the selected light / channel, unpin when deselected (select 255)
+            if (pinned != UINT16_MAX) holdChannels(pinned, pinnedGroup, false);
+            pinned = select == 255 ? UINT16_MAX : select;
+            pinnedGroup = group;
+            if (pinned != UINT16_MAX) holdChannels(pinned, group, true);
+          } else if (equal(action, "mouseenter"))
+            holdChannels(select, group, true);
+          else if (equal(action, "mouseleave") && select != pinned)
+            holdChannels(select, group, false);
         } else {
+          uint8_t value = updatedItem.value["action"] == "mouseenter" ? 255 : 0;
           if (group)
             for (uint8_t i = 0; i < layerP.lights.header.channelsPerLight; i++) layerP.layers[view - 1]->setLight(select, i, value); //setLight(select, &value, i, 1);
           else
@@ -94,6 +104,23 @@ class ModuleChannels : public Module {
       // EXT_LOGV(ML_TAG, "no handle for %s[%d]%s[%d].%s = %s -> %s", updatedItem.parent[0].c_str(), updatedItem.index[0], updatedItem.parent[1].c_str(), updatedItem.index[1], updatedItem.name.c_str(), updatedItem.oldValue.c_str(), updatedItem.value.as<String>().c_str());
     }
   }
+
+ private:
+  uint16_t pinned = UINT16_MAX;  // the light (group) or channel held by a click, UINT16_MAX: none
+  bool pinnedGroup = false;
+
+  // Hold select at full (all channels of light select if group) or give it back to the effects.
+  void holdChannels(uint16_t select, bool group, bool hold) {
+    uint8_t channelsPerLight = layerP.lights.header.channelsPerLight;
+    uint32_t first = group ? select * channelsPerLight : select;
+    uint8_t count = group ? channelsPerLight : 1;
+    for (uint8_t i = 0; i < count; i++) {
+      if (hold)
+        layerP.overrideChannel(first + i, 255);
+      else
+        layerP.releaseChannel(first + i);
+    }
+  }
 };
 
 #endif
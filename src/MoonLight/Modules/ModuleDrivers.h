@@ -104,44 +104,22 @@ class ModuleDrivers : public NodeManager {
     NodeManager::begin();
   }
 
+  const NodeRegistry<Node>& nodeTypes() const override {
+    static const NodeRegistry<Node> registry = [] {
+      NodeRegistry<Node> types;
+  #define NODE(Class, name) registerNode<Class>(types, name);
+  #define BOARD_NODE(Class, name, board) registerNode<Class>(types, name, board);
+  #define ALIAS(oldName, name) addAlias(types, oldName, name);
+  #include "DriverNodeTypes.h"
+      return types;
+    }();
+    return registry;
+  }
+
   void addNodes(const JsonObject& control) override {
-    // Layouts, Most used first
-    addNodeValue<PanelLayout>(control);
-    addNodeValue<PanelsLayout>(control);
-    addNodeValue<CubeLayout>(control);
-    addNodeValue<HumanSizedCubeLayout>(control);
-    addNodeValue<TorontoBarGourdsLayout>(control);
-    addNodeValue<RingLayout>(control);
-    addNodeValue<Rings16Layout>(control);
-    addNodeValue<Rings241Layout>(control);
-    addNodeValue<CarLightsLayout>(control);
-    addNodeValue<WheelLayout>(control);
-    addNodeValue<SpiralLayout>(control);
-    addNodeValue<SingleRowLayout>(control);
-    addNodeValue<SingleColumnLayout>(control);
-    addNodeValue<TubesLayout>(control);
-
-    // Drivers, Most used first
-    addNodeValue<ParallelLEDDriver>(control);
-    addNodeValue<FastLEDDriver>(control);
-    addNodeValue<FastLEDAudioDriver>(control);
-    addNodeValue<NetworkInDriver>(control);
-    addNodeValue<NetworkOutDriver>(control);
-    addNodeValue<DMXInDriver>(control);
-    addNodeValue<DMXOutDriver>(control);
-    addNodeValue<WLEDAudioDriver>(control);
-    addNodeValue<IRDriver>(control);
-    addNodeValue<IMUDriver>(control);
-    // addNodeValue<HUB75Driver>(control);
-
-    // board preset specific
-    _moduleIO->read(
-        [&](ModuleState& state) {
-          const char* boardPreset = state.data["boardPreset"] | "";
-          if (strcmp(boardPreset, BoardName::SE16V1) == 0) addNodeValue<SE16Layout>(control);
-          if (strcmp(boardPreset, BoardName::LightCrafter16) == 0) addNodeValue<LightCrafter16Layout>(control);
-        },
-        _moduleName);
+    Char<32> boardPreset;
+    _moduleIO->read([&](ModuleState& state) { boardPreset = state.data["boardPreset"] | ""; }, _moduleName);
+    addNodeValues(control, boardPreset.c_str());
 
   #if FT_LIVESCRIPT
     // find layout/driver live scripts (.sc files with L_ or D_ prefix) on FS
@@ -162,52 +140,9 @@ class ModuleDrivers : public NodeManager {
   }
 
   Node* addNode(const uint8_t index, char* name, const JsonArray& controls) const override {
-    Node* node = nullptr;
-
-    // Layouts, most used first
-    // cppcheck-suppress knownConditionTrueFalse -- intentional: chain tries each type in order; first check is always true after node=nullptr
-    if (!node) node = checkAndAlloc<PanelLayout>(name);
-    if (!node) node = checkAndAlloc<PanelsLayout>(name);
-    if (!node) node = checkAndAlloc<CubeLayout>(name);
-    if (!node) node = checkAndAlloc<RingLayout>(name);
-    if (!node) node = checkAndAlloc<Rings16Layout>(name);
-    if (!node) node = checkAndAlloc<Rings241Layout>(name);
-    if (!node) node = checkAndAlloc<CarLightsLayout>(name);
-    if (!node) node = checkAndAlloc<WheelLayout>(name);
-    if (!node) node = checkAndAlloc<SpiralLayout>(name);
-    if (!node) node = checkAndAlloc<HumanSizedCubeLayout>(name);
-    if (!node) node = checkAndAlloc<TorontoBarGourdsLayout>(name);
-    if (!node) node = checkAndAlloc<SingleRowLayout>(name);
-    if (!node) node = checkAndAlloc<SingleColumnLayout>(name);
-    if (!node) node = checkAndAlloc<TubesLayout>(name);
-
-    // Drivers most used first
-    if (!node) node = checkAndAlloc<ParallelLEDDriver>(name);
-    if (!node) node = checkAndAlloc<FastLEDDriver>(name);
-    if (!node) node = checkAndAlloc<FastLEDAudioDriver>(name);
-    if (!node) node = checkAndAlloc<NetworkInDriver>(name);
-    if (!node) node = checkAndAlloc<NetworkOutDriver>(name);
-    // Migration: Art-Net In / Art-Net Out were renamed to Network In / Network Out.
-    // equalAZaz09 strips punctuation, so "ArtNetIn" != "NetworkIn" — handle explicitly.
-    if (!node && equalAZaz09(name, "ArtNetIn"))  { strlcpy(name, NetworkInDriver::name(),  32); node = allocMBObject<NetworkInDriver>();  }
-    if (!node && equalAZaz09(name, "ArtNetOut")) { strlcpy(name, NetworkOutDriver::name(), 32); node = allocMBObject<NetworkOutDriver>(); }
-    if (!node) node = checkAndAlloc<DMXInDriver>(name);
-    if (!node) node = checkAndAlloc<DMXOutDriver>(name);
-    if (!node) node = checkAndAlloc<WLEDAudioDriver>(name);
-    // Migration: Audio Sync was renamed to WLED Audio.
-    if (!node && equalAZaz09(name, "AudioSync")) { strlcpy(name, WLEDAudioDriver::name(), 32); node = allocMBObject<WLEDAudioDriver>(); }
-    if (!node) node = checkAndAlloc<IRDriver>(name);
-    if (!node) node = checkAndAlloc<IMUDriver>(name);
-    // if (!node) node = checkAndAlloc<HUB75Driver>(name);
-
-    // board preset specific
-    _moduleIO->read(
-        [&](ModuleState& state) {
-          const char* boardPreset = state.data["boardPreset"] | "";
-          if (!node && strcmp(boardPreset, BoardName::SE16V1) == 0) node = checkAndAlloc<SE16Layout>(name);
-          if (!node && strcmp(boardPreset, BoardName::LightCrafter16) == 0) node = checkAndAlloc<LightCrafter16Layout>(name);
-        },
-        _moduleName);
+    Char<32> boardPreset;
+    _moduleIO->read([&](ModuleState& state) { boardPreset = state.data["boardPreset"] | ""; }, _moduleName);
+    Node* node = createNode(name, boardPreset.c_str());
 
   #if FT_LIVESCRIPT
     if (!node && !safeModeMB) {
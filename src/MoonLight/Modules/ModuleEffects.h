@@ -39,15 +39,17 @@ class ModuleEffects : public NodeManager {
     layerMgr.scheduleRestore();
 
   #if FT_ENABLED(FT_MONITOR)
-    _sveltekit->getSocket()->registerEvent("monitor");
+    _sveltekit->getSocket()->registerEvent("monitor", EventSendPolicy::ordered);  // header and positions in order, frames are sent with emitStreamEvent
     _server->on("/rest/monitorLayout", HTTP_GET, [&](PsychicRequest* request) {
       EXT_LOGV(ML_TAG, "rest monitor triggered");
 
       // trigger pass 1 mapping of layout
+      xSemaphoreTake(layerP.driversMutex, portMAX_DELAY);  // layout nodes run in driverTask
       layerP.pass = 1;  //(requestMapPhysical=1 physical rerun)
       layerP.monitorPass = true;
       layerP.mapLayout();
       layerP.monitorPass = false;
+      xSemaphoreGive(layerP.driversMutex);
 
       PsychicJsonResponse response = PsychicJsonResponse(request, false);
       return response.send();
@@ -63,118 +65,20 @@ class ModuleEffects : public NodeManager {
     NodeManager::setupDefinition(controls);
   }
 
+  const NodeRegistry<Node>& nodeTypes() const override {
+    static const NodeRegistry<Node> registry = [] {
+      NodeRegistry<Node> types;
+  #define NODE(Class, name) registerNode<Class>(types, name);
+  #define BOARD_NODE(Class, name, board) registerNode<Class>(types, name, board);
+  #define ALIAS(oldName, name) addAlias(types, oldName, name);
+  #include "EffectNodeTypes.h"
+      return types;
+    }();
+    return registry;
+  }
+
   void addNodes(const JsonObject& control) override {
-    // keep the order the same as in https://moonmodules.org/MoonLight/moonlight/effects
-
-    // MoonLight effects, Solid first then alphabetically
-    addNodeValue<SolidEffect>(control);
-    addNodeValue<AudioRingsEffect>(control);
-    addNodeValue<LinesEffect>(control);
-    addNodeValue<FireEffect>(control);
-    addNodeValue<FixedRectangleEffect>(control);
-  #if USE_M5UNIFIED
-    addNodeValue<MoonManEffect>(control);
-  #endif
-    addNodeValue<FreqSawsEffect>(control);
-    addNodeValue<MarioTestEffect>(control);
-    addNodeValue<ParticlesEffect>(control);
-    addNodeValue<PixelMapEffect>(control);
-    addNodeValue<PraxisEffect>(control);
-    addNodeValue<RadarEffect>(control);
-    addNodeValue<RandomEffect>(control);
-    addNodeValue<RingRandomFlowEffect>(control);
-    addNodeValue<RipplesEffect>(control);
-    addNodeValue<RubiksCubeEffect>(control);
-    addNodeValue<ScrollingTextEffect>(control);
-    addNodeValue<SinusEffect>(control);
-    addNodeValue<SphereMoveEffect>(control);
-    addNodeValue<SpiralFireEffect>(control);
-    addNodeValue<StarFieldEffect>(control);
-    addNodeValue<StarSkyEffect>(control);
-    addNodeValue<VUMeterEffect>(control);
-    addNodeValue<WaveEffect>(control);
-
-    // MoonModules effects, alphabetically
-    addNodeValue<GameOfLifeEffect>(control);
-    addNodeValue<GEQ3DEffect>(control);
-    addNodeValue<PaintBrushEffect>(control);
-
-    // WLED effects, alphabetically
-    addNodeValue<BlackholeEffect>(control);
-    addNodeValue<BlinkRainbowEffect>(control);
-    addNodeValue<BlurzEffect>(control);
-    addNodeValue<BouncingBallsEffect>(control);
-    addNodeValue<ColorTwinkleEffect>(control);
-    addNodeValue<DistortionWavesEffect>(control);
-    addNodeValue<DJLightEffect>(control);
-    addNodeValue<DNAEffect>(control);
-    addNodeValue<DripEffect>(control);
-    addNodeValue<FireworksEffect>(control);
-    addNodeValue<FlowEffect>(control);
-    addNodeValue<FrizzlesEffect>(control);
-    addNodeValue<FunkyPlankEffect>(control);
-    addNodeValue<GEQEffect>(control);
-    addNodeValue<HeartBeatEffect>(control);
-    addNodeValue<JuliaEffect>(control);
-    addNodeValue<LissajousEffect>(control);
-    addNodeValue<MeteorEffect>(control);
-    addNodeValue<Noise2DEffect>(control);
-    addNodeValue<NoisefireEffect>(control);
-    addNodeValue<NoisemoveEffect>(control);
-    addNodeValue<OctopusEffect>(control);
-    addNodeValue<OscillateEffect>(control);
-    addNodeValue<PacManEffect>(control);
-    addNodeValue<PhasedNoiseEffect>(control);
-    addNodeValue<PlasmaEffect>(control);
-    addNodeValue<PoliceEffect>(control);
-    addNodeValue<PopCornEffect>(control);
-    addNodeValue<RainEffect>(control);
-    addNodeValue<TetrixEffect>(control);
-    addNodeValue<WaverlyEffect>(control);
-
-    addNodeValue<FreqmapEffect>(control);
-    addNodeValue<FreqMatrixEffect>(control);
-    addNodeValue<FreqpixelsEffect>(control);
-    addNodeValue<FreqwaveEffect>(control);
-    addNodeValue<GravfreqEffect>(control);
-    addNodeValue<GravimeterEffect>(control);
-    addNodeValue<GravcenterEffect>(control);
-    addNodeValue<GravcentricEffect>(control);
-    addNodeValue<MidnoiseEffect>(control);
-    addNodeValue<NoiseMeterEffect>(control);
-    addNodeValue<PixelwaveEffect>(control);
-    addNodeValue<PlasmoidEffect>(control);
-    addNodeValue<PuddlepeakEffect>(control);
-    addNodeValue<PuddlesEffect>(control);
-    addNodeValue<RipplepeakEffect>(control);
-    addNodeValue<RocktavesEffect>(control);
-    addNodeValue<WaterfallEffect>(control);
-
-    // FastLED effects
-    addNodeValue<ColorTrailsEffect>(control);
-    addNodeValue<RainbowEffect>(control);
-    addNodeValue<FLAudioEffect>(control);
-    addNodeValue<FixedPointCanvasDemoEffect>(control);
-
-    // Moving head effects, alphabetically
-    addNodeValue<AmbientMoveEffect>(control);
-    addNodeValue<FreqColorsEffect>(control);
-    addNodeValue<Troy1ColorEffect>(control);
-    addNodeValue<Troy1MoveEffect>(control);
-    addNodeValue<Troy2ColorEffect>(control);
-    addNodeValue<Troy2MoveEffect>(control);
-    addNodeValue<WowiMoveEffect>(control);
-
-    // Modifiers, most used first
-    addNodeValue<MultiplyModifier>(control);
-    addNodeValue<MirrorModifier>(control);
-    addNodeValue<TransposeModifier>(control);
-    addNodeValue<CircleModifier>(control);
-    addNodeValue<BlockModifier>(control);
-    addNodeValue<RotateModifier>(control);
-    addNodeValue<CheckerboardModifier>(control);
-    addNodeValue<PinwheelModifier>(control);
-    addNodeValue<RippleXZModifier>(control);
+    addNodeValues(control);
 
     // find all the .sc files on FS
     File rootFolder = ESPFS.open("/");
@@ -193,120 +97,16 @@ class ModuleEffects : public NodeManager {
   }
 
   Node* addNode(const uint8_t index, char* name, const JsonArray& controls) const override {
-    Node* node = nullptr;
-
-    // MoonLight effects, Solid first then alphabetically
-    // cppcheck-suppress knownConditionTrueFalse -- intentional: chain tries each type in order; first check is always true after node=nullptr
-    if (!node) node = checkAndAlloc<SolidEffect>(name);
-    if (!node) node = checkAndAlloc<AudioRingsEffect>(name);
-    if (!node) node = checkAndAlloc<FireEffect>(name);
-    if (!node) node = checkAndAlloc<FixedRectangleEffect>(name);
-    if (!node) node = checkAndAlloc<FreqSawsEffect>(name);
-    if (!node) node = checkAndAlloc<LinesEffect>(name);
-    if (!node) node = checkAndAlloc<MarioTestEffect>(name);
-  #if USE_M5UNIFIED
-    if (!node) node = checkAndAlloc<MoonManEffect>(name);
-  #endif
-    if (!node) node = checkAndAlloc<ParticlesEffect>(name);
-    if (!node) node = checkAndAlloc<PixelMapEffect>(name);
-    if (!node) node = checkAndAlloc<PraxisEffect>(name);
-    if (!node) node = checkAndAlloc<RadarEffect>(name);
-    if (!node) node = checkAndAlloc<RandomEffect>(name);
-    if (!node) node = checkAndAlloc<RingRandomFlowEffect>(name);
-    if (!node) node = checkAndAlloc<RipplesEffect>(name);
-    if (!node) node = checkAndAlloc<RubiksCubeEffect>(name);
-    if (!node) node = checkAndAlloc<ScrollingTextEffect>(name);
-    if (!node) node = checkAndAlloc<SinusEffect>(name);
-    if (!node) node = checkAndAlloc<SphereMoveEffect>(name);
-    if (!node) node = checkAndAlloc<SpiralFireEffect>(name);
-    if (!node) node = checkAndAlloc<StarFieldEffect>(name);
-    if (!node) node = checkAndAlloc<StarSkyEffect>(name);
-    if (!node) node = checkAndAlloc<VUMeterEffect>(name);
-    if (!node) node = checkAndAlloc<WaveEffect>(name);
-
-    // MoonModules effects, alphabetically
-    if (!node) node = checkAndAlloc<GameOfLifeEffect>(name);
-    if (!node) node = checkAndAlloc<GEQ3DEffect>(name);
-    if (!node) node = checkAndAlloc<PaintBrushEffect>(name);
-
-    // WLED effects, alphabetically
-    if (!node) node = checkAndAlloc<BlackholeEffect>(name);
-    if (!node) node = checkAndAlloc<BlinkRainbowEffect>(name);
-    if (!node) node = checkAndAlloc<BlurzEffect>(name);
-    if (!node) node = checkAndAlloc<BouncingBallsEffect>(name);
-    if (!node) node = checkAndAlloc<ColorTwinkleEffect>(name);
-    if (!node) node = checkAndAlloc<DistortionWavesEffect>(name);
-    if (!node) node = checkAndAlloc<DJLightEffect>(name);
-    if (!node) node = checkAndAlloc<DNAEffect>(name);
-    if (!node) node = checkAndAlloc<DripEffect>(name);
-    if (!node) node = checkAndAlloc<FireworksEffect>(name);
-    if (!node) node = checkAndAlloc<FlowEffect>(name);
-    if (!node) node = checkAndAlloc<FrizzlesEffect>(name);
-    if (!node) node = checkAndAlloc<FunkyPlankEffect>(name);
-    if (!node) node = checkAndAlloc<GEQEffect>(name);
-    if (!node) node = checkAndAlloc<HeartBeatEffect>(name);
-    if (!node) node = checkAndAlloc<JuliaEffect>(name);
-    if (!node) node = checkAndAlloc<LissajousEffect>(name);
-    if (!node) node = checkAndAlloc<MeteorEffect>(name);
-    if (!node) node = checkAndAlloc<Noise2DEffect>(name);
-    if (!node) node = checkAndAlloc<NoisefireEffect>(name);
-    if (!node) node = checkAndAlloc<NoisemoveEffect>(name);
-    if (!node) node = checkAndAlloc<OctopusEffect>(name);
-    if (!node) node = checkAndAlloc<OscillateEffect>(name);
-    if (!node) node = checkAndAlloc<PacManEffect>(name);
-    if (!node) node = checkAndAlloc<PhasedNoiseEffect>(name);
-    if (!node) node = checkAndAlloc<PlasmaEffect>(name);
-    if (!node) node = checkAndAlloc<PoliceEffect>(name);
-    if (!node) node = checkAndAlloc<PopCornEffect>(name);
-    if (!node) node = checkAndAlloc<RainEffect>(name);
-    if (!node) node = checkAndAlloc<TetrixEffect>(name);
-    if (!node) node = checkAndAlloc<WaverlyEffect>(name);
-
-    if (!node) node = checkAndAlloc<FreqmapEffect>(name);
-    if (!node) node = checkAndAlloc<FreqMatrixEffect>(name);
-    if (!node) node = checkAndAlloc<FreqpixelsEffect>(name);
-    if (!node) node = checkAndAlloc<FreqwaveEffect>(name);
-    if (!node) node = checkAndAlloc<GravfreqEffect>(name);
-    if (!node) node = checkAndAlloc<GravimeterEffect>(name);
-    if (!node) node = checkAndAlloc<GravcenterEffect>(name);
-    if (!node) node = checkAndAlloc<GravcentricEffect>(name);
-    if (!node) node = checkAndAlloc<MidnoiseEffect>(name);
-    if (!node) node = checkAndAlloc<NoiseMeterEffect>(name);
-    if (!node) node = checkAndAlloc<PixelwaveEffect>(name);
-    if (!node) node = checkAndAlloc<PlasmoidEffect>(name);
-    if (!node) node = checkAndAlloc<PuddlepeakEffect>(name);
-    if (!node) node = checkAndAlloc<PuddlesEffect>(name);
-    if (!node) node = checkAndAlloc<RipplepeakEffect>(name);
-    if (!node) node = checkAndAlloc<RocktavesEffect>(name);
-    if (!node) node = checkAndAlloc<WaterfallEffect>(name);
-
-    // FastLED
-    if (!node) node = checkAndAlloc<ColorTrailsEffect>(name);
-    if (!node) node = checkAndAlloc<RainbowEffect>(name);
-    if (!node) node = checkAndAlloc<FLAudioEffect>(name);
-    if (!node) node = checkAndAlloc<FixedPointCanvasDemoEffect>(name);
-
-    // Moving head effects, alphabetically
-
-    if (!node) node = checkAndAlloc<AmbientMoveEffect>(name);
-    if (!node) node = checkAndAlloc<FreqColorsEffect>(name);
-    if (!node) node = checkAndAlloc<Troy1ColorEffect>(name);
-    if (!node) node = checkAndAlloc<Troy1MoveEffect>(name);
-    if (!node) node = checkAndAlloc<Troy2ColorEffect>(name);
-    if (!node) node = checkAndAlloc<Troy2MoveEffect>(name);
-    if (!node) node = checkAndAlloc<WowiMoveEffect>(name);
-
-    // Modifiers, most used first
-
-    if (!node) node = checkAndAlloc<MultiplyModifier>(name);
-    if (!node) node = checkAndAlloc<MirrorModifier>(name);
-    if (!node) node = checkAndAlloc<TransposeModifier>(name);
-    if (!node) node = checkAndAlloc<CircleModifier>(name);
-    if (!node) node = checkAndAlloc<BlockModifier>(name);
-    if (!node) node = checkAndAlloc<RotateModifier>(name);
-    if (!node) node = checkAndAlloc<CheckerboardModifier>(name);
-    if (!node) node = checkAndAlloc<PinwheelModifier>(name);
-    if (!node) node = checkAndAlloc<RippleXZModifier>(name);
+    if (memBudget.degraded(MemDegradeNodes)) {  // low on heap: the nodes running keep running, no new ones
+      EXT_LOGW(ML_TAG, "%s not added: low on memory (%s)", name, memDegradationName(memBudget.level()));
+      return nullptr;
+    }
+    VirtualLayer* layer = layerP.ensureLayer(layerMgr.getSelectedLayer());
+    layer->ensureNodePool();
+    uint16_t poolOwner = layer->nodePool.newOwner();
+    NodePoolScope poolScope(&layer->nodePool, poolOwner);  // the node and the buffers of its setup / onSizeChanged from the layer pool
+
+    Node* node = createNode(name);
 
   #if FT_LIVESCRIPT
     if (!node && !safeModeMB) {
@@ -319,7 +119,7 @@ class ModuleEffects : public NodeManager {
     if (node) {
       EXT_LOGI(ML_TAG, "Add %s (p:%p pr:%d)", name, node, isInPSRAM(node));
 
-      VirtualLayer* layer = layerP.ensureLayer(layerMgr.getSelectedLayer());
+      node->poolOwner = poolOwner;
       node->constructor(layer, controls, &layerP.effectsMutex);  // pass the selected layer to the node
       node->moduleControl = _moduleLightsControl;                // to access global lights control functions if needed
       // node->moduleIO = _moduleIO;                     // to get pin allocations
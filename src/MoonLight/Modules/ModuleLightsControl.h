@@ -19,6 +19,7 @@
   #include "MoonBase/Modules/FileManager.h"
   #include "MoonBase/Nodes.h"                // for Node::updateControl
   #include "MoonBase/utilities/PlatformFunctions.h"  //for isInPSRAM
+  #include "MoonLight/Layers/MonitorCodec.h"
   #include "palettes.h"
   #if FT_LIVESCRIPT
     #include "MoonBase/LiveScriptNode.h"
@@ -55,6 +56,15 @@ class ModuleLightsControl : public Module {
   MqttSettingsService* _mqttSettingsService;
   update_handler_id_t _mqttSettingsUpdateHandlerId = 0;  // track handler ID
   #endif
+  #if FT_ENABLED(FT_MONITOR)
+  MonitorEncoder _monitorEncoder;
+  uint8_t* _monitorPrevious = nullptr;  // frame as the monitor clients hold it
+  size_t _monitorPreviousSize = 0;
+  uint8_t* _monitorFrame = nullptr;  // encoded frame
+  size_t _monitorFrameSize = 0;
+  unsigned int _monitorClients = 0;
+  EventId _monitorEvent = EVENT_ID_NONE;  // registered by ModuleEffects
+  #endif
  public:
   FileManager* _fileManager;
   ModuleIO* _moduleIO;
@@ -338,6 +348,9 @@ class ModuleLightsControl : public Module {
     }
   #endif
 
+    control = addControl(controls, "paletteBlend", "slider", 0, 100, false, "palette transition in 1/10 s");
+    control["default"] = 10;
+
     control = addControl(controls, "bpm", "slider");
     control["default"] = 60;
 
@@ -363,6 +376,13 @@ class ModuleLightsControl : public Module {
   #if FT_ENABLED(FT_MONITOR)
     control = addControl(controls, "monitorOn", "checkbox");
     control["default"] = true;
+    control = addControl(controls, "monitorDownsample", "slider", 1, 16);  // send every nth light
+    control["default"] = 1;
+  #endif
+
+  #ifndef CONFIG_FREERTOS_UNICORE
+    control = addControl(controls, "multiCore", "checkbox");
+    control["default"] = false;
   #endif
   }
 
@@ -394,10 +414,13 @@ class ModuleLightsControl : public Module {
       uint8_t nrOfHardcodedPalettes = sizeof(palette_names) / sizeof(palette_names[0]);
 
       if (index < nrOfHardcodedPalettes) {
-        layerP.palette = getGradientPalette(index);
+        // crossfade (also when selected by group sync, so a group fades together); audio palettes are written by the audio driver
+        uint8_t paletteBlend = strstr(palette_names[index], "♪") ? 0 : _state.data["paletteBlend"].as<uint8_t>();
+        layerP.setPalette(getGradientPalette(index), paletteBlend * 100);
       }
       #if FT_LIVESCRIPT
       else {
+        layerP.stopPaletteTransition();  // the script writes the palette entries
         // LiveScript palette — find the P_ script by index offset
         uint8_t palScriptIndex = index - nrOfHardcodedPalettes;
         uint8_t count = 0;
@@ -420,6 +443,8 @@ class ModuleLightsControl : public Module {
         rootFolder.close();
       }
       #endif
+    } else if (updatedItem.name == "multiCore") {
+      layerP.parallelRender = updatedItem.value;  // applied by effectTask at the start of the next frame
     } else if (updatedItem.name == "bpm") {
       if (updatedItem.originId->toInt()) {  // only propagate UI-initiated changes to nodes
         uint8_t bpm = _state.data["bpm"];
@@ -458,16 +483,19 @@ class ModuleLightsControl : public Module {
                   [&](FilesState& state) {
                     state.updatedItems.clear();
                     state.updatedItems.push_back("/.config/effects.json");
+                    state.indexPath("/.config/effects.json");
                     return StateUpdateResult::CHANGED;  // notify StatefulService by returning CHANGED
                   },
                   *updatedItem.originId);
             } else {
               copyFile("/.config/effects.json", presetFile.c_str());
+              _fileManager->fileChanged(presetFile.c_str(), *updatedItem.originId);
               setPresetsFromFolder();  // update presets in UI
             }
           }
         } else if (updatedItem.value["action"] == "dblclick") {
           ESPFS.remove(presetFile.c_str());
+          _fileManager->fileChanged(presetFile.c_str(), *updatedItem.originId);
           setPresetsFromFolder();  // update presets in UI
         }
         // Clear transient action/select fields after processing to prevent stale UI echoes.
@@ -656,6 +684,7 @@ class ModuleLightsControl : public Module {
           static_assert(sizeof(LightsHeader) > headerPrimeNumber, "LightsHeader size nog large enough for Monitor protocol");
           _sveltekit->getSocket()->emitEvent("monitor", (char*)&layerP.lights.header, headerPrimeNumber, _moduleName);                                                      // send headerPrimeNumber bytes so Monitor.svelte can recognize this
           _sveltekit->getSocket()->emitEvent("monitor", (char*)layerP.lights.channelsD, layerP.lights.header.nrOfLights * 3, _moduleName);  //*3 is for 3 bytes position
+          _monitorEncoder.requestKeyframe();  // clients reset their frame on a new header
         }
         // isPositions==2 is set before onLayoutPost() resizes channelsD to nrOfChannels,
         // so channelsD holds only nrOfLights*3 bytes here. Use that size, not nrOfChannels.
@@ -670,8 +699,29 @@ class ModuleLightsControl : public Module {
       if (millis() - monitorMillis >= MAX(20, layerP.lights.header.nrOfLights / 300)) {  // 12K lights -> 40ms
         monitorMillis = millis();
 
-        if (layerP.lights.channelsD && _sveltekit->getSocket()->getActiveClients() && _state.data["monitorOn"]) {
-          _sveltekit->getSocket()->emitEvent("monitor", (char*)layerP.lights.channelsD, layerP.lights.header.nrOfChannels, _moduleName);  // use channelsD as it won't be overwritten by effects during loop
+        unsigned int activeClients = _sveltekit->getSocket()->getActiveClients();
+        if (activeClients > _monitorClients) _monitorEncoder.requestKeyframe();  // new client: send it a full frame
+        _monitorClients = activeClients;
+
+        if (memBudget.degraded(MemDegradeMonitor)) {  // low on heap: no monitor frames, the buffers go first
+          if (_monitorPrevious) freeMB(_monitorPrevious, "monitorPrevious");
+          if (_monitorFrame) freeMB(_monitorFrame, "monitorFrame");
+          _monitorPreviousSize = _monitorFrameSize = 0;
+        } else if (layerP.lights.channelsD && activeClients && _state.data["monitorOn"]) {
+          uint8_t step = MAX(1, _state.data["monitorDownsample"].as<uint8_t>());
+          uint8_t channelsPerLight = layerP.lights.header.channelsPerLight;
+          size_t length = monitorFrameLength(layerP.lights.header.nrOfLights, channelsPerLight, step);
+          if (length != _monitorPreviousSize) {  // other layout or step: previous frame is of no use
+            reallocMB2<uint8_t>(_monitorPrevious, _monitorPreviousSize, length, "monitorPrevious", MemMonitor);
+            reallocMB2<uint8_t>(_monitorFrame, _monitorFrameSize, monitorMaxEncodedSize(length), "monitorFrame", MemMonitor);
+            _monitorEncoder.requestKeyframe();
+          }
+          if (_monitorPrevious && _monitorPreviousSize == length && _monitorFrameSize == monitorMaxEncodedSize(length)) {
+            // use channelsD as it won't be overwritten by effects during loop
+            size_t size = _monitorEncoder.encode(layerP.lights.channelsD, layerP.lights.header.nrOfLights, channelsPerLight, step, _monitorPrevious, _monitorFrame);
+            if (_monitorEvent == EVENT_ID_NONE) _monitorEvent = _sveltekit->getSocket()->getEventId("monitor");
+            _sveltekit->getSocket()->emitStreamEvent(_monitorEvent, (char*)_monitorFrame, size, _monitorFrame[1] & MONITOR_FLAG_KEYFRAME);  // lagging clients only get keyframes
+          }
         }
       }
     }
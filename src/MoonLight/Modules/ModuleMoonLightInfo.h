@@ -42,6 +42,7 @@ class ModuleMoonLightInfo : public Module {
       addControl(rows, "nrOfOneLight", "number", 0, UINT16_MAX, true);
       addControl(rows, "mappingTableIndexes#", "number", 0, UINT16_MAX, true);
       addControl(rows, "nrOfMoreLights", "number", 0, UINT16_MAX, true);
+      addControl(rows, "mappingRuns#", "number", 0, UINT16_MAX, true);
       addControl(rows, "nodes#", "number", 0, 255, true);
     }
   }
@@ -66,6 +67,26 @@ class ModuleMoonLightInfo : public Module {
         nrOfLights_t nrOfZeroLights = 0;
         nrOfLights_t nrOfOneLight = 0;
         nrOfLights_t nrOfMoreLights = 0;
+        size_t mappingRuns = 0;
+        if (layer->analyticMapping) {  // no table: the pairs of the MappingDescriptor
+          size_t lights;
+          layer->mapping.count(lights, mappingRuns);
+          if (layer->mapping.unique()) {
+            nrOfOneLight = lights;
+            nrOfZeroLights = layer->nrOfLights - lights;
+          } else {  // copies (Mirror, Multiply): per virtual light, as the table would have it
+            for (nrOfLights_t indexV = 0; indexV < layer->nrOfLights; indexV++) {
+              nrOfLights_t count = 0;
+              layer->mapping.forEachIndexP(indexV, [&](uint32_t) { count++; });
+              if (count == 0)
+                nrOfZeroLights++;
+              else if (count == 1)
+                nrOfOneLight++;
+              else
+                nrOfMoreLights += count;
+            }
+          }
+        }
         for (size_t i = 0; i < layer->mappingTableSize; i++) {
           PhysMap& map = layer->mappingTable[i];
           switch (map.mapType) {
@@ -93,6 +114,7 @@ class ModuleMoonLightInfo : public Module {
         data["layers"][index]["nrOfOneLight"] = nrOfOneLight;
         data["layers"][index]["mappingTableIndexes#"] = layer->mappingTableIndexesSizeUsed;
         data["layers"][index]["nrOfMoreLights"] = nrOfMoreLights;
+        data["layers"][index]["mappingRuns#"] = mappingRuns;
         data["layers"][index]["nodes#"] = layer->nodes.size();
         index++;
       }
@@ -13,6 +13,7 @@
 
 #if FT_MOONLIGHT
 
+#include "MoonBase/utilities/DMXFrames.h"
 #include "driver/uart.h"
 #include "soc/soc_caps.h"
 
@@ -23,28 +24,55 @@
 // Requires at minimum pin_RS485_TX assigned in the board preset;
 // pin_RS485_DE is optional (enables automatic RS-485 direction control).
 //
+// A frame of 512 slots takes ~23 ms on the wire. loop() only builds the frames (DMXFrames.h) and hands them to the
+// DMX task, which sends them on all universes at once and resends the last frame when no new one comes (fixtures
+// hold their values ~1 s). The driver task (and the LED drivers in it) never waits for a UART.
+// More universes (ESP32-P4): one UART and one pin_RS485_TX (and optional pin_RS485_DE) per universe, in board order.
+//
 // See also: https://github.com/MoonModules/MoonLight/issues/157
 
 class DMXOutDriver : public DriverNode {
  private:
-  uint16_t startChannel = 1;   // DMX start address (1-512)
+  uint16_t startChannel = 1;   // DMX start address (1-512) in the first universe
+  uint8_t universes = 1;       // lights that do not fit in a universe continue in the next, at address 1
   Char<32> status = "No pins";
 
-  uint8_t pinTX = UINT8_MAX;
-  uint8_t pinDE = UINT8_MAX;
-
 // DMXOut uses UART_NUM_2 on 3-UART chips so it doesn't collide with DMXIn (UART_NUM_1) or
 // ModuleIO's RS-485 bootstrap (also UART_NUM_1).  On 2-UART chips there is no UART_NUM_2, so
 // both DMX nodes fall back to UART_NUM_1 — startDMX() detects the conflict at runtime.
 // SOC_UART_NUM counts only the standard HP UARTs; see D_DMXIn.h for the full explanation.
-#if SOC_UART_NUM > 2
-  static constexpr uart_port_t uartNum = UART_NUM_2;
+// ESP32-P4 has 5 HP UARTs: universes 2 and 3 on UART_NUM_3 and UART_NUM_4.
+#if defined(SOC_UART_HP_NUM) && SOC_UART_HP_NUM > 4
+  static constexpr uart_port_t uartNums[] = {UART_NUM_2, UART_NUM_3, UART_NUM_4};
+#elif SOC_UART_NUM > 2
+  static constexpr uart_port_t uartNums[] = {UART_NUM_2};
 #else
-  static constexpr uart_port_t uartNum = UART_NUM_1;  // ESP32-C3/H2: no UART_NUM_2 available
+  static constexpr uart_port_t uartNums[] = {UART_NUM_1};  // ESP32-C3/H2: no UART_NUM_2 available
 #endif
-  bool dmxActive = false;
+  static constexpr uint8_t maxUniverses = sizeof(uartNums) / sizeof(uartNums[0]);
+  static constexpr uint32_t keepAliveMs = 100;  // resend the last frame if no new one within this time
+
+  uint8_t pinsTX[maxUniverses];
+  uint8_t pinsDE[maxUniverses];
+
+  uint8_t activeUniverses = 0;  // universes with an installed UART, 0: not active
   update_handler_id_t ioUpdateHandler;
 
+  // frames: 3 buffers of maxUniverses frames, shared by loop() and the DMX task through handoff
+  uint8_t* frames = nullptr;
+  uint16_t frameSizes[3][maxUniverses] = {};
+  FrameHandoff handoff;
+
+  TaskHandle_t dmxTaskHandle = nullptr;
+  SemaphoreHandle_t dmxTaskDone = nullptr;
+  volatile bool dmxRunning = false;
+  volatile bool requestReadPins = false;  // set by the IO update handler, handled in loop() on the driver task
+  volatile uint32_t framesSent = 0;  // by the DMX task
+  uint32_t framesCounted = 0;
+  unsigned long statusMillis = 0;
+
+  uint8_t* frame(uint8_t buffer, uint8_t universe) { return frames + ((size_t)buffer * maxUniverses + universe) * DMX_FRAME_BYTES; }
+
  public:
   static const char* name() { return "DMX Out"; }
   static uint8_t dim() { return _NoD; }
@@ -54,25 +82,34 @@ class DMXOutDriver : public DriverNode {
   void setup() override {
     DriverNode::setup();
     addControl(startChannel, "startChannel", "number", 1, 512);
+    addControl(universes, "universes", "number", 1, maxUniverses);
     addControl(status, "status", "text", 0, 32, true);
 
-    ioUpdateHandler = moduleIO->addUpdateHandler([this](const String& originId) { readPins(); });
-    readPins();
+    memset(pinsTX, UINT8_MAX, sizeof(pinsTX));
+    memset(pinsDE, UINT8_MAX, sizeof(pinsDE));
+    // stopDMX / startDMX replace dmxTaskHandle and the UARTs loop() uses: only on the driver task, not in the IO handler
+    ioUpdateHandler = moduleIO->addUpdateHandler([this](const String& originId) { requestReadPins = true; });
+    readPins();  // the node does not run in the driver task yet
   }
 
   void onUpdate(const JsonObject& control) override {
     DriverNode::onUpdate(control);
+
+    if (control["name"] == "universes" && activeUniverses) {
+      stopDMX();
+      startDMX();
+    }
   }
 
   void readPins() {
     if (safeModeMB) return;
 
-    bool changed = moduleIO->updatePin(pinTX, pin_RS485_TX);
-    changed = moduleIO->updatePin(pinDE, pin_RS485_DE) || changed;
+    bool changed = moduleIO->updatePins(pinsTX, maxUniverses, pin_RS485_TX);
+    changed = moduleIO->updatePins(pinsDE, maxUniverses, pin_RS485_DE) || changed;
 
     if (changed) {
       stopDMX();
-      if (pinTX != UINT8_MAX) {
+      if (pinsTX[0] != UINT8_MAX) {
         startDMX();
       } else {
         updateControl("status", "No pins");
@@ -80,7 +117,9 @@ class DMXOutDriver : public DriverNode {
     }
   }
 
-  void startDMX() {
+  // installs the UART of universe u, false if it failed (status set)
+  bool startUART(uint8_t u) {
+    uart_port_t uartNum = uartNums[u];
     uart_config_t uartConfig = {
       .baud_rate = 250000,          // DMX512 baud rate
       .data_bits = UART_DATA_8_BITS,
@@ -93,84 +132,156 @@ class DMXOutDriver : public DriverNode {
 #if SOC_UART_NUM <= 2
     // On 2-UART chips DMXIn and DMXOut share UART_NUM_1.  Skip the pre-delete so that
     // uart_driver_install() returns ESP_ERR_INVALID_STATE when DMXIn already owns the port.
-    esp_err_t err = uart_driver_install(uartNum, 256, 513 + 16, 0, NULL, 0);
+    esp_err_t err = uart_driver_install(uartNum, 256, DMX_FRAME_BYTES + 16, 0, NULL, 0);
     if (err == ESP_ERR_INVALID_STATE) {
       EXT_LOGW(ML_TAG, "DMX Out: UART_NUM_1 already in use (DMX In active?) — not starting");
       updateControl("status", "UART conflict");
-      return;
+      return false;
     }
 #else
     uart_driver_delete(uartNum);  // clean up any prior installation
-    esp_err_t err = uart_driver_install(uartNum, 256, 513 + 16, 0, NULL, 0);
+    esp_err_t err = uart_driver_install(uartNum, 256, DMX_FRAME_BYTES + 16, 0, NULL, 0);
 #endif
     if (err != ESP_OK) {
-      EXT_LOGE(ML_TAG, "DMX Out: UART install failed: %s", esp_err_to_name(err));
+      EXT_LOGE(ML_TAG, "DMX Out: UART %d install failed: %s", uartNum, esp_err_to_name(err));
       updateControl("status", "UART error");
-      return;
+      return false;
     }
     uart_param_config(uartNum, &uartConfig);
-    uart_set_pin(uartNum, pinTX, UART_PIN_NO_CHANGE,
-                 pinDE != UINT8_MAX ? pinDE : UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
-    if (pinDE != UINT8_MAX)
+    uart_set_pin(uartNum, pinsTX[u], UART_PIN_NO_CHANGE,
+                 pinsDE[u] != UINT8_MAX ? pinsDE[u] : UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    if (pinsDE[u] != UINT8_MAX)
       uart_set_mode(uartNum, UART_MODE_RS485_HALF_DUPLEX);
+    EXT_LOGI(ML_TAG, "DMX Out universe %d started UART:%d TX:%d DE:%d", u + 1, uartNum, pinsTX[u], pinsDE[u]);
+    return true;
+  }
+
+  void startDMX() {
+    if (!frames) frames = allocMB<uint8_t>(3 * maxUniverses * DMX_FRAME_BYTES, "DMXOut");
+    if (!frames) {
+      updateControl("status", "No memory");
+      return;
+    }
 
-    dmxActive = true;
-    updateControl("status", "Active");
-    EXT_LOGI(ML_TAG, "DMX Out started TX:%d DE:%d", pinTX, pinDE);
+    uint8_t wanted = universes < maxUniverses ? universes : maxUniverses;
+    activeUniverses = 0;
+    while (activeUniverses < wanted && pinsTX[activeUniverses] != UINT8_MAX && startUART(activeUniverses)) activeUniverses++;
+    if (!activeUniverses) return;
+    if (activeUniverses < wanted) EXT_LOGW(ML_TAG, "DMX Out: %d of %d universes (pin_RS485_TX per universe needed)", activeUniverses, wanted);
+
+    memset(frameSizes, 0, sizeof(frameSizes));  // nothing to send before the first frame is built
+    framesCounted = framesSent;
+    statusMillis = millis();
+    dmxTaskDone = xSemaphoreCreateBinary();
+    dmxRunning = true;
+    if (!dmxTaskDone || xTaskCreatePinnedToCore(dmxTask, "AppDMXOut", 3072, this, 3, &dmxTaskHandle, xPortGetCoreID()) != pdPASS) {
+      EXT_LOGE(ML_TAG, "DMX Out: task create failed");
+      dmxRunning = false;
+      stopUARTs();
+      updateControl("status", "Task error");
+      return;
+    }
+
+    Char<32> text;
+    text.format("Active %d universe%s", activeUniverses, activeUniverses > 1 ? "s" : "");
+    updateControl("status", text.c_str());
+  }
+
+  void stopUARTs() {
+    for (uint8_t u = 0; u < activeUniverses; u++) {
+      uart_wait_tx_done(uartNums[u], pdMS_TO_TICKS(100));
+      uart_driver_delete(uartNums[u]);
+    }
+    activeUniverses = 0;
+    if (dmxTaskDone) {
+      vSemaphoreDelete(dmxTaskDone);
+      dmxTaskDone = nullptr;
+    }
   }
 
   void stopDMX() {
-    if (dmxActive) {
-      uart_wait_tx_done(uartNum, pdMS_TO_TICKS(100));
-      uart_driver_delete(uartNum);
-      dmxActive = false;
+    if (activeUniverses) {
+      if (dmxRunning) {
+        dmxRunning = false;
+        xTaskNotifyGive(dmxTaskHandle);
+        xSemaphoreTake(dmxTaskDone, portMAX_DELAY);  // the task deletes itself after giving
+        dmxTaskHandle = nullptr;
+      }
+      stopUARTs();
       updateControl("status", "Stopped");
     }
   }
 
+  // sends the newest frame on all universes: each UART gets the whole frame in its TX buffer, so they send at the
+  // same time, then waits until all are done. Woken by loop() for a new frame, or after keepAliveMs to resend.
+  static void dmxTask(void* parameter) {
+    DMXOutDriver* driver = static_cast<DMXOutDriver*>(parameter);
+    while (true) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(keepAliveMs));
+      if (!driver->dmxRunning) break;
+      driver->handoff.take();  // the newest frame, else the last one again
+      uint8_t buffer = driver->handoff.front();
+      bool sent = false;
+      for (uint8_t u = 0; u < driver->activeUniverses; u++) {
+        uint16_t slots = driver->frameSizes[buffer][u];
+        if (!slots) continue;
+        // the break after the frame is the break before the next one
+        uart_write_bytes_with_break(uartNums[u], driver->frame(buffer, u), 1 + slots, 24);
+        sent = true;
+      }
+      for (uint8_t u = 0; u < driver->activeUniverses; u++) uart_wait_tx_done(uartNums[u], pdMS_TO_TICKS(50));
+      if (sent) driver->framesSent = driver->framesSent + 1;
+    }
+    xSemaphoreGive(driver->dmxTaskDone);
+    vTaskDelete(nullptr);
+  }
+
   void loop() override {
     DriverNode::loop();  // applies brightness LUT
-    if (!dmxActive) return;
+    if (requestReadPins) {
+      requestReadPins = false;
+      readPins();
+    }
+    if (!dmxRunning) return;
 
     LightsHeader* header = &layerP.lights.header;
     if (header->nrOfChannels == 0) return;
 
-    uint16_t offset = startChannel - 1;  // convert 1-based address to 0-based offset
-
-    // Build the DMX channel payload into a 511-byte stack frame (DMX512 minus start code).
-    // Zero-init covers both the startChannel offset padding and any trailing unused slots.
+    // Build the frames from channelsD in the buffer the DMX task is not using, then hand it over.
     // rgbwBufferMapping reorders R/G/B to the fixture's channel order (e.g. GRB, WRGB) and
     // extracts a white channel from RGB for RGBW/RGBWYP presets, applying the brightness LUT.
     // This mirrors the ArtNet output driver's per-light remapping.
-    uint8_t dmxFrame[511] = {};
-    uint16_t frameSize = 0;
-    for (uint16_t indexP = 0; indexP < header->nrOfLights; indexP++) {
-      uint16_t dstBase = offset + indexP * header->channelsPerLight;
-      if (dstBase + header->channelsPerLight > 511) break;
-      uint8_t* src = &layerP.lights.channelsD[indexP * header->channelsPerLight];
-      uint8_t* dst = &dmxFrame[dstBase];
-      memcpy(dst, src, header->channelsPerLight);
-      rgbwBufferMapping(dst + header->offsetRGBW, src + header->offsetRGBW);
-      if (header->offsetRGBW1 != UINT8_MAX) {
-        rgbwBufferMapping(dst + header->offsetRGBW1, src + header->offsetRGBW1);
-        if (header->offsetRGBW2 != UINT8_MAX) {
-          rgbwBufferMapping(dst + header->offsetRGBW2, src + header->offsetRGBW2);
-          if (header->offsetRGBW3 != UINT8_MAX)
-            rgbwBufferMapping(dst + header->offsetRGBW3, src + header->offsetRGBW3);
-        }
-      }
-      frameSize = dstBase + header->channelsPerLight;
-    }
+    uint8_t buffer = handoff.back();
+    dmxBuildFrames(frame(buffer, 0), frameSizes[buffer], activeUniverses, layerP.lights.channelsD, header->nrOfLights, header->channelsPerLight, startChannel - 1,
+                   [this, header](uint8_t* dst, const uint8_t* light) {
+                     uint8_t* src = const_cast<uint8_t*>(light);
+                     rgbwBufferMapping(dst + header->offsetRGBW, src + header->offsetRGBW);
+                     if (header->offsetRGBW1 != UINT8_MAX) {
+                       rgbwBufferMapping(dst + header->offsetRGBW1, src + header->offsetRGBW1);
+                       if (header->offsetRGBW2 != UINT8_MAX) {
+                         rgbwBufferMapping(dst + header->offsetRGBW2, src + header->offsetRGBW2);
+                         if (header->offsetRGBW3 != UINT8_MAX) rgbwBufferMapping(dst + header->offsetRGBW3, src + header->offsetRGBW3);
+                       }
+                     }
+                   });
+    handoff.publish();
+    xTaskNotifyGive(dmxTaskHandle);
+  }
 
-    const uint8_t startCode = 0;
-    uart_wait_tx_done(uartNum, pdMS_TO_TICKS(50));
-    uart_write_bytes(uartNum, &startCode, 1);
-    uart_write_bytes_with_break(uartNum, dmxFrame, frameSize, 24);
+  void loop20ms() override {
+    if (!dmxRunning || millis() - statusMillis < 1000) return;
+    uint32_t sent = framesSent;
+    Char<32> text;
+    text.format("Active %d univ %d fps", activeUniverses, (int)((sent - framesCounted) * 1000 / (millis() - statusMillis)));
+    framesCounted = sent;
+    statusMillis = millis();
+    if (!equal(text.c_str(), status.c_str())) updateControl("status", text.c_str());
   }
 
   ~DMXOutDriver() override {
     stopDMX();
     moduleIO->removeUpdateHandler(ioUpdateHandler);
+    if (frames) freeMB(frames, "DMXOut");
   }
 };
 
@@ -28,9 +28,11 @@ class NetworkInDriver : public Node {
   uint16_t port = 6454;
   uint16_t universeMin = 0;
   uint16_t universeMax = 32767;
+  bool overrides = false;  // physical channels received above 0 are held (HTP) over the effects, 0 releases them
   Char<32> status = "Not connected";
   unsigned long lastPacketMs = 0;
   bool statusReceiving = false;
+  bool overridesFull = false;  // warned once until a packet fits again
 
   void setup() override {
     addControl(protocol, "protocol", "select");
@@ -49,6 +51,7 @@ class NetworkInDriver : public Node {
       addControlValue(layerName.c_str());
       i++;
     }
+    addControl(overrides, "overrides", "checkbox");
     addControl(status, "status", "text", 0, 32, true);
   }
 
@@ -71,6 +74,8 @@ class NetworkInDriver : public Node {
         udp.stop();
         init = false;
       }
+    } else if (control["name"] == "overrides") {
+      if (!overrides) layerP.releaseChannels();
     }
   }
 
@@ -158,20 +163,20 @@ class NetworkInDriver : public Node {
     if (startPixel < 0) return;
 
     // Resolve bounds against the target layer's own light count.
-    // Physical layer: clamp to nrOfLights (physical).
+    // Physical layer (and overrides, which are physical channels): clamp to nrOfLights (physical).
     // Virtual layer:  clamp to vLayer->nrOfLights (virtual) — physical count may be
     //                 smaller when a modifier expands the virtual grid, so clamping to
     //                 physical would silently drop valid virtual indices.
     VirtualLayer* vLayer = nullptr;
     nrOfLights_t maxLights;
-    if (layer == 0) {
+    if (layer == 0 || overrides) {
       maxLights = layerP.lights.header.nrOfLights;
     } else {
       if (layer - 1 >= layerP.layers.size() || !layerP.layers[layer - 1]) return;
       vLayer = layerP.layers[layer - 1];
       // If no virtual mapping exists (no effects → onLayoutPre skipped → mappingTableSize==0),
       // nrOfLights stays at the default (256). Use physical bounds to prevent buffer overflow.
-      maxLights = (vLayer->mappingTableSize > 0) ? vLayer->nrOfLights : layerP.lights.header.nrOfLights;
+      maxLights = (vLayer->mappingTableSize > 0 || vLayer->analyticMapping) ? vLayer->nrOfLights : layerP.lights.header.nrOfLights;
     }
 
     EXT_LOGD(ML_TAG, "%d %d %d %d %p", startPixel, maxLights, MIN(numPixels, (int)(maxLights - startPixel)), layer, (void*)dmxData);
@@ -180,6 +185,23 @@ class NetworkInDriver : public Node {
     numPixels = MIN(numPixels, (int)(maxLights - startPixel));
     if (numPixels <= 0) return;
 
+    if (overrides) {  // physical channels of the lights, one lock per packet
+      uint8_t channelsPerLight = layerP.lights.header.channelsPerLight;
+      uint32_t first = (uint32_t)startPixel * channelsPerLight;
+      bool full = false;
+      xSemaphoreTake(layerP.overridesMutex, portMAX_DELAY);
+      for (int i = 0; i < numPixels * channelsPerLight; i++) {
+        if (dmxData[i])
+          full |= !layerP.channelOverrides.set(first + i, dmxData[i], OverrideMax);
+        else
+          layerP.channelOverrides.release(first + i);
+      }
+      xSemaphoreGive(layerP.overridesMutex);
+      if (full && !overridesFull) EXT_LOGW(ML_TAG, "channel overrides full, %d channels held", layerP.channelOverrides.size());
+      overridesFull = full;
+      return;
+    }
+
     xSemaphoreTake(swapMutex, portMAX_DELAY);
     for (int i = 0; i < numPixels; i++) {
       int ledIndex = startPixel + i;
@@ -257,7 +279,7 @@ class NetworkInDriver : public Node {
       ddpMaxLights = layerP.lights.header.nrOfLights;
     } else if (layer - 1 < layerP.layers.size() && layerP.layers[layer - 1]) {
       VirtualLayer* vl = layerP.layers[layer - 1];
-      ddpMaxLights = (vl->mappingTableSize > 0) ? vl->nrOfLights : layerP.lights.header.nrOfLights;
+      ddpMaxLights = (vl->mappingTableSize > 0 || vl->analyticMapping) ? vl->nrOfLights : layerP.lights.header.nrOfLights;
     } else {
       ddpMaxLights = layerP.lights.header.nrOfLights;
     }
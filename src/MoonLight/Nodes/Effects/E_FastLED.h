@@ -36,7 +36,7 @@ class RainbowEffect : public Node {
     if (usePalette) {
       uint8_t paletteIndex = hue >> 8;
       for (int i = 0; i < layer->nrOfLights; ++i) {
-        layer->setRGB(i, ColorFromPalette(layerP.palette, paletteIndex));
+        layer->setRGB(i, layerP.colorFromPalette(paletteIndex));
         paletteIndex += deltaHue;
       }
     } else {
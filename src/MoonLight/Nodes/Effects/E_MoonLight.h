@@ -53,7 +53,7 @@ class SolidEffect : public Node {
 
     } else if (colorMode == 1) {
       for (int index = 0; index < layer->nrOfLights; index++) {
-        layer->setRGB(index, ColorFromPalette(layerP.palette, map(index, 0, layer->nrOfLights, 0, 256), brightness));
+        layer->setRGB(index, layerP.colorFromPalette(map(index, 0, layer->nrOfLights, 0, 256), brightness));
       }
     } else if (colorMode == 2) {
       // Square-Root Averaging
@@ -61,7 +61,7 @@ class SolidEffect : public Node {
       uint16_t nrOfColors = 0;
 
       for (int index = 0; index < 256; index++) {  // Sample entire palette
-        CRGB color = ColorFromPalette(layerP.palette, index, brightness);
+        CRGB color = layerP.colorFromPalette(index, brightness);
         if (color != CRGB::Black) {
           sumRedSq += color.red * color.red;
           sumGreenSq += color.green * color.green;
@@ -83,7 +83,7 @@ class SolidEffect : public Node {
       uint8_t validIndices[256];
       uint16_t nrValid = 0;
       for (int index = 0; index < 256; index++) {
-        CRGB color = ColorFromPalette(layerP.palette, index, brightness);
+        CRGB color = layerP.colorFromPalette(index, brightness);
         if (color.red >= minRGB || color.green >= minRGB || color.blue >= minRGB) validIndices[nrValid++] = index;
       }
 
@@ -106,10 +106,10 @@ class SolidEffect : public Node {
             int axisSize = colorMode == 3 ? layer->size.y : layer->size.x;
             if (nrValid) {
               uint16_t validIdx = axisSize <= 1 ? 0 : ::map(axisValue, 0, axisSize - 1, 0, nrValid - 1);
-              layer->setRGB(Coord3D(x, y, z), ColorFromPalette(layerP.palette, validIndices[validIdx], brightness));
+              layer->setRGB(Coord3D(x, y, z), layerP.colorFromPalette(validIndices[validIdx], brightness));
             } else {
               uint8_t paletteIndex = axisSize <= 1 ? 0 : ::map(axisValue, 0, axisSize - 1, 0, 255);
-              layer->setRGB(Coord3D(x, y, z), ColorFromPalette(layerP.palette, paletteIndex, brightness));
+              layer->setRGB(Coord3D(x, y, z), layerP.colorFromPalette(paletteIndex, brightness));
             }
           }
         }
@@ -191,7 +191,7 @@ class StarSkyEffect : public Node {
     layer->fadeToBlackBy(50);  // this is better than fill_solid when more effects run at the same time
     for (uint32_t i = 0; i < nb_stars; i++) {
       Coord3D pos = Coord3D(stars_indexes[i] % layer->size.x, (stars_indexes[i] / layer->size.x) % layer->size.y, stars_indexes[i] / (layer->size.x * layer->size.y));
-      CRGB color = usePalette ? ColorFromPalette(layerP.palette, stars_colors[i], stars_brightness[i]) : CRGB(stars_brightness[i], stars_brightness[i], stars_brightness[i]);
+      CRGB color = usePalette ? layerP.colorFromPalette(stars_colors[i], stars_brightness[i]) : CRGB(stars_brightness[i], stars_brightness[i], stars_brightness[i]);
       if (stars_fade_dir[i]) {
         stars_brightness[i] = (stars_brightness[i] >= UINT8_MAX - star_speed) ? UINT8_MAX : stars_brightness[i] + star_speed;
         layer->setRGB(pos, color);
@@ -333,7 +333,7 @@ class RandomEffect : public Node {
   void setup() { addControl(fade, "fade", "slider"); }
   void loop() override {
     layer->fadeToBlackBy(fade);
-    layer->setRGB(random16(layer->nrOfLights), ColorFromPalette(layerP.palette, random8()));
+    layer->setRGB(random16(layer->nrOfLights), layerP.colorFromPalette(random8()));
   }
 };
 
@@ -356,15 +356,23 @@ class RipplesEffect : public Node {
     float ripple_interval = 1.3f * ((255.0f - interval) / 128.0f) * sqrtf(layer->size.y);
     float time_interval = pal::millis() / (100.0 - speed) / ((256.0f - 128.0f) / 20.0f);
 
+    // the ripple: sin(d / ripple_interval + time_interval), d = distance / 9.899495 * size.y, as angles (65536 a turn)
+    // of the distances around the vertical axis from the layer (1/16 light, built once per size), per light if low on memory
+    const PolarCoord* polar = layer->polarXZ();
+    const float toAngle = 65536.0f / (2 * PI);
+    const uint32_t anglePerRadius = layer->size.y / 9.899495f / MAX(ripple_interval, 0.01f) / 16 * toAngle * 256;  // per 1/16 light, * 256 (wraps: only the angle bits count)
+    const uint16_t timeAngle = fmodf(time_interval, 2 * PI) * toAngle;
+
     layer->fadeToBlackBy(255);
 
     Coord3D pos = {0, 0, 0};
     for (pos.z = 0; pos.z < layer->size.z; pos.z++) {
       for (pos.x = 0; pos.x < layer->size.x; pos.x++) {
-        float d = distance(layer->size.x / 2.0f, layer->size.z / 2.0f, 0.0f, (float)pos.x, (float)pos.z, 0.0f) / 9.899495f * layer->size.y;
-        pos.y = floor(layer->size.y / 2.0f * (1 + sinf(d / ripple_interval + time_interval)));  // between 0 and layer->size.y
+        uint16_t radius = polar ? polar[pos.x + pos.z * layer->size.x].radius : polarCoord(pos.x, pos.z, layer->size.x, layer->size.z).radius;
+        uint16_t angle = ((radius * anglePerRadius) >> 8) + timeAngle;
+        pos.y = layer->size.y * (32767 + sinFixed(angle)) / 65534;  // between 0 and layer->size.y
 
-        layer->setRGB(pos, ColorFromPalette(layerP.palette, pal::millis() / 50 + random8(64)));
+        layer->setRGB(pos, layerP.colorFromPalette(pal::millis() / 50 + random8(64)));
       }
     }
   }
@@ -518,7 +526,7 @@ class SinusEffect : public Node {
       // Map the sine wave value to a color hue
       uint8_t hue = wave + hueOffset;
       // Set the LED color using the calculated hue
-      layer->setRGB(i, ColorFromPalette(layerP.palette, hue, brightness));
+      layer->setRGB(i, layerP.colorFromPalette(hue, brightness));
     }
 
     // Increment the phase to animate the wave
@@ -548,15 +556,19 @@ class SphereMoveEffect : public Node {
     origin.z = layer->size.z / 2.0 * (1.0 + cosf(time_interval));
 
     float diameter = 2.0f + sinf(time_interval / 3.0f);
+    // d > diameter && d < diameter + 1 on squared distances (1/16 light): no sqrt per light
+    const int32_t inner = diameter * 16, outer = inner + 16;
+    const int32_t innerSq = inner * inner, outerSq = outer * outer;
 
     Coord3D pos;
     for (pos.x = 0; pos.x < layer->size.x; pos.x++) {
       for (pos.y = 0; pos.y < layer->size.y; pos.y++) {
         for (pos.z = 0; pos.z < layer->size.z; pos.z++) {
-          float d = distance(pos.x, pos.y, pos.z, origin.x, origin.y, origin.z);
+          int32_t dx = (pos.x - origin.x) * 16, dy = (pos.y - origin.y) * 16, dz = (pos.z - origin.z) * 16;
+          int32_t dSq = dx * dx + dy * dy + dz * dz;
 
-          if (d > diameter && d < diameter + 1.0) {
-            layer->setRGB(pos, ColorFromPalette(layerP.palette, pal::millis() / 50 + random8(64)));
+          if (dSq > innerSq && dSq < outerSq) {
+            layer->setRGB(pos, layerP.colorFromPalette(pal::millis() / 50 + random8(64)));
           }
         }
       }
@@ -618,7 +630,7 @@ class StarFieldEffect : public Node {  // Inspired by Daniel Shiffman's Coding T
       Coord3D pos = Coord3D(sx, sy);
       if (!pos.isOutofBounds(layer->size)) {
         if (usePalette)
-          layer->setRGB(Coord3D(sx, sy), ColorFromPalette(layerP.palette, stars[i].colorIndex, ::map(stars[i].z, 0, layer->size.x, 255, 150)));
+          layer->setRGB(Coord3D(sx, sy), layerP.colorFromPalette(stars[i].colorIndex, ::map(stars[i].z, 0, layer->size.x, 255, 150)));
         else {
           uint8_t color = ::map(stars[i].colorIndex, 0, 255, 120, 255);
           int brightness = ::map(stars[i].z, 0, layer->size.x, 7, 10);
@@ -682,7 +694,7 @@ class PraxisEffect : public Node {
         // uint8_t hue = huebase + (-(pos.x+pos.y)*macro_mutator*10) + ((pos.x+pos.x*pos.y*(macro_mutator*256))/(micro_mutator+1));
         uint8_t hue = huebase + ((pos.x + pos.y * macro_mutator * pos.x) / (micro_mutator + 1));
         // uint8_t hue = huebase + ((pos.x+pos.y)*(250-macro_mutator)/5) + ((pos.x+pos.y*macro_mutator*pos.x)/(micro_mutator+1)); Original
-        CRGB colour = ColorFromPalette(layerP.palette, hue, 255);
+        CRGB colour = layerP.colorFromPalette(hue, 255);
         layer->setRGB(pos, colour);  // blend(layer->getRGB(pos), colour, 155);
       }
     }
@@ -715,7 +727,7 @@ class WaveEffect : public Node {
   void loop() override {
     layer->fadeToBlackBy(fade);  // should only fade rgb ...
 
-    CRGB color = ColorFromPalette(layerP.palette, pal::millis() / 50);
+    CRGB color = layerP.colorFromPalette(pal::millis() / 50);
 
     int prevPos = layer->size.y / 2;  // somewhere in the middle
 
@@ -849,7 +861,7 @@ class FreqSawsEffect : public Node {
           y = ::map(bandPhase[band] >> 8, 0, 255, 0, layer->size.y - 1);  // saw wave, running over the y-axis, speed is determined by bpm
         }
         // y-axis shows a saw wave which runs faster if the bandSpeed for the x-column is higher, if rings are used for the y-axis, it will show as turning wheels
-        layer->setRGB(Coord3D(x, (invert && x % 2 == 0) ? layer->size.y - 1 - y : y), ColorFromPalette(layerP.palette, ::map(x, 0, layer->size.x - 1, 0, 255)));
+        layer->setRGB(Coord3D(x, (invert && x % 2 == 0) ? layer->size.y - 1 - y : y), layerP.colorFromPalette(::map(x, 0, layer->size.x - 1, 0, 255)));
       }
     }
   }
@@ -1332,7 +1344,7 @@ class ParticlesEffect : public Node {
       else
         particles[index].vz = 0;
 
-      particles[index].color = ColorFromPalette(layerP.palette, random8());
+      particles[index].color = layerP.colorFromPalette(random8());
       Coord3D initPos = particles[index].toCoord3DRounded();
       layer->setRGB(initPos, particles[index].color);
     }
@@ -1482,28 +1494,21 @@ class SpiralFireEffect : public Node {
     Coord3D pos;
     uint16_t time = pal::millis() >> 4;
 
-    // Calculate center of the cone
-    float centerX = layer->size.x / 2.0f;
-    float centerZ = layer->size.z / 2.0f;
+    // angle and distance around the vertical axis per x,z, from the layer (built once per size), in 1/16 light,
+    // per light if low on memory
+    const PolarCoord* polar = layer->polarXZ();
 
     for (pos.y = 0; pos.y < layer->size.y; pos.y++) {
+      // Expected radius at this height (cone tapers to point at top)
+      int32_t expectedRadius = (layer->size.x * 8) * (layer->size.y - pos.y) / layer->size.y;
       for (pos.x = 0; pos.x < layer->size.x; pos.x++) {
         for (pos.z = 0; pos.z < layer->size.z; pos.z++) {
-          // Calculate distance from center (radius)
-          float dx = pos.x - centerX;
-          float dz = pos.z - centerZ;
-          float radius = sqrtf(dx * dx + dz * dz);
-
-          // Calculate angle around the cone
-          float angle = atan2f(dz, dx);
-
-          // Expected radius at this height (cone tapers to point at top)
-          float expectedRadius = (layer->size.x / 2.0f) * (1.0f - (float)pos.y / layer->size.y);
+          const PolarCoord coord = polar ? polar[pos.x + pos.z * layer->size.x] : polarCoord(pos.x, pos.z, layer->size.x, layer->size.z);
 
-          // Only light LEDs that are close to the cone surface
-          if (fabsf(radius - expectedRadius) < 1.5f) {
-            // Create rising flame effect with spiral
-            uint8_t spiralPhase = (uint8_t)(angle * 40.0f + pos.y * 20 - time * rotationSpeed / 10);
+          // Only light LEDs that are close to the cone surface (1.5 light)
+          if (abs(coord.radius - expectedRadius) < 24) {
+            // Create rising flame effect with spiral: angle around the cone * 40 (atan2Fixed * 40π / 32768)
+            uint8_t spiralPhase = (((int16_t)coord.angle * 8042) >> 21) + pos.y * 20 - time * rotationSpeed / 10;
             uint8_t flameHeight = beatsin8(speed, 0, layer->size.y);
 
             // Brightness based on height and spiral pattern
@@ -1514,7 +1519,7 @@ class SpiralFireEffect : public Node {
               // Color: bottom hot (yellow/white), top cooler (red/orange)
               uint8_t colorIndex = 255 - (pos.y * 180 / layer->size.y) + sin8(spiralPhase) / 3;
 
-              CRGB color = ColorFromPalette(layerP.palette, colorIndex, brightness);
+              CRGB color = layerP.colorFromPalette(colorIndex, brightness);
 
               // Add some intensity variation
               color.nscale8(intensity);
@@ -1547,8 +1552,8 @@ class FireEffect : public Node {
           int d = (flareDecay * isqrt((x - j) * (x - j) + (y - i) * (y - i)) + 5) / 10;
           uint8_t n = 0;
           if (z > d) n = z - d;
-          if (layer->getRGB(Coord3D(j, layer->size.y - 1 - i)) < usePalette ? ColorFromPalette(layerP.palette, n * 23) : colors[n]) {  // can only get brighter
-            layer->setRGB(Coord3D(j, layer->size.y - 1 - i), usePalette ? ColorFromPalette(layerP.palette, n * 23) : colors[n]);       // 23*11 -> within palette range
+          if (layer->getRGB(Coord3D(j, layer->size.y - 1 - i)) < usePalette ? layerP.colorFromPalette(n * 23) : colors[n]) {  // can only get brighter
+            layer->setRGB(Coord3D(j, layer->size.y - 1 - i), usePalette ? layerP.colorFromPalette(n * 23) : colors[n]);       // 23*11 -> within palette range
           }
         }
       }
@@ -1610,7 +1615,7 @@ class FireEffect : public Node {
     for (int x = 0; x < layer->size.x; ++x) {
       CRGB i = layer->getRGB(Coord3D(x, layer->size.y - 1));  // - 0; //-0 to force conversion to CRGB
       if (i != CRGB::Black) {
-        layer->setRGB(Coord3D(x, layer->size.y - 1), usePalette ? ColorFromPalette(layerP.palette, random8()) : colors[random(NCOLORS - 6, NCOLORS - 2)]);
+        layer->setRGB(Coord3D(x, layer->size.y - 1), usePalette ? layerP.colorFromPalette(random8()) : colors[random(NCOLORS - 6, NCOLORS - 2)]);
       }
     }
 
@@ -1657,7 +1662,7 @@ class VUMeterEffect : public Node {
     int x0 = topLeft.x + size.x / 2;  // Center of the needle
     int y0 = topLeft.y + size.y - 1;  // Bottom of the needle
 
-    layer->drawCircle(topLeft.x + size.x / 2, topLeft.y + size.y / 2, size.x / 2, ColorFromPalette(layerP.palette, 35, 128), false);
+    layer->drawCircle(topLeft.x + size.x / 2, topLeft.y + size.y / 2, size.x / 2, layerP.colorFromPalette(35, 128), false);
 
     // Calculate needle end position
     int x1 = x0 - round(size.y * 0.7 * cos((angle + 30) * PI / 180));
@@ -1689,7 +1694,7 @@ class VUMeterEffect : public Node {
     uint8_t band = 0;
     for (int h = 0; h < nHorizontal; h++) {
       for (int v = 0; v < nVertical; v++) {
-        drawNeedle((float)sharedData.bands[2 * (band++)] / 2.0, {layer->size.x * h / nHorizontal, layer->size.y * v / nVertical, 0}, {(layer->size.x - 1) / nHorizontal, (layer->size.y - 1) / nVertical, 0}, ColorFromPalette(layerP.palette, 255 / (nHorizontal * nVertical) * band));
+        drawNeedle((float)sharedData.bands[2 * (band++)] / 2.0, {layer->size.x * h / nHorizontal, layer->size.y * v / nVertical, 0}, {(layer->size.x - 1) / nHorizontal, (layer->size.y - 1) / nVertical, 0}, layerP.colorFromPalette(255 / (nHorizontal * nVertical) * band));
       }  // sharedData.bands[band++] / 200
     }
     // ppf(" v:%f, f:%f", sharedData.volume, (float) sharedData.bands[5]);
@@ -1710,7 +1715,7 @@ class PixelMapEffect : public Node {
   void loop() override {
     layer->fill_solid(CRGB::Black);
 
-    layer->setRGB(pos, ColorFromPalette(layerP.palette, pal::millis() / 50 + random8(64)));
+    layer->setRGB(pos, layerP.colorFromPalette(pal::millis() / 50 + random8(64)));
   }
 };  // PixelMap
 
@@ -1793,7 +1798,7 @@ class RingRandomFlowEffect : public RingEffect {
     if (hue) {
       hue[0] = random(0, 255);
       for (int r = 0; r < hueSize; r++) {
-        setRing(r, ColorFromPalette(layerP.palette, hue[r]));
+        setRing(r, layerP.colorFromPalette(hue[r]));
       }
       for (int r = (hueSize - 1); r >= 1; r--) {
         hue[r] = hue[(r - 1)];  // set this ruing based on the inner
@@ -1831,7 +1836,7 @@ class AudioRingsEffect : public RingEffect {
       }
 
       // Visualize leds to the beat
-      CRGB color = ColorFromPalette(layerP.palette, val, val);
+      CRGB color = layerP.colorFromPalette(val, val);
       //      CRGB color = ColorFromPalette(currentPalette, val, 255, currentBlending);
       //      color.nscale8_video(val);
       setRing(i, color);
@@ -1844,7 +1849,7 @@ class AudioRingsEffect : public RingEffect {
   void setRingFromFtt(int index, int ring) {
     uint8_t val = sharedData.bands[index];
     // Visualize leds to the beat
-    CRGB color = ColorFromPalette(layerP.palette, val);
+    CRGB color = layerP.colorFromPalette(val);
     color.nscale8_video(val);
     setRing(ring, color);
   }
@@ -1908,10 +1913,10 @@ class RadarEffect : public Node {
       float physPosB = fmod(physPos + physPerimeter / 2.0f, physPerimeter);
       int16_t x2, y2;
       physToXY(physPosB, x2, y2);
-      layer->drawLine(x1, y1, x2, y2, ColorFromPalette(layerP.palette, (uint8_t)(physPos / physPerimeter * 255)), false);
+      layer->drawLine(x1, y1, x2, y2, layerP.colorFromPalette((uint8_t)(physPos / physPerimeter * 255)), false);
     } else {
       // Half line: from center to perimeter point
-      layer->drawLine(W / 2, H / 2, x1, y1, ColorFromPalette(layerP.palette, (uint8_t)(physPos / physPerimeter * 255)), false);
+      layer->drawLine(W / 2, H / 2, x1, y1, layerP.colorFromPalette((uint8_t)(physPos / physPerimeter * 255)), false);
     }
   }
 };
@@ -89,7 +89,7 @@ class BouncingBallsEffect : public Node {
 
         uint8_t pos = layer->size.y - 1 - roundf(balls[x][i].height * (layer->size.y - 1));  // balls go up
 
-        CRGB color = ColorFromPalette(layerP.palette, i * (256 / MAX(numBalls, 8)));  // error: no matching function for call to 'MAX(uint8_t&, int)'
+        CRGB color = layerP.colorFromPalette(i * (256 / MAX(numBalls, 8)));  // error: no matching function for call to 'MAX(uint8_t&, int)'
 
         layer->setRGB(Coord3D(x, pos), color);
       }  // balls      layer->fill_solid(CRGB::White);
@@ -161,14 +161,14 @@ class BlurzEffect : public Node {
     // unsigned pixIntensity = MIN(2.0f * sharedData.bands[freqBand], 255);  // cppcheck-suppress unreadVariable -- WLED ported code
 
     if (sharedData.volume > 1.0f) {
-      layer->setRGB(segLoc, ColorFromPalette(layerP.palette, pixColor));
+      layer->setRGB(segLoc, layerP.colorFromPalette(pixColor));
       step = layer->getRGB(segLoc);  // remember last color
       aux1 = segLoc;                 // remember last position
 
       layer->blur2d(blur);
       aux0++;
       aux0 %= 16;                                                         // make sure it doesn't cross 16
-      layer->addRGB(segLoc, ColorFromPalette(layerP.palette, pixColor));  // repaint center pixel after blur
+      layer->addRGB(segLoc, layerP.colorFromPalette(pixColor));  // repaint center pixel after blur
     } else
       layer->blur2d(blur);  // silence - just blur it again
     call++;
@@ -191,28 +191,35 @@ class DistortionWavesEffect : public Node {
     addControl(scale, "scale", "slider", 0, 8);
   }
 
-  void loop() override {
-    uint8_t w = 2;
+  // tile-safe: loopFrame() advances the wave centres, loopRows() only writes its own rows
+  bool isTileSafe() const override { return true; }
+
+  uint16_t a, a2, a3;
+  uint16_t cx, cy, cx1, cy1, cx2, cy2;
 
-    uint16_t a = millis() / 32;
-    uint16_t a2 = a / 2;
-    uint16_t a3 = a / 3;
+  void loopFrame() override {
+    a = millis() / 32;
+    a2 = a / 2;
+    a3 = a / 3;
 
-    uint16_t cx = beatsin8(10 - speed, 0, layer->size.x - 1) * scale;
-    uint16_t cy = beatsin8(12 - speed, 0, layer->size.y - 1) * scale;
-    uint16_t cx1 = beatsin8(13 - speed, 0, layer->size.x - 1) * scale;
-    uint16_t cy1 = beatsin8(15 - speed, 0, layer->size.y - 1) * scale;
-    uint16_t cx2 = beatsin8(17 - speed, 0, layer->size.x - 1) * scale;
-    uint16_t cy2 = beatsin8(14 - speed, 0, layer->size.y - 1) * scale;
+    cx = beatsin8(10 - speed, 0, layer->size.x - 1) * scale;
+    cy = beatsin8(12 - speed, 0, layer->size.y - 1) * scale;
+    cx1 = beatsin8(13 - speed, 0, layer->size.x - 1) * scale;
+    cy1 = beatsin8(15 - speed, 0, layer->size.y - 1) * scale;
+    cx2 = beatsin8(17 - speed, 0, layer->size.x - 1) * scale;
+    cy2 = beatsin8(14 - speed, 0, layer->size.y - 1) * scale;
+  }
+
+  void loopRows(uint16_t rowStart, uint16_t rowEnd) override {
+    uint8_t w = 2;
 
-    uint16_t xoffs = 0;
     Coord3D pos = {0, 0, 0};
-    for (pos.x = 0; pos.x < layer->size.x; pos.x++) {
-      xoffs += scale;
-      uint16_t yoffs = 0;
+    for (pos.y = rowStart; pos.y < rowEnd; pos.y++) {
+      uint16_t yoffs = (pos.y + 1) * scale;
+      uint16_t xoffs = 0;
 
-      for (pos.y = 0; pos.y < layer->size.y; pos.y++) {
-        yoffs += scale;
+      for (pos.x = 0; pos.x < layer->size.x; pos.x++) {
+        xoffs += scale;
 
         uint8_t rdistort = cos8((cos8(((pos.x << 3) + a) & 255) + cos8(((pos.y << 3) - a2) & 255) + a3) & 255) >> 1;
         uint8_t gdistort = cos8((cos8(((pos.x << 3) - a2) & 255) + cos8(((pos.y << 3) + a3) & 255) + a + 32) & 255) >> 1;
@@ -230,6 +237,11 @@ class DistortionWavesEffect : public Node {
       }
     }
   }
+
+  void loop() override {
+    loopFrame();
+    loopRows(0, layer->size.y);
+  }
 };  // DistortionWaves
 
 class FreqMatrixEffect : public Node {
@@ -293,7 +305,7 @@ class FreqMatrixEffect : public Node {
         int freqMapped = lowerLimit != upperLimit ? ::map(sharedData.majorPeak, lowerLimit, upperLimit, 0, 255) : sharedData.majorPeak;  // WLEDMM preserve overflows
         uint8_t i = abs(freqMapped) & 0xFF;                                                                                              // WLEDMM we embrace overflow ;-) by "modulo 256"
 
-        color = ColorFromPalette(layerP.palette, i, (uint8_t)pixVal);
+        color = layerP.colorFromPalette(i, (uint8_t)pixVal);
       }
 
       // shift the pixels one pixel up
@@ -409,7 +421,7 @@ class GEQEffect : public Node {
         if (colorBars)  // color_vertical / color bars toggle
           colorIndex = ::map(pos.y, 0, layer->size.y, 0, 256);
 
-        ledColor = ColorFromPalette(layerP.palette, (uint8_t)colorIndex);
+        ledColor = layerP.colorFromPalette((uint8_t)colorIndex);
 
         layer->setRGB(Coord3D(pos.x, layer->size.y - 1 - pos.y), ledColor);
       }
@@ -417,7 +429,7 @@ class GEQEffect : public Node {
       if (previousBarHeight && pos.x < previousBarHeightSize) {
         if (barHeight > previousBarHeight[pos.x]) previousBarHeight[pos.x] = barHeight;                                              // drive the peak up
         if ((ripple > 0) && (previousBarHeight[pos.x] > 0) && (previousBarHeight[pos.x] < layer->size.y))                            // WLEDMM avoid "overshooting" into other segments
-          layer->setRGB(Coord3D(pos.x, layer->size.y - previousBarHeight[pos.x]), ColorFromPalette(layerP.palette, millis() / 50));  // take millis()/50 color for the time being
+          layer->setRGB(Coord3D(pos.x, layer->size.y - previousBarHeight[pos.x]), layerP.colorFromPalette(millis() / 50));  // take millis()/50 color for the time being
 
         if (rippleTime && previousBarHeight[pos.x] > 0) previousBarHeight[pos.x]--;  // delay/ripple effect
       }
@@ -452,7 +464,7 @@ class LissajousEffect : public Node {
       locn.y = cos8(phase / 2 + i * 2);
       locn.x = (layer->size.x < 2) ? 1 : (::map(2 * locn.x, 0, 511, 0, 2 * (layer->size.x - 1)) + 1) / 2;  // softhack007: "*2 +1" for proper rounding
       locn.y = (layer->size.y < 2) ? 1 : (::map(2 * locn.y, 0, 511, 0, 2 * (layer->size.y - 1)) + 1) / 2;  // "layer->size.y > 2" is needed to avoid div/0 in ::map()
-      layer->setRGB(locn, ColorFromPalette(layerP.palette, millis() / 100 + i, 255));
+      layer->setRGB(locn, layerP.colorFromPalette(millis() / 100 + i, 255));
     }
   }
 };
@@ -472,14 +484,26 @@ class Noise2DEffect : public Node {
     addControl(scale, "scale", "slider", 2, 255);
   }
 
-  void loop() override {
-    for (int y = 0; y < layer->size.y; y++) {
+  // tile-safe: the noise z coordinate is taken once per frame, so all tiles show the same moment
+  bool isTileSafe() const override { return true; }
+
+  uint32_t noiseZ = 0;
+
+  void loopFrame() override { noiseZ = millis() / (16 - speed); }
+
+  void loopRows(uint16_t rowStart, uint16_t rowEnd) override {
+    for (int y = rowStart; y < rowEnd; y++) {
       for (int x = 0; x < layer->size.x; x++) {
-        uint8_t pixelHue8 = inoise8(x * scale, y * scale, millis() / (16 - speed));
-        layer->setRGB(Coord3D(x, y), ColorFromPalette(layerP.palette, pixelHue8));
+        uint8_t pixelHue8 = inoise8(x * scale, y * scale, noiseZ);
+        layer->setRGB(Coord3D(x, y), layerP.colorFromPalette(pixelHue8));
       }
     }
   }
+
+  void loop() override {
+    loopFrame();
+    loopRows(0, layer->size.y);
+  }
 };  // Noise2D
 
 class NoiseMeterEffect : public Node {
@@ -510,7 +534,7 @@ class NoiseMeterEffect : public Node {
     for (int y = 0; y < maxLen; y++) {                                                                                                         // The louder the sound, the wider the soundbar. By Andrew Tuline.
       uint8_t index = inoise8(y * sharedData.volume + aux0, aux1 + y * sharedData.volume);                                                     // Get a value from the noise function. I'm using both x and y axis.
       for (int x = 0; x < layer->size.x; x++)                                                                                                  // propagate to other dimensions
-        for (int z = 0; z < layer->size.z; z++) layer->setRGB(Coord3D(x, layer->size.y - 1 - y, z), ColorFromPalette(layerP.palette, index));  //, 255, PALETTE_SOLID_WRAP));
+        for (int z = 0; z < layer->size.z; z++) layer->setRGB(Coord3D(x, layer->size.y - 1 - y, z), layerP.colorFromPalette(index));  //, 255, PALETTE_SOLID_WRAP));
     }
 
     aux0 += beatsin8(5, 0, 10);
@@ -832,7 +856,7 @@ class AntEffect : public Node {
   // Helper function to calculate ant color
   CRGB getAntColor(int antIndex, int numAnts, bool usePalette) {
     // if (usePalette)
-    return ColorFromPalette(layerP.palette, antIndex * 255 / numAnts);
+    return layerP.colorFromPalette(antIndex * 255 / numAnts);
     // Alternate between two colors for default palette
     // return (antIndex % 3 == 1) ? SEGCOLOR(0) : SEGCOLOR(2);
   }
@@ -1038,7 +1062,7 @@ class TetrixEffect : public Node {
           drops[x].pos -= drops[x].speed;     // may add gravity as: speed += gravity
           if (drops[x].pos < drops[x].stack) drops[x].pos = drops[x].stack;
           for (int i = drops[x].pos; i < layer->size.y; i++) {
-            CRGB col = i < drops[x].pos + drops[x].brick ? ColorFromPalette(layerP.palette, drops[x].col) : CRGB::Black;
+            CRGB col = i < drops[x].pos + drops[x].brick ? layerP.colorFromPalette(drops[x].col) : CRGB::Black;
             layer->setRGB(Coord3D(x, layer->size.y - 1 - i), col);
           }
         } else {                                                                 // we hit bottom
@@ -1141,7 +1165,7 @@ class PopCornEffect : public Node {
         // uint32_t col = layer->color_wheel(popcorn[i].colIndex);
         // if (!layer->palette && popcorn[i].colIndex < NUM_COLORS) col = SEGCOLOR(popcorn[i].colIndex);
         uint16_t ledIndex = popcorn[i].pos;
-        CRGB col = ColorFromPalette(layerP.palette, popcorn[i].colIndex * (256 / maxNumPopcorn));
+        CRGB col = layerP.colorFromPalette(popcorn[i].colIndex * (256 / maxNumPopcorn));
         if (ledIndex < layer->size.y) {
           // layer->setRGB(Coord3D(0, ledIndex), col);
           for (int x = 0; x < layer->size.x; x++)
@@ -1189,7 +1213,7 @@ class WaverlyEffect : public Node {
       uint16_t thisMax = MIN(map(thisVal, 0, 512, 0, layer->size.y), layer->size.y);
 
       for (pos.y = 0; pos.y < thisMax; pos.y++) {
-        CRGB color = ColorFromPalette(layerP.palette, ::map(pos.y, 0, thisMax, 250, 0));
+        CRGB color = layerP.colorFromPalette(::map(pos.y, 0, thisMax, 250, 0));
         if (!noClouds) layer->addRGB(pos, color);
         layer->addRGB(Coord3D((layer->size.x - 1) - pos.x, (layer->size.y - 1) - pos.y), color);
       }
@@ -1234,13 +1258,13 @@ class BlackholeEffect : public Node {
     for (size_t i = 0; i < 8; i++) {
       x = beatsin8(outerXfreq >> 3, 0, cols - 1, 0, ((i % 2) ? 128 : 0) + (t * i) / ratio);
       y = beatsin8(outerYfreq >> 3, 0, rows - 1, 0, ((i % 2) ? 192 : 64) + (t * i) / ratio);
-      layer->addRGB(Coord3D(x, y), ColorFromPalette(layerP.palette, i * 32));
+      layer->addRGB(Coord3D(x, y), layerP.colorFromPalette(i * 32));
     }
     // inner stars
     for (size_t i = 0; i < 4; i++) {
       x = beatsin8(innerXfreq >> 3, cols / 4, cols - 1 - cols / 4, 0, ((i % 2) ? 128 : 0) + (t * i) / ratio);
       y = beatsin8(innerYfreq >> 3, rows / 4, rows - 1 - rows / 4, 0, ((i % 2) ? 192 : 64) + (t * i) / ratio);
-      layer->addRGB(Coord3D(x, y), ColorFromPalette(layerP.palette, i * 32));
+      layer->addRGB(Coord3D(x, y), layerP.colorFromPalette(i * 32));
     }
     // central white dot
     layer->setRGB(Coord3D(cols / 2, rows / 2), CRGB::White);
@@ -1289,11 +1313,11 @@ class DNAEffect : public Node {
       int posY1 = beatsin8(speed, 0, rows - 1, 0, phase);
       int posY2 = beatsin8(speed, 0, rows - 1, 0, phase + 128);
       if ((i == 0) || ((abs(lastY1 - posY1) < 2) && (abs(lastY2 - posY2) < 2))) {  // use original code when no holes
-        layer->setRGB(Coord3D(i, posY1), ColorFromPalette(layerP.palette, i * 5 + millis() / 17, beatsin8(5, 55, 255, 0, i * 10)));
-        layer->setRGB(Coord3D(i, posY2), ColorFromPalette(layerP.palette, i * 5 + 128 + millis() / 17, beatsin8(5, 55, 255, 0, i * 10 + 128)));
+        layer->setRGB(Coord3D(i, posY1), layerP.colorFromPalette(i * 5 + millis() / 17, beatsin8(5, 55, 255, 0, i * 10)));
+        layer->setRGB(Coord3D(i, posY2), layerP.colorFromPalette(i * 5 + 128 + millis() / 17, beatsin8(5, 55, 255, 0, i * 10 + 128)));
       } else {  // draw line to prevent holes
-        layer->drawLine(i - 1, lastY1, i, posY1, ColorFromPalette(layerP.palette, i * 5 + millis() / 17, beatsin8(5, 55, 255, 0, i * 10)));
-        layer->drawLine(i - 1, lastY2, i, posY2, ColorFromPalette(layerP.palette, i * 5 + 128 + millis() / 17, beatsin8(5, 55, 255, 0, i * 10 + 128)));
+        layer->drawLine(i - 1, lastY1, i, posY1, layerP.colorFromPalette(i * 5 + millis() / 17, beatsin8(5, 55, 255, 0, i * 10)));
+        layer->drawLine(i - 1, lastY2, i, posY2, layerP.colorFromPalette(i * 5 + 128 + millis() / 17, beatsin8(5, 55, 255, 0, i * 10 + 128)));
       }
       lastY1 = posY1;
       lastY2 = posY2;
@@ -1350,13 +1374,14 @@ class OctopusEffect : public Node {
     const uint16_t C_Y = layer->size.y / 2 + (offset.y - 50) * layer->size.y / 100;
     Coord3D pos = {0, 0, 0};
     // const uint8_t mapp = MAX(1, 180 / MAX(layer->size.x, layer->size.y));
-    const float mapp = 180.0f / (float)MAX(layer->size.x, layer->size.y);
+    const uint32_t mapp = MAX(layer->size.x, layer->size.y);  // radius * 180 / mapp
     for (pos.x = 0; pos.x < layer->size.x; pos.x++) {
       for (pos.y = 0; pos.y < layer->size.y; pos.y++) {
         nrOfLights_t indexV = layer->XYZUnModified(pos);
-        if (indexV < rMapSize) {                                             // excluding UINT16_MAX from XY if out of bounds due to projection
-          rMap[indexV].angle = 40.7436f * atan2f(pos.y - C_Y, pos.x - C_X);  // avoid 128*atan2()/PI
-          rMap[indexV].radius = constrain(lroundf(hypotf(pos.x - C_X, pos.y - C_Y) * mapp), 0, 255);
+        if (indexV < rMapSize) {                                                   // excluding UINT16_MAX from XY if out of bounds due to projection
+          rMap[indexV].angle = atan2Fixed(pos.y - C_Y, pos.x - C_X) >> 8;          // 128*atan2()/PI
+          uint32_t radius = hypotFixed((pos.x - C_X) * 16, (pos.y - C_Y) * 16);  // 1/16 light
+          rMap[indexV].radius = MIN((radius * 180 / mapp + 8) / 16, 255);
         }
       }
     }
@@ -1389,7 +1414,7 @@ class OctopusEffect : public Node {
             else
               intensity = sin8(sin8((angle * 4 - radius) / 4 + step / 2) + radius - step + angle * legs);  // octopus
             intensity = intensity * intensity / 255;                                                       // add a bit of non-linearity for cleaner display
-            layer->setRGB(pos, ColorFromPalette(layerP.palette, step / 2 - radius, intensity));
+            layer->setRGB(pos, layerP.colorFromPalette(step / 2 - radius, intensity));
           }
         }
       }
@@ -1423,7 +1448,7 @@ class FrizzlesEffect : public Node {
       Coord3D pos = {0, 0, 0};
       pos.x = beatsin8(bpm / 8 + i, 0, layer->size.x - 1);
       pos.y = beatsin8(intensity / 8 - i, 0, layer->size.y - 1);
-      CRGB color = ColorFromPalette(layerP.palette, beatsin8(12, 0, 255));
+      CRGB color = layerP.colorFromPalette(beatsin8(12, 0, 255));
       layer->setRGB(pos, color);
     }
     layer->blur2d(blur);
@@ -1545,7 +1570,7 @@ class FireworksEffect : public Node {
           if (sparks[i].pos > 0 && sparks[i].pos < rows) {
             if (!(sparks[i].posX >= 0 && sparks[i].posX < cols)) continue;
             uint16_t prog = sparks[i].col;
-            CRGB spColor = ColorFromPalette(layerP.palette, sparks[i].colIndex);
+            CRGB spColor = layerP.colorFromPalette(sparks[i].colIndex);
             CRGB c = CRGB::Black;  // HeatColor(sparks[i].col);
             if (prog > 300) {      // fade from white to spark color
               c = CRGB(blend(spColor, CRGB::White, (prog - 300) * 5));
@@ -1609,7 +1634,7 @@ class FunkyPlankEffect : public Node {
 
         int hue = sharedData.bands[map(band, 0, bands - 1, 0, NUM_GEQ_CHANNELS - 1)];
         int v = ::map(hue, 0, 255, 10, 255);
-        layer->setRGB(Coord3D(posx, 0), ColorFromPalette(layerP.palette, hue, v));
+        layer->setRGB(Coord3D(posx, 0), layerP.colorFromPalette(hue, v));
       }
 
       // drip down:
@@ -1652,14 +1677,14 @@ class FlowEffect : public Node {
     uint16_t zoneLen = layer->size.y / zones;
     uint16_t offset = (layer->size.y - zones * zoneLen) >> 1;
 
-    layer->fill_solid(ColorFromPalette(layerP.palette, -counter));
+    layer->fill_solid(layerP.colorFromPalette(-counter));
 
     for (int zone = 0; zone < zones; zone++) {
       uint16_t pos = offset + zone * zoneLen;
       for (int i = 0; i < zoneLen; i++) {
         uint8_t colorIndex = (i * 255 / zoneLen) - counter;
         uint16_t led = (zone & 0x01) ? i : (zoneLen - 1) - i;
-        CRGB color = ColorFromPalette(layerP.palette, colorIndex);
+        CRGB color = layerP.colorFromPalette(colorIndex);
         for (int x = 0; x < layer->size.x; x++)
           for (int z = 0; z < layer->size.z; z++) layer->setRGB(Coord3D(x, pos + led, z), color);
       }
@@ -1716,9 +1741,9 @@ static void mode_fireworks(VirtualLayer* layer, uint16_t x, uint16_t aux0, uint1
       if (random8(my_intensity) == 0) {
         uint16_t index = random(layer->size.y);
         if (soundColor < 0)
-          layer->setRGB(Coord3D(x, layer->size.y - 1 - index), ColorFromPalette(layerP.palette, random8()));
+          layer->setRGB(Coord3D(x, layer->size.y - 1 - index), layerP.colorFromPalette(random8()));
         else
-          layer->setRGB(Coord3D(x, layer->size.y - 1 - index), ColorFromPalette(layerP.palette, soundColor + random8(24)));  // WLEDSR
+          layer->setRGB(Coord3D(x, layer->size.y - 1 - index), layerP.colorFromPalette(soundColor + random8(24)));  // WLEDSR
         aux1 = aux0;                                                                                                         // cppcheck-suppress unreadVariable -- WLED ported code
         aux0 = index;
       }
@@ -1849,7 +1874,7 @@ class DripEffect : public Node {
           drops[x][j].vel = 0;                                   // speed
           drops[x][j].col = sourcedrop;                          // brightness
           drops[x][j].colIndex = forming;                        // drop state
-          CRGB c = ColorFromPalette(layerP.palette, random8());  // random color by MoonModules, hacked into velX of type float
+          CRGB c = layerP.colorFromPalette(random8());  // random color by MoonModules, hacked into velX of type float
           memcpy(&drops[x][j].velX, (void*)&c, sizeof(CRGB));
         }
         CRGB dropColor;
@@ -1941,7 +1966,7 @@ class HeartBeatEffect : public Node {
     }
 
     for (int i = 0; i < layer->size.y; i++) {
-      layer->setRGB(Coord3D(0, i), ColorFromPalette(layerP.palette, ::map(i, 0, layer->size.y, 0, 255), 255 - (bri_lower >> 8)));
+      layer->setRGB(Coord3D(0, i), layerP.colorFromPalette(::map(i, 0, layer->size.y, 0, 255), 255 - (bri_lower >> 8)));
     }
   }
 };  // HeartBeatEffect
@@ -1997,7 +2022,7 @@ class DJLightEffect : public Node {
       if (color.getLuma() > 32) {  // don't change "dark" pixels
         CHSV hsvColor = rgb2hsv_approximate(color);
         hsvColor.v = constrain(hsvColor.v, 48, 204);  // 48 < brightness < 204
-        color = ColorFromPalette(layerP.palette, hsvColor.h, hsvColor.v);
+        color = layerP.colorFromPalette(hsvColor.h, hsvColor.v);
       }
       // if (color.getLuma() > 12) color.maximizeBrightness();          // for testing
 
@@ -2123,18 +2148,31 @@ class PlasmaEffect : public Node {
 
   uint8_t aux0;
 
-  void loop() override {
-    uint8_t thisPhase = beatsin8(6 + aux0, -64, 64);
-    uint8_t thatPhase = beatsin8(7 + aux0, -64, 64);
+  // tile-safe: phases and brightness wave are taken once per frame
+  bool isTileSafe() const override { return true; }
+
+  uint8_t thisPhase, thatPhase, brightWave;
+
+  void loopFrame() override {
+    thisPhase = beatsin8(6 + aux0, -64, 64);
+    thatPhase = beatsin8(7 + aux0, -64, 64);
+    brightWave = beatsin8(7, 0, (128 - (intensity >> 1)));
+  }
 
-    for (int i = 0; i < layer->size.y; i++) {                                               // For each of the LED's in the strand, set color &  brightness based on a wave as follows:
+  void loopRows(uint16_t rowStart, uint16_t rowEnd) override {
+    for (int i = rowStart; i < rowEnd; i++) {                                               // For each of the LED's in the strand, set color &  brightness based on a wave as follows:
       uint8_t colorIndex = cubicwave8((i * (2 + 3 * (speed >> 5)) + thisPhase) & 0xFF) / 2  // factor=23 // Create a wave and add a phase change and add another wave with its own phase change.
                            + cos8((i * (1 + 2 * (speed >> 5)) + thatPhase) & 0xFF) / 2;     // factor=15 // Hey, you can even change the frequencies if you wish.
-      uint8_t thisBright = qsub8(colorIndex, beatsin8(7, 0, (128 - (intensity >> 1))));
+      uint8_t thisBright = qsub8(colorIndex, brightWave);
       for (int x = 0; x < layer->size.x; x++)
-        for (int z = 0; z < layer->size.z; z++) layer->setRGB(Coord3D(x, i, z), ColorFromPalette(layerP.palette, colorIndex, thisBright));
+        for (int z = 0; z < layer->size.z; z++) layer->setRGB(Coord3D(x, i, z), layerP.colorFromPalette(colorIndex, thisBright));
     }
   }
+
+  void loop() override {
+    loopFrame();
+    loopRows(0, layer->size.y);
+  }
 };
 
 class JuliaEffect : public Node {
@@ -2179,15 +2217,17 @@ class JuliaEffect : public Node {
 
   Julia julias;
 
-  void loop() override {
+  // tile-safe unless a blur or the crosshair is drawn over the whole layer afterwards
+  bool isTileSafe() const override { return !softBlur && !strongBlur && !showCenter; }
+
+  // per-frame values, set by loopFrame(), used by loopRows() (JuliaKernel.h)
+  JuliaFrame frame;
+  static constexpr float maxCenter = 2.5f;  // WLEDMM limit drift, so we don't move away into nothing. just an educated guess
+
+  void loopFrame() override {
     const uint16_t cols = layer->size.x;
     const uint16_t rows = layer->size.y;
 
-    float reAl;
-    float imAg;
-
-    // WLEDMM limit drift, so we don't move away into nothing
-    constexpr float maxCenter = 2.5f;  // just an educated guess
     if (fabsf(julias.xcen) < maxCenter) julias.xcen = julias.xcen + (float)(centerX - 128) / 100000.f;
     if (fabsf(julias.ycen) < maxCenter) julias.ycen = julias.ycen + (float)(centerY - 128) / 100000.f;
 
@@ -2206,61 +2246,41 @@ class JuliaEffect : public Node {
     ymin = constrain(ymin, -0.8f, 1.0f);
     ymax = constrain(ymax, -0.8f, 1.0f);
 
-    float dx;  // Delta x is mapped to the matrix size.
-    float dy;  // Delta y is mapped to the matrix size.
-
-    int maxIterations = 15;  // How many iterations per pixel before we give up. Make it 8 bits to match our range of colours.
-    float maxCalc = 16.0;    // How big is each calculation allowed to be before we give up.
-
-    maxIterations = iterations / 2;
+    frame.maxIterations = iterations / 2;  // How many iterations per pixel before we give up. Make it 8 bits to match our range of colours.
 
     // Resize section on the fly for some animation.
-    reAl = -0.94299f;  // PixelBlaze example
-    imAg = 0.3162f;
+    float reAl = -0.94299f;  // PixelBlaze example
+    float imAg = 0.3162f;
 
     // reAl += sinf((float)pal::millis()/305.f)/20.f;
     // imAg += sinf((float)pal::millis()/405.f)/20.f;
     reAl += (float)sin16(pal::millis() * 34) / 655340.f;
     imAg += (float)sin16(pal::millis() * 26) / 655340.f;
 
-    dx = (xmax - xmin) / cols;  // Scale the delta x and y values to our matrix size.
-    dy = (ymax - ymin) / rows;
-
-    // Start y
-    float y = ymin;
-    for (int j = 0; j < rows; j++) {
-      // Start x
-      float x = xmin;
-      for (int i = 0; i < cols; i++) {
-        // Now we test, as we iterate z = z^2 + c does z tend towards infinity?
-        float a = x;
-        float b = y;
-        int iter = 0;
-
-        while (iter < maxIterations) {  // Here we determine whether or not we're out of bounds.
-          float aa = a * a;
-          float bb = b * b;
-          float len = aa + bb;
-          if (len > maxCalc) {  // |z| = sqrt(a^2+b^2) OR z^2 = a^2+b^2 to save on having to perform a square root.
-            break;              // Bail
-          }
+    frame.xmin = toJulia(xmin);
+    frame.ymin = toJulia(ymin);
+    frame.stepX = toJulia((xmax - xmin) / cols);  // Scale the delta x and y values to our matrix size.
+    frame.stepY = toJulia((ymax - ymin) / rows);
+    frame.re = toJulia(reAl);
+    frame.im = toJulia(imAg);
+  }
 
-          // This operation corresponds to z -> z^2+c where z=a+ib c=(x,y). Remember to use 'foil'.
-          b = 2 * a * b + imAg;
-          a = aa - bb + reAl;
-          iter++;
-        }  // while
+  void loopRows(uint16_t rowStart, uint16_t rowEnd) override {
+    juliaRows(frame, layer->size.x, rowStart, rowEnd, [&](uint16_t column, uint16_t row, int iter) {
+      // We color each pixel based on how long it takes to get to infinity, or black if it never gets there.
+      if (iter == frame.maxIterations)
+        layer->setRGB(Coord3D(column, row), 0);
+      else
+        layer->setRGB(Coord3D(column, row), layerP.colorFromPalette(iter * 255 / frame.maxIterations));
+    });
+  }
 
-        // We color each pixel based on how long it takes to get to infinity, or black if it never gets there.
-        if (iter == maxIterations) {
-          layer->setRGB(Coord3D(i, j), 0);
-        } else {
-          layer->setRGB(Coord3D(i, j), ColorFromPalette(layerP.palette, iter * 255 / maxIterations));
-        }
-        x += dx;
-      }
-      y += dy;
-    }
+  void loop() override {
+    const uint16_t cols = layer->size.x;
+    const uint16_t rows = layer->size.y;
+
+    loopFrame();
+    loopRows(0, rows);
 
     // WLEDMM
     if (softBlur) layer->blurRows(48);  // slight blurr
@@ -2609,7 +2629,7 @@ class BlinkRainbowEffect : public Node {
     bool on = (timebase % dutyCycle) < onTime;
 
     if (on) {
-      CRGB color = ColorFromPalette(layerP.palette, colorIndex);
+      CRGB color = layerP.colorFromPalette(colorIndex);
       layer->fill_solid(color);
     } else {
       layer->fill_solid(CRGB::Black);
@@ -2674,12 +2694,12 @@ class MeteorEffect : public Node {
             int change = trailData[i] + 4 - random8(24);
             trailData[i] = constrain(change, 0, 240);
           }
-          CRGB col = gradient ? ColorFromPalette(layerP.palette, i * 255 / layer->nrOfLights, trailData[i]) : ColorFromPalette(layerP.palette, trailData[i]);
+          CRGB col = gradient ? layerP.colorFromPalette(i * 255 / layer->nrOfLights, trailData[i]) : layerP.colorFromPalette(trailData[i]);
           layer->setRGB(i, col);
         } else {
           trailData[i] = scale8(trailData[i], 128 + random8(127));
           int index = gradient ? map(i, 0, layer->nrOfLights, 0, 240) : trailData[i];
-          CRGB col = ColorFromPalette(layerP.palette, index, trailData[i]);
+          CRGB col = layerP.colorFromPalette(index, trailData[i]);
           layer->setRGB(i, col);
         }
       }
@@ -2690,7 +2710,7 @@ class MeteorEffect : public Node {
       int index = (meteorStart + j) % layer->nrOfLights;
       trailData[index] = 240;
       int colorIdx = gradient ? (index * 255 / layer->nrOfLights) : 240;
-      CRGB col = ColorFromPalette(layerP.palette, colorIdx, 255);
+      CRGB col = layerP.colorFromPalette(colorIdx, 255);
       layer->setRGB(index, col);
     }
 
@@ -2768,7 +2788,7 @@ class OscillateEffect : public Node {
       CRGB color = CRGB::Black;
       for (int j = 0; j < 3; j++) {
         if (i >= oscillators[j].pos - oscillators[j].size && i <= oscillators[j].pos + oscillators[j].size) {
-          CRGB newColor = ColorFromPalette(layerP.palette, j * 85);
+          CRGB newColor = layerP.colorFromPalette(j * 85);
           color = (color == CRGB::Black) ? newColor : blend(color, newColor, 128);
         }
       }
@@ -2814,7 +2834,7 @@ class PhasedNoiseEffect : public Node {
       uint8_t b = cubicwave8(val);
       b = (b > cutOff) ? (b - cutOff) : 0;
 
-      CRGB color = blend(CRGB::Black, ColorFromPalette(layerP.palette, index), b);
+      CRGB color = blend(CRGB::Black, layerP.colorFromPalette(index), b);
       layer->setRGB(i, color);
 
       index += 256 / layer->nrOfLights;
@@ -2854,7 +2874,7 @@ class FreqmapEffect : public Node {
 
     uint16_t bright = (int)(sqrtf(myMagnitude) * 16.0f);  // cppcheck-suppress unreadVariable -- WLED ported code
 
-    CRGB color = ColorFromPalette(layerP.palette, intensity + pixCol);
+    CRGB color = layerP.colorFromPalette(intensity + pixCol);
     layer->setRGB(locn, color);  // blend(layerP.color2, color, bright));
 
     if (speed > 228) {
@@ -2893,7 +2913,7 @@ class FreqpixelsEffect : public Node {
       uint8_t pixCol = (log10f(myMajorPeak) - 1.78f) * 255.0f / (MAX_FREQ_LOG10 - 1.78f);
       if (myMajorPeak < 61.0f) pixCol = 0;
 
-      CRGB color = ColorFromPalette(layerP.palette, intensity + pixCol);
+      CRGB color = layerP.colorFromPalette(intensity + pixCol);
       layer->setRGB(locn, color);  // blend(layerP.color2, color, (int)myMagnitude));
     }
   }
@@ -2953,7 +2973,7 @@ class FreqwaveEffect : public Node {
         uint16_t b = 255.0f * intensity;
         if (b > 255) b = 255;
         // color = CHSV(i, 176 + (uint8_t)b / 4, (uint8_t)b);
-        color = ColorFromPalette(layerP.palette, i, (uint8_t)b);
+        color = layerP.colorFromPalette(i, (uint8_t)b);
       }
 
       for (int x = 0; x < layer->size.x; x++)
@@ -3022,7 +3042,7 @@ class GravfreqEffect : public Node {
     int palIndex = (indexNew + lastColorIndex) / 2;
 
     for (int i = 0; i < tempsamp; i++) {
-      CRGB color = ColorFromPalette(layerP.palette, (uint8_t)palIndex);
+      CRGB color = layerP.colorFromPalette((uint8_t)palIndex);
       layer->setRGB(i + layer->nrOfLights / 2, color);
       layer->setRGB(layer->nrOfLights / 2 - i - 1, color);
     }
@@ -3092,7 +3112,7 @@ class GravimeterEffect : public Node {
     if (sharedData.volume > 0.85f) {
       for (int i = 0; i < tempsamp; i++) {
         uint8_t index = inoise8(i * segmentSampleAvg + millis(), 5000 + i * segmentSampleAvg);
-        CRGB color = ColorFromPalette(layerP.palette, index, (uint8_t)blendVal);
+        CRGB color = layerP.colorFromPalette(index, (uint8_t)blendVal);
         layer->setRGB(i, color);  // blend(layerP.color2, color, (uint8_t)blendVal));
       }
     }
@@ -3103,7 +3123,7 @@ class GravimeterEffect : public Node {
       gravData->topLED--;
 
     if ((gravData->topLED > 0) && (speed < 255)) {
-      CRGB color = ColorFromPalette(layerP.palette, MAX(uint16_t(millis() / 2), (uint16_t)2));
+      CRGB color = layerP.colorFromPalette(MAX(uint16_t(millis() / 2), (uint16_t)2));
       layer->setRGB(gravData->topLED, color);
     }
     gravData->gravityCounter = (gravData->gravityCounter + 1) % gravity;
@@ -3152,7 +3172,7 @@ class GravcenterEffect : public Node {
 
     for (int i = 0; i < tempsamp; i++) {
       uint8_t index = inoise8(i * segmentSampleAvg + millis(), 5000 + i * segmentSampleAvg);
-      CRGB color = ColorFromPalette(layerP.palette, index, segmentSampleAvg * 8);
+      CRGB color = layerP.colorFromPalette(index, segmentSampleAvg * 8);
       // color = blend(layerP.color2, color, segmentSampleAvg * 8);
       layer->setRGB(i + layer->nrOfLights / 2, color);
       layer->setRGB(layer->nrOfLights / 2 - i - 1, color);
@@ -3164,7 +3184,7 @@ class GravcenterEffect : public Node {
       gravData->topLED--;
 
     if (gravData->topLED >= 0) {
-      CRGB color = ColorFromPalette(layerP.palette, millis() / 4);
+      CRGB color = layerP.colorFromPalette(millis() / 4);
       layer->setRGB(gravData->topLED + layer->nrOfLights / 2, color);
       layer->setRGB(layer->nrOfLights / 2 - 1 - gravData->topLED, color);
     }
@@ -3214,7 +3234,7 @@ class GravcentricEffect : public Node {
 
     for (int i = 0; i < tempsamp; i++) {
       uint8_t index = segmentSampleAvg * 24 + millis() / 200;
-      CRGB color = ColorFromPalette(layerP.palette, index);
+      CRGB color = layerP.colorFromPalette(index);
       layer->setRGB(i + layer->nrOfLights / 2, color);
       layer->setRGB(layer->nrOfLights / 2 - 1 - i, color);
     }
@@ -3259,7 +3279,7 @@ class MidnoiseEffect : public Node {
 
     for (int i = (layer->nrOfLights / 2 - maxLen); i < (layer->nrOfLights / 2 + maxLen); i++) {
       uint8_t index = inoise8(i * sharedData.volume + xdist, ydist + i * sharedData.volume);
-      layer->setRGB(i, ColorFromPalette(layerP.palette, index));
+      layer->setRGB(i, layerP.colorFromPalette(index));
     }
 
     xdist = xdist + beatsin8(5, 0, 10);
@@ -3292,7 +3312,7 @@ class NoisemoveEffect : public Node {
     for (int i = 0; i < numBins; i++) {
       uint16_t locn = inoise16(millis() * speed + i * 50000, millis() * speed);
       locn = ::map(locn, 7500, 58000, 0, layer->nrOfLights - 1);
-      CRGB color = ColorFromPalette(layerP.palette, i * 64);
+      CRGB color = layerP.colorFromPalette(i * 64);
       // color = blend(layerP.color2, color, sharedData.bands[i % 16] * 4);
       layer->setRGB(locn, color);
     }
@@ -3354,7 +3374,7 @@ class PixelwaveEffect : public Node {
       rawPixel = rawPixel * rawPixel / 256.0f;
       int pixBri = rawPixel * (intensity + 1) / 96;
 
-      CRGB color = ColorFromPalette(layerP.palette, millis() / 5, pixBri);
+      CRGB color = layerP.colorFromPalette(millis() / 5, pixBri);
       // color = blend(layerP.color2, color, pixBri);
       layer->setRGB(layer->nrOfLights / 2, color);
 
@@ -3416,7 +3436,7 @@ class PlasmoidEffect : public Node {
         thisbright = 0;
       }
 
-      CRGB color = ColorFromPalette(layerP.palette, colorIndex, thisbright);
+      CRGB color = layerP.colorFromPalette(colorIndex, thisbright);
       layer->addRGB(i, color);  // blend(layerP.color2, color, thisbright));
     }
   }
@@ -3452,7 +3472,7 @@ class PuddlepeakEffect : public Node {
     }
 
     for (int i = 0; i < size; i++) {
-      layer->setRGB(pos + i, ColorFromPalette(layerP.palette, millis() / 4));
+      layer->setRGB(pos + i, layerP.colorFromPalette(millis() / 4));
     }
   }
 };
@@ -3485,7 +3505,7 @@ class PuddlesEffect : public Node {
     }
 
     for (int i = 0; i < size; i++) {
-      layer->setRGB(pos + i, ColorFromPalette(layerP.palette, millis() / 4));
+      layer->setRGB(pos + i, layerP.colorFromPalette(millis() / 4));
     }
   }
 };
@@ -3538,15 +3558,15 @@ class RipplepeakEffect : public Node {
         ripples[i].state = 0;
         break;
       case 0:
-        layer->setRGB(ripples[i].pos, ColorFromPalette(layerP.palette, ripples[i].color));  // blend(layerP.color2, ColorFromPalette(layerP.palette, ripples[i].color), brightness));
+        layer->setRGB(ripples[i].pos, layerP.colorFromPalette(ripples[i].color));  // blend(layerP.color2, ColorFromPalette(layerP.palette, ripples[i].color), brightness));
         ripples[i].state++;
         break;
       case 16:
         ripples[i].state = 254;
         break;
       default:
-        layer->setRGB((ripples[i].pos + ripples[i].state + layer->nrOfLights) % layer->nrOfLights, ColorFromPalette(layerP.palette, ripples[i].color));  // blend(layerP.color2, ColorFromPalette(layerP.palette, ripples[i].color), brightness / ripples[i].state * 2));
-        layer->setRGB((ripples[i].pos - ripples[i].state + layer->nrOfLights) % layer->nrOfLights, ColorFromPalette(layerP.palette, ripples[i].color));  // blend(layerP.color2, ColorFromPalette(layerP.palette, ripples[i].color), brightness / ripples[i].state * 2));
+        layer->setRGB((ripples[i].pos + ripples[i].state + layer->nrOfLights) % layer->nrOfLights, layerP.colorFromPalette(ripples[i].color));  // blend(layerP.color2, ColorFromPalette(layerP.palette, ripples[i].color), brightness / ripples[i].state * 2));
+        layer->setRGB((ripples[i].pos - ripples[i].state + layer->nrOfLights) % layer->nrOfLights, layerP.colorFromPalette(ripples[i].color));  // blend(layerP.color2, ColorFromPalette(layerP.palette, ripples[i].color), brightness / ripples[i].state * 2));
         ripples[i].state++;
         break;
       }
@@ -3588,7 +3608,7 @@ class RocktavesEffect : public Node {
 
     uint16_t i = ::map(beatsin8(8 + octCount * 4, 0, 255, 0, octCount * 8), 0, 255, 0, layer->nrOfLights - 1);
     i = constrain(i, 0, layer->nrOfLights - 1);
-    layer->addRGB(i, ColorFromPalette(layerP.palette, (uint8_t)frTemp));  // blend(layerP.color2, ColorFromPalette(layerP.palette, (uint8_t)frTemp), volTemp));
+    layer->addRGB(i, layerP.colorFromPalette((uint8_t)frTemp));  // blend(layerP.color2, ColorFromPalette(layerP.palette, (uint8_t)frTemp), volTemp));
   }
 };
 
@@ -3629,7 +3649,7 @@ class WaterfallEffect : public Node {
         for (int x = 0; x < layer->size.x; x++)
           for (int z = 0; z < layer->size.z; z++) layer->setRGB(Coord3D(x, layer->size.y - 1, z), CHSV(92, 92, 92));
       } else {
-        CRGB color = ColorFromPalette(layerP.palette, pixCol + intensity, 127 + myMagnitude / 2.0);
+        CRGB color = layerP.colorFromPalette(pixCol + intensity, 127 + myMagnitude / 2.0);
         for (int x = 0; x < layer->size.x; x++)
           for (int z = 0; z < layer->size.z; z++) layer->setRGB(Coord3D(x, layer->size.y - 1, z), color);  // blend(layerP.color2, color, (int)myMagnitude));
       }
@@ -12,7 +12,7 @@
 #if FT_MOONLIGHT
 
 // example template, do not remove!
-// add this class in /src/MoonLight/ModuleEffects::addNodes()
+// register this class in /src/MoonLight/ModuleEffects::nodeTypes()
 // add documentation in /docs/moonlight/effects.md
 class ExampleEffect : public Node {
  public:
@@ -53,7 +53,7 @@ class ExampleEffect : public Node {
           pos.x = beatsin8(bpm, 0, layer->size.x - 1);
           pos.y = beatsin8(intensity, 0, layer->size.y - 1);
           pos.z = beatsin8(intensity, 0, layer->size.z - 1);
-          layer->setRGB(pos, ColorFromPalette(layerP.palette, beatsin8(12, 0, 255)));
+          layer->setRGB(pos, layerP.colorFromPalette(beatsin8(12, 0, 255)));
           // NOTE: effects must ensure pos is within layer->size bounds (setRGB omits bounds checks for performance)
         }
       }
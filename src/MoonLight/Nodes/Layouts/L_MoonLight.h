@@ -34,19 +34,33 @@ class HumanSizedCubeLayout : public Node {
 
   bool hasOnLayout() const override { return true; }
   void onLayout() override {
+    // each curtain a grid, column by column
+    LightGrid curtain;
+
     // front: z = 0
-    for (int x = 0; x < width; x++)
-      for (int y = 0; y < height; y++) addLight(Coord3D(x + 1, y + 1, 0));
+    curtain.origin = Coord3D(1, 1, 0);
+    curtain.size[0] = width;
+    curtain.size[1] = height;
+    curtain.size[2] = 1;
+    curtain.axes[0] = 2;  // z, x, y (y fastest)
+    curtain.axes[1] = 0;
+    curtain.axes[2] = 1;
+    addLights(curtain);
     nextPin();  // each curtain it's own pin
 
     // back: z = depth+1
-    for (int x = 0; x < width; x++)
-      for (int y = 0; y < height; y++) addLight(Coord3D(x + 1, y + 1, depth + 1));
+    curtain.origin.z = depth + 1;
+    addLights(curtain);
     nextPin();  // each curtain it's own pin
 
     // above: y = 0
-    for (int x = 0; x < width; x++)
-      for (int z = 0; z < depth; z++) addLight(Coord3D(x + 1, 0, z + 1));
+    curtain.origin = Coord3D(1, 0, 1);
+    curtain.size[1] = 1;
+    curtain.size[2] = depth;
+    curtain.axes[0] = 0;  // x, y, z (z fastest)
+    curtain.axes[1] = 1;
+    curtain.axes[2] = 2;
+    addLights(curtain);
     nextPin();  // each curtain it's own pin
 
     // //below: y = height+1
@@ -54,34 +68,22 @@ class HumanSizedCubeLayout : public Node {
     // nextPin();  // each curtain it's own pin
 
     // left: x = 0
-    for (int z = 0; z < depth; z++)
-      for (int y = 0; y < height; y++) addLight(Coord3D(0, y + 1, z + 1));
+    curtain.origin = Coord3D(0, 1, 1);
+    curtain.size[0] = 1;
+    curtain.size[1] = height;
+    curtain.axes[0] = 2;  // z, x, y (y fastest)
+    curtain.axes[1] = 0;
+    curtain.axes[2] = 1;
+    addLights(curtain);
     nextPin();  // each curtain it's own pin
 
     // right: x = width+1
-    for (int z = 0; z < depth; z++)
-      for (int y = 0; y < height; y++) addLight(Coord3D(width + 1, y + 1, z + 1));
+    curtain.origin.x = width + 1;
+    addLights(curtain);
     nextPin();  // each curtain it's own pin
   }
 };
 
-struct Wiring {
-  uint16_t size[3] = {16, 16, 16};       // panels of 16x16
-  uint8_t wiringOrder = 1;               // first Y, then X, then Z
-  bool inc[3] = {true, true};            // left, top, front
-  bool snake[3] = {false, true, false};  // snake on Y
-  uint8_t* axes;
-
-  template <typename Callback>
-  void iterate(int axis, int snaker, Callback&& fun) {
-    bool iInc = inc[axes[axis]];
-    if (snake[axis] && snaker % 2 == 1) iInc = !iInc;  // reverse order for snake
-    for (int j = iInc ? 0 : size[axes[axis]] - 1; iInc ? j < size[axes[axis]] : j >= 0; j += iInc ? 1 : -1) {
-      fun(j);
-    }
-  }
-};
-
 // PanelLayout is a simplified version of PanelsLayout (only one panel)
 class PanelLayout : public Node {
  public:
@@ -112,14 +114,7 @@ class PanelLayout : public Node {
     };
 
     panel.axes = axisOrders[panel.wiringOrder];  // choose one of the orders
-    panel.iterate(0, 0, [&](uint16_t i) {
-      panel.iterate(1, i, [&](uint16_t j) {
-        int coords[2];
-        coords[panel.axes[0]] = i;
-        coords[panel.axes[1]] = j;
-        addLight(Coord3D(coords[0], coords[1]));
-      });
-    });
+    addLights(panel.grid(2));
     nextPin();  // all lights to one pin
   }
 };
@@ -173,14 +168,7 @@ class PanelsLayout : public Node {
         coordsP[panels.axes[1]] = b;
 
         panel.axes = axisOrders[panel.wiringOrder];  // choose one of the orders
-        panel.iterate(0, 0, [&](uint16_t i) {
-          panel.iterate(1, i, [&](uint16_t j) {
-            int coords[2];
-            coords[panel.axes[0]] = i;
-            coords[panel.axes[1]] = j;
-            addLight(Coord3D(coordsP[0] * panel.size[0] + coords[0], coordsP[1] * panel.size[1] + coords[1]));
-          });
-        });
+        addLights(panel.grid(2, Coord3D(coordsP[0] * panel.size[0], coordsP[1] * panel.size[1])));
 
         nrOfPanels++;
 
@@ -232,19 +220,12 @@ class CubeLayout : public Node {
     };
 
     panels.axes = axisOrders[panels.wiringOrder];  // choose one of the orders
-    panels.iterate(0, 0, [&](uint16_t i) {
-      panels.iterate(1, i, [&](uint16_t j) {
-        panels.iterate(2, j, [&](uint16_t k) {
-          int coords[3];
-          coords[panels.axes[0]] = i;
-          coords[panels.axes[1]] = j;
-          coords[panels.axes[2]] = k;
-          addLight(Coord3D(coords[0], coords[1], coords[2]));
-        });
-      });
-
+    LightGrid cube = panels.grid(3);
+    size_t plane = (size_t)cube.size[cube.axes[1]] * cube.size[cube.axes[2]];
+    for (uint16_t i = 0; i < cube.size[cube.axes[0]]; i++) {
+      addLights(cube, i * plane, plane);
       nextPin();  // each plane it's own pin
-    });
+    }
   }
 };
 
@@ -391,15 +372,11 @@ class SingleRowLayout : public Node {
 
   bool hasOnLayout() const override { return true; }
   void onLayout() override {
-    if (reversed_order) {
-      for (int x = start_x + width - 1; x >= start_x; x--) {
-        addLight(Coord3D(x, yposition, 0));
-      }
-    } else {
-      for (int x = start_x; x < start_x + width; x++) {
-        addLight(Coord3D(x, yposition, 0));
-      }
-    }
+    LightGrid row;
+    row.origin = Coord3D(start_x, yposition, 0);
+    row.size[0] = width;
+    row.inc[0] = !reversed_order;
+    addLights(row);
     nextPin(ledPinDIO == 0 ? UINT8_MAX : ledPinDIO - 1);  // all lights to one pin, default: use default
   }
 };
@@ -433,15 +410,11 @@ class SingleColumnLayout : public Node {
 
   bool hasOnLayout() const override { return true; }
   void onLayout() override {
-    if (reversed_order) {
-      for (int y = start_y + height - 1; y >= start_y; y--) {
-        addLight(Coord3D(xposition, y, 0));
-      }
-    } else {
-      for (int y = start_y; y < start_y + height; y++) {
-        addLight(Coord3D(xposition, y, 0));
-      }
-    }
+    LightGrid column;
+    column.origin = Coord3D(xposition, start_y, 0);
+    column.size[1] = height;
+    column.inc[1] = !reversed_order;
+    addLights(column);
     nextPin(ledPinDIO == 0 ? UINT8_MAX : ledPinDIO - 1);  // all lights to one pin, default: use default
   }
 };
@@ -514,61 +487,9 @@ class RingLayout : public Node {
   const float getRadius(uint8_t nrOfLEDs) { return nrOfLEDs / (TWO_PI); }
 
   void onLayout() override {
-    // Calculate ring dimensions based on 1cm * scale spacing between LEDs
-
-    for (int i = 0; i < nrOfLEDs; i++) {
-      float x = scale * ringCenter.x;
-      float y = scale * ringCenter.y;
-
-      // Calculate angle for this LED including the angleFirst offset
-      float ledAngle = fmod(angleFirst + ((float)i / nrOfLEDs) * 360.0, 360.0);
-
-      // Calculate the actual position angle for rendering
-      float angleRad = PI + (TWO_PI * i) / nrOfLEDs + TWO_PI * angleFirst / 360.0;
-
-      if (nrOfLEDs != 1) {
-        x -= scale * sinf(angleRad) * getRadius(nrOfLEDs);
-        y += scale * cosf(angleRad) * getRadius(nrOfLEDs);
-      }
-
-      // Check if this LED should be included in the partial circle
-      bool includeLED = false;
-      if (rotation < 1.0 || rotation >= 360.0) {
-        // Full circle
-        includeLED = true;
-      } else {
-        // Calculate end angle
-        float endAngle;
-        if (clockwise) {
-          endAngle = fmod(angleFirst + rotation, 360.0);
-        } else {
-          endAngle = fmod(angleFirst - rotation + 360.0, 360.0);
-        }
-
-        // Check if ledAngle is between angleFirst and endAngle
-        if (clockwise) {
-          if (endAngle >= angleFirst) {
-            // No wrap: angleFirst=180, rotation=90, endAngle=270
-            includeLED = (ledAngle >= angleFirst && ledAngle <= endAngle);
-          } else {
-            // Wraps around 0: angleFirst=270, rotation=180, endAngle=90
-            includeLED = (ledAngle >= angleFirst || ledAngle <= endAngle);
-          }
-        } else {
-          if (endAngle <= angleFirst) {
-            // No wrap: angleFirst=180, rotation=90, endAngle=90
-            includeLED = (ledAngle <= angleFirst && ledAngle >= endAngle);
-          } else {
-            // Wraps around 0: angleFirst=90, rotation=180, endAngle=270
-            includeLED = (ledAngle <= angleFirst || ledAngle >= endAngle);
-          }
-        }
-      }
-
-      if (includeLED) {
-        addLight({(int)x, (int)y, scale * ringCenter.z});
-      }
-    }
+    // Calculate ring dimensions based on 1cm * scale spacing between LEDs, only the lights on the part of the ring
+    // from angleFirst over rotation degrees
+    addLights(nrOfLEDs, [&](size_t i, Coord3D& position) { return ringLight(ringCenter, nrOfLEDs, i, angleFirst, rotation, clockwise, scale, position); });
     if (doNextPin) nextPin();  // all lights to one pin
   }
 };
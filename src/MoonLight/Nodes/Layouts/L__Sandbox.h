@@ -12,7 +12,7 @@
 #if FT_MOONLIGHT
 
 // example template, do not remove!
-// add this class in /src/MoonLight/ModuleDrivers::addNodes()
+// register this class in /src/MoonLight/ModuleDrivers::nodeTypes()
 // add documentation in /docs/moonlight/layouts.md
 class ExampleLayout : public Node {
  public:
@@ -214,8 +214,8 @@ class PinwheelModifier : public Node {
 
     const int dx = position.x - layer->middle.x;
     const int dy = position.y - layer->middle.y;
-    const int swirlFactor = swirlVal == 0 ? 0 : hypot(dy, dx) * abs(swirlVal);  // Only calculate if swirlVal != 0
-    int angle = degrees(atan2(dy, dx)) + 180;                                   // 0 - 360
+    const int swirlFactor = swirlVal == 0 ? 0 : hypotFixed(dx * 16, dy * 16) * abs(swirlVal) / 16;  // Only calculate if swirlVal != 0
+    int angle = (dy == 0 && dx < 0) ? 360 : atan2Fixed(dy, dx) * 360 / 65536 + 180;              // 0 - 360 (atan2 of -x is π)
 
     if (swirlVal < 0) angle = 360 - angle;  // Reverse Swirl
 
@@ -228,7 +228,7 @@ class PinwheelModifier : public Node {
     position.x = value;
     position.y = 0;
     if (layer->effectDimension > _1D && layer->layerDimension > _1D) {
-      position.y = int(sqrt(sq(dx) + sq(dy)));  // Round produced blank position
+      position.y = hypotFixed(dx, dy);  // Round produced blank position
     }
     position.z = 0;
 
@@ -337,6 +337,7 @@ class RotateModifier : public Node {
   int maxX, maxY;
 
   bool hasModifier() const override { return true; }
+  bool hasModifyXYZ() const override { return true; }
 
   void modifySize() override {
     if (expand) {
@@ -394,10 +395,12 @@ class RotateModifier : public Node {
 
       shearAngle = flip ? (shearAngle + 180) % 360 : shearAngle;  // Flip shearAngle if needed
 
-      // Calculate shearX and shearY
-      float angleRadians = radians(shearAngle);
-      shearX = -tanf(angleRadians / 2) * Fixed_Scale;  // f by softhack007
-      shearY = sinf(angleRadians) * Fixed_Scale;       // f by softhack007
+      // Calculate shearX and shearY: -tan(angle / 2) = -sin / (1 + cos), cos >= 0 after the flip
+      uint16_t angle16 = shearAngle * 65536 / 360;
+      int32_t sinA = sinFixed(angle16);
+      int32_t cosA = cosFixed(angle16);
+      shearX = -(sinA * Fixed_Scale) / (32767 + cosA);  // f by softhack007
+      shearY = (sinA * Fixed_Scale) / 32767;            // f by softhack007
 
       prevAngle = angle;
     }
@@ -12,7 +12,7 @@
 #if FT_MOONLIGHT
 
 // example template, do not remove!
-// add this class in /src/MoonLight/ModuleDrivers::addNodes()
+// register this class in /src/MoonLight/ModuleDrivers::nodeTypes()
 // add documentation in /docs/moonlight/modifiers.md
 class ExampleModifier : public Node {
  public:
@@ -32,6 +32,7 @@ class ExampleModifier : public Node {
   Coord3D modifierSize;  // store modified size for use in modifyPosition and modifyXYZ, useful for multiple modifiers
 
   bool hasModifier() const override { return true; }  // so the mapping system knows this node is a modifier
+  bool hasModifyXYZ() const override { return true; }  // so blur goes through XYZ()
 
   // modify the (virtual) size during mapping
   void modifySize() override {
@@ -136,7 +136,9 @@ TaskHandle_t driverTaskHandle = nullptr;
   while (true) {
     // Check state under lock
     esp_task_wdt_reset();
+    unsigned long waitStart = micros();
     xSemaphoreTake(swapMutex, portMAX_DELAY);
+    moduleTasks.effectsSwapWait.add(micros() - waitStart);
 
     if (layerP.lights.header.isPositions == 0 && !newFrameReady) {  // within mutex as driver task can change this
       xSemaphoreGive(swapMutex);  // release so driver can run concurrently while effects write virtualChannels
@@ -174,8 +176,12 @@ TaskHandle_t driverTaskHandle = nullptr;
       }
 
       // Wait for driver to finish reading channelsD, then composite virtualChannels into it
+      waitStart = micros();
       xSemaphoreTake(channelsDFreeSemaphore, portMAX_DELAY);
+      moduleTasks.channelsFreeWait.add(micros() - waitStart);
+      waitStart = micros();
       xSemaphoreTake(swapMutex, portMAX_DELAY);
+      moduleTasks.effectsSwapWait.add(micros() - waitStart);
       if (layerP.lights.header.isPositions == 0) {  // check if layout didn't start while we were unlocked
         layerP.compositeLayers();  // zero channelsD + composite all virtualChannels into it
         newFrameReady = true;
@@ -202,7 +208,9 @@ TaskHandle_t driverTaskHandle = nullptr;
     bool mutexGiven = false;
     esp_task_wdt_reset();
     // Check and transition state under lock
+    unsigned long waitStart = micros();
     xSemaphoreTake(swapMutex, portMAX_DELAY);
+    moduleTasks.driversSwapWait.add(micros() - waitStart);
     if (layerP.lights.header.isPositions == 3) {
       EXT_LOGD(ML_TAG, "positions done (3 -> 0)");
       layerP.lights.header.isPositions = 0;
@@ -303,6 +311,24 @@ void setup() {
     safeModeMB = true;
   }
 
+  // heap and internal RAM to keep free before subsystems shed memory (see MemBudget.h), and what the monitor may take
+  memBudget.setReserve(psramFound() ? 64 * 1024 : 16 * 1024, 16 * 1024);
+  memBudget.setBudget(MemMonitor, psramFound() ? 256 * 1024 : 32 * 1024);
+  // memory per subsystem and the degradation level in System Status
+  esp32sveltekit.systemStatusExtension = [](JsonObject root) {
+    char line[96];
+    snprintf(line, sizeof(line), "%s (peak %s, raised %d times)", memDegradationName(memBudget.level()), memDegradationName(memBudget.peakLevel()), memBudget.raised());
+    root["mem_degradation"] = line;
+    JsonArray tags = root["mem_tags"].to<JsonArray>();
+    for (uint8_t tag = 0; tag < MemTags; tag++) {
+      MemTagStats stats = memBudget.stats((MemTag)tag);
+      int length = snprintf(line, sizeof(line), "%s: %d KB, peak %d KB", memTagName((MemTag)tag), stats.used / 1024, stats.peak / 1024);
+      if (stats.budget) length += snprintf(line + length, sizeof(line) - length, " of %d KB", stats.budget / 1024);
+      if (stats.failed || stats.denied) snprintf(line + length, sizeof(line) - length, ", %d failed, %d denied", stats.failed, stats.denied);
+      tags.add(line);
+    }
+  };
+
   // start ESP32-SvelteKit
   esp32sveltekit.begin();
 
@@ -344,6 +370,8 @@ void setup() {
 // MoonBase
 #if FT_ENABLED(FT_MOONBASE)
   fileManager.begin();
+  sharedFsPersistence->onFileWritten = [](const char* path) { fileManager.fileChanged(path, "SharedFSPersistence"); };
+  fsPersistenceWritten = [](const char* path) { fileManager.fileChanged(path, "FSPersistence"); };  // settings of the framework services
   for (Module* module : modules) {
     module->begin();
   }
@@ -381,6 +409,7 @@ void setup() {
 
   // run UI stuff in the sveltekit task
   esp32sveltekit.addLoopFunction([]() {
+    fileManager.loop();  // index updates of files written by modules (fileChanged)
     for (Module* module : modules) module->loop();
 
     static unsigned long last20ms = 0;
@@ -396,6 +425,8 @@ void setup() {
 
         for (Module* module : modules) module->loop1s();
 
+        if (memBudget.update(memFreeBytes(), memFreeInternal())) EXT_LOGW(MB_TAG, "memory: %s (%d bytes free, %d internal)", memDegradationName(memBudget.level()), memFreeBytes(), memFreeInternal());
+
         // every 10 seconds
         static unsigned long last10Second = 0;
         if (millis() - last10Second >= 10000) {
@@ -0,0 +1,106 @@
+/**
+    @title     MoonLight Unit Tests — native heap_caps
+    @file      native_heap_caps.h
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    The ESP-IDF heap_caps_* functions MemAlloc.h calls, on a fake heap of fixed capacity (malloc'ed blocks whose sizes
+    count against it), and the memBudget it accounts to. Include before MemAlloc.h, so tests call the real
+    allocMB / reallocMB2 / freeMB. All test files link into one program: everything here is inline.
+**/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <new>
+
+#include "MemBudget.h"
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+struct NativeHeap {
+  size_t capacity = SIZE_MAX / 2;
+  size_t used = 0;
+  std::map<void*, size_t> blocks;  // live blocks and their sizes
+  size_t foreignFrees = 0;         // heap_caps_free of a pointer the heap did not hand out (a pool block, twice freed)
+  size_t internalFree = SIZE_MAX / 2;  // MALLOC_CAP_INTERNAL: set by a test, blocks are not taken from it (PSRAM)
+
+  size_t freeBytes() const { return capacity - used; }
+  size_t size(void* p) const {
+    auto block = blocks.find(p);
+    return block != blocks.end() ? block->second : 0;
+  }
+};
+
+inline NativeHeap& nativeHeap() {
+  static NativeHeap heap;
+  return heap;
+}
+
+inline MemBudget memBudget;
+
+/// A test case's heap of capacity bytes and a fresh memBudget; blocks left at the end are freed (and counted).
+struct NativeHeapScope {
+  explicit NativeHeapScope(size_t capacity = SIZE_MAX / 2) {
+    reset();
+    nativeHeap().capacity = capacity;
+  }
+  ~NativeHeapScope() { reset(); }
+
+  static void reset() {
+    NativeHeap& heap = nativeHeap();
+    for (auto& block : heap.blocks) ::free(block.first);
+    heap.blocks.clear();
+    heap.used = 0;
+    heap.foreignFrees = 0;
+    heap.capacity = SIZE_MAX / 2;
+    heap.internalFree = SIZE_MAX / 2;
+    memBudget.~MemBudget();  // not assignable (mutex): a new one in place
+    new (&memBudget) MemBudget();
+  }
+};
+
+inline void* heap_caps_calloc_prefer(size_t n, size_t size, size_t num, ...) {
+  NativeHeap& heap = nativeHeap();
+  size_t bytes = n * size;
+  if (bytes > heap.freeBytes()) return nullptr;
+  void* p = calloc(1, bytes ? bytes : 1);
+  if (!p) return nullptr;
+  heap.blocks[p] = bytes;
+  heap.used += bytes;
+  return p;
+}
+
+inline void* heap_caps_realloc_prefer(void* p, size_t bytes, size_t num, ...) {
+  NativeHeap& heap = nativeHeap();
+  size_t old = heap.size(p);
+  if (bytes > old && bytes - old > heap.freeBytes()) return nullptr;
+  void* res = realloc(p, bytes ? bytes : 1);
+  if (!res) return nullptr;
+  if (p) heap.blocks.erase(p);
+  heap.blocks[res] = bytes;
+  heap.used = heap.used - old + bytes;
+  return res;
+}
+
+inline size_t heap_caps_get_allocated_size(void* p) { return nativeHeap().size(p); }
+
+inline void heap_caps_free(void* p) {
+  NativeHeap& heap = nativeHeap();
+  auto block = heap.blocks.find(p);
+  if (block == heap.blocks.end()) {
+    heap.foreignFrees++;
+    return;
+  }
+  heap.used -= block->second;
+  heap.blocks.erase(block);
+  ::free(p);
+}
+
+inline size_t heap_caps_get_free_size(uint32_t caps) { return caps & MALLOC_CAP_INTERNAL ? nativeHeap().internalFree : nativeHeap().freeBytes(); }
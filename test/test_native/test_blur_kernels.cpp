@@ -0,0 +1,157 @@
+/**
+    @title     MoonLight Unit Tests — BlurKernels
+    @file      test_blur_kernels.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the stride based blur kernels of VirtualLayer (src/MoonBase/utilities/BlurKernels.h): rows,
+    columns and z lines of a channel buffer blurred by the kernels are byte for byte what the light by light blur
+    (getRGB, nscale8, +=, addRGB as in VirtualLayer::blurLineXYZ) makes of them, for RGB and for lights with more
+    channels, where only the RGB bytes change.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "BlurKernels.h"
+
+namespace {
+
+struct Grid {
+  int sizeX, sizeY, sizeZ;
+  uint8_t channelsPerLight, offsetRGB;
+  std::vector<uint8_t> channels;
+
+  Grid(int x, int y, int z, uint8_t cpl, uint8_t offset) : sizeX(x), sizeY(y), sizeZ(z), channelsPerLight(cpl), offsetRGB(offset) {
+    channels.resize((size_t)x * y * z * cpl);
+    uint32_t seed = 12345;
+    for (uint8_t& channel : channels) {
+      seed = seed * 1664525u + 1013904223u;
+      channel = seed >> 24;
+    }
+  }
+  uint8_t* rgb(int x, int y, int z) { return &channels[((size_t)x + (size_t)y * sizeX + (size_t)z * sizeX * sizeY) * channelsPerLight + offsetRGB]; }
+};
+
+// the light by light blur of VirtualLayer (blurLineXYZ): get, scale, add the carry, add to the previous light, set
+void referenceLine(Grid& grid, int x, int y, int z, int dx, int dy, int dz, int length, uint8_t keep, uint8_t seep) {
+  uint8_t carry[3] = {0, 0, 0};
+  for (int i = 0; i < length; i++) {
+    uint8_t* cur = grid.rgb(x + i * dx, y + i * dy, z + i * dz);
+    uint8_t part[3], kept[3];
+    for (int c = 0; c < 3; c++) {
+      part[c] = blurScale(cur[c], seep);
+      kept[c] = blurAdd(blurScale(cur[c], keep), carry[c]);
+    }
+    if (i) {
+      uint8_t* previous = grid.rgb(x + (i - 1) * dx, y + (i - 1) * dy, z + (i - 1) * dz);
+      for (int c = 0; c < 3; c++) previous[c] = blurAdd(previous[c], part[c]);
+    }
+    for (int c = 0; c < 3; c++) {
+      cur[c] = kept[c];
+      carry[c] = part[c];
+    }
+  }
+  if (length) {
+    uint8_t* last = grid.rgb(x + (length - 1) * dx, y + (length - 1) * dy, z + (length - 1) * dz);
+    for (int c = 0; c < 3; c++) last[c] = blurAdd(last[c], carry[c]);
+  }
+}
+
+void referenceBlur3d(Grid& grid, uint8_t keep, uint8_t seep) {
+  for (int z = 0; z < grid.sizeZ; z++) {
+    for (int y = 0; y < grid.sizeY; y++) referenceLine(grid, 0, y, z, 1, 0, 0, grid.sizeX, keep, seep);
+    for (int x = 0; x < grid.sizeX; x++) referenceLine(grid, x, 0, z, 0, 1, 0, grid.sizeY, keep, seep);
+  }
+  for (int y = 0; y < grid.sizeY; y++)
+    for (int x = 0; x < grid.sizeX; x++) referenceLine(grid, x, y, 0, 0, 0, 1, grid.sizeZ, keep, seep);
+}
+
+// as VirtualLayer::blur3d on virtualChannels
+void kernelBlur3d(Grid& grid, uint8_t keep, uint8_t seep) {
+  const size_t cpl = grid.channelsPerLight, plane = (size_t)grid.sizeX * grid.sizeY * cpl;
+  uint8_t* rgb = grid.rgb(0, 0, 0);
+  for (int z = 0; z < grid.sizeZ; z++) {
+    for (int y = 0; y < grid.sizeY; y++) blurLine(rgb + z * plane + (size_t)y * grid.sizeX * cpl, cpl, grid.sizeX, keep, seep);
+    blurLines(rgb + z * plane, cpl, grid.sizeX, (size_t)grid.sizeX * cpl, grid.sizeY, keep, seep);
+  }
+  blurLines(rgb, cpl, (uint32_t)grid.sizeX * grid.sizeY, plane, grid.sizeZ, keep, seep);
+}
+
+}  // namespace
+
+TEST_CASE("BlurKernels: rows, columns and one column as the light by light blur") {
+  for (uint8_t cpl : {3, 4, 6}) {
+    for (uint8_t amount : {0, 1, 64, 172, 255}) {
+      uint8_t keep = 255 - amount, seep = amount >> 1;
+      uint8_t offset = cpl == 3 ? 0 : 1;
+      Grid reference(70, 13, 1, cpl, offset);  // more columns than BLUR_CHUNK
+      Grid kernel = reference;
+      std::vector<uint8_t> before = reference.channels;
+
+      for (int y = 0; y < 13; y++) referenceLine(reference, 0, y, 0, 1, 0, 0, 70, keep, seep);  // blurRows
+      for (int y = 0; y < 13; y++) blurLine(kernel.rgb(0, y, 0), cpl, 70, keep, seep);
+      REQUIRE(kernel.channels == reference.channels);
+
+      for (int x = 0; x < 70; x++) referenceLine(reference, x, 0, 0, 0, 1, 0, 13, keep, seep);  // blurColumns
+      blurLines(kernel.rgb(0, 0, 0), cpl, 70, (size_t)70 * cpl, 13, keep, seep);
+      REQUIRE(kernel.channels == reference.channels);
+
+      referenceLine(reference, 5, 0, 0, 0, 1, 0, 13, keep, seep);  // blur1d of column 5
+      blurLine(kernel.rgb(5, 0, 0), (size_t)70 * cpl, 13, keep, seep);
+      REQUIRE(kernel.channels == reference.channels);
+
+      for (size_t i = 0; i < before.size(); i++) {  // channels other than RGB are not touched
+        size_t channel = i % cpl;
+        if (channel < offset || channel >= offset + 3u) REQUIRE_EQ(kernel.channels[i], before[i]);
+      }
+    }
+  }
+}
+
+TEST_CASE("BlurKernels: blur3d along x, y and z as the light by light blur") {
+  for (uint8_t cpl : {3, 5}) {
+    Grid reference(9, 11, 7, cpl, cpl - 3);
+    Grid kernel = reference;
+    referenceBlur3d(reference, 255 - 128, 64);
+    kernelBlur3d(kernel, 255 - 128, 64);
+    CHECK(kernel.channels == reference.channels);
+  }
+
+  Grid single(1, 1, 5, 3, 0);  // one line along z
+  Grid reference = single;
+  referenceLine(reference, 0, 0, 0, 0, 0, 1, 5, 200, 27);
+  blurLines(single.rgb(0, 0, 0), 3, 1, 3, 5, 200, 27);
+  CHECK(single.channels == reference.channels);
+
+  Grid empty(4, 4, 1, 3, 0);  // length 0: nothing happens
+  std::vector<uint8_t> before = empty.channels;
+  blurLine(empty.rgb(0, 0, 0), 3, 0, 100, 50);
+  blurLines(empty.rgb(0, 0, 0), 3, 4, 12, 0, 100, 50);
+  CHECK(empty.channels == before);
+}
+
+TEST_CASE("BlurKernels benchmark: blur2d of 128x128 light by light and with the kernels") {
+  Grid reference(128, 128, 1, 3, 0);
+  Grid kernel = reference;
+  const int frames = 50;
+  auto start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++) {
+    for (int y = 0; y < 128; y++) referenceLine(reference, 0, y, 0, 1, 0, 0, 128, 128, 64);
+    for (int x = 0; x < 128; x++) referenceLine(reference, x, 0, 0, 0, 1, 0, 128, 128, 64);
+  }
+  double referenceUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+  start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++) {
+    for (int y = 0; y < 128; y++) blurLine(kernel.rgb(0, y, 0), 3, 128, 128, 64);
+    blurLines(kernel.rgb(0, 0, 0), 3, 128, 128 * 3, 128, 128, 64);
+  }
+  double kernelUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+  CHECK(kernel.channels == reference.channels);
+  MESSAGE("blur2d 128x128: " << referenceUs << " us light by light (without XYZ()), " << kernelUs << " us with the kernels");
+}
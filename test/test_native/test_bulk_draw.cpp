@@ -0,0 +1,197 @@
+/**
+    @title     MoonLight Unit Tests — BulkDraw and TaskBindings
+    @file      test_bulk_draw.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the bulk drawing of LiveScript (src/MoonBase/utilities/BulkDraw.h): gradients, palette spans,
+    copying and shifting match drawing light by light, for RGB and multi-channel lights. And for the task to node
+    binding of script externals (src/MoonBase/utilities/TaskBindings.h). The benchmark compares an external call per
+    light with the task map scanned per call, with the node cached per task, and one bulk call per row.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "BulkDraw.h"
+#include "TaskBindings.h"
+
+namespace {
+
+struct RGB {
+  uint8_t r, g, b;
+};
+
+RGB palette(uint8_t index) { return {index, (uint8_t)(255 - index), (uint8_t)(index * 3)}; }
+
+struct Layer {
+  int width, height, depth;
+  uint8_t cpl, offset;
+  std::vector<uint8_t> channels;
+  Layer(int w, int h, int d, uint8_t cpl, uint8_t offset) : width(w), height(h), depth(d), cpl(cpl), offset(offset), channels((size_t)w * h * d * cpl) {
+    for (size_t n = 0; n < channels.size(); n++) channels[n] = n * 13 + 5;
+  }
+  ChannelView view() { return {channels.data(), cpl, offset, width, height, depth}; }
+  uint8_t* light(int x, int y, int z = 0) { return &channels[((size_t)x + (size_t)y * width + (size_t)z * width * height) * cpl]; }
+  void set(size_t index, RGB color) {
+    uint8_t* rgb = &channels[index * cpl + offset];
+    rgb[0] = color.r;
+    rgb[1] = color.g;
+    rgb[2] = color.b;
+  }
+};
+
+// light by light, as a script calling setRGBPal per light
+void referenceGradient(Layer& layer, size_t first, size_t count, ptrdiff_t stride, uint8_t startIndex, int16_t step) {
+  uint16_t index = startIndex << 4;
+  for (size_t i = 0; i < count; i++, index += step) layer.set(first + i * stride, palette(index >> 4));
+}
+
+// through a copy of the layer: what copyRect must do for any overlap
+void referenceCopy(Layer& layer, int x, int y, int w, int h, int toX, int toY) {
+  Layer before = layer;
+  for (int z = 0; z < layer.depth; z++)
+    for (int r = 0; r < h; r++)
+      for (int c = 0; c < w; c++) {
+        int fx = x + c, fy = y + r, tx = toX + c, ty = toY + r;
+        if (fx < 0 || fy < 0 || fx >= layer.width || fy >= layer.height) continue;
+        if (tx < 0 || ty < 0 || tx >= layer.width || ty >= layer.height) continue;
+        for (int ch = 0; ch < layer.cpl; ch++) layer.light(tx, ty, z)[ch] = before.light(fx, fy, z)[ch];
+      }
+}
+
+// a script task: the handle of the calling task, as xTaskGetCurrentTaskHandle (not inlined: a call on the device too)
+thread_local int currentTask = 0;
+__attribute__((noinline)) int taskHandle() { return currentTask; }
+
+struct ScriptNode {
+  Layer* layer;
+};
+TaskBindings<int, ScriptNode, 4> bindings;
+ScriptNode* fallbackNode = nullptr;
+thread_local ScriptNode* cachedNode = nullptr;
+
+ScriptNode* scanned() {
+  ScriptNode* node = bindings.find(taskHandle());
+  return node ? node : fallbackNode;
+}
+ScriptNode* cached() {
+  if (cachedNode) return cachedNode;
+  ScriptNode* node = bindings.find(taskHandle());
+  if (!node) return fallbackNode;
+  cachedNode = node;
+  return node;
+}
+
+// the externals, called by pointer from compiled script code
+__attribute__((noinline)) void setRGBPalScanned(uint16_t index, uint8_t palIndex) { scanned()->layer->set(index, palette(palIndex)); }
+__attribute__((noinline)) void setRGBPalCached(uint16_t index, uint8_t palIndex) { cached()->layer->set(index, palette(palIndex)); }
+__attribute__((noinline)) void fillRowPal(uint8_t y, uint8_t startIndex, int16_t step) {
+  Layer* layer = cached()->layer;
+  fillGradient(layer->view(), (size_t)y * layer->width, layer->width, 1, startIndex, step, palette);
+}
+void (*volatile setRGBPalScannedCall)(uint16_t, uint8_t) = setRGBPalScanned;
+void (*volatile setRGBPalCachedCall)(uint16_t, uint8_t) = setRGBPalCached;
+void (*volatile fillRowPalCall)(uint8_t, uint8_t, int16_t) = fillRowPal;
+
+}  // namespace
+
+TEST_CASE("BulkDraw: gradients and palette spans as light by light") {
+  for (uint8_t cpl : {3, 5}) {
+    uint8_t offset = cpl == 3 ? 0 : 2;
+    Layer reference(20, 12, 2, cpl, offset);
+    Layer bulk = reference;
+
+    referenceGradient(reference, 3 * 20, 20, 1, 10, 37);  // row 3
+    fillGradient(bulk.view(), 3 * 20, 20, 1, 10, 37, palette);
+    referenceGradient(reference, 7, 12, 20, 250, -90);  // column 7, going down the palette and wrapping
+    fillGradient(bulk.view(), 7, 12, 20, 250, -90, palette);
+    referenceGradient(reference, 300, 100, 1, 0, 4096 / 100);  // a range spanning the palette once, in plane z = 1
+    fillGradient(bulk.view(), 300, 100, 1, 0, 4096 / 100, palette);
+    CHECK(bulk.channels == reference.channels);
+
+    std::vector<uint8_t> indexes(50);
+    for (size_t i = 0; i < indexes.size(); i++) indexes[i] = i * i;  // a per-light expression
+    for (size_t i = 0; i < indexes.size(); i++) reference.set(100 + i, palette(indexes[i]));
+    fillIndexes(bulk.view(), 100, indexes.size(), indexes.data(), palette);
+    CHECK(bulk.channels == reference.channels);
+  }
+}
+
+TEST_CASE("BulkDraw: copyRect and shiftLights, overlapping and clipped") {
+  struct Copy {
+    int x, y, w, h, toX, toY;
+  };
+  for (uint8_t cpl : {3, 4}) {
+    for (Copy copy : {Copy{0, 0, 5, 5, 2, 1}, Copy{2, 1, 5, 5, 0, 0}, Copy{1, 1, 6, 3, 1, 2}, Copy{1, 2, 6, 3, 1, 1}, Copy{-3, -2, 20, 20, 4, 3},
+                      Copy{4, 3, 20, 20, -1, -2}, Copy{0, 0, 16, 9, 16, 0}, Copy{0, 0, 0, 4, 1, 1}}) {
+      Layer reference(16, 9, 2, cpl, 0);
+      Layer bulk = reference;
+      referenceCopy(reference, copy.x, copy.y, copy.w, copy.h, copy.toX, copy.toY);
+      copyRect(bulk.view(), copy.x, copy.y, copy.w, copy.h, copy.toX, copy.toY);
+      REQUIRE(bulk.channels == reference.channels);
+    }
+  }
+
+  for (auto [dx, dy] : {std::pair<int, int>{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {3, -2}, {-20, 0}, {0, 0}}) {
+    Layer reference(10, 6, 1, 3, 0);
+    Layer bulk = reference;
+    referenceCopy(reference, 0, 0, 10, 6, dx, dy);
+    for (int y = 0; y < 6; y++)
+      for (int x = 0; x < 10; x++)
+        if (x < dx || x >= 10 + dx || y < dy || y >= 6 + dy) reference.set(x + y * 10, {0, 0, 0});
+    shiftLights(bulk.view(), dx, dy);
+    REQUIRE(bulk.channels == reference.channels);
+  }
+}
+
+TEST_CASE("TaskBindings: bind, find, unbind, full") {
+  TaskBindings<int, ScriptNode, 2> map;
+  ScriptNode a{nullptr}, b{nullptr}, c{nullptr};
+  CHECK(map.find(1) == nullptr);
+  CHECK(map.bind(1, &a));
+  CHECK(map.bind(2, &b));
+  CHECK_FALSE(map.bind(3, &c));  // full
+  CHECK(map.find(2) == &b);
+  map.unbind(1);
+  CHECK(map.find(1) == nullptr);
+  CHECK(map.bind(3, &c));  // the freed entry
+  CHECK(map.find(3) == &c);
+  CHECK(map.find(2) == &b);
+}
+
+TEST_CASE("BulkDraw benchmark: 128x128 palette frame, external call per light (scan, cached) and per row") {
+  Layer layer(128, 128, 1, 3, 0);
+  ScriptNode other{nullptr}, script{&layer};
+  bindings.bind(11, &other);
+  bindings.bind(12, &other);
+  bindings.bind(13, &script);  // the script task: the last entry, as a third running script
+  currentTask = 13;
+  const int frames = 200;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++)
+    for (uint16_t i = 0; i < 128 * 128; i++) setRGBPalScannedCall(i, i + frame);
+  double scannedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+  std::vector<uint8_t> perLight = layer.channels;
+
+  start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++)
+    for (uint16_t i = 0; i < 128 * 128; i++) setRGBPalCachedCall(i, i + frame);
+  double cachedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+  CHECK(layer.channels == perLight);
+
+  start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++)
+    for (uint8_t y = 0; y < 128; y++) fillRowPalCall(y, y * 128 + frame, 16);
+  double bulkUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+  CHECK(layer.channels == perLight);  // the same frame
+
+  MESSAGE("128x128 palette frame: per light, task map scanned " << scannedUs << " us, node cached " << cachedUs << " us; per row " << bulkUs << " us");
+  currentTask = 0;
+}
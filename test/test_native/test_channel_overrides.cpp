@@ -0,0 +1,97 @@
+/**
+    @title     MoonLight Unit Tests — ChannelOverrides
+    @file      test_channel_overrides.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the channel overrides applied after compositing (src/MoonBase/utilities/ChannelOverrides.h):
+    entries stay sorted and unique, set / max / min against the composited channels, channels beyond the layout are
+    skipped, and no overrides leave the channels as composited.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "ChannelOverrides.h"
+
+TEST_CASE("ChannelOverrides: sorted, one entry per channel") {
+  ChannelOverrides<4> overrides;
+  CHECK(overrides.empty());
+  CHECK(overrides.set(30, 1));
+  CHECK(overrides.set(10, 2));
+  CHECK(overrides.set(20, 3));
+  CHECK(overrides.set(10, 4, OverrideMax));  // replaces the override of 10
+  CHECK_EQ(overrides.size(), 3u);
+
+  std::vector<uint32_t> channels;
+  for (const ChannelOverride& entry : overrides) channels.push_back(entry.channel);
+  const std::vector<uint32_t> sorted = {10, 20, 30};
+  CHECK(channels == sorted);
+  REQUIRE(overrides.find(10) != nullptr);
+  CHECK_EQ(overrides.find(10)->value, 4);
+  CHECK_EQ(overrides.find(10)->mode, OverrideMax);
+  CHECK(overrides.find(15) == nullptr);
+
+  CHECK(overrides.set(0, 5));
+  CHECK_FALSE(overrides.set(40, 6));  // full
+  CHECK(overrides.set(20, 7));        // full, but 20 is there already
+  CHECK_EQ(overrides.size(), 4u);
+
+  CHECK(overrides.release(20));
+  CHECK_FALSE(overrides.release(20));
+  CHECK(overrides.find(20) == nullptr);
+  REQUIRE(overrides.find(30) != nullptr);
+  CHECK_EQ(overrides.find(30)->value, 1);
+  CHECK(overrides.set(40, 6));  // room again
+
+  overrides.clear();
+  CHECK(overrides.empty());
+  CHECK(overrides.find(10) == nullptr);
+}
+
+TEST_CASE("ChannelOverrides: set, max and min over the composited channels") {
+  std::vector<uint8_t> channels = {10, 200, 100, 100, 50, 0};
+  ChannelOverrides<8> overrides;
+
+  std::vector<uint8_t> composited = channels;
+  overrides.apply(composited.data(), composited.size());  // no overrides: as composited
+  CHECK(composited == channels);
+
+  overrides.set(0, 255);               // set: up
+  overrides.set(1, 0);                 // set: down (blackout of one channel)
+  overrides.set(2, 150, OverrideMax);  // max: the override is higher
+  overrides.set(3, 50, OverrideMax);   // max: the effect is higher
+  overrides.set(4, 20, OverrideMin);   // min: the override is lower
+  overrides.set(5, 80, OverrideMin);   // min: the effect is lower
+  overrides.apply(composited.data(), composited.size());
+  const std::vector<uint8_t> overridden = {255, 0, 150, 100, 20, 0};
+  CHECK(composited == overridden);
+
+  // the next frame composites again: the overrides apply again, released channels are the effects' again
+  composited = channels;
+  overrides.release(0);
+  overrides.apply(composited.data(), composited.size());
+  const std::vector<uint8_t> released = {10, 0, 150, 100, 20, 0};
+  CHECK(composited == released);
+}
+
+TEST_CASE("ChannelOverrides: channels beyond the layout are skipped") {
+  std::vector<uint8_t> channels(6, 1);
+  ChannelOverrides<8> overrides;
+  overrides.set(2, 9);
+  overrides.set(6, 9);     // just beyond
+  overrides.set(1000, 9);  // from a larger layout
+  overrides.apply(channels.data(), channels.size());
+  const std::vector<uint8_t> inLayout = {1, 1, 9, 1, 1, 1};
+  CHECK(channels == inLayout);
+  CHECK_EQ(overrides.size(), 3u);  // kept for when the layout grows again
+
+  std::vector<uint8_t> larger(1001, 1);
+  overrides.apply(larger.data(), larger.size());
+  CHECK_EQ(larger[6], 9);
+  CHECK_EQ(larger[1000], 9);
+}
@@ -0,0 +1,212 @@
+/**
+    @title     MoonLight Unit Tests — ControlTable
+    @file      test_control_table.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the typed control table of nodes (src/MoonBase/utilities/ControlTable.h), and a benchmark
+    of Node::updateControl(name, value) latency: the table against a scan of the controls comparing names and type strings.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "ControlTable.h"
+
+namespace {
+
+typedef ControlTable<int> Table;  // Ref: index of the JSON control in these tests
+
+// a driver node: some sliders, a checkbox and status texts
+struct DriverVariables {
+  uint8_t brightness = 10;
+  int8_t offset = 0;
+  uint16_t port = 6454;
+  uint32_t universes = 0;
+  int fps = 0;
+  float gamma = 2.2f;
+  bool enabled = true;
+  char status[32] = "Not connected";
+  char version[16] = "";
+};
+
+void addDriverControls(Table& table, DriverVariables& v) {
+  table.add("brightness", ControlKind::u8, &v.brightness, 1, 0, 255, false, 0);
+  table.add("offset", ControlKind::i8, &v.offset, 1, -100, 100, false, 1);
+  table.add("port", ControlKind::u16, &v.port, 2, 0, 65535, false, 2);
+  table.add("totalUniverses", ControlKind::u32, &v.universes, 4, 0, 255, true, 3);
+  table.add("fps", ControlKind::i32, &v.fps, 4, 0, 255, true, 4);
+  table.add("gamma", ControlKind::f32, &v.gamma, 4, 0, 255, false, 5);
+  table.add("enabled", ControlKind::boolean, &v.enabled, 1, 0, 255, false, 6);
+  table.add("status", ControlKind::text, v.status, sizeof(v.status), 0, 32, true, 7);
+  table.add("version", ControlKind::text, v.version, sizeof(v.version), 0, 255, true, 8);
+}
+
+}  // namespace
+
+TEST_CASE("ControlTable: find by name, rebind on add") {
+  Table table;
+  DriverVariables v;
+  addDriverControls(table, v);
+  CHECK_EQ(table.size(), 9);
+  REQUIRE(table.find("port"));
+  CHECK_EQ(table.find("port")->ref, 2);
+  CHECK_EQ(table.find("port")->kind, ControlKind::u16);
+  CHECK_FALSE(table.find("nope"));
+  CHECK_FALSE(table.find(nullptr));
+
+  uint16_t otherPort = 0;  // LiveScript recompiled: same name, new variable
+  table.add("port", ControlKind::u16, &otherPort, 2, 0, 65535, false, 2);
+  CHECK_EQ(table.size(), 9);
+  CHECK_EQ(table.find("port")->pointer, (void*)&otherPort);
+
+  const char* longName = "a name longer than the stored name of a control";
+  table.add(longName, ControlKind::u8, &v.brightness, 1, 0, 255, false, 9);
+  CHECK(table.find(longName));
+  CHECK_FALSE(table.find("a name longer than the stored name of another control"));  // same first 23 characters, other hash
+}
+
+TEST_CASE("ControlTable: unbind until the controls are added again (LiveScript executable replaced)") {
+  Table table;
+  DriverVariables v;
+  addDriverControls(table, v);
+  CHECK(Table::setNumber(*table.find("port"), 6454));
+  CHECK_FALSE(Table::setNumber(*table.find("port"), 6454));
+
+  table.unbind();
+  CHECK_EQ(table.size(), 9);  // names kept: add() rebinds them
+  for (auto& control : table) CHECK_FALSE(control.bound());
+
+  uint16_t newPort = 0;
+  table.add("port", ControlKind::u16, &newPort, 2, 0, 65535, false, 2);
+  REQUIRE(table.find("port")->bound());
+  CHECK_FALSE(table.find("fps")->bound());  // not added by the new script
+  CHECK(Table::setNumber(*table.find("port"), 6454));  // not synced any more: the JSON control is written again
+  CHECK_EQ(newPort, 6454);
+}
+
+TEST_CASE("ControlTable: typed writes, unchanged values do not touch the JSON control") {
+  Table table;
+  DriverVariables v;
+  addDriverControls(table, v);
+
+  CHECK(Table::setNumber(*table.find("port"), 5568));
+  CHECK_EQ(v.port, 5568);
+  CHECK_FALSE(Table::setNumber(*table.find("port"), 5568));  // same value: no JSON write
+  CHECK(Table::setNumber(*table.find("offset"), -5));
+  CHECK_EQ(v.offset, -5);
+  CHECK(Table::setNumber(*table.find("gamma"), 1.8));
+  CHECK_EQ(v.gamma, doctest::Approx(1.8f));
+  CHECK(Table::setNumber(*table.find("enabled"), false));
+  CHECK_FALSE(v.enabled);
+  CHECK_FALSE(Table::setNumber(*table.find("status"), 3));  // not a number control
+
+  // the UI wrote the JSON value and the variable: the same value from the node is not a change
+  v.brightness = 200;
+  Table::markSynced(*table.find("brightness"), 200);
+  CHECK_FALSE(Table::setNumber(*table.find("brightness"), 200));
+  CHECK(Table::setNumber(*table.find("brightness"), 201));
+
+  // the variable changed behind the table's back (node code, script): an unchanged JSON value still writes it
+  v.port = 1;
+  CHECK_FALSE(Table::setNumber(*table.find("port"), 5568));
+  CHECK_EQ(v.port, 5568);
+}
+
+TEST_CASE("ControlTable: text controls, own variable, truncation") {
+  Table table;
+  DriverVariables v;
+  addDriverControls(table, v);
+  Table::Descriptor& status = *table.find("status");
+
+  CHECK(Table::setText(status, "Active"));
+  CHECK_EQ(std::string(v.status), "Active");
+  CHECK_FALSE(Table::setText(status, "Active"));
+  strcpy(v.status, "Other");  // not the JSON value: written again, no JSON write
+  CHECK_FALSE(Table::setText(status, "Active"));
+  CHECK_EQ(std::string(v.status), "Active");
+
+  strcpy(v.status, "Stopped");  // the node set its status variable and passes it
+  CHECK(Table::setText(status, v.status));
+  CHECK_EQ(std::string(v.status), "Stopped");
+  CHECK_FALSE(Table::setText(status, v.status));
+
+  Table::Descriptor& version = *table.find("version");  // buffer of 16, no max
+  CHECK(Table::setText(version, "4.0 pre release! 20261019"));
+  CHECK_EQ(std::string(v.version), "4.0 pre release");
+  CHECK(Table::setText(version, nullptr));
+  CHECK_EQ(std::string(v.version), "");
+
+  CHECK(isControlText<const char*>::value);
+  CHECK(isControlText<std::string>::value);
+  CHECK_FALSE(isControlText<int>::value);
+  CHECK_EQ(std::string(controlText(std::string("x"))), "x");
+}
+
+TEST_CASE("ControlTable benchmark: updateControl by name vs scanning the controls") {
+  // before: updateControl(name, value) scanned the controls comparing names, then the type and size of the
+  // match decided how to write the variable (in ArduinoJson, which is slower than these std::strings)
+  struct ScannedControl {
+    std::string name, type, value;
+    int size;
+    void* p;
+  };
+  DriverVariables scannedVariables, tableVariables;
+  std::vector<ScannedControl> scanned = {{"brightness", "slider", "", 8, &scannedVariables.brightness}, {"offset", "slider", "", 108, &scannedVariables.offset},
+                                         {"port", "number", "", 16, &scannedVariables.port},           {"totalUniverses", "number", "", 32, &scannedVariables.universes},
+                                         {"fps", "number", "", 33, &scannedVariables.fps},             {"gamma", "slider", "", 34, &scannedVariables.gamma},
+                                         {"enabled", "checkbox", "", 1, &scannedVariables.enabled},    {"status", "text", "", 32, scannedVariables.status},
+                                         {"version", "text", "", 16, scannedVariables.version}};
+  auto scanUpdate = [&](const char* name, const char* text, long number) {
+    for (ScannedControl& control : scanned) {
+      if (control.name != name) continue;
+      control.value = text ? text : std::to_string(number);
+      if (control.type == "slider" || control.type == "number") {
+        if (control.size == 8) *(uint8_t*)control.p = number;
+        else if (control.size == 16) *(uint16_t*)control.p = number;
+        else if (control.size == 32) *(uint32_t*)control.p = number;
+      } else if (control.type == "text") {
+        strncpy((char*)control.p, control.value.c_str(), control.size - 1);
+      }
+      break;
+    }
+  };
+
+  Table table;
+  addDriverControls(table, tableVariables);
+  int jsonWrites = 0;
+  auto tableUpdateText = [&](const char* name, const char* text) {
+    Table::Descriptor* control = table.find(name);
+    if (control && Table::setText(*control, text)) jsonWrites++;
+  };
+  auto tableUpdateNumber = [&](const char* name, long number) {
+    Table::Descriptor* control = table.find(name);
+    if (control && Table::setNumber(*control, number)) jsonWrites++;
+  };
+
+  // a driver loop: status every loop (changes now and then), a counter that changes every 10 loops
+  const int loops = 200000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < loops; i++) {
+    scanUpdate("status", (i / 1000) % 2 ? "Active" : "Stopped", 0);
+    scanUpdate("totalUniverses", nullptr, i / 10);
+  }
+  double scanNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (2 * loops);
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < loops; i++) {
+    tableUpdateText("status", (i / 1000) % 2 ? "Active" : "Stopped");
+    tableUpdateNumber("totalUniverses", i / 10);
+  }
+  double tableNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (2 * loops);
+
+  CHECK_EQ(std::string(tableVariables.status), std::string(scannedVariables.status));
+  CHECK_EQ(tableVariables.universes, scannedVariables.universes);
+  CHECK(jsonWrites < loops / 4);  // only changes reach the JSON control
+  MESSAGE("updateControl: scan " << scanNs << " ns, table " << tableNs << " ns, JSON writes " << jsonWrites << " of " << 2 * loops);
+}
@@ -0,0 +1,191 @@
+/**
+    @title     MoonLight Unit Tests — DMXFrames
+    @file      test_dmx_frames.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the DMX512 frames of DMXOutDriver (src/MoonBase/utilities/DMXFrames.h): a universe is the
+    frame the driver built light by light before, lights continue in the next universe without being split, and the
+    frame handoff between the driver task and the DMX task only ever hands over complete frames. The benchmark runs a
+    driver loop against a transmitter taking the wire time of a frame, waiting for it and handing frames over.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "DMXFrames.h"
+
+namespace {
+
+// the fixture's channel order: R and B swapped (as rgbwBufferMapping for BGR)
+void swapRB(uint8_t* dst, const uint8_t* src) {
+  dst[0] = src[2];
+  dst[2] = src[0];
+}
+
+std::vector<uint8_t> lightChannels(size_t nrOfLights, uint8_t channelsPerLight) {
+  std::vector<uint8_t> channels(nrOfLights * channelsPerLight);
+  for (size_t n = 0; n < channels.size(); n++) channels[n] = n * 7 + 1;
+  return channels;
+}
+
+// the loop of DMXOutDriver before: one universe, light by light
+size_t referenceUniverse(uint8_t* frame, const std::vector<uint8_t>& channels, uint8_t cpl, uint16_t offset) {
+  memset(frame, 0, DMX_FRAME_BYTES);
+  size_t frameSize = 0;
+  for (size_t light = 0; light < channels.size() / cpl; light++) {
+    size_t dstBase = offset + light * cpl;
+    if (dstBase + cpl > DMX_SLOTS) break;
+    memcpy(frame + 1 + dstBase, &channels[light * cpl], cpl);
+    swapRB(frame + 1 + dstBase, &channels[light * cpl]);
+    frameSize = dstBase + cpl;
+  }
+  return frameSize;
+}
+
+}  // namespace
+
+TEST_CASE("DMXFrames: a universe as built light by light") {
+  for (uint8_t cpl : {3, 4, 13}) {
+    for (uint16_t offset : {0, 1, 100, 509}) {
+      std::vector<uint8_t> channels = lightChannels(300, cpl);
+      std::vector<uint8_t> reference(DMX_FRAME_BYTES), frame(DMX_FRAME_BYTES, 0xAA);
+      size_t referenceSize = referenceUniverse(reference.data(), channels, cpl, offset);
+      size_t light = 0;
+      uint16_t size = dmxBuildUniverse(frame.data(), channels.data(), 300, cpl, light, offset, swapRB);
+      REQUIRE_EQ(size, referenceSize);
+      if (size) CHECK(std::equal(frame.begin(), frame.begin() + 1 + size, reference.begin()));  // start code and slots
+      CHECK_EQ(light * cpl + offset, size ? size : offset);  // the lights in the frame
+    }
+  }
+
+  // more slots than lights: only the lights, nothing when there are no lights
+  std::vector<uint8_t> channels = lightChannels(10, 3);
+  std::vector<uint8_t> frame(DMX_FRAME_BYTES);
+  size_t light = 0;
+  CHECK_EQ(dmxBuildUniverse(frame.data(), channels.data(), 10, 3, light, 5, swapRB), 35);
+  CHECK_EQ(light, 10u);
+  CHECK_EQ(dmxBuildUniverse(frame.data(), channels.data(), 10, 3, light, 0, swapRB), 0);
+}
+
+TEST_CASE("DMXFrames: lights continue in the next universe, not split") {
+  const uint8_t cpl = 3;
+  std::vector<uint8_t> channels = lightChannels(400, cpl);
+  std::vector<uint8_t> frames(3 * DMX_FRAME_BYTES);
+  uint16_t sizes[3];
+  auto none = [](uint8_t*, const uint8_t*) {};
+
+  size_t lights = dmxBuildFrames(frames.data(), sizes, 3, channels.data(), 400, cpl, 10, none);
+  CHECK_EQ(lights, 400u);
+  CHECK_EQ(sizes[0], 10 + 167 * 3);  // 167 lights after 10 slots, 1 slot left
+  CHECK_EQ(sizes[1], 170 * 3);       // from slot 1
+  CHECK_EQ(sizes[2], 63 * 3);        // the rest
+  CHECK_EQ(frames[DMX_FRAME_BYTES + 1], channels[167 * 3]);              // universe 2 starts with light 167
+  CHECK_EQ(frames[2 * DMX_FRAME_BYTES + 1], channels[(167 + 170) * 3]);  // universe 3 with light 337
+
+  lights = dmxBuildFrames(frames.data(), sizes, 2, channels.data(), 400, cpl, 0, none);  // more lights than universes
+  CHECK_EQ(lights, 340u);
+  CHECK_EQ(sizes[1], 510);
+
+  CHECK_EQ(dmxBuildFrames(frames.data(), sizes, 2, channels.data(), 400, 0, 0, none), 0u);  // no channels per light
+  CHECK_EQ(sizes[0], 0);
+}
+
+TEST_CASE("DMXFrames: the handoff hands over complete frames, newest first") {
+  FrameHandoff handoff;
+  CHECK_FALSE(handoff.take());  // nothing published
+  uint8_t buffers[3] = {};
+
+  buffers[handoff.back()] = 1;
+  CHECK(handoff.publish());
+  buffers[handoff.back()] = 2;
+  CHECK_FALSE(handoff.publish());  // frame 1 was not taken: dropped
+  CHECK_EQ(handoff.dropped(), 1u);
+  CHECK(handoff.take());
+  CHECK_EQ(buffers[handoff.front()], 2);
+  CHECK_FALSE(handoff.take());  // nothing new: resend front
+  CHECK_EQ(buffers[handoff.front()], 2);
+  CHECK_NE(handoff.back(), handoff.front());
+
+  // a writer and a reader thread: every frame taken is complete and newer than the one before
+  const int frames = 20000;
+  std::vector<std::vector<uint32_t>> frameBuffers(3, std::vector<uint32_t>(128, 0));
+  FrameHandoff shared;
+  std::thread writer([&] {
+    for (uint32_t frame = 1; frame <= (uint32_t)frames; frame++) {
+      for (uint32_t& value : frameBuffers[shared.back()]) value = frame;
+      shared.publish();
+    }
+  });
+  uint32_t last = 0;
+  bool complete = true, newer = true;
+  while (last < (uint32_t)frames) {
+    if (!shared.take()) continue;
+    const std::vector<uint32_t>& frame = frameBuffers[shared.front()];
+    for (uint32_t value : frame) complete &= value == frame[0];
+    newer &= frame[0] > last;
+    last = frame[0];
+  }
+  writer.join();
+  CHECK(complete);
+  CHECK(newer);
+}
+
+TEST_CASE("DMXFrames benchmark: driver loop waiting for the UART vs handing frames over") {
+  const uint8_t cpl = 3;
+  const int loops = 20;
+  const auto wireTime = std::chrono::microseconds(22700);  // 513 slots of 44 us + break
+  std::vector<uint8_t> channels = lightChannels(170, cpl);
+  std::vector<uint8_t> frames(3 * DMX_FRAME_BYTES);
+  uint16_t sizes[3][1];
+
+  // before: the driver builds a frame and waits until the UART sent the previous one
+  auto transmitDone = std::chrono::steady_clock::now();
+  double blockedUs = 0;
+  for (int loop = 0; loop < loops; loop++) {
+    auto start = std::chrono::steady_clock::now();
+    dmxBuildFrames(frames.data(), sizes[0], 1, channels.data(), 170, cpl, 0, swapRB);
+    std::this_thread::sleep_until(transmitDone);  // uart_wait_tx_done
+    transmitDone = std::chrono::steady_clock::now() + wireTime;
+    blockedUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));  // the rest of the driver loop (LED drivers)
+  }
+
+  // now: the driver builds into the back buffer and publishes, the DMX task takes the wire time
+  FrameHandoff handoff;
+  std::atomic<bool> running{true};
+  std::atomic<int> sent{0};
+  std::thread dmxTask([&] {
+    while (running) {
+      if (handoff.take()) {
+        std::this_thread::sleep_for(wireTime);
+        sent++;
+      } else
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  });
+  double handedUs = 0;
+  for (int loop = 0; loop < loops; loop++) {
+    auto start = std::chrono::steady_clock::now();
+    uint8_t buffer = handoff.back();
+    dmxBuildFrames(&frames[buffer * DMX_FRAME_BYTES], sizes[buffer], 1, channels.data(), 170, cpl, 0, swapRB);
+    handoff.publish();
+    handedUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  running = false;
+  dmxTask.join();
+  CHECK(sent > 0);
+  CHECK(handedUs < blockedUs);
+  MESSAGE("DMX driver loop, 170 RGB lights: waiting for the UART " << blockedUs / loops << " us, handing over " << handedUs / loops << " us per frame (" << sent << " of " << loops
+                                                                   << " sent, " << handoff.dropped() << " replaced by a newer one)");
+}
@@ -0,0 +1,117 @@
+/**
+    @title     MoonLight Unit Tests — EventRegistry
+    @file      test_event_registry.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the interned event ids of EventSocket (lib/framework/EventRegistry.h), and a
+    microbenchmark of an emit lookup by id against the String keyed maps it replaces.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "EventRegistry.h"
+
+TEST_CASE("EventRegistry: names get stable small ids") {
+  EventRegistry events;
+  EventId a = events.add("lightscontrol");
+  EventId b = events.add("monitor");
+  CHECK_EQ(a, 0);
+  CHECK_EQ(b, 1);
+  CHECK_EQ(events.add("lightscontrol"), a);  // registered twice: same id
+  CHECK_EQ(events.find("monitor"), b);
+  CHECK_EQ(events.find("nope"), EVENT_ID_NONE);
+  CHECK_EQ(events.find(nullptr), EVENT_ID_NONE);
+  CHECK_EQ(std::string(events.name(b)), "monitor");
+  CHECK_EQ(std::string(events.name(EVENT_ID_NONE)), "");
+  CHECK_EQ(events.size(), 2);
+}
+
+TEST_CASE("EventRegistry: subscriptions per event, each client once") {
+  EventRegistry events;
+  EventId a = events.add("a");
+  EventId b = events.add("b");
+  events.subscribe(a, 50);
+  events.subscribe(a, 51);
+  events.subscribe(a, 50);  // the UI subscribes again on page change
+  events.subscribe(b, 50);
+  events.subscribe(EVENT_ID_NONE, 52);  // unregistered: ignored
+  CHECK_EQ(events.subscribers(a).size(), 2);
+  CHECK_EQ(events.subscribers(b).size(), 1);
+  CHECK(events.subscribers(EVENT_ID_NONE).empty());
+
+  events.unsubscribe(a, 51);
+  CHECK_EQ(events.subscribers(a).size(), 1);
+  events.unsubscribeAll(50);  // client closed
+  CHECK(events.subscribers(a).empty());
+  CHECK(events.subscribers(b).empty());
+}
+
+TEST_CASE("EventRegistry: full registry refuses new names") {
+  EventRegistry events;
+  for (int i = 0; i < EVENT_REGISTRY_CAPACITY; i++) CHECK_EQ(events.add(("event" + std::to_string(i)).c_str()), i);
+  CHECK_EQ(events.add("one too many"), EVENT_ID_NONE);
+  CHECK_EQ(events.find("one too many"), EVENT_ID_NONE);
+  CHECK_EQ(events.size(), (size_t)EVENT_REGISTRY_CAPACITY);
+  CHECK_EQ(events.find("event63"), 63);
+  CHECK_EQ(events.add("event63"), 63);  // existing names are still found
+}
+
+TEST_CASE("EventRegistry benchmark: emit lookup by id vs String keyed maps") {
+  // the events of a MoonLight build: framework services and one per module
+  const char* names[] = {"client_info", "status", "notification", "rssi", "reconnect", "ethernet", "battery", "otastatus", "analytics", "features",
+                         "monitor", "lightscontrol", "effects", "drivers", "devices", "tasks", "io", "channels", "livescripts", "instances",
+                         "files", "system", "mqtt", "ntp", "wifi", "ap", "security", "coredump", "sleep", "palettes"};
+  const int nrOfEvents = sizeof(names) / sizeof(names[0]);
+  const int emits = 200000;
+
+  // before: std::vector<String> events (isEventValid) + std::map<String, std::list<int>> client_subscriptions
+  std::vector<std::string> eventList;
+  std::map<std::string, std::list<int>> subscriptions;
+  EventRegistry events;
+  for (const char* name : names) {
+    eventList.push_back(name);
+    subscriptions[name] = {50, 51};
+    EventId id = events.add(name);
+    events.subscribe(id, 50);
+    events.subscribe(id, 51);
+  }
+
+  size_t mapClients = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < emits; i++) {
+    std::string event = names[i % nrOfEvents];  // String event argument
+    if (std::find(eventList.begin(), eventList.end(), event) == eventList.end()) continue;
+    for (int client : subscriptions[event]) mapClients += client;
+  }
+  double mapNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / emits;
+
+  size_t nameClients = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < emits; i++) {
+    EventId id = events.find(names[i % nrOfEvents]);  // String API: one lookup
+    for (int client : events.subscribers(id)) nameClients += client;
+  }
+  double nameNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / emits;
+
+  std::vector<EventId> ids;
+  for (const char* name : names) ids.push_back(events.find(name));
+  size_t idClients = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < emits; i++)
+    for (int client : events.subscribers(ids[i % nrOfEvents])) idClients += client;  // caller keeps the id
+  double idNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / emits;
+
+  CHECK_EQ(mapClients, idClients);
+  CHECK_EQ(nameClients, idClients);
+  MESSAGE(nrOfEvents << " events: String maps " << mapNs << " ns/emit, registry by name " << nameNs << " ns/emit, by id " << idNs << " ns/emit");
+}
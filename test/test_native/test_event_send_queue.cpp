@@ -0,0 +1,268 @@
+/**
+    @title     MoonLight Unit Tests — EventSendQueue
+    @file      test_event_send_queue.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the per-client websocket send queues of EventSocket (lib/framework/EventSendQueue.h):
+    bounds, coalescing of state events, ordered notifications and dropping monitor frames until a keyframe.
+    A fake transport sends for a fast and a slow client, like the HTTP task draining the queues.
+    EventSendFrame: websocket frame headers, and a frame written to a socket that takes a few bytes at a time resumes
+    where it stopped, reports no progress while the socket is full and fails on a socket error.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "EventSendQueue.h"
+
+namespace {
+
+enum : EventId { stateEvent, notificationEvent, monitorEvent, otherEvent };
+
+EventMessagePtr message(EventId event, EventSendPolicy policy, uint32_t seq, bool keyframe = false, size_t size = 4) {
+  auto m = std::make_shared<EventMessage>();
+  m->event = event;
+  m->policy = policy;
+  m->keyframe = keyframe;
+  m->data.assign(size, 0);
+  for (size_t i = 0; i < 4 && i < size; i++) m->data[i] = seq >> (8 * i);
+  return m;
+}
+
+uint32_t seqOf(const EventMessage& m) { return m.data[0] | m.data[1] << 8 | m.data[2] << 16 | (uint32_t)m.data[3] << 24; }
+
+// Fake client transport: takes sendsPerTick messages from its queue per tick and checks what it receives
+struct FakeClient {
+  EventSendQueue queue{16, 64 * 1024};
+  int sendsPerTick;
+  std::vector<uint32_t> states, notifications;
+  uint32_t frames = 0, keyframes = 0;
+  bool hasFrame = false;
+  uint32_t lastFrame = 0;
+  bool corrupt = false;  // a delta frame arrived without the frame before it
+
+  explicit FakeClient(int sendsPerTick) : sendsPerTick(sendsPerTick) {}
+
+  void tick() {
+    EventMessagePtr m;
+    for (int i = 0; i < sendsPerTick && queue.pop(m); i++) {
+      uint32_t seq = seqOf(*m);
+      if (m->event == stateEvent) states.push_back(seq);
+      if (m->event == notificationEvent) notifications.push_back(seq);
+      if (m->event == monitorEvent) {
+        if (!m->keyframe && (!hasFrame || seq != lastFrame + 1)) corrupt = true;
+        hasFrame = true;
+        lastFrame = seq;
+        frames++;
+        keyframes += m->keyframe;
+      }
+    }
+  }
+};
+
+// one second at 50 fps: state changes every frame (slider drag), a notification every 10 frames, a monitor frame each frame
+void emit(std::vector<FakeClient*> clients, int frames) {
+  for (int f = 0; f < frames; f++) {
+    std::vector<EventMessagePtr> messages = {message(stateEvent, EventSendPolicy::latest, f)};
+    if (f % 10 == 0) messages.push_back(message(notificationEvent, EventSendPolicy::ordered, f / 10));
+    messages.push_back(message(monitorEvent, EventSendPolicy::stream, f, f % 25 == 0, 2000));
+    for (FakeClient* client : clients) {
+      for (auto& m : messages) client->queue.push(m);
+      client->tick();
+    }
+  }
+  for (int drain = 0; drain < 100; drain++)
+    for (FakeClient* client : clients) client->tick();
+}
+
+}  // namespace
+
+TEST_CASE("EventSendQueue: fast client gets every message in order") {
+  FakeClient fast(10);
+  emit({&fast}, 100);
+  CHECK_EQ(fast.states.size(), 100);
+  CHECK_EQ(fast.notifications.size(), 10);
+  CHECK_EQ(fast.frames, 100);
+  CHECK_FALSE(fast.corrupt);
+  CHECK_EQ(fast.queue.stats().dropped, 0);
+  CHECK_EQ(fast.queue.stats().coalesced, 0);
+}
+
+TEST_CASE("EventSendQueue: slow client stays bounded and does not slow down the fast one") {
+  FakeClient fast(10), slow(1);
+  emit({&fast, &slow}, 200);
+
+  CHECK_EQ(fast.frames, 200);
+  CHECK_EQ(fast.states.size(), 200);
+  CHECK_LE(slow.queue.stats().maxDepth, 16);
+
+  // state: coalesced to the latest, which always arrives last
+  CHECK(slow.queue.stats().coalesced > 0);
+  REQUIRE_FALSE(slow.states.empty());
+  CHECK_EQ(slow.states.back(), 199);
+  for (size_t i = 1; i < slow.states.size(); i++) CHECK(slow.states[i] > slow.states[i - 1]);
+
+  // notifications: all of them, in order
+  REQUIRE_EQ(slow.notifications.size(), 20);
+  for (uint32_t i = 0; i < 20; i++) CHECK_EQ(slow.notifications[i], i);
+
+  // monitor: frames were dropped, but never a delta without its base
+  CHECK(slow.frames < 200);
+  CHECK(slow.keyframes > 0);
+  CHECK(slow.queue.stats().dropped > 0);
+  CHECK_FALSE(slow.corrupt);
+  MESSAGE("slow client: " << slow.frames << " of 200 monitor frames, " << slow.states.size() << " of 200 states, max depth " << slow.queue.stats().maxDepth << ", dropped "
+                          << slow.queue.stats().dropped << ", coalesced " << slow.queue.stats().coalesced);
+}
+
+TEST_CASE("EventSendQueue: lagging stream waits for a keyframe") {
+  EventSendQueue queue(4, 1024);
+  CHECK(queue.push(message(monitorEvent, EventSendPolicy::stream, 0, true)));
+  CHECK(queue.push(message(monitorEvent, EventSendPolicy::stream, 1)));
+  CHECK_FALSE(queue.push(message(monitorEvent, EventSendPolicy::stream, 2)));  // half full: lagging
+  EventMessagePtr m;
+  while (queue.pop(m)) {
+  }
+  CHECK_FALSE(queue.push(message(monitorEvent, EventSendPolicy::stream, 3)));  // empty, but still waiting for a keyframe
+  CHECK(queue.push(message(monitorEvent, EventSendPolicy::stream, 4, true)));
+  CHECK(queue.push(message(monitorEvent, EventSendPolicy::stream, 5)));
+  CHECK_EQ(queue.stats().dropped, 2);
+}
+
+TEST_CASE("EventSendQueue: a keyframe supersedes queued frames") {
+  EventSendQueue queue(8, 1024);
+  queue.push(message(monitorEvent, EventSendPolicy::stream, 0, true));
+  queue.push(message(monitorEvent, EventSendPolicy::ordered, 100));  // header
+  queue.push(message(monitorEvent, EventSendPolicy::stream, 1));
+  queue.push(message(monitorEvent, EventSendPolicy::stream, 2, true));
+  EventMessagePtr m;
+  REQUIRE(queue.pop(m));
+  CHECK_EQ(seqOf(*m), 100);  // the header stays
+  REQUIRE(queue.pop(m));
+  CHECK_EQ(seqOf(*m), 2);
+  CHECK_FALSE(queue.pop(m));
+  CHECK_EQ(queue.stats().coalesced, 2);
+}
+
+TEST_CASE("EventSendQueue: ordered messages make room by dropping frames, else are dropped") {
+  EventSendQueue queue(2, 1024);
+  queue.push(message(notificationEvent, EventSendPolicy::ordered, 0));
+  queue.push(message(monitorEvent, EventSendPolicy::stream, 0, true));
+  CHECK(queue.push(message(notificationEvent, EventSendPolicy::ordered, 1)));  // drops the frame
+  CHECK_FALSE(queue.push(message(notificationEvent, EventSendPolicy::ordered, 2)));
+  CHECK_EQ(queue.size(), 2);
+  CHECK_EQ(queue.stats().dropped, 2);
+  CHECK_FALSE(queue.push(message(monitorEvent, EventSendPolicy::stream, 1)));  // missed a frame: waits for a keyframe
+}
+
+TEST_CASE("EventSendQueue: byte limit, and a message larger than the limit still goes out alone") {
+  EventSendQueue queue(16, 1000);
+  CHECK(queue.push(message(otherEvent, EventSendPolicy::ordered, 0, false, 600)));
+  CHECK_FALSE(queue.push(message(otherEvent, EventSendPolicy::ordered, 1, false, 600)));
+  EventMessagePtr m;
+  queue.pop(m);
+  CHECK(queue.push(message(otherEvent, EventSendPolicy::ordered, 2, false, 5000)));
+  CHECK_EQ(queue.stats().bytes, 5000);
+  queue.clear();
+  CHECK_EQ(queue.stats().bytes, 0);
+  CHECK_EQ(queue.stats().depth, 0);
+}
+
+namespace {
+
+// Fake non-blocking socket: takes at most perCall bytes per send, 0 when full (would block), -1 when broken
+struct FakeSocket {
+  std::vector<uint8_t> received;
+  size_t perCall = 1000;
+  size_t room = SIZE_MAX;  // bytes it takes before it is full
+  bool broken = false;
+
+  int send(const uint8_t* data, size_t length) {
+    if (broken) return -1;
+    size_t n = std::min(std::min(length, perCall), room);
+    received.insert(received.end(), data, data + n);
+    room -= n;
+    return (int)n;
+  }
+};
+
+size_t headerSize(const std::vector<uint8_t>& frame) { return (frame[1] & 0x7F) == 127 ? 10 : (frame[1] & 0x7F) == 126 ? 4 : 2; }
+
+uint64_t payloadLength(const std::vector<uint8_t>& frame) {
+  uint8_t length = frame[1] & 0x7F;
+  if (length < 126) return length;
+  uint64_t value = 0;
+  for (size_t i = 2; i < headerSize(frame); i++) value = value << 8 | frame[i];
+  return value;
+}
+
+}  // namespace
+
+TEST_CASE("EventSendFrame: header of small, 16-bit and 64-bit payload lengths") {
+  for (size_t size : {4, 125, 126, 65535, 65536, 70000}) {
+    auto m = message(otherEvent, EventSendPolicy::ordered, 7, false, size);
+    EventSendFrame frame;
+    frame.begin(m, 0x2, 0);
+    FakeSocket socket;
+    socket.perCall = SIZE_MAX;
+    CHECK_EQ(frame.write([&](const uint8_t* data, size_t length) { return socket.send(data, length); }, 0), (int)(headerSize(socket.received) + size));
+    CHECK_FALSE(frame.active());
+    CHECK_EQ(socket.received[0], 0x82);  // FIN, binary
+    CHECK_EQ(socket.received[1] & 0x80, 0);  // server frames are not masked
+    CHECK_EQ(payloadLength(socket.received), size);
+    CHECK(std::equal(m->data.begin(), m->data.end(), socket.received.begin() + headerSize(socket.received)));
+  }
+}
+
+TEST_CASE("EventSendFrame: a slow socket gets a large message in pieces, resumed at the offset") {
+  auto keyframe = std::make_shared<EventMessage>(*message(monitorEvent, EventSendPolicy::stream, 42, true, 20000));
+  for (size_t i = 4; i < keyframe->data.size(); i++) keyframe->data[i] = i * 7;
+  EventMessagePtr m = keyframe;
+  EventSendFrame frame;
+  frame.begin(m, 0x2, 0);
+  FakeSocket socket;
+  socket.perCall = 3;  // splits the 4-byte header too
+  uint32_t now = 0;
+  int writes = 0;
+  while (frame.active()) {
+    socket.room = 1460;  // one segment per round, then the socket is full
+    int written = frame.write([&](const uint8_t* data, size_t length) { return socket.send(data, length); }, now);
+    CHECK(written > 0);
+    CHECK(written <= 1460);
+    CHECK_EQ(frame.stalled(now), 0);  // the socket took bytes: progress
+    now += 100;
+    writes++;
+  }
+  CHECK_EQ(writes, (4 + 20000 + 1459) / 1460);
+  REQUIRE_EQ(socket.received.size(), 4 + 20000);
+  CHECK(std::equal(m->data.begin(), m->data.end(), socket.received.begin() + 4));
+}
+
+TEST_CASE("EventSendFrame: a full socket makes no progress, a broken one fails") {
+  auto m = message(stateEvent, EventSendPolicy::latest, 1, false, 500);
+  EventSendFrame frame;
+  frame.begin(m, 0x1, 1000);
+  FakeSocket socket;
+  socket.room = 100;
+  auto send = [&](const uint8_t* data, size_t length) { return socket.send(data, length); };
+  CHECK_EQ(frame.write(send, 1000), 100);
+  CHECK_EQ(frame.write(send, 3000), 0);  // full
+  CHECK(frame.active());
+  CHECK_EQ(frame.offset(), 100);
+  CHECK_EQ(frame.stalled(7000), 6000);  // since the last byte taken, not since begin()
+  socket.room = SIZE_MAX;
+  CHECK_EQ(frame.write(send, 7000), 4 + 500 - 100);
+  CHECK_FALSE(frame.active());
+  CHECK_EQ(frame.stalled(9000), 0);
+
+  frame.begin(m, 0x1, 0);
+  socket.broken = true;
+  CHECK_EQ(frame.write(send, 0), -1);
+  CHECK(frame.active());  // half a frame: the client must be closed
+}
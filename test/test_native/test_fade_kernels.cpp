@@ -0,0 +1,225 @@
+/**
+    @title     MoonLight Unit Tests — FadeKernels
+    @file      test_fade_kernels.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the fade of trail effects fused with compositing (src/MoonBase/utilities/FadeKernels.h):
+    composite and fade in one pass, skipping blocks that stay black, gives the same physical channels and layer buffer
+    as a fade pass before the effects and a composite pass after them, for RGB and RGBW lights, also for runs of
+    lights that are not one after the other on the fixture (compositeFadeRGBRun). The benchmark runs a
+    trail effect frame on a 16K light layer both ways.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "FadeKernels.h"
+
+namespace {
+
+// the passes before: fadeToBlackBy over the buffer (six offset checks per light), then composite
+struct Offsets {
+  uint8_t rgbw = 0, white = UINT8_MAX, white2 = UINT8_MAX, rgbw1 = UINT8_MAX, rgbw2 = UINT8_MAX, rgbw3 = UINT8_MAX;
+};
+
+void fadePass(std::vector<uint8_t>& channels, uint8_t cpl, const Offsets& o, uint8_t fadeBy) {
+  uint8_t scale = 255 - fadeBy;
+  uint16_t factor = 1 + scale;
+  for (size_t i = 0; i < channels.size() / cpl; i++) {
+    uint8_t* vch = &channels[i * cpl];
+    for (int c = 0; c < 3; c++) vch[o.rgbw + c] = fadeScale(vch[o.rgbw + c], factor);
+    if (o.white != UINT8_MAX) vch[o.rgbw + 3] = fadeScale(vch[o.rgbw + 3], factor);
+    if (o.white2 != UINT8_MAX) vch[o.rgbw + 4] = fadeScale(vch[o.rgbw + 4], factor);
+    for (uint8_t block : {o.rgbw1, o.rgbw2, o.rgbw3})
+      if (block != UINT8_MAX)
+        for (int c = 0; c < 4; c++) vch[block + c] = fadeScale(vch[block + c], factor);
+  }
+}
+
+void compositePass(const std::vector<uint8_t>& channels, std::vector<uint8_t>& dest, uint8_t brightness) {
+  for (size_t n = 0; n < channels.size(); n++) dest[n] = fadeAdd(dest[n], brightness == 255 ? channels[n] : fadeScaleVideo(channels[n], brightness));
+}
+
+// as VirtualLayer::compositeTo for RGB lights, one to one mapped
+void compositeFused(std::vector<uint8_t>& channels, std::vector<uint8_t>& dest, FadeBlocks<>& blocks, uint8_t brightness, uint8_t fadeBy) {
+  size_t nrOfLights = channels.size() / 3;
+  for (size_t first = 0; first < nrOfLights; first += FADE_BLOCK) {
+    size_t last = first + FADE_BLOCK < nrOfLights ? first + FADE_BLOCK : nrOfLights;
+    size_t block = first / FADE_BLOCK;
+    if (blocks.black(block) && fadeIsBlack(&channels[first * 3], (last - first) * 3)) continue;
+    blocks.set(block, compositeFadeRGB(&channels[first * 3], &dest[first * 3], (last - first) * 3, brightness, fadeBy));
+  }
+}
+
+// a trail effect: a few moving dots drawn each frame (in the first quarter of the layer), the rest fades
+void drawDots(std::vector<uint8_t>& channels, uint8_t cpl, int frame, int dots) {
+  size_t nrOfLights = channels.size() / cpl;
+  for (int d = 0; d < dots; d++) {
+    size_t light = ((size_t)d * 7919 + frame * (d + 1) * 3) % (nrOfLights / 4);
+    uint32_t color = (frame * 2654435761u) ^ (d * 40503u);
+    for (int c = 0; c < cpl; c++) channels[light * cpl + c] = (color >> (c % 4 * 8)) | 1;
+  }
+}
+
+}  // namespace
+
+TEST_CASE("FadeKernels: fused composite and fade equal the fade pass and composite pass, RGB") {
+  for (uint8_t brightness : {255, 200, 0}) {
+    for (uint8_t fadeBy : {0, 1, 40, 255}) {
+      std::vector<uint8_t> passes(3 * 1000, 0), fused(3 * 1000, 0);
+      FadeBlocks<> blocks;
+      blocks.reset(1000);
+      for (int frame = 0; frame < 30; frame++) {
+        // passes: the fade requested last frame before the effects, effects draw, composite
+        if (frame && fadeBy) fadePass(passes, 3, Offsets(), fadeBy);
+        drawDots(passes, 3, frame, 5);
+        std::vector<uint8_t> destPasses(passes.size(), 10);
+        compositePass(passes, destPasses, brightness);
+
+        // fused: effects draw, composite and fade
+        drawDots(fused, 3, frame, 5);
+        std::vector<uint8_t> destFused(fused.size(), 10);
+        compositeFused(fused, destFused, blocks, brightness, fadeBy);
+        REQUIRE(destFused == destPasses);
+      }
+      if (fadeBy) fadePass(passes, 3, Offsets(), fadeBy);
+      CHECK(fused == passes);  // the buffer the effects of the next frame see
+    }
+  }
+}
+
+TEST_CASE("FadeKernels: a run of lights to every step-th physical light, odd lights shifted") {
+  // MappingRun shapes: a reversed row, a column, a snake across the row (0, 3, 2, 5, 4, ...), split at any light
+  const int32_t runs[][2] = {{1, 0}, {-1, 0}, {16, 0}, {1, 1}, {-1, -1}, {2, 1}};
+  for (const auto& shape : runs) {
+    for (uint8_t brightness : {255, 200}) {
+      for (uint8_t fadeBy : {0, 40}) {
+        for (uint32_t split : {0u, 3u, 6u}) {
+          const uint32_t lights = 13;
+          const int32_t step = shape[0], odd = shape[1];
+          const size_t first = 100;  // room for runs going down
+          std::vector<uint8_t> src(lights * 3), perLight, dest(3 * 400, 9), expected(dest);
+          for (size_t n = 0; n < src.size(); n++) src[n] = n * 37 + 5;
+          perLight = src;
+          uint8_t any = 0;
+          for (uint32_t n = 0; n < lights; n++) {  // MappingRun::at, light by light
+            size_t indexP = first + (int32_t)n * step + ((n & 1) ? odd : 0);
+            for (int c = 0; c < 3; c++) {
+              uint8_t value = perLight[n * 3 + c];
+              expected[indexP * 3 + c] = fadeAdd(expected[indexP * 3 + c], brightness == 255 ? value : fadeScaleVideo(value, brightness));
+              if (fadeBy) perLight[n * 3 + c] = fadeScale(value, 256 - fadeBy);
+              any |= perLight[n * 3 + c];
+            }
+          }
+          // as VirtualLayer::compositeRunsRGB: the run in two, the second from light split (its odd negated if odd)
+          size_t splitP = first + (int32_t)split * step + ((split & 1) ? odd : 0);
+          bool black = compositeFadeRGBRun(&src[0], &dest[first * 3], split, step, odd, brightness, fadeBy);
+          black &= compositeFadeRGBRun(&src[split * 3], &dest[splitP * 3], lights - split, step, (split & 1) ? -odd : odd, brightness, fadeBy);
+          CHECK(dest == expected);
+          CHECK(src == perLight);
+          CHECK_EQ(black, !any);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("FadeKernels: fade factors per channel of multi-channel lights, control channels kept") {
+  // RGBW + RGBW1 + pan, tilt (8 channels): colors and whites fade, pan and tilt don't
+  Offsets o;
+  o.rgbw = 0;
+  o.white = 3;
+  o.rgbw1 = 4;
+  const uint8_t cpl = 10;
+  std::vector<uint8_t> reference(cpl * 300);
+  for (size_t n = 0; n < reference.size(); n++) reference[n] = n * 37 + 11;
+  std::vector<uint8_t> faded = reference, control = reference;
+
+  fadePass(reference, cpl, o, 70);
+  const uint8_t colorChannels[] = {0, 1, 2, 3, 4, 5, 6, 7};
+  FadeFactors factors;
+  factors.set(cpl, colorChannels, sizeof(colorChannels), 70);
+  factors.fade(faded.data(), 300);
+  CHECK(faded == reference);
+  for (size_t i = 0; i < 300; i++) {
+    CHECK_EQ(faded[i * cpl + 8], control[i * cpl + 8]);  // pan
+    CHECK_EQ(faded[i * cpl + 9], control[i * cpl + 9]);  // tilt
+  }
+
+  FadeFactors rgb;  // light by light as compositeTo does
+  const uint8_t rgbChannels[] = {0, 1, 2};
+  rgb.set(3, rgbChannels, 3, 255);
+  uint8_t light[3] = {255, 128, 1};
+  rgb.fade(light, 1);
+  CHECK_EQ(light[0], 0);
+  CHECK_EQ(light[1], 0);
+  rgb.set(3, rgbChannels, 3, 0);
+  uint8_t kept[3] = {255, 128, 1};
+  rgb.fade(kept, 1);
+  CHECK_EQ(kept[0], 255);  // fadeBy 0: unchanged
+  CHECK_EQ(kept[2], 1);
+}
+
+TEST_CASE("FadeKernels: black blocks are checked, not trusted") {
+  std::vector<uint8_t> channels(3 * 256, 0), dest(3 * 256, 0);
+  FadeBlocks<> blocks;
+  blocks.reset(256);
+  CHECK(blocks.black(0));
+  CHECK_EQ(blocks.blocks(), 4u);
+  channels[3 * 130 + 1] = 200;  // an effect drew in block 2 since the last composite
+  compositeFused(channels, dest, blocks, 255, 128);
+  CHECK_EQ(dest[3 * 130 + 1], 200);
+  CHECK_EQ(channels[3 * 130 + 1], 100);
+  CHECK_FALSE(blocks.black(2));
+  CHECK(blocks.black(1));
+  compositeFused(channels, dest, blocks, 255, 255);  // faded to black: the block is black again
+  CHECK(blocks.black(2));
+  CHECK_FALSE(blocks.black(99));  // beyond the layer: never black
+}
+
+TEST_CASE("FadeKernels benchmark: trail effect frame on 16K lights, fade pass + composite vs fused") {
+  const size_t nrOfLights = 128 * 128;
+  const int frames = 100;
+  for (uint8_t cpl : {3, 4}) {
+    Offsets o;
+    if (cpl == 4) o.white = 3;
+    std::vector<uint8_t> passes(nrOfLights * cpl, 0), fused(nrOfLights * cpl, 0), dest(nrOfLights * cpl);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+      fadePass(passes, cpl, o, 20);
+      drawDots(passes, cpl, frame, 50);
+      std::fill(dest.begin(), dest.end(), 0);
+      compositePass(passes, dest, 255);
+    }
+    double passesUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    FadeBlocks<> blocks;
+    blocks.reset(nrOfLights);
+    FadeFactors factors;
+    const uint8_t colorChannels[] = {0, 1, 2, 3};
+    factors.set(cpl, colorChannels, cpl, 20);
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+      drawDots(fused, cpl, frame, 50);
+      std::fill(dest.begin(), dest.end(), 0);
+      if (cpl == 3)
+        compositeFused(fused, dest, blocks, 255, 20);
+      else
+        for (size_t i = 0; i < nrOfLights; i++) {  // as compositeTo for multi-channel lights: composite, then fade the light
+          for (int c = 0; c < cpl; c++) dest[i * cpl + c] = fadeAdd(dest[i * cpl + c], fused[i * cpl + c]);
+          factors.fade(&fused[i * cpl], 1);
+        }
+    }
+    double fusedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+    fadePass(passes, cpl, o, 20);  // fused faded the last frame already
+    CHECK(fused == passes);
+    MESSAGE((int)cpl << " channels, 16K lights: fade pass + composite " << passesUs << " us, fused " << fusedUs << " us per frame");
+  }
+}
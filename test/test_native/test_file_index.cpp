@@ -0,0 +1,229 @@
+/**
+    @title     MoonLight Unit Tests — FileIndex
+    @file      test_file_index.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the incremental File Manager index and its change journal (src/MoonBase/utilities/FileIndex.h).
+    A temp directory plays the FS: after changes made on disk and applied to the index, the index must equal a fresh walk,
+    and the journal applied to the previous tree must give the new tree (what FileManager.svelte does).
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <string>
+
+#include "FileIndex.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// The FS: a temp directory, removed at the end of the test
+struct TempFS {
+  fs::path root;
+
+  TempFS() {
+    root = fs::temp_directory_path() / ("moonlight_file_index_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    fs::create_directories(root);
+  }
+  ~TempFS() {
+    std::error_code ec;
+    fs::remove_all(root, ec);
+  }
+
+  fs::path at(const std::string& path) const { return root / path.substr(1); }
+
+  void write(const std::string& path, const std::string& contents) {
+    fs::create_directories(at(path).parent_path());
+    std::ofstream(at(path), std::ios::binary) << contents;
+  }
+
+  // stat a path as FileManager does after a write: what the index gets
+  bool stat(const std::string& path, bool& isFile, uint32_t& size, uint32_t& time) const { return stat(at(path), isFile, size, time); }
+
+  static bool stat(const fs::path& p, bool& isFile, uint32_t& size, uint32_t& time) {
+    std::error_code ec;
+    if (!fs::exists(p, ec)) return false;
+    isFile = fs::is_regular_file(p);
+    size = isFile ? fs::file_size(p) : 0;
+    time = isFile ? std::chrono::duration_cast<std::chrono::seconds>(fs::last_write_time(p).time_since_epoch()).count() : 0;
+    return true;
+  }
+
+  // the walk FileManager does once at boot (addFolder)
+  void walk(const std::function<void(const char*, bool, uint32_t, uint32_t)>& add) const {
+    for (const auto& item : fs::recursive_directory_iterator(root)) {
+      bool isFile = false;
+      uint32_t size = 0, time = 0;
+      stat(item.path(), isFile, size, time);
+      std::string path = "/" + fs::relative(item.path(), root).generic_string();
+      add(path.c_str(), isFile, size, time);
+    }
+  }
+
+  void index(FileIndex& index, const std::string& path) const {
+    bool isFile = false;
+    uint32_t size = 0, time = 0;
+    if (stat(path, isFile, size, time))
+      index.set(path.c_str(), isFile, size, time);
+    else
+      index.remove(path.c_str());
+  }
+};
+
+typedef std::map<std::string, FileIndexEntry> Tree;
+
+Tree treeOf(const FileIndex& index) {
+  Tree tree;
+  index.forEach([&](const char* path, const char*, const FileIndexEntry& entry, int) { tree[path] = entry; });
+  return tree;
+}
+
+// the client side: apply a journal to the tree it has
+void applyJournal(Tree& tree, const FileIndex& index) {
+  for (const FileJournalEntry& change : index.journal()) {
+    if (change.change == FileChange::removed) {
+      for (auto it = tree.begin(); it != tree.end();)
+        it = it->first == change.path || it->first.rfind(change.path + "/", 0) == 0 ? tree.erase(it) : std::next(it);
+    } else
+      tree[change.path] = change.entry;
+  }
+}
+
+bool equal(const Tree& a, const Tree& b) {
+  if (a.size() != b.size()) return false;
+  for (auto ia = a.begin(), ib = b.begin(); ia != a.end(); ++ia, ++ib)
+    if (ia->first != ib->first || ia->second.isFile != ib->second.isFile || ia->second.size != ib->second.size || ia->second.time != ib->second.time) return false;
+  return true;
+}
+
+}  // namespace
+
+TEST_CASE("FileIndex: walk order is depth first, hidden paths") {
+  FileIndex index;
+  index.rebuild([](auto add) {
+    add("/a b", true, 1, 0);
+    add("/a/x", true, 2, 0);
+    add("/a", false, 0, 0);
+    add("/b.json", true, 3, 0);
+  });
+  std::string order;
+  index.forEach([&](const char* path, const char* name, const FileIndexEntry&, int depth) { order += std::string(path) + "(" + name + "," + std::to_string(depth) + ") "; });
+  CHECK_EQ(order, "/a(a,0) /a/x(x,1) /a b(a b,0) /b.json(b.json,0) ");
+  CHECK_FALSE(index.journalComplete());  // rebuilt: clients need the tree
+
+  CHECK(isHiddenPath("/.config/effects.json"));
+  CHECK(isHiddenPath("/presets/.hidden"));
+  CHECK_FALSE(isHiddenPath("/presets/a.json"));
+}
+
+TEST_CASE("FileIndex: changes in a temp dir, index equals a fresh walk, journal brings a client up to date") {
+  TempFS disk;
+  disk.write("/.config/effects.json", "{}");
+  disk.write("/.config/presets/preset01.json", "{\"a\":1}");
+  disk.write("/livescripts/fire.sc", "void setup() {}");
+  disk.write("/readme.txt", "hello");
+
+  FileIndex index;
+  index.rebuild([&](auto add) { disk.walk(add); });
+  Tree client = treeOf(index);  // the client loads the whole tree
+  uint32_t clientVersion = index.version();
+  index.publish();
+
+  // FileManager updates: new file, new folder, write, rename of a folder, delete
+  disk.write("/livescripts/spiral.sc", "void loop() {}");
+  disk.index(index, "/livescripts/spiral.sc");
+  fs::create_directories(disk.at("/new folder"));
+  disk.index(index, "/new folder");
+  disk.write("/.config/effects.json", "{\"nodes\":[]}");
+  disk.index(index, "/.config/effects.json");
+  disk.write("/.config/effects.json", "{\"nodes\":[1]}");  // written twice: one journal entry
+  disk.index(index, "/.config/effects.json");
+  fs::rename(disk.at("/livescripts"), disk.at("/scripts"));
+  index.rename("/livescripts", "/scripts");
+  fs::remove(disk.at("/readme.txt"));
+  disk.index(index, "/readme.txt");
+
+  FileIndex walked;
+  walked.rebuild([&](auto add) { disk.walk(add); });
+  CHECK(equal(treeOf(index), treeOf(walked)));
+  CHECK(index.find("/scripts/fire.sc"));
+  CHECK_FALSE(index.find("/livescripts"));
+
+  REQUIRE(index.journalComplete());
+  CHECK_EQ(index.journalFrom(), clientVersion);
+  int modified = 0;
+  for (const auto& change : index.journal()) modified += change.change == FileChange::modified;
+  CHECK_EQ(modified, 1);
+  applyJournal(client, index);
+  CHECK(equal(client, treeOf(index)));
+}
+
+TEST_CASE("FileIndex: a published journal is followed by a new one, unchanged writes are not journaled") {
+  FileIndex index;
+  index.rebuild([](auto add) { add("/a.json", true, 10, 100); });
+  index.publish();
+  uint32_t v1 = index.version();
+
+  CHECK(index.set("/a.json", true, 11, 101));
+  CHECK_FALSE(index.set("/a.json", true, 11, 101));
+  CHECK_EQ(index.journalFrom(), v1);
+  REQUIRE_EQ(index.journal().size(), 1);
+  index.publish();
+  uint32_t v2 = index.version();
+
+  CHECK(index.set("/dir/b.json", true, 1, 1));  // parent folder added first
+  CHECK_EQ(index.journalFrom(), v2);
+  REQUIRE_EQ(index.journal().size(), 2);
+  CHECK_EQ(index.journal()[0].path, "/dir");
+  CHECK_FALSE(index.journal()[0].entry.isFile);
+  CHECK_EQ(index.journal()[1].path, "/dir/b.json");
+
+  CHECK(index.remove("/dir"));
+  CHECK_EQ(index.size(), 1);
+  CHECK_FALSE(index.remove("/dir"));
+}
+
+TEST_CASE("FileIndex: a long journal becomes incomplete, the client reloads the tree") {
+  FileIndex index;
+  index.rebuild([](auto) {});
+  index.publish();
+  for (int i = 0; i < FILE_JOURNAL_MAX + 1; i++) index.set(("/f" + std::to_string(i)).c_str(), true, 1, 1);
+  CHECK_FALSE(index.journalComplete());
+  CHECK(index.journal().empty());
+  index.publish();
+  index.set("/f0", true, 2, 2);
+  CHECK(index.journalComplete());
+}
+
+TEST_CASE("FileIndex benchmark: walk of 500 files vs one indexed write") {
+  TempFS disk;
+  for (int p = 0; p < 400; p++) disk.write("/.config/presets/preset" + std::to_string(p) + ".json", std::string(200, 'x'));
+  for (int s = 0; s < 100; s++) disk.write("/livescripts/script" + std::to_string(s) + ".sc", std::string(500, 'y'));
+
+  FileIndex index;
+  auto start = std::chrono::steady_clock::now();
+  index.rebuild([&](auto add) { disk.walk(add); });
+  double walkUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  index.publish();
+
+  const int writes = 100;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < writes; i++) {
+    disk.write("/.config/effects.json", std::string(i, 'z'));
+    disk.index(index, "/.config/effects.json");
+    index.publish();
+  }
+  double writeUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / writes;
+
+  CHECK_EQ(index.size(), 504);  // 500 files, 3 folders, effects.json
+  MESSAGE(index.size() << " entries: walk " << walkUs << " us, write + index update " << writeUs << " us");
+}
@@ -0,0 +1,129 @@
+/**
+    @title     MoonLight Unit Tests — FixedMath
+    @file      test_fixed_math.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the integer trig and square root of effects (src/MoonBase/utilities/FixedMath.h): accuracy
+    against <cmath> over the whole input range, and the speed of a per-light polar kernel (Spiral Fire) with float and
+    with integer math. The host has an FPU: on an ESP32-C3 the float kernel runs in software.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+#include "FixedMath.h"
+
+namespace {
+
+const double turn = 65536.0;
+
+// distance in 1/65536 turn, across the wrap
+int angleError(int16_t a, double radians) {
+  int expected = (int)lround(radians * turn / (2 * M_PI));
+  return std::abs((int16_t)(uint16_t)(a - expected));
+}
+
+// Spiral Fire: is the light on the cone surface, and its spiral phase
+volatile uint32_t sink;
+
+double floatKernelNs(int size, int frames) {
+  uint32_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++)
+    for (int y = 0; y < size; y++)
+      for (int x = 0; x < size; x++)
+        for (int z = 0; z < size; z++) {
+          float dx = x - size / 2.0f, dz = z - size / 2.0f;
+          float radius = sqrtf(dx * dx + dz * dz);
+          float angle = atan2f(dz, dx);
+          float expectedRadius = (size / 2.0f) * (1.0f - (float)y / size);
+          if (fabsf(radius - expectedRadius) < 1.5f) sum += (uint8_t)(int)(angle * 40.0f + y * 20 - frame);
+        }
+  sink = sum;
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ((double)frames * size * size * size);
+}
+
+double fixedKernelNs(int size, int frames) {
+  uint32_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++)
+    for (int y = 0; y < size; y++)
+      for (int x = 0; x < size; x++)
+        for (int z = 0; z < size; z++) {
+          int32_t dx = (2 * x - size) * 8, dz = (2 * z - size) * 8;  // Q4
+          int32_t expectedRadius = ((size * 8) * (size - y)) / size;
+          int32_t inner = std::max(expectedRadius - 24, 0), outer = expectedRadius + 24;  // ± 1.5
+          int32_t radius2 = dx * dx + dz * dz;
+          if (radius2 > inner * inner && radius2 < outer * outer) sum += (uint8_t)(((atan2Fixed(dz, dx) * 8042) >> 21) + y * 20 - frame);
+        }
+  sink = sum;
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ((double)frames * size * size * size);
+}
+
+}  // namespace
+
+TEST_CASE("FixedMath: sinFixed and cosFixed within 1 (Q15) of sin and cos for every angle") {
+  int maxError = 0;
+  for (uint32_t a = 0; a < 65536; a++) {
+    double radians = a * 2 * M_PI / turn;
+    maxError = std::max(maxError, std::abs(sinFixed(a) - (int)lround(sin(radians) * 32767)));
+    maxError = std::max(maxError, std::abs(cosFixed(a) - (int)lround(cos(radians) * 32767)));
+  }
+  CHECK(maxError <= 1);
+  CHECK_EQ(sinFixed(0), 0);
+  CHECK_EQ(sinFixed(16384), 32767);
+  CHECK_EQ(sinFixed(32768), 0);
+  CHECK_EQ(sinFixed(49152), -32767);
+  CHECK_EQ(cosFixed(0), 32767);
+  MESSAGE("sin/cos max error " << maxError << " / 32767");
+}
+
+TEST_CASE("FixedMath: atan2Fixed within 2 of atan2, in every direction and at every scale") {
+  int maxError = 0;
+  for (int y = -300; y <= 300; y++)
+    for (int x = -300; x <= 300; x++) {
+      if (!x && !y) continue;
+      maxError = std::max(maxError, angleError(atan2Fixed(y, x), atan2((double)y, (double)x)));
+    }
+  for (int64_t scale = 1; scale < (1 << 29); scale *= 7) {  // large inputs are scaled down
+    maxError = std::max(maxError, angleError(atan2Fixed(3 * scale, -2 * scale), atan2(3.0, -2.0)));
+    maxError = std::max(maxError, angleError(atan2Fixed(-scale, 5 * scale), atan2(-1.0, 5.0)));
+  }
+  CHECK(maxError <= 2);
+  CHECK_EQ(atan2Fixed(0, 0), 0);
+  CHECK_EQ(atan2Fixed(0, 10), 0);
+  CHECK_EQ((uint16_t)atan2Fixed(10, 0), 16384);
+  CHECK_EQ((uint16_t)atan2Fixed(0, -10), 32768);
+  CHECK_EQ(atan2Fixed(-10, 0), -16384);
+  MESSAGE("atan2 max error " << maxError << " / 65536 turn");
+}
+
+TEST_CASE("FixedMath: sqrtFixed and hypotFixed are floor of sqrt") {
+  for (uint32_t x = 0; x < 200000; x++) REQUIRE_EQ(sqrtFixed(x), (uint16_t)floor(sqrt((double)x)));
+  uint32_t seed = 7;
+  for (int i = 0; i < 100000; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    REQUIRE_EQ(sqrtFixed(seed), (uint16_t)floor(sqrt((double)seed)));
+  }
+  CHECK_EQ(sqrtFixed(UINT32_MAX), 65535);
+  CHECK_EQ(sqrtFixed(65536u * 65535u), 65535);  // just below 65536²
+  CHECK_EQ(hypotFixed(3, -4), 5);
+  CHECK_EQ(hypotFixed(-46340, 46340), 65534);
+}
+
+TEST_CASE("FixedMath benchmark: polar kernel (Spiral Fire) with float and integer math") {
+  for (int size : {16, 32}) {
+    double floatNs = floatKernelNs(size, 20);
+    double fixedNs = fixedKernelNs(size, 20);
+    MESSAGE(size << "³ lights: float " << floatNs << " ns, integer " << fixedNs << " ns per light (host FPU)");
+  }
+  CHECK(sink != 0);
+}
@@ -0,0 +1,277 @@
+/**
+    @title     MoonLight Unit Tests — LightRuns
+    @file      test_light_runs.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for adding lights in runs (src/MoonBase/utilities/LightRuns.h): a LightGrid walks the lights in
+    the order of the nested Wiring::iterate loops of the panel and cube layouts (also from a light in the middle),
+    gridIsOneToOne only claims a 1:1 mapping when every light is its virtual light, and lines and rings are placed
+    as addTube and RingLayout did. Wiring is the real one (LightRuns.h). The benchmark times a model of the remap
+    (RemapModel, not PhysicalLayer / VirtualLayer, which need the ESP32 build) of a 64K light panel, light by light
+    and as a grid.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "LightRuns.h"
+
+namespace {
+
+// the nested Wiring::iterate loops of the panel and cube layouts (L_MoonLight.h), light by light
+std::vector<Coord3D> wired3D(Wiring& wiring, Coord3D origin) {
+  std::vector<Coord3D> positions;
+  wiring.iterate(0, 0, [&](uint16_t i) {
+    wiring.iterate(1, i, [&](uint16_t j) {
+      wiring.iterate(2, j, [&](uint16_t k) {
+        int coords[3];
+        coords[wiring.axes[0]] = i;
+        coords[wiring.axes[1]] = j;
+        coords[wiring.axes[2]] = k;
+        positions.push_back(Coord3D(origin.x + coords[0], origin.y + coords[1], origin.z + coords[2]));
+      });
+    });
+  });
+  return positions;
+}
+
+std::vector<Coord3D> gridPositions(const LightGrid& grid, size_t first, size_t count) {
+  std::vector<Coord3D> positions;
+  grid.forEach(first, count, [&](Coord3D position) { positions.push_back(position); });
+  return positions;
+}
+
+// the virtual light of each light of grid in a layer of size layerSize at start, as VirtualLayer::addLight
+bool mapsOneToOne(const LightGrid& grid, size_t first, size_t count, size_t firstIndex, Coord3D start, Coord3D layerSize) {
+  bool oneToOne = true;
+  size_t index = firstIndex;
+  grid.forEach(first, count, [&](Coord3D position) {
+    position = position - start;
+    oneToOne &= (size_t)position.x + (size_t)position.y * layerSize.x + (size_t)position.z * layerSize.x * layerSize.y == index++;
+  });
+  return oneToOne;
+}
+
+}  // namespace
+
+TEST_CASE("LightRuns: a grid walks the lights as the wiring loops") {
+  uint8_t axisOrders[6][3] = {{2, 1, 0}, {2, 0, 1}, {1, 2, 0}, {1, 0, 2}, {0, 2, 1}, {0, 1, 2}};
+  const Coord3D origin(3, 0, 5);
+  for (auto& axes : axisOrders) {
+    for (uint8_t variant = 0; variant < 64; variant++) {
+      Wiring wiring = {{4, 3, 5}, 1, {bool(variant & 1), bool(variant & 2), bool(variant & 4)}, {bool(variant & 8), bool(variant & 16), bool(variant & 32)}, axes};
+      std::vector<Coord3D> expected = wired3D(wiring, origin);
+
+      LightGrid grid;
+      grid.origin = origin;
+      for (uint8_t n = 0; n < 3; n++) {
+        grid.size[n] = wiring.size[n];
+        grid.inc[n] = wiring.inc[n];
+        grid.snake[n] = wiring.snake[n];
+        grid.axes[n] = axes[n];
+      }
+      REQUIRE_EQ(grid.count(), expected.size());
+      bool same = gridPositions(grid, 0, grid.count()) == expected;
+      for (size_t n = 0; n < expected.size(); n++) same &= grid.position(n) == expected[n];
+      std::vector<Coord3D> middle = gridPositions(grid, 17, 20);  // from a light in the middle, over a row and a plane
+      same &= std::equal(middle.begin(), middle.end(), expected.begin() + 17);
+      CHECK(same);
+      CHECK(grid.last() == Coord3D(origin.x + 3, origin.y + 2, origin.z + 4));
+      CHECK(gridPositions(wiring.grid(3, origin), 0, grid.count()) == expected);  // what the cube layouts add
+    }
+  }
+
+  // a 16x16 panel wired column by column, snaking (PanelLayout default): columns up and down
+  LightGrid panel;
+  panel.size[0] = 16;
+  panel.size[1] = 16;
+  panel.axes[1] = 0;
+  panel.axes[2] = 1;
+  panel.snake[2] = true;
+  CHECK(panel.position(15) == Coord3D(0, 15));
+  CHECK(panel.position(16) == Coord3D(1, 15));
+  CHECK(panel.position(31) == Coord3D(1, 0));
+  CHECK(panel.position(32) == Coord3D(2, 0));
+  CHECK(gridPositions(panel, 256, 0).empty());
+}
+
+TEST_CASE("LightRuns: one to one only if every light is its virtual light") {
+  const Coord3D layer(8, 4, 2);
+  uint8_t axisOrders[6][3] = {{2, 1, 0}, {2, 0, 1}, {1, 2, 0}, {1, 0, 2}, {0, 2, 1}, {0, 1, 2}};
+  int claimed = 0;
+  for (auto& axes : axisOrders) {
+    for (uint8_t variant = 0; variant < 64; variant++) {
+      for (Coord3D size : {Coord3D(8, 4, 2), Coord3D(8, 2, 1), Coord3D(5, 1, 1), Coord3D(1, 4, 1)}) {
+        LightGrid grid;
+        for (uint8_t n = 0; n < 3; n++) {
+          grid.axes[n] = axes[n];
+          grid.inc[n] = variant & (1 << n);
+          grid.snake[n] = variant & (8 << n);
+        }
+        grid.size[0] = size.x;
+        grid.size[1] = size.y;
+        grid.size[2] = size.z;
+        for (size_t firstIndex : {(size_t)0, (size_t)8}) {
+          bool claims = gridIsOneToOne(grid, 0, grid.count(), firstIndex, Coord3D(), layer);
+          if (claims) {
+            claimed++;
+            CHECK(mapsOneToOne(grid, 0, grid.count(), firstIndex, Coord3D(), layer));
+          }
+        }
+      }
+    }
+  }
+  CHECK(claimed > 0);
+
+  // a panel filling the layer, and its second half after the first
+  LightGrid panel;
+  panel.size[0] = 8;
+  panel.size[1] = 4;
+  panel.size[2] = 2;
+  CHECK(gridIsOneToOne(panel, 0, 64, 0, Coord3D(), layer));
+  CHECK(gridIsOneToOne(panel, 32, 32, 32, Coord3D(), layer));
+  CHECK_FALSE(gridIsOneToOne(panel, 0, 64, 1, Coord3D(), layer));  // after another light
+  panel.origin = Coord3D(2, 0, 0);
+  CHECK(gridIsOneToOne(panel, 0, 64, 0, Coord3D(2, 0, 0), layer));  // the layer starts at the panel
+  panel.snake[2] = true;
+  CHECK_FALSE(gridIsOneToOne(panel, 0, 64, 0, Coord3D(2, 0, 0), layer));  // serpentine: needs a table
+}
+
+TEST_CASE("LightRuns: lines and rings as addTube and RingLayout") {
+  CHECK(lineLight(Coord3D(0, 0, 0), Coord3D(10, 20, 0), 0, 11) == Coord3D(0, 0, 0));
+  CHECK(lineLight(Coord3D(0, 0, 0), Coord3D(10, 20, 0), 10, 11) == Coord3D(10, 20, 0));
+  CHECK(lineLight(Coord3D(0, 0, 0), Coord3D(10, 20, 0), 5, 11) == Coord3D(5, 10, 0));
+  CHECK(lineLight(Coord3D(4, 4, 4), Coord3D(9, 9, 9), 0, 1) == Coord3D(4, 4, 4));  // one light: at from
+
+  // a full ring of 24 lights around (5, 5), the first at the top
+  Coord3D center(5, 5, 0), position;
+  int lights = 0;
+  for (size_t n = 0; n < 24; n++) lights += ringLight(center, 24, n, 0, 360, true, 1, position);
+  CHECK_EQ(lights, 24);
+  REQUIRE(ringLight(center, 24, 0, 0, 360, true, 1, position));
+  CHECK(position == Coord3D(5, 1, 0));  // radius 24 / 2 pi = 3.8
+  REQUIRE(ringLight(center, 24, 12, 0, 360, true, 1, position));
+  CHECK(position == Coord3D(4, 8, 0));  // truncated as RingLayout did: sinf of 2 pi is not exactly 0
+
+  // a quarter, clockwise and not, and one light in the middle
+  lights = 0;
+  for (size_t n = 0; n < 24; n++) lights += ringLight(center, 24, n, 0, 90, true, 1, position);
+  CHECK_EQ(lights, 7);  // 0, 15, ... 90 degrees
+  lights = 0;
+  for (size_t n = 0; n < 24; n++) lights += ringLight(center, 24, n, 0, 90, false, 1, position);
+  CHECK_EQ(lights, 7);  // 270 ... 345, 0
+  REQUIRE(ringLight(center, 1, 0, 0, 360, true, 2, position));
+  CHECK(position == Coord3D(10, 10, 0));
+}
+
+namespace {
+
+// A model of the remap for the benchmark, not the layers themselves: PhysicalLayer::addLight (pass 1) and
+// VirtualLayer::addLight (pass 2) reduced to what they cost per light, a virtual call per node on the layer
+struct EffectNode {
+  bool on = true;
+  virtual ~EffectNode() = default;
+  virtual void modifyPosition(Coord3D& position) {}
+};
+
+struct RemapModel {
+  std::vector<EffectNode*> nodes;
+  Coord3D layerSize;
+  std::vector<uint8_t> positions;     // channelsD in pass 1
+  size_t nrOfLights = 0, indexP = 0;
+  bool oneToOne = true;
+  std::vector<uint32_t> mappingTable;  // indexP + 1 per virtual light, 0: none
+
+  void startTable(size_t upTo) {
+    mappingTable.assign((size_t)layerSize.x * layerSize.y * layerSize.z, 0);
+    for (size_t index = 0; index < upTo && index < mappingTable.size(); index++) mappingTable[index] = index + 1;
+  }
+
+  // addLight, pass 1 (channelsD doubling) and pass 2
+  __attribute__((noinline)) void addLight(Coord3D position, int pass) {
+    if (position.x < 0) position.x = 0;
+    if (position.y < 0) position.y = 0;
+    if (position.z < 0) position.z = 0;
+    if (pass == 1) {
+      if ((nrOfLights + 1) * 3 > positions.size()) positions.resize(std::max((nrOfLights + 1) * 3, positions.size() * 2));
+      uint8_t* buf = &positions[nrOfLights * 3];
+      buf[0] = std::min(position.x, 255);
+      buf[1] = std::min(position.y, 255);
+      buf[2] = std::min(position.z, 255);
+      nrOfLights++;
+    } else {
+      for (EffectNode* node : nodes)
+        if (node->on) node->modifyPosition(position);
+      size_t indexV = (size_t)position.x + (size_t)position.y * layerSize.x + (size_t)position.z * layerSize.x * layerSize.y;
+      if (oneToOne && indexV != indexP) {
+        oneToOne = false;
+        startTable(indexP);
+      }
+      if (!oneToOne && indexV < mappingTable.size()) mappingTable[indexV] = indexP + 1;
+      indexP++;
+    }
+  }
+
+  // addLights(grid), pass 1 (channelsD grown once) and pass 2
+  void addLights(const LightGrid& grid, int pass) {
+    if (pass == 1) {
+      if ((nrOfLights + grid.count()) * 3 > positions.size()) positions.resize((nrOfLights + grid.count()) * 3);
+      grid.forEach(0, grid.count(), [&](Coord3D position) {
+        uint8_t* buf = &positions[nrOfLights++ * 3];
+        buf[0] = std::min(position.x, 255);
+        buf[1] = std::min(position.y, 255);
+        buf[2] = std::min(position.z, 255);
+      });
+    } else if (oneToOne && gridIsOneToOne(grid, 0, grid.count(), indexP, Coord3D(), layerSize)) {
+      indexP += grid.count();
+    } else {
+      grid.forEach(0, grid.count(), [&](Coord3D position) {
+        size_t indexV = (size_t)position.x + (size_t)position.y * layerSize.x + (size_t)position.z * layerSize.x * layerSize.y;
+        if (oneToOne && indexV != indexP) {
+          oneToOne = false;
+          startTable(indexP);
+        }
+        if (!oneToOne && indexV < mappingTable.size()) mappingTable[indexV] = indexP + 1;
+        indexP++;
+      });
+    }
+  }
+};
+
+}  // namespace
+
+TEST_CASE("LightRuns benchmark: remap of a 64K light panel, light by light vs as a grid") {
+  EffectNode effect1, effect2;  // two effects on the layer, as nodes loop over in addLight
+  for (bool serpentine : {false, true}) {
+    LightGrid panel;
+    panel.size[0] = 256;
+    panel.size[1] = 256;
+    panel.snake[2] = serpentine;
+
+    RemapModel perLight, bulk;
+    for (RemapModel* model : {&perLight, &bulk}) {
+      model->nodes = {&effect1, &effect2};
+      model->layerSize = Coord3D(256, 256, 1);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int pass : {1, 2}) panel.forEach(0, panel.count(), [&](Coord3D position) { perLight.addLight(position, pass); });
+    double perLightMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int pass : {1, 2}) bulk.addLights(panel, pass);
+    double bulkMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    CHECK_EQ(bulk.nrOfLights, 65536u);
+    CHECK(std::equal(bulk.positions.begin(), bulk.positions.begin() + 65536 * 3, perLight.positions.begin()));
+    CHECK_EQ(bulk.oneToOne, !serpentine);
+    CHECK(bulk.mappingTable == perLight.mappingTable);
+    MESSAGE("remap model, " << (serpentine ? "serpentine" : "row by row") << " 256x256 panel, pass 1 + 2: light by light " << perLightMs << " ms, as a grid " << bulkMs << " ms");
+  }
+}
@@ -0,0 +1,297 @@
+/**
+    @title     MoonLight Unit Tests — MappingDescriptor
+    @file      test_mapping_descriptor.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the analytic mappings (src/MoonBase/utilities/MappingDescriptor.h): a GridWiring finds the
+    tiles of single panels, cubes added plane by plane and panels in any tile order, and rejects lights that are not
+    one tiling. The runs of a MappingDescriptor give exactly the (virtual, physical) pairs of the mapping table
+    VirtualLayer::addLight builds, also in a window and folded by the Mirror and Multiply modifiers, and fit() only
+    accepts folds matching the table. The benchmark composites a 128x128 wall of serpentine panels through a mapping
+    table and through the runs.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "FadeKernels.h"
+#include "MappingDescriptor.h"
+
+namespace {
+
+typedef std::vector<std::pair<uint32_t, uint32_t>> Pairs;  // (indexV, indexP)
+
+LightGrid serpentinePanel(Coord3D origin, uint16_t width, uint16_t height) {
+  LightGrid grid;
+  grid.origin = origin;
+  grid.size[0] = width;
+  grid.size[1] = height;
+  grid.snake[2] = true;  // rows snake
+  return grid;
+}
+
+// panels of a tile wired as panel, in the order of tiles
+GridWiring panels(const LightGrid& tiles, const LightGrid& panel) {
+  GridWiring wiring;
+  uint32_t indexP = 0;
+  for (size_t t = 0; t < tiles.count(); t++) {
+    LightGrid grid = panel;
+    Coord3D position = tiles.position(t);
+    grid.origin = Coord3D(panel.origin.x + position.x * panel.size[0], panel.origin.y + position.y * panel.size[1], panel.origin.z + position.z * panel.size[2]);
+    wiring.add(grid, 0, grid.count(), indexP);
+    indexP += grid.count();
+  }
+  return wiring;
+}
+
+// the pairs of the mapping table VirtualLayer::addLight builds: lights in the window at start of size window, moved
+// by modify (a modifier's modifyPosition)
+Pairs tablePairs(const GridWiring& wiring, Coord3D start, Coord3D window, Coord3D size, const std::function<void(Coord3D&)>& modify) {
+  Pairs pairs;
+  wiring.forEachLight([&](Coord3D position, uint32_t indexP) {
+    if (position.isOutofBounds(start + window) || position.x < start.x || position.y < start.y || position.z < start.z) return;
+    position = position - start;
+    modify(position);
+    pairs.push_back({(uint32_t)(position.x + position.y * size.x + position.z * size.x * size.y), indexP});
+  });
+  std::sort(pairs.begin(), pairs.end());
+  return pairs;
+}
+
+Pairs runPairs(const MappingDescriptor& mapping) {
+  Pairs pairs;
+  mapping.forEachRun([&](uint32_t indexV, uint32_t count, const MappingRun& run) {
+    run.forEach(count, [&](uint32_t n, uint32_t indexP) {
+      pairs.push_back({indexV + n, indexP});
+      CHECK_EQ(indexP, run.at(n));
+    });
+  });
+  std::sort(pairs.begin(), pairs.end());
+  return pairs;
+}
+
+MappingDescriptor descriptor(const GridWiring& wiring, Coord3D start, Coord3D window, Coord3D size) {
+  MappingDescriptor mapping;
+  mapping.wiring = wiring.wiring();
+  mapping.start = start;
+  mapping.window = window;
+  mapping.size = size;
+  return mapping;
+}
+
+// compositeTo() per light: additive, saturating
+void addLight(uint8_t* dst, const uint8_t* src) {
+  for (uint8_t c = 0; c < 3; c++) dst[c] = fadeAdd(dst[c], src[c]);
+}
+
+// fit() against the table of pairs
+bool fitTable(MappingDescriptor& mapping, const Pairs& pairs) { return mapping.fit(pairs.size(), [&](uint32_t indexV, uint32_t indexP) { return std::binary_search(pairs.begin(), pairs.end(), std::make_pair(indexV, indexP)); }); }
+
+}  // namespace
+
+TEST_CASE("MappingDescriptor: gridLightNumber is the inverse of position") {
+  uint8_t axisOrders[6][3] = {{2, 1, 0}, {2, 0, 1}, {1, 2, 0}, {1, 0, 2}, {0, 2, 1}, {0, 1, 2}};
+  for (auto& axes : axisOrders) {
+    for (uint8_t variant = 0; variant < 64; variant++) {
+      LightGrid grid;
+      grid.size[0] = 4;
+      grid.size[1] = 3;
+      grid.size[2] = 5;
+      for (uint8_t i = 0; i < 3; i++) {
+        grid.axes[i] = axes[i];
+        grid.inc[i] = variant & (1 << i);
+        grid.snake[i] = variant & (8 << i);
+      }
+      bool inverse = true;
+      for (size_t n = 0; n < grid.count(); n++) inverse &= gridLightNumber(grid, grid.position(n)) == n;
+      CHECK(inverse);
+    }
+  }
+}
+
+TEST_CASE("MappingDescriptor: the tiles of panels and cubes") {
+  // one serpentine panel, not at the origin
+  GridWiring single;
+  LightGrid panel = serpentinePanel(Coord3D(2, 1, 0), 8, 4);
+  single.add(panel, 0, panel.count(), 0);
+  REQUIRE(single.finish(panel.count()));
+  bool same = true;
+  single.forEachLight([&](Coord3D position, uint32_t indexP) { same &= single.wiring().indexP(position) == indexP; });
+  CHECK(same);
+  CHECK_EQ(single.wiring().indexP(Coord3D(0, 0, 0)), UINT32_MAX);  // no light there
+  CHECK_EQ(single.wiring().indexP(Coord3D(10, 1, 0)), UINT32_MAX);
+
+  // a cube added plane by plane (Cube layout) is one grid
+  GridWiring cube;
+  LightGrid cubeGrid;
+  cubeGrid.size[0] = cubeGrid.size[1] = cubeGrid.size[2] = 4;
+  cubeGrid.snake[1] = cubeGrid.snake[2] = true;
+  for (size_t plane = 0; plane < 4; plane++) cube.add(cubeGrid, plane * 16, 16, plane * 16);
+  REQUIRE(cube.finish(64));
+  CHECK_EQ(cube.wiring().tiles.count(), 1u);
+
+  // 3 x 2 panels in every tile order: the order is found
+  uint8_t axisOrders[6][3] = {{2, 1, 0}, {2, 0, 1}, {1, 2, 0}, {1, 0, 2}, {0, 2, 1}, {0, 1, 2}};
+  for (auto& axes : axisOrders) {
+    for (uint8_t variant = 0; variant < 32; variant++) {
+      LightGrid tiles;
+      tiles.size[0] = 3;
+      tiles.size[1] = 2;
+      for (uint8_t i = 0; i < 3; i++) {
+        tiles.axes[i] = axes[i];
+        tiles.inc[i] = variant & (1 << i);
+      }
+      tiles.snake[1] = variant & 8;
+      tiles.snake[2] = variant & 16;
+      GridWiring wiring = panels(tiles, serpentinePanel(Coord3D(0, 0, 0), 4, 4));
+      REQUIRE(wiring.finish(tiles.count() * 16));
+      bool found = true;
+      wiring.forEachLight([&](Coord3D position, uint32_t indexP) { found &= wiring.wiring().indexP(position) == indexP; });
+      CHECK(found);
+    }
+  }
+
+  // not one tiling: lights added one by one, unequal tiles, a gap
+  GridWiring oneByOne;
+  oneByOne.add(panel, 0, panel.count(), 0);
+  CHECK_FALSE(oneByOne.finish(panel.count() + 1));
+  GridWiring unequal;
+  unequal.add(serpentinePanel(Coord3D(0, 0, 0), 4, 4), 0, 16, 0);
+  unequal.add(serpentinePanel(Coord3D(4, 0, 0), 4, 2), 0, 8, 16);
+  CHECK_FALSE(unequal.finish(24));
+  GridWiring gap;
+  gap.add(serpentinePanel(Coord3D(0, 0, 0), 4, 4), 0, 16, 0);
+  gap.add(serpentinePanel(Coord3D(8, 0, 0), 4, 4), 0, 16, 16);
+  CHECK_FALSE(gap.finish(32));
+}
+
+TEST_CASE("MappingDescriptor: runs give the pairs of the mapping table") {
+  LightGrid tiles;
+  tiles.size[0] = 3;
+  tiles.size[1] = 2;
+  tiles.axes[1] = 0;  // columns of panels, bottom up in odd columns
+  tiles.axes[2] = 1;
+  tiles.snake[2] = true;
+  LightGrid panel = serpentinePanel(Coord3D(1, 0, 0), 5, 4);
+  panel.axes[1] = 0;  // column wired panels: x at level 1, y snakes with the parity of x
+  panel.axes[2] = 1;
+  panel.inc[0] = false;  // mirrored
+  GridWiring wiring = panels(tiles, panel);
+  REQUIRE(wiring.finish(6 * 20));
+  const Coord3D fixture(16, 8, 1);  // one empty column at x 0
+  auto none = [](Coord3D&) {};
+
+  // the whole fixture, and windows of a layer (startPct / endPct)
+  const Coord3D windows[][2] = {{{0, 0, 0}, fixture}, {{3, 2, 0}, {9, 5, 1}}, {{0, 4, 0}, {16, 4, 1}}};
+  for (auto& window : windows) {
+    MappingDescriptor mapping = descriptor(wiring, window[0], window[1], window[1]);
+    Pairs table = tablePairs(wiring, window[0], window[1], window[1], none);
+    CHECK(runPairs(mapping) == table);
+    CHECK(mapping.unique());
+
+    size_t lights, runs;
+    mapping.count(lights, runs);
+    CHECK_EQ(lights, table.size());
+    bool each = true;  // per light as forEachLightIndex
+    for (const auto& pair : table) {
+      uint32_t found = UINT32_MAX;
+      mapping.forEachIndexP(pair.first, [&](uint32_t indexP) { found = indexP; });
+      each &= found == pair.second;
+    }
+    CHECK(each);
+  }
+
+  // Mirror modifier on x and y: the window folded in two, the middle column once
+  Coord3D mirrored((fixture.x + 1) / 2, (fixture.y + 1) / 2, 1);
+  auto mirror = [&](Coord3D& position) {
+    if (position.x >= mirrored.x) position.x = mirrored.x * 2 - 1 - position.x;
+    if (position.y >= mirrored.y) position.y = mirrored.y * 2 - 1 - position.y;
+  };
+  Pairs table = tablePairs(wiring, Coord3D(0, 0, 0), fixture, mirrored, mirror);
+  MappingDescriptor mapping = descriptor(wiring, Coord3D(0, 0, 0), fixture, mirrored);
+  REQUIRE(fitTable(mapping, table));
+  CHECK(mapping.mirror[0]);
+  CHECK(mapping.mirror[1]);
+  CHECK_FALSE(mapping.unique());
+  CHECK(runPairs(mapping) == table);
+
+  // Multiply modifier 3 x 2, without and with mirror, on an odd window
+  const Coord3D window(15, 8, 1);
+  Coord3D multiplied(5, 4, 1);
+  for (bool mirrorCopies : {false, true}) {
+    auto multiply = [&](Coord3D& position) {
+      Coord3D copy = position / multiplied;
+      position = position % multiplied;
+      if (mirrorCopies && copy.x % 2) position.x = multiplied.x - 1 - position.x;
+      if (mirrorCopies && copy.y % 2) position.y = multiplied.y - 1 - position.y;
+    };
+    Pairs table = tablePairs(wiring, Coord3D(1, 0, 0), window, multiplied, multiply);
+    MappingDescriptor mapping = descriptor(wiring, Coord3D(1, 0, 0), window, multiplied);
+    REQUIRE(fitTable(mapping, table));
+    CHECK_EQ(mapping.copies[0], 3);
+    CHECK_EQ(mapping.mirror[0], mirrorCopies);
+    CHECK(runPairs(mapping) == table);
+  }
+
+  // a modifier that is no fold (transpose) keeps the table
+  Coord3D square(8, 8, 1);
+  auto transpose = [](Coord3D& position) { std::swap(position.x, position.y); };
+  Pairs transposed = tablePairs(wiring, Coord3D(0, 0, 0), square, square, transpose);
+  MappingDescriptor noFold = descriptor(wiring, Coord3D(0, 0, 0), square, square);
+  CHECK_FALSE(fitTable(noFold, transposed));
+  CHECK(noFold.unique());
+}
+
+TEST_CASE("MappingDescriptor benchmark: compositing a panel wall through a table and through runs") {
+  // 128 x 128: 8 x 8 panels of 16 x 16, serpentine, panels wired in serpentine columns
+  LightGrid tiles;
+  tiles.size[0] = tiles.size[1] = 8;
+  tiles.axes[1] = 0;
+  tiles.axes[2] = 1;
+  tiles.snake[2] = true;
+  GridWiring wiring = panels(tiles, serpentinePanel(Coord3D(0, 0, 0), 16, 16));
+  const size_t nrOfLights = 128 * 128;
+  REQUIRE(wiring.finish(nrOfLights));
+  MappingDescriptor mapping = descriptor(wiring, Coord3D(0, 0, 0), Coord3D(128, 128, 1), Coord3D(128, 128, 1));
+
+  std::vector<uint32_t> table(nrOfLights);  // as PhysMap on PSRAM boards: 4 bytes per light
+  wiring.forEachLight([&](Coord3D position, uint32_t indexP) { table[position.x + position.y * 128] = indexP; });
+
+  std::vector<uint8_t> virtualChannels(nrOfLights * 3), viaTable(nrOfLights * 3), viaRuns(nrOfLights * 3);
+  for (size_t n = 0; n < virtualChannels.size(); n++) virtualChannels[n] = n * 31 + 7;
+  const int frames = 200;
+
+  // the best of 5 rounds, the two alternating: the same cache and clock state for both
+  double tableUs = 1e9, runsUs = 1e9;
+  for (int round = 0; round < 5; round++) {
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+      const uint8_t* src = virtualChannels.data();
+      for (size_t indexV = 0; indexV < nrOfLights; indexV++) addLight(&viaTable[table[indexV] * 3], &src[indexV * 3]);
+    }
+    tableUs = std::min(tableUs, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames);
+
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+      uint8_t* src = virtualChannels.data();
+      uint8_t* dst = viaRuns.data();
+      mapping.forEachRun([&](uint32_t indexV, uint32_t count, const MappingRun& run) { compositeFadeRGBRun(&src[indexV * 3], &dst[run.indexP * 3], count, run.step, run.odd, 255, 0); });
+    }
+    runsUs = std::min(runsUs, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames);
+  }
+
+  CHECK(viaRuns == viaTable);
+  size_t lights, runs;
+  mapping.count(lights, runs);
+  CHECK_EQ(lights, nrOfLights);
+  MESSAGE("128x128 serpentine panel wall: mapping table " << table.size() * sizeof(uint32_t) << " bytes, " << tableUs << " us per frame; descriptor " << sizeof(MappingDescriptor) << " bytes, " << runs << " runs, "
+                                                           << runsUs << " us per frame");
+}
@@ -0,0 +1,321 @@
+/**
+    @title     MoonLight Unit Tests — MemBudget
+    @file      test_mem_budget.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the heap accounting per subsystem (src/MoonBase/utilities/MemBudget.h) through the real
+    allocHeapMB / allocMB / reallocMB / reallocMB2 / freeMB of MemAlloc.h, on a fake heap of fixed size
+    (native_heap_caps.h): used and peak per tag, tags found again by pointer on free and realloc, budgets (also
+    when growing a block passed without its tag), node buffers in a NodePoolScope accounted as nodes, the degradation
+    levels before the heap or the internal RAM runs out and the way back, a full block table, JSON accounted outside
+    the budgets and levels, and the arena for short-lived JSON.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <vector>
+
+#include "native_heap_caps.h"  // before MemAlloc.h
+#include "MemAlloc.h"
+
+TEST_CASE("MemBudget: used, peak and blocks per tag, tags found again on free") {
+  NativeHeapScope heap(100000);
+
+  uint8_t* channels = allocHeapMB<uint8_t>(3000, "channels", MemChannels);
+  uint8_t* layer1 = allocHeapMB<uint8_t>(2000, "layer", MemLayers);
+  uint8_t* layer2 = allocHeapMB<uint8_t>(2000, "layer", MemLayers);
+  uint8_t* json = allocHeapMB<uint8_t>(100, "json", MemJson);
+  uint8_t* other = allocHeapMB<uint8_t>(50);
+  CHECK_EQ(memBudget.stats(MemChannels).used, 3000u);
+  CHECK_EQ(memBudget.stats(MemLayers).used, 4000u);
+  CHECK_EQ(memBudget.stats(MemLayers).blocks, 2u);
+  CHECK_EQ(memBudget.stats(MemJson).used, 100u);
+  CHECK_EQ(memBudget.total(), nativeHeap().used);
+
+  // freeMB finds the tag of tracked blocks by pointer, JsonRAMAllocator passes MemJson
+  freeMB(layer1);
+  freeMB(json, "json", MemJson);
+  freeMB(other);
+  CHECK_FALSE(layer1);
+  CHECK_EQ(memBudget.stats(MemLayers).used, 2000u);
+  CHECK_EQ(memBudget.stats(MemLayers).peak, 4000u);
+  CHECK_EQ(memBudget.stats(MemLayers).blocks, 1u);
+  CHECK_EQ(memBudget.stats(MemJson).used, 0u);
+  CHECK_EQ(memBudget.stats(MemOther).used, 0u);
+  CHECK_EQ(memBudget.total(), nativeHeap().used);
+
+  freeMB(layer2);
+  freeMB(channels);
+  CHECK_EQ(memBudget.total(), 0u);
+  CHECK_EQ(memBudget.stats(MemChannels).peak, 3000u);
+  CHECK(nativeHeap().blocks.empty());
+  CHECK_EQ(nativeHeap().foreignFrees, 0u);
+}
+
+TEST_CASE("MemBudget: realloc keeps the tag of the block") {
+  NativeHeapScope heap(100000);
+
+  // channelsD grows by doubling in pass 1 and is resized to nrOfChannels at its end, without passing its tag again
+  uint8_t* channels = nullptr;
+  size_t channelsSize = 0;
+  reallocMB2(channels, channelsSize, 768, "channels", MemChannels);
+  REQUIRE(channels);
+  for (size_t bytes = 1536; bytes <= 12288; bytes *= 2) reallocMB2(channels, channelsSize, bytes);
+  CHECK_EQ(channelsSize, 12288u);
+  CHECK_EQ(memBudget.stats(MemChannels).used, 12288u);
+  reallocMB2(channels, channelsSize, 9000);  // shrunk
+  CHECK_EQ(memBudget.stats(MemChannels).used, 9000u);
+  CHECK_EQ(memBudget.stats(MemChannels).peak, 12288u);
+  CHECK_EQ(memBudget.stats(MemChannels).blocks, 1u);
+  CHECK_EQ(memBudget.stats(MemOther).used, 0u);
+
+  uint8_t* json = reallocMB<uint8_t>(nullptr, 64, "json", MemJson);  // untracked: the caller passes the tag every time
+  json = reallocMB(json, 256, "json", MemJson);
+  CHECK_EQ(memBudget.stats(MemJson).used, 256u);
+
+  freeMB(channels);
+  freeMB(json, "json", MemJson);
+  CHECK_EQ(memBudget.total(), 0u);
+  CHECK(nativeHeap().blocks.empty());
+}
+
+TEST_CASE("MemBudget: a budget denies what would exceed it, also when growing a block passed without its tag") {
+  NativeHeapScope heap(100000);
+  memBudget.setBudget(MemMonitor, 10000);
+
+  uint8_t* previous = allocHeapMB<uint8_t>(6000, "monitor", MemMonitor);
+  REQUIRE(previous);
+  CHECK(allocHeapMB<uint8_t>(6000, "monitor", MemMonitor) == nullptr);  // not tried: the heap is untouched
+  CHECK_EQ(memBudget.stats(MemMonitor).denied, 1u);
+  CHECK_EQ(memBudget.stats(MemMonitor).failed, 0u);
+  CHECK_EQ(nativeHeap().used, 6000u);
+
+  // reallocHeapMB admits the growth for the tag of the old block, not the MemOther it is called with
+  CHECK(reallocMB(previous, 12000) == nullptr);
+  CHECK_EQ(memBudget.stats(MemMonitor).denied, 2u);
+  CHECK_EQ(memBudget.stats(MemOther).denied, 0u);
+  CHECK_EQ(nativeHeap().size(previous), 6000u);  // the block is kept
+  size_t previousSize = 6000;
+  reallocMB2(previous, previousSize, 12000);
+  CHECK_EQ(previousSize, 6000u);  // reallocMB2 keeps the old block and size
+  reallocMB2(previous, previousSize, 9000);
+  CHECK_EQ(previousSize, 9000u);
+  CHECK_EQ(memBudget.stats(MemMonitor).used, 9000u);
+
+  uint8_t* other = allocHeapMB<uint8_t>(50000);  // other tags are not limited by it
+  CHECK(other != nullptr);
+  freeMB(other);
+  freeMB(previous);
+  CHECK_EQ(memBudget.total(), 0u);
+  CHECK(memBudget.level() == MemDegradeNone);  // plenty of heap all along, no reserve set
+}
+
+TEST_CASE("MemBudget: node buffers the pool cannot hold are accounted as nodes") {
+  NativeHeapScope heap(100000);
+  std::vector<uint8_t> region(4096);
+  NodePool pool;
+  REQUIRE(pool.init(region.data(), region.size()));
+  uint16_t owner = pool.newOwner();
+
+  uint8_t* small = nullptr;
+  uint8_t* big = nullptr;
+  uint8_t* grown = nullptr;
+  uint16_t* resized = nullptr;
+  size_t grownSize = 0;
+  {
+    NodePoolScope scope(&pool, owner);  // as in addNode / loopNodes
+    small = allocMB<uint8_t>(100);
+    CHECK_EQ(NodePool::owning(small), &pool);
+    CHECK_EQ(memBudget.total(), 0u);  // the pool is one block, accounted where it is allocated
+
+    big = allocMB<uint8_t>(8000);  // too big for the pool: the heap, MemOther becomes MemNodes
+    REQUIRE(big);
+    CHECK_FALSE(NodePool::owning(big));
+    CHECK_EQ(memBudget.stats(MemNodes).used, 8000u);
+    CHECK_EQ(memBudget.stats(MemOther).used, 0u);
+
+    reallocMB2(grown, grownSize, 200);  // from the pool, then grows out of it onto the heap, as nodes
+    CHECK_EQ(NodePool::owning(grown), &pool);
+    grown[0] = 42;
+    reallocMB2(grown, grownSize, 6000);
+    CHECK_FALSE(NodePool::owning(grown));
+    CHECK_EQ(grown[0], 42);
+    CHECK_EQ(memBudget.stats(MemNodes).used, 14000u);
+
+    resized = reallocMB<uint16_t>(nullptr, 3000);  // reallocHeapMB of a new block in a scope: nodes too
+    CHECK_EQ(memBudget.stats(MemNodes).used, 20000u);
+    CHECK_EQ(memBudget.stats(MemOther).used, 0u);
+  }
+
+  uint8_t* outside = allocMB<uint8_t>(100);  // no scope: the heap, as other
+  CHECK_FALSE(NodePool::owning(outside));
+  CHECK_EQ(memBudget.stats(MemOther).used, 100u);
+
+  freeMB(big);  // no tag given: found by pointer
+  freeMB(grown);
+  freeMB(resized);
+  freeMB(small);  // back to the pool, not the heap
+  freeMB(outside);
+  CHECK_EQ(memBudget.stats(MemNodes).used, 0u);
+  CHECK_EQ(memBudget.stats(MemNodes).blocks, 0u);
+  CHECK_EQ(memBudget.total(), 0u);
+  CHECK_EQ(pool.stats().used, 0u);
+  CHECK(nativeHeap().blocks.empty());
+  CHECK_EQ(nativeHeap().foreignFrees, 0u);
+  pool.release();
+}
+
+TEST_CASE("MemBudget: degradation before the heap runs out, and back with hysteresis") {
+  NativeHeapScope heap(10000);
+  memBudget.setReserve(1000);  // monitor off below 3000 free, caches off below 2000, no new nodes below 1000
+
+  uint8_t* layers = allocHeapMB<uint8_t>(6000, "layers", MemLayers);
+  CHECK(memBudget.level() == MemDegradeNone);  // 4000 free
+  uint8_t* mapping = allocHeapMB<uint8_t>(1500, "mapping", MemMapping);
+  CHECK(memBudget.level() == MemDegradeMonitor);  // 2500 free: raised by the allocation itself, before the next update
+  CHECK(memBudget.degraded(MemDegradeMonitor));
+  CHECK_FALSE(memBudget.degraded(MemDegradeCaches));
+  uint8_t* nodes = allocHeapMB<uint8_t>(1000, "nodes", MemNodes);
+  CHECK(memBudget.level() == MemDegradeCaches);  // 1500 free
+  CHECK_EQ(memBudget.raised(), 2u);
+
+  CHECK(allocHeapMB<uint8_t>(2000, "nodes", MemNodes) == nullptr);  // the heap has no room: the next level
+  CHECK_EQ(memBudget.stats(MemNodes).failed, 1u);
+  CHECK(memBudget.level() == MemDegradeNodes);
+  CHECK(memBudget.degraded(MemDegradeMonitor));
+
+  // the level steps down one per update while the heap is half a reserve above the threshold of the level
+  CHECK(memBudget.update(memFreeBytes(), memFreeInternal()));  // 1500 free: 1000 + 500
+  CHECK(memBudget.level() == MemDegradeCaches);
+  CHECK_FALSE(memBudget.update(memFreeBytes(), memFreeInternal()));  // not 2000 + 500
+  CHECK(memBudget.level() == MemDegradeCaches);
+
+  freeMB(nodes);  // the subsystems shed: 2500 free
+  CHECK(memBudget.update(memFreeBytes(), memFreeInternal()));
+  CHECK(memBudget.level() == MemDegradeMonitor);
+  CHECK_FALSE(memBudget.update(memFreeBytes(), memFreeInternal()));  // 2500 < 3000 + 500
+  CHECK(memBudget.level() == MemDegradeMonitor);
+  freeMB(mapping);  // 4000 free
+  CHECK(memBudget.update(memFreeBytes(), memFreeInternal()));
+  CHECK(memBudget.level() == MemDegradeNone);
+  CHECK(memBudget.peakLevel() == MemDegradeNodes);
+
+  CHECK_FALSE(memBudget.update(memFreeBytes(), memFreeInternal()));
+  freeMB(layers);
+  CHECK_EQ(memBudget.total(), 0u);
+}
+
+TEST_CASE("MemBudget: internal RAM degrades on its own reserve, whichever heap is lower") {
+  NativeHeapScope heap(1000000);  // plenty of PSRAM
+  memBudget.setReserve(64000, 1000);
+  nativeHeap().internalFree = 5000;
+
+  uint8_t* layers = allocHeapMB<uint8_t>(1000, "layers", MemLayers);  // the heap is fine, so is internal RAM
+  CHECK(memBudget.level() == MemDegradeNone);
+
+  nativeHeap().internalFree = 1500;  // e.g. WiFi and task stacks: below 2 internal reserves, the heap is not
+  CHECK(memBudget.update(memFreeBytes(), memFreeInternal()));
+  CHECK(memBudget.level() == MemDegradeCaches);
+  uint8_t* monitor = allocHeapMB<uint8_t>(1000, "monitor", MemMonitor);  // admitted (PSRAM), the level stays
+  CHECK(monitor != nullptr);
+  CHECK(memBudget.level() == MemDegradeCaches);
+
+  nativeHeap().internalFree = 3200;  // internal RAM back, but the level only drops when both heaps allow it
+  CHECK(memBudget.update(memFreeBytes(), memFreeInternal()));  // 3200 >= 2000 + 500
+  CHECK(memBudget.level() == MemDegradeMonitor);
+  nativeHeap().capacity = 150000;  // the heap now below 3 reserves of its own
+  CHECK_FALSE(memBudget.update(memFreeBytes(), memFreeInternal()));  // 3200 >= 3000 + 500 fails anyway
+  nativeHeap().internalFree = 5000;
+  CHECK_FALSE(memBudget.update(memFreeBytes(), memFreeInternal()));  // internal fine, the heap is not: kept
+  CHECK(memBudget.level() == MemDegradeMonitor);
+  nativeHeap().capacity = 1000000;
+  CHECK(memBudget.update(memFreeBytes(), memFreeInternal()));
+  CHECK(memBudget.level() == MemDegradeNone);
+
+  freeMB(monitor);
+  freeMB(layers);
+  CHECK_EQ(memBudget.total(), 0u);
+}
+
+TEST_CASE("MemBudget: blocks beyond the table are accounted as other, on both ends") {
+  NativeHeapScope heap(1000000);
+
+  uint8_t* blocks[MEM_BLOCKS_MAX + 4];
+  for (uint8_t*& block : blocks) block = allocHeapMB<uint8_t>(100, "nodes", MemNodes);
+  CHECK_EQ(memBudget.stats(MemNodes).used, (size_t)MEM_BLOCKS_MAX * 100);
+  CHECK_EQ(memBudget.stats(MemOther).used, 400u);
+  CHECK_EQ(memBudget.total(), nativeHeap().used);
+
+  freeMB(blocks[0]);  // a tracked block, its table entry is free again
+  uint8_t* again = allocHeapMB<uint8_t>(100, "nodes", MemNodes);
+  CHECK_EQ(memBudget.stats(MemNodes).used, (size_t)MEM_BLOCKS_MAX * 100);
+
+  for (size_t n = 1; n < MEM_BLOCKS_MAX + 4; n++) freeMB(blocks[n]);
+  freeMB(again);
+  CHECK_EQ(memBudget.stats(MemNodes).used, 0u);
+  CHECK_EQ(memBudget.stats(MemOther).used, 0u);
+  CHECK_EQ(memBudget.total(), 0u);
+}
+
+TEST_CASE("MemBudget: JSON is accounted, but not held to a budget or the levels") {
+  NativeHeapScope heap(10000);
+  memBudget.setReserve(1000);
+  memBudget.setBudget(MemJson, 100);  // ignored: module state must load
+
+  ArduinoJson::Allocator* allocator = JsonRAMAllocator::instance();
+  void* document = allocator->allocate(6000);
+  REQUIRE(document != nullptr);
+  CHECK(memBudget.level() == MemDegradeNone);  // 4000 free would be monitor off for other tags: JSON does not raise it
+  document = allocator->reallocate(document, 7500);
+  REQUIRE(document != nullptr);
+  CHECK(memBudget.level() == MemDegradeNone);
+  CHECK_EQ(memBudget.stats(MemJson).used, 7500u);
+  CHECK_EQ(memBudget.stats(MemJson).blocks, 1u);
+  CHECK_EQ(memBudget.stats(MemJson).denied, 0u);
+  CHECK_EQ(memBudget.total(), nativeHeap().used);
+
+  CHECK(memBudget.update(memFreeBytes(), memFreeInternal()));  // the next update sees the heap it took
+  CHECK(memBudget.level() == MemDegradeMonitor);
+
+  allocator->deallocate(document);
+  CHECK_EQ(memBudget.stats(MemJson).used, 0u);
+  CHECK_EQ(memBudget.stats(MemJson).peak, 7500u);
+  CHECK_EQ(memBudget.stats(MemJson).blocks, 0u);
+  CHECK(nativeHeap().blocks.empty());
+}
+
+TEST_CASE("MemBudget: a JSON arena allocates once, resets per document, overflows to the heap") {
+  NativeHeapScope heap(100000);
+  {
+    JsonArenaAllocator arena(256);
+    ArduinoJson::Allocator& allocator = arena;
+    void* pool = allocator.allocate(100);
+    REQUIRE(pool != nullptr);
+    CHECK(arena.owns(pool));
+    CHECK_EQ(nativeHeap().blocks.size(), 1u);  // the arena buffer, allocated on first use
+
+    memset(pool, 7, 100);
+    CHECK_EQ(allocator.reallocate(pool, 120), pool);  // the last block grows in place
+    void* text = allocator.allocate(24);
+    void* grown = allocator.reallocate(pool, 130);  // not the last block any more: moved, contents kept
+    CHECK(grown != pool);
+    CHECK(arena.owns(grown) == false);  // 8 + 120 + 8 + 24 + 8 + 130 > 256: to the heap
+    CHECK_EQ(((uint8_t*)grown)[99], 7);
+    CHECK_EQ(nativeHeap().blocks.size(), 2u);
+    allocator.deallocate(text);  // arena blocks: freed by reset
+    allocator.deallocate(grown);
+    CHECK_EQ(nativeHeap().blocks.size(), 1u);
+
+    size_t used = arena.used();
+    arena.reset();  // the next document
+    CHECK_EQ(arena.used(), 0u);
+    CHECK_EQ(allocator.allocate(100), pool);  // the same memory again, no heap call
+    CHECK(used > 0);
+    CHECK_EQ(nativeHeap().blocks.size(), 1u);
+  }
+  CHECK(nativeHeap().blocks.empty());  // the buffer is freed with the arena
+  CHECK_EQ(nativeHeap().foreignFrees, 0u);
+}
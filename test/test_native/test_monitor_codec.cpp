@@ -0,0 +1,166 @@
+/**
+    @title     MoonLight Unit Tests — MonitorCodec
+    @file      test_monitor_codec.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the compressed monitor stream (keyframes, XOR deltas, run-length coding, downsampling).
+    The benchmark encodes effect-like frames of 16K RGB lights and reports compression ratio and throughput.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "MoonLight/Layers/MonitorCodec.h"
+
+namespace {
+
+struct Stream {
+  MonitorEncoder encoder;
+  std::vector<uint8_t> previous, out, client;
+  uint32_t nrOfLights;
+  uint8_t channelsPerLight, step;
+
+  Stream(uint32_t nrOfLights, uint8_t channelsPerLight, uint8_t step = 1) : nrOfLights(nrOfLights), channelsPerLight(channelsPerLight), step(step) {
+    size_t length = monitorFrameLength(nrOfLights, channelsPerLight, step);
+    previous.resize(length);
+    out.resize(monitorMaxEncodedSize(length));
+    client.resize(length);
+  }
+  // encode and decode one frame, returns the encoded size (0 = decode failed)
+  size_t send(const std::vector<uint8_t>& channels) {
+    size_t size = encoder.encode(channels.data(), nrOfLights, channelsPerLight, step, previous.data(), out.data());
+    CHECK(size <= out.size());
+    return decodeMonitorFrame(out.data(), size, client.data(), client.size()) ? size : 0;
+  }
+};
+
+// gradient bands moving over a dark background, a few lights changing color each frame:
+// what most effects look like frame to frame
+void renderFrame(std::vector<uint8_t>& channels, uint32_t nrOfLights, int frame) {
+  for (uint32_t i = 0; i < nrOfLights; i++) {
+    uint8_t* rgb = &channels[i * 3];
+    bool lit = ((i + frame) % 128) < 40;
+    rgb[0] = lit ? (uint8_t)(i * 2) : 0;
+    rgb[1] = lit ? (uint8_t)(128 + 127 * sinf(i * 0.05f)) : 0;
+    rgb[2] = lit ? 200 : 0;
+    if (i % 997 == (uint32_t)frame % 997) rgb[2] = frame;  // some sparkle
+  }
+}
+
+}  // namespace
+
+TEST_CASE("MonitorCodec: keyframe then deltas reproduce every frame") {
+  const uint32_t nrOfLights = 1000;
+  Stream stream(nrOfLights, 3);
+  std::vector<uint8_t> channels(nrOfLights * 3);
+  for (int frame = 0; frame < 120; frame++) {
+    renderFrame(channels, nrOfLights, frame);
+    REQUIRE(stream.send(channels));
+    CHECK(stream.client == channels);
+    CHECK_EQ((stream.out[1] & MONITOR_FLAG_KEYFRAME) != 0, frame % (stream.encoder.keyframeInterval + 1) == 0);
+  }
+}
+
+TEST_CASE("MonitorCodec: unchanged frame is a few bytes") {
+  const uint32_t nrOfLights = 16384;
+  Stream stream(nrOfLights, 3);
+  std::vector<uint8_t> channels(nrOfLights * 3, 42);
+  REQUIRE(stream.send(channels));
+  CHECK(stream.send(channels) <= MONITOR_FRAME_HEADER + 6);  // one long zero run
+  CHECK(stream.client == channels);
+}
+
+TEST_CASE("MonitorCodec: noise does not grow beyond the worst case") {
+  const uint32_t nrOfLights = 700;
+  Stream stream(nrOfLights, 3);
+  std::vector<uint8_t> channels(nrOfLights * 3);
+  uint32_t seed = 1;
+  for (int frame = 0; frame < 5; frame++) {
+    for (uint8_t& c : channels) c = (seed = seed * 1103515245 + 12345) >> 16;
+    size_t size = stream.send(channels);
+    REQUIRE(size);
+    CHECK(size <= monitorMaxEncodedSize(channels.size()));
+    CHECK(stream.client == channels);
+  }
+}
+
+TEST_CASE("MonitorCodec: runs of every length round trip") {
+  for (uint32_t run : {1u, 2u, 3u, 4u, 127u, 128u, 129u, 130u, 131u, 255u, 256u, 1000u, 20000u}) {
+    CAPTURE(run);
+    std::vector<uint8_t> channels;
+    for (uint32_t i = 0; i < run; i++) channels.push_back(7);
+    for (int i = 0; i < 300; i++) channels.push_back(i);  // literals crossing the 128 block boundary
+    while (channels.size() % 3) channels.push_back(9);
+    Stream stream(channels.size() / 3, 3);
+    stream.encoder.requestKeyframe();
+    REQUIRE(stream.send(channels));
+    CHECK(stream.client == channels);
+  }
+}
+
+TEST_CASE("MonitorCodec: downsampling sends every step-th light") {
+  const uint32_t nrOfLights = 10;
+  Stream stream(nrOfLights, 3, 4);  // lights 0, 4, 8
+  std::vector<uint8_t> channels(nrOfLights * 3);
+  for (uint32_t i = 0; i < channels.size(); i++) channels[i] = i;
+  REQUIRE(stream.send(channels));
+  CHECK_EQ(stream.out[3], 4);
+  REQUIRE_EQ(stream.client.size(), 9);
+  const uint8_t expected[9] = {0, 1, 2, 12, 13, 14, 24, 25, 26};
+  for (int i = 0; i < 9; i++) CHECK_EQ(stream.client[i], expected[i]);
+}
+
+TEST_CASE("MonitorCodec: frames are never the size of the header message") {
+  for (uint32_t nrOfLights = 1; nrOfLights < 40; nrOfLights++) {
+    Stream stream(nrOfLights, 3);
+    std::vector<uint8_t> channels(nrOfLights * 3);
+    for (uint32_t i = 0; i < channels.size(); i++) channels[i] = i * 37;  // no runs
+    stream.encoder.requestKeyframe();
+    size_t size = stream.send(channels);
+    REQUIRE(size);
+    CHECK(size != 47);
+    CHECK(stream.client == channels);
+  }
+}
+
+TEST_CASE("MonitorCodec: malformed frames are rejected") {
+  std::vector<uint8_t> frame(30);
+  const uint8_t wrongMagic[] = {'X', 1, 3, 1, 3, 0, 0, 0, 2, 1, 2, 3};
+  CHECK_EQ(decodeMonitorFrame(wrongMagic, sizeof(wrongMagic), frame.data(), frame.size()), 0);
+  const uint8_t tooLong[] = {'M', 1, 3, 1, 100, 0, 0, 0, 0x80, 5};  // 100 bytes don't fit in 30
+  CHECK_EQ(decodeMonitorFrame(tooLong, sizeof(tooLong), frame.data(), frame.size()), 0);
+  const uint8_t truncated[] = {'M', 1, 3, 1, 6, 0, 0, 0, 5, 1, 2};  // 6 literals announced, 2 present
+  CHECK_EQ(decodeMonitorFrame(truncated, sizeof(truncated), frame.data(), frame.size()), 0);
+  const uint8_t overrun[] = {'M', 1, 3, 1, 3, 0, 0, 0, 0x81, 5};  // run of 4 in a 3 byte frame
+  CHECK_EQ(decodeMonitorFrame(overrun, sizeof(overrun), frame.data(), frame.size()), 0);
+}
+
+TEST_CASE("MonitorCodec benchmark: 16K RGB lights") {
+  const uint32_t nrOfLights = 16384;
+  const int frames = 200;
+  std::vector<uint8_t> channels(nrOfLights * 3);
+
+  for (uint8_t step : {1, 4}) {
+    Stream stream(nrOfLights, 3, step);
+    size_t bytes = 0;
+    double encodeUs = 0;
+    for (int frame = 0; frame < frames; frame++) {
+      renderFrame(channels, nrOfLights, frame);
+      auto start = std::chrono::steady_clock::now();
+      size_t size = stream.encoder.encode(channels.data(), nrOfLights, 3, step, stream.previous.data(), stream.out.data());
+      encodeUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+      bytes += size;
+      REQUIRE(decodeMonitorFrame(stream.out.data(), size, stream.client.data(), stream.client.size()));
+    }
+    double ratio = (double)channels.size() * frames / bytes;
+    if (step == 1) CHECK(ratio > 4);
+    MESSAGE("step " << (int)step << ": raw " << channels.size() << " bytes/frame, encoded " << bytes / frames << " bytes/frame (ratio " << ratio << "), encode " << encodeUs / frames << " us/frame, "
+                    << channels.size() * frames / encodeUs << " MB/s");
+  }
+}
@@ -0,0 +1,244 @@
+/**
+    @title     MoonLight Unit Tests — NodePool
+    @file      test_node_pool.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the size-class pool of node objects and buffers (src/MoonBase/utilities/NodePool.h), and a
+    fragmentation stress test: switching through every registered effect for hours must not grow the pool.
+    Nodes and buffers are allocated with the real allocMBObject / allocMB / reallocMB2 / freeMB of MemAlloc.h, the heap
+    is native_heap_caps.h. The effects of the stress test are stand-ins (the real ones need FastLED): object sizes and
+    buffers per effect vary as in the registry, buffers follow the layer size and some effects leak.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "native_heap_caps.h"  // before MemAlloc.h
+#include "MemAlloc.h"
+#include "NodePool.h"
+#include "NodeRegistry.h"
+
+namespace {
+
+// the layer: its size and pool
+struct FakeLayer {
+  int width = 16, height = 16;
+  NodePool nodePool;
+  std::vector<uint8_t> region;
+
+  explicit FakeLayer(size_t capacity) : region(capacity) { nodePool.init(region.data(), capacity); }
+};
+
+struct FakeNode {
+  FakeLayer* layer = nullptr;
+  uint16_t poolOwner = 0;
+  virtual ~FakeNode() = default;
+  virtual void setup() {}
+  virtual void onSizeChanged() {}
+};
+
+// an effect of the registry: object size and buffers differ per effect, buffers depend on the layer size
+template <int N>
+struct StressEffect : FakeNode {
+  static const char* name() {
+    static std::string name = "Stress Effect " + std::to_string(N);
+    return name.c_str();
+  }
+  static uint8_t dim() { return 2; }
+  static const char* tags() { return "🔥"; }
+  static const char* category() { return "Stress"; }
+
+  uint8_t state[16 + (N * 53) % 700] = {};  // the node object: 16 .. 716 bytes + vtable
+  uint8_t* cells = nullptr;
+  size_t cellsSize = 0;
+  uint16_t* history = nullptr;
+  size_t historySize = 0;
+  uint32_t* particles = nullptr;  // N % 9 == 0: a particle buffer, which N % 18 == 0 forget to free (a leak)
+  size_t particlesSize = 0;
+
+  void setup() override {
+    if (N % 9 == 0) reallocMB2(particles, particlesSize, 32 + N);
+  }
+  void onSizeChanged() override {
+    size_t lights = layer->width * layer->height;
+    reallocMB2(cells, cellsSize, (lights * (1 + N % 4) + 7) / 8 + N % 5 * 100);
+    if (N % 3 == 0) reallocMB2(history, historySize, layer->width * (N % 7 + 1));
+  }
+  ~StressEffect() override {
+    if (cells) freeMB(cells);
+    if (history) freeMB(history);
+    if (particles && N % 18 != 0) freeMB(particles);
+  }
+};
+
+#define STRESS_EFFECTS 95  // as many as ModuleEffects registers
+typedef NodeRegistry<FakeNode> Registry;
+
+template <int... N>
+void registerEffects(Registry& registry, std::integer_sequence<int, N...>) {
+  (registry.add<StressEffect<N>>([]() -> FakeNode* { return allocMBObject<StressEffect<N>>(); }), ...);
+}
+
+// what ModuleEffects::addNode and NodeManager::handleNodeNameChange do: the new node is added before the old one is freed
+FakeNode* replaceNode(FakeLayer& layer, FakeNode* oldNode, const Registry::Type& type) {
+  uint16_t owner = layer.nodePool.newOwner();
+  FakeNode* node;
+  {
+    NodePoolScope scope(&layer.nodePool, owner);
+    node = type.create();
+    node->layer = &layer;
+    node->poolOwner = owner;
+    node->setup();
+    node->onSizeChanged();
+  }
+  if (oldNode) {
+    uint16_t oldOwner = oldNode->poolOwner;
+    freeMBObject(oldNode);
+    layer.nodePool.releaseOwner(oldOwner);
+  }
+  return node;
+}
+
+void resize(FakeLayer& layer, FakeNode* node, int width, int height) {
+  layer.width = width;
+  layer.height = height;
+  NodePoolScope scope(&layer.nodePool, node->poolOwner);  // as VirtualLayer::loopNodes
+  node->onSizeChanged();
+}
+
+}  // namespace
+
+TEST_CASE("NodePool: size classes, reuse of freed blocks, end trimmed") {
+  std::vector<uint8_t> region(64 * 1024);
+  NodePool pool;
+  REQUIRE(pool.init(region.data(), region.size()));
+  CHECK_EQ(NodePool::classSize(NodePool::classOf(1)), 32);
+  CHECK_EQ(NodePool::classSize(NodePool::classOf(33)), 48);
+  CHECK_EQ(NodePool::classSize(NodePool::classOf(100)), 128);
+  CHECK_EQ(NodePool::classSize(NodePool::classOf(1000)), 1024);
+  CHECK_EQ(NodePool::classSize(NodePool::classOf(1025)), 1536);
+
+  void* a = pool.allocate(100, 1);
+  void* b = pool.allocate(500, 1);
+  void* c = pool.allocate(20, 2);
+  REQUIRE(a);
+  REQUIRE(b);
+  REQUIRE(c);
+  CHECK_EQ(NodePool::owning(b), &pool);
+  CHECK_FALSE(NodePool::owning(&pool));
+  CHECK_EQ(pool.ownerOf(c), 2);
+  CHECK_EQ(((uint8_t*)b)[499], 0);  // zeroed
+  ((uint8_t*)b)[0] = 0xAA;
+
+  pool.free(b);
+  void* b2 = pool.allocate(400, 3);  // same class: the freed block
+  CHECK_EQ(b2, b);
+  CHECK_EQ(((uint8_t*)b2)[0], 0);
+  size_t reserved = pool.stats().reserved;
+
+  pool.free(c);  // the last block: given back
+  CHECK(pool.stats().reserved < reserved);
+  CHECK_EQ(pool.stats().blocks, 2);
+
+  CHECK_FALSE(pool.allocate(100 * 1024, 1));  // too big: the heap
+  CHECK_EQ(pool.stats().fallbacks, 1);
+
+  pool.free(a);
+  pool.free(b2);
+  CHECK_EQ(pool.stats().reserved, 0);  // empty: the whole region again
+  CHECK_EQ(pool.stats().used, 0);
+  CHECK_EQ(pool.release(), region.data());
+  CHECK_FALSE(NodePool::owning(region.data()));
+}
+
+TEST_CASE("NodePool: releaseOwner frees what a node left, scopes nest and route per owner") {
+  NativeHeapScope heap;
+  std::vector<uint8_t> region(16 * 1024);
+  NodePool pool;
+  REQUIRE(pool.init(region.data(), region.size()));
+  uint16_t first = pool.newOwner(), second = pool.newOwner();
+  CHECK(first != 0);
+  CHECK(first != second);
+
+  uint8_t* leak = nullptr;
+  uint8_t* kept = nullptr;
+  {
+    NodePoolScope scope(&pool, first);
+    leak = allocMB<uint8_t>(200);
+    {
+      NodePoolScope inner(&pool, second);
+      kept = allocMB<uint8_t>(200);
+    }
+    CHECK_EQ(NodePoolScope::owner(), first);
+  }
+  CHECK_FALSE(NodePoolScope::pool());
+  CHECK_EQ(pool.ownerOf(leak), first);
+  CHECK_EQ(pool.ownerOf(kept), second);
+  {
+    NodePoolScope scope(&pool, 0);  // owner 0: not a pool node, the heap
+    CHECK_FALSE(NodePoolScope::pool());
+  }
+
+  size_t capacity = 0;
+  uint8_t* grown = kept;
+  reallocMB2(grown, capacity, 3000);  // grows into a bigger block of the same owner
+  CHECK(grown != kept);
+  CHECK_EQ(pool.ownerOf(grown), second);
+
+  CHECK_EQ(pool.releaseOwner(first), 1);
+  CHECK_EQ(pool.stats().blocks, 1);
+  CHECK_EQ(pool.releaseOwner(second), 1);
+  CHECK_EQ(pool.stats().reserved, 0);
+  CHECK_EQ(pool.stats().leaked, 2);
+  CHECK(nativeHeap().blocks.empty());
+}
+
+TEST_CASE("NodePool stress: switching through every registered effect does not grow the pool") {
+  Registry registry;
+  registerEffects(registry, std::make_integer_sequence<int, STRESS_EFFECTS>());
+  REQUIRE_EQ(registry.size(), STRESS_EFFECTS);
+
+  NativeHeapScope heap;
+  FakeLayer layer(256 * 1024);  // NODE_POOL_SIZE
+  const int sizes[][2] = {{16, 16}, {32, 32}, {64, 32}, {128, 64}, {48, 48}};
+  FakeNode* node = nullptr;
+  size_t reservedAfterWarmup = 0;
+  const int rounds = 60;  // 5700 switches: a long evening of live effect changes
+  int switches = 0;
+  for (int round = 0; round < rounds; round++) {
+    for (const Registry::Type& type : registry) {
+      node = replaceNode(layer, node, type);
+      if (++switches % 7 == 0) {  // the layout or the layer size changes now and then
+        const int* size = sizes[(switches / 7) % 5];
+        resize(layer, node, size[0], size[1]);
+      }
+    }
+    if (round == 9) reservedAfterWarmup = layer.nodePool.stats().reservedPeak;  // every effect met every layer size
+  }
+  NodePoolStats stats = layer.nodePool.stats();
+  MESSAGE(switches << " switches: pool used " << stats.used << " (peak " << stats.usedPeak << "), reserved " << stats.reserved << " (peak " << stats.reservedPeak << " after 10 rounds "
+                   << reservedAfterWarmup << ") of " << stats.capacity << ", leaked blocks released " << stats.leaked << ", heap fallbacks " << stats.fallbacks);
+
+  CHECK_EQ(stats.fallbacks, 0);
+  CHECK(nativeHeap().blocks.empty());  // nothing went to the heap
+  CHECK_EQ(nativeHeap().foreignFrees, 0u);
+  CHECK_EQ(memBudget.stats(MemNodes).failed, 0u);
+  CHECK_EQ(stats.reservedPeak, reservedAfterWarmup);  // no growth with the number of switches
+  CHECK(stats.leaked > 0);                            // the leaking effects were released with their node
+
+  // remove the last node: the pool is empty again
+  uint16_t owner = node->poolOwner;
+  freeMBObject(node);
+  layer.nodePool.releaseOwner(owner);
+  CHECK_EQ(layer.nodePool.stats().used, 0);
+  CHECK_EQ(layer.nodePool.stats().reserved, 0);
+}
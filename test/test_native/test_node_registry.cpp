@@ -0,0 +1,231 @@
+/**
+    @title     MoonLight Unit Tests — NodeRegistry
+    @file      test_node_registry.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the table of node types of a NodeManager (src/MoonBase/utilities/NodeRegistry.h):
+    every registered name (as stored in presets, with dim and tags) resolves to the factory of its own type.
+    The node classes need FastLED and the ESP32: the real lists are the ones ModuleEffects.h and ModuleDrivers.h
+    include (EffectNodeTypes.h, DriverNodeTypes.h), registered here by name as the modules do (NodeManager checks
+    each name against name() of its class at boot).
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BoardNames.h"
+#include "NodeRegistry.h"
+
+namespace {
+
+struct FakeNode {
+  virtual ~FakeNode() = default;
+  virtual const char* typeName() const = 0;
+};
+
+// node types as in the Nodes folders: static name, dim (_1D=1, _2D=2, _3D=3, _NoD=4), tags and category
+#define FAKE_NODE(Class, Name, Dim, Tags, Category)                  \
+  struct Class : FakeNode {                                          \
+    static const char* name() { return Name; }                       \
+    static uint8_t dim() { return Dim; }                             \
+    static const char* tags() { return Tags; }                       \
+    static const char* category() { return Category; }               \
+    const char* typeName() const override { return #Class; }         \
+  };
+
+FAKE_NODE(SolidEffect, "Solid", 3, "🔥", "MoonLight")
+FAKE_NODE(StarSkyEffect, "Star Sky", 3, "🔥", "MoonLight")
+FAKE_NODE(GEQ3DEffect, "GEQ 3D", 3, "🐙♫", "MoonModules")
+FAKE_NODE(GEQEffect, "GEQ", 2, "🐙♫", "WLED")
+FAKE_NODE(DNAEffect, "DNA", 2, "🐙", "WLED")
+FAKE_NODE(Troy1ColorEffect, "Troy1 Color", 1, "♫💫", "Moving head")
+FAKE_NODE(MirrorModifier, "Mirror", 3, "💎", "Modifier")
+FAKE_NODE(NetworkInDriver, "Network In", 4, "☸️", "Driver")
+FAKE_NODE(SE16Layout, "SE16", 2, "🚥", "Layout")
+
+typedef NodeRegistry<FakeNode> Registry;
+
+template <typename T>
+bool registerNode(Registry& registry, const char* board = nullptr) {
+  return registry.add<T>([]() -> FakeNode* { return new T(); }, board);
+}
+
+Registry fakeRegistry() {
+  Registry types;
+  registerNode<SolidEffect>(types);
+  registerNode<StarSkyEffect>(types);
+  registerNode<GEQ3DEffect>(types);
+  registerNode<GEQEffect>(types);
+  registerNode<DNAEffect>(types);
+  registerNode<Troy1ColorEffect>(types);
+  registerNode<MirrorModifier>(types);
+  registerNode<NetworkInDriver>(types);
+  registerNode<SE16Layout>(types, "SE16 v1");
+  types.addAlias("ArtNetIn", NetworkInDriver::name());
+  return types;
+}
+
+// benchmark: a type per name
+#define NUMBERED_TYPES 95
+std::string numberedNames[NUMBERED_TYPES];
+
+template <int N>
+struct NumberedEffect : FakeNode {
+  static const char* name() { return numberedNames[N].c_str(); }
+  static uint8_t dim() { return 2; }
+  static const char* tags() { return "🐙"; }
+  static const char* category() { return "WLED"; }
+  const char* typeName() const override { return "NumberedEffect"; }
+};
+
+template <int... N>
+void registerNumbered(Registry& registry, std::integer_sequence<int, N...>) {
+  (registerNode<NumberedEffect<N>>(registry), ...);
+}
+
+std::string created(const Registry& registry, const char* name) {
+  const Registry::Type* type = registry.find(name);
+  if (!type) return "";
+  std::unique_ptr<FakeNode> node(type->create());
+  return node->typeName();
+}
+
+struct ListedNode : FakeNode {
+  static const char* current;  // name of the type being registered
+  static const char* name() { return current; }
+  static uint8_t dim() { return 3; }
+  static const char* tags() { return ""; }
+  static const char* category() { return ""; }
+  const char* typeName() const override { return "ListedNode"; }
+};
+const char* ListedNode::current = "";
+
+// registers a node type list as the module does; adds the registrations refused
+struct ModuleList {
+  std::deque<std::string> names;  // the class names, stable storage
+  Registry registry;
+  std::vector<std::string> refused;
+  size_t registrations = 0;
+
+  void node(const char* className, const char* name, const char* board = nullptr) {
+    registrations++;
+    ListedNode::current = name;
+    if (!registerNode<ListedNode>(registry, board)) refused.push_back(std::string(className) + " \"" + name + "\"");
+    names.emplace_back(className);
+  }
+  void alias(const char* alias, const char* name) {
+    if (!registry.addAlias(alias, name)) refused.push_back("alias " + std::string(alias));
+  }
+};
+
+ModuleList effectList() {
+  ModuleList list;
+#define NODE(Class, name) list.node(#Class, name);
+#define BOARD_NODE(Class, name, board) list.node(#Class, name, board);
+#define ALIAS(oldName, name) list.alias(oldName, name);
+#include "MoonLight/Modules/EffectNodeTypes.h"
+  return list;
+}
+
+ModuleList driverList() {
+  ModuleList list;
+#define NODE(Class, name) list.node(#Class, name);
+#define BOARD_NODE(Class, name, board) list.node(#Class, name, board);
+#define ALIAS(oldName, name) list.alias(oldName, name);
+#include "MoonLight/Modules/DriverNodeTypes.h"
+  return list;
+}
+
+}  // namespace
+
+TEST_CASE("NodeRegistry: the node types of ModuleEffects and ModuleDrivers have distinct names") {
+  for (const ModuleList& list : {effectList(), driverList()}) {
+    CHECK(list.registrations > 20);
+    CHECK_EQ(list.refused.size(), 0);
+    for (const std::string& refused : list.refused) MESSAGE("name taken: " << refused);
+    CHECK_EQ(list.registry.size(), list.registrations);
+    MESSAGE(list.names.front() << "...: " << list.registry.size() << " node types");
+  }
+  ModuleList drivers = driverList();
+  CHECK_EQ(std::string(drivers.registry.find("ArtNetIn")->name), "Network In");  // presets with renamed nodes
+  CHECK_EQ(std::string(drivers.registry.find("SE16")->board), BoardName::SE16V1);
+}
+
+TEST_CASE("NodeRegistry: every registered name resolves to its own factory") {
+  Registry registry = fakeRegistry();
+  REQUIRE_EQ(registry.size(), 9);
+  for (const Registry::Type& type : registry) {
+    const Registry::Type* found = registry.find(type.name);
+    REQUIRE(found);
+    CHECK_EQ(found, &type);
+    std::string nameAndTags = std::string(type.name) + " 🧊 " + type.tags;  // how presets store the name (buildNameAndTags)
+    CHECK_EQ(registry.find(nameAndTags.c_str()), &type);
+  }
+  CHECK_EQ(created(registry, "Star Sky"), "StarSkyEffect");
+  CHECK_EQ(created(registry, "GEQ 3D 🧊 🐙♫"), "GEQ3DEffect");
+  CHECK_EQ(created(registry, "GEQ"), "GEQEffect");  // not a prefix match
+  CHECK_EQ(created(registry, "Troy1 Color"), "Troy1ColorEffect");
+}
+
+TEST_CASE("NodeRegistry: registration order, aliases, unknown and duplicate names") {
+  Registry registry = fakeRegistry();
+  std::string order;
+  for (const Registry::Type& type : registry) order += std::string(type.name) + ",";
+  CHECK_EQ(order, "Solid,Star Sky,GEQ 3D,GEQ,DNA,Troy1 Color,Mirror,Network In,SE16,");  // the UI list, aliases not listed
+
+  CHECK_EQ(created(registry, "Art-Net In ☸️"), "NetworkInDriver");
+  CHECK_EQ(std::string(registry.find("ArtNetIn")->name), "Network In");
+  CHECK_EQ(std::string(registry.find("SE16")->board), "SE16 v1");
+  CHECK_FALSE(registry.find("Solid")->board);
+
+  CHECK(registry.find("Sol id!"));                    // symbols are ignored, as equalAZaz09 does
+  CHECK_FALSE(registry.find("solid"));                // case sensitive
+  CHECK_FALSE(registry.find("/E_fire.sc"));           // LiveScript files are not registered
+  CHECK_FALSE(registry.find(""));
+  CHECK_FALSE(registry.find(nullptr));
+
+  CHECK_FALSE(registry.add<SolidEffect>([]() -> FakeNode* { return new SolidEffect(); }));
+  CHECK_FALSE(registry.addAlias("Star-Sky", "Solid"));  // taken
+  CHECK_FALSE(registry.addAlias("Old", "Unknown"));
+  CHECK_EQ(registry.size(), 9);
+}
+
+TEST_CASE("NodeRegistry benchmark: lookup vs trying every type (checkAndAlloc chain)") {
+  // as many types as ModuleEffects registers, looked up with the name and tags stored in presets
+  for (int i = 0; i < NUMBERED_TYPES; i++) numberedNames[i] = "Effect Number " + std::to_string(i);
+  Registry registry;
+  registerNumbered(registry, std::make_integer_sequence<int, NUMBERED_TYPES>());
+  REQUIRE_EQ(registry.size(), NUMBERED_TYPES);
+  std::vector<std::string> presetNames;
+  for (const Registry::Type& type : registry) presetNames.push_back(std::string(type.name) + " ⏹️ " + type.tags);
+
+  const int loops = 20000;
+  size_t found = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < loops; i++) {
+    const char* name = presetNames[i % NUMBERED_TYPES].c_str();
+    for (const Registry::Type& type : registry)  // the checkAndAlloc chain
+      if (nodeNameEqual(name, type.name)) {
+        found++;
+        break;
+      }
+  }
+  double chainNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / loops;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < loops; i++) found += registry.find(presetNames[i % NUMBERED_TYPES].c_str()) != nullptr;
+  double registryNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / loops;
+
+  CHECK_EQ(found, 2 * loops);
+  CHECK_EQ(created(registry, "Effect Number 42"), "NumberedEffect");
+  MESSAGE("find node type of " << NUMBERED_TYPES << ": chain " << chainNs << " ns, registry " << registryNs << " ns");
+}
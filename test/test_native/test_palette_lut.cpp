@@ -0,0 +1,201 @@
+/**
+    @title     MoonLight Unit Tests — PaletteLUT
+    @file      test_palette_lut.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the 256 color table of the palette (src/MoonBase/utilities/PaletteLUT.h): for every index
+    and brightness the table gives what ColorFromPalette gives, and it is only rebuilt when the palette changes.
+    And the palette crossfade (src/MoonBase/utilities/PaletteTransition.h) feeding it a few entries per frame.
+    ColorFromPalette below is FastLED's (colorutils, LINEARBLEND, FASTLED_SCALE8_FIXED) for a 16 entry palette.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+#include "PaletteLUT.h"
+#include "PaletteTransition.h"
+
+namespace {
+
+struct RGB {
+  uint8_t r, g, b;
+  bool operator==(const RGB& o) const { return r == o.r && g == o.g && b == o.b; }
+};
+
+struct Palette16 {
+  RGB entries[16];
+};
+
+uint8_t scale8(uint8_t i, uint8_t scale) { return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8; }
+
+RGB ColorFromPalette(const Palette16& pal, uint8_t index, uint8_t brightness = 255) {
+  uint8_t hi4 = index >> 4;
+  uint8_t lo4 = index & 0x0F;
+  const RGB& entry = pal.entries[hi4];
+  uint8_t red1 = entry.r, green1 = entry.g, blue1 = entry.b;
+  if (lo4) {
+    const RGB& next = pal.entries[(hi4 + 1) & 15];
+    uint8_t f2 = lo4 << 4;
+    uint8_t f1 = 255 - f2;
+    red1 = scale8(red1, f1) + scale8(next.r, f2);
+    green1 = scale8(green1, f1) + scale8(next.g, f2);
+    blue1 = scale8(blue1, f1) + scale8(next.b, f2);
+  }
+  if (brightness != 255) {
+    if (brightness) {
+      ++brightness;  // adjust for rounding
+      if (red1) red1 = scale8(red1, brightness);
+      if (green1) green1 = scale8(green1, brightness);
+      if (blue1) blue1 = scale8(blue1, brightness);
+    } else
+      red1 = green1 = blue1 = 0;
+  }
+  return {red1, green1, blue1};
+}
+
+Palette16 rainbowPalette() {  // RainbowColors_p
+  const uint32_t colors[16] = {0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00, 0xABAB00, 0x56D500, 0x00FF00, 0x00D52A,
+                               0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5, 0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B};
+  Palette16 pal;
+  for (int i = 0; i < 16; i++) pal.entries[i] = {(uint8_t)(colors[i] >> 16), (uint8_t)(colors[i] >> 8), (uint8_t)colors[i]};
+  return pal;
+}
+
+Palette16 randomPalette(uint32_t seed) {
+  Palette16 pal;
+  for (RGB& entry : pal.entries) {
+    seed = seed * 1664525u + 1013904223u;
+    entry = {(uint8_t)(seed >> 24), (uint8_t)(seed >> 16), (uint8_t)(seed >> 8)};
+  }
+  return pal;
+}
+
+void update(PaletteLUT<RGB>& lut, const Palette16& pal) {  // as PhysicalLayer::loop
+  lut.update(pal, [&pal](uint8_t index) { return ColorFromPalette(pal, index); });
+}
+
+// effect kernels on a 64x64 panel: the palette index and brightness of a pixel, as the effects compute them
+const int width = 64, height = 64;
+RGB leds[width * height];
+
+template <typename ColorAt>
+double nsPerPixel(ColorAt colorAt, uint32_t frames) {
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t frame = 0; frame < frames; frame++)
+    for (int y = 0; y < height; y++)
+      for (int x = 0; x < width; x++) leds[y * width + x] = colorAt(x, y, frame);
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (frames * width * height);
+}
+
+}  // namespace
+
+TEST_CASE("PaletteLUT: every index and brightness equals ColorFromPalette") {
+  const Palette16 palettes[] = {rainbowPalette(), randomPalette(1), randomPalette(2), Palette16{}};
+  PaletteLUT<RGB> lut;
+  for (const Palette16& pal : palettes) {
+    update(lut, pal);
+    int mismatches = 0;
+    for (int index = 0; index < 256; index++)
+      for (int brightness = 0; brightness < 256; brightness++)
+        if (!(lut.color(index, brightness) == ColorFromPalette(pal, index, brightness))) mismatches++;
+    CHECK_EQ(mismatches, 0);
+    CHECK(lut[0x48] == ColorFromPalette(pal, 0x48));
+  }
+}
+
+TEST_CASE("PaletteLUT: only rebuilt when the palette changes") {
+  PaletteLUT<RGB> lut;
+  Palette16 pal = rainbowPalette();
+  update(lut, pal);
+  update(lut, pal);
+  CHECK_EQ(lut.builds(), 1);
+
+  pal.entries[7].g ^= 1;  // one channel of one entry (a palette LiveScript, the audio palettes)
+  update(lut, pal);
+  CHECK_EQ(lut.builds(), 2);
+  CHECK(lut[7 * 16] == pal.entries[7]);
+
+  Palette16 other = randomPalette(3);
+  for (int frame = 0; frame < 100; frame++) update(lut, frame < 50 ? pal : other);
+  CHECK_EQ(lut.builds(), 3);
+}
+
+TEST_CASE("PaletteTransition: blends towards the new palette a few entries per frame, ends on it") {
+  Palette16 from = rainbowPalette(), to = randomPalette(4), pal = from;
+  PaletteTransition<RGB> transition;
+  PaletteLUT<RGB> lut, full;
+  update(lut, pal);
+  int calls = 0, maxCalls = 0;
+
+  transition.start(pal.entries, to.entries, 1000, 5000);
+  CHECK(transition.active());
+  CHECK(pal.entries[3] == from.entries[3]);  // nothing changes before the first frame
+  for (uint32_t now = 5000; transition.active(); now += 20) {  // 50 fps
+    transition.step(pal.entries, now);
+    calls = 0;
+    lut.update(pal, [&](uint8_t index) {
+      calls++;
+      return ColorFromPalette(pal, index);
+    });
+    if (transition.active()) maxCalls = std::max(maxCalls, calls);
+    full = PaletteLUT<RGB>();
+    update(full, pal);
+    for (int i = 0; i < 256; i++) REQUIRE(lut[i] == full[i]);  // the partial rebuild is the full table
+    if (now == 5500) {                                           // halfway every entry is between old and new
+      for (int i = 0; i < 16; i++) {
+        uint8_t lo = std::min(from.entries[i].r, to.entries[i].r), hi = std::max(from.entries[i].r, to.entries[i].r);
+        CHECK(pal.entries[i].r >= lo);
+        CHECK(pal.entries[i].r <= hi);
+        CHECK(std::abs((int)pal.entries[i].r - PaletteTransition<RGB>::blend(from.entries[i].r, to.entries[i].r, 127)) <= (hi - lo) / 10 + 1);  // at most 3 frames behind
+      }
+    }
+  }
+  for (int i = 0; i < 16; i++) CHECK(pal.entries[i] == to.entries[i]);
+  CHECK(maxCalls <= PALETTE_TRANSITION_ENTRIES * 31 + 1);  // not the whole table per frame
+  MESSAGE("palette transition: at most " << maxCalls << " of 256 colors rebuilt per frame");
+
+  // a new palette halfway: continues from the palette as shown, 0 ms is at once
+  Palette16 next = randomPalette(5);
+  transition.start(pal.entries, next.entries, 400, 0);
+  transition.step(pal.entries, 200);
+  Palette16 shown = pal;
+  transition.start(pal.entries, from.entries, 0, 200);
+  CHECK_FALSE(transition.active());
+  for (int i = 0; i < 16; i++) CHECK(pal.entries[i] == from.entries[i]);
+  transition.start(pal.entries, shown.entries, 100, 300);
+  transition.stop();
+  CHECK_FALSE(transition.step(pal.entries, 1000));
+  CHECK(pal.entries[0] == from.entries[0]);  // stopped: left as it was
+}
+
+TEST_CASE("PaletteLUT benchmark: ColorFromPalette vs table per pixel") {
+  Palette16 pal = rainbowPalette();
+  PaletteLUT<RGB> lut;
+  update(lut, pal);
+  const uint32_t frames = 200;
+  uint32_t seed = 42;
+  auto random8 = [&seed]() { return (uint8_t)((seed = seed * 1664525u + 1013904223u) >> 24); };
+
+  // Rainbow: index from position and time, full brightness
+  double rainbowFn = nsPerPixel([&](int x, int y, uint32_t f) { return ColorFromPalette(pal, x * 4 + y * 2 + f); }, frames);
+  double rainbowLut = nsPerPixel([&](int x, int y, uint32_t f) { return lut.color(x * 4 + y * 2 + f); }, frames);
+  // Plasma: index and brightness per pixel
+  double plasmaFn = nsPerPixel([&](int x, int y, uint32_t f) { return ColorFromPalette(pal, (x * y + f) >> 2, (x ^ y) * 4 + f); }, frames);
+  double plasmaLut = nsPerPixel([&](int x, int y, uint32_t f) { return lut.color((x * y + f) >> 2, (x ^ y) * 4 + f); }, frames);
+  // Sparkle: random index, random brightness
+  double sparkleFn = nsPerPixel([&](int, int, uint32_t) { return ColorFromPalette(pal, random8(), random8()); }, frames);
+  double sparkleLut = nsPerPixel([&](int, int, uint32_t) { return lut.color(random8(), random8()); }, frames);
+
+  uint32_t lit = 0;  // the kernels wrote the panel (and are not optimized away)
+  for (const RGB& led : leds) lit += led.r | led.g | led.b;
+  CHECK(lit > 0);
+  MESSAGE("ns per pixel, ColorFromPalette / table: rainbow " << rainbowFn << " / " << rainbowLut << ", plasma " << plasmaFn << " / " << plasmaLut << ", sparkle " << sparkleFn << " / "
+                                                             << sparkleLut);
+}
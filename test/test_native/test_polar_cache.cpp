@@ -0,0 +1,144 @@
+/**
+    @title     MoonLight Unit Tests — PolarCache
+    @file      test_polar_cache.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the per-layer angle and distance tables of radial effects
+    (src/MoonBase/utilities/PolarCache.h): the tables match atan2 / hypot from the layer centre, are built once per
+    size, and a radial effect frame reading them is compared with one computing atan2f / hypotf per light.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "PolarCache.h"
+
+namespace {
+
+int angleError(uint16_t angle, double radians) {
+  int expected = (int)lround(radians * 65536.0 / (2 * M_PI));
+  return std::abs((int16_t)(uint16_t)(angle - expected));
+}
+
+// a radial effect (Octopus like): the intensity of a light from its angle and distance, per frame
+uint8_t wave(uint8_t angle, uint16_t radius, uint32_t step) { return (uint8_t)(angle * 4 - radius / 16 + step); }
+
+std::vector<uint8_t> leds;
+
+double floatFrameUs(int width, int height, int frames) {
+  leds.assign((size_t)width * height, 0);
+  auto start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++)
+    for (int y = 0; y < height; y++)
+      for (int x = 0; x < width; x++) {
+        float dx = x - width / 2.0f, dy = y - height / 2.0f;
+        uint8_t angle = (int)floorf(40.7436f * atan2f(dy, dx));  // 128 * atan2 / π
+        uint16_t radius = hypotf(dx, dy) * 16;
+        leds[x + y * width] = wave(angle, radius, frame);
+      }
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+double cachedFrameUs(PolarCache<>& cache, int width, int height, int frames) {
+  leds.assign((size_t)width * height, 0);
+  auto start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++) {
+    const PolarCoord* polar = cache.plane(PolarXY, width, height);  // as effects do in loop(): built in the first frame
+    for (int y = 0; y < height; y++)
+      for (int x = 0; x < width; x++) {
+        const PolarCoord& coord = polar[x + y * width];
+        leds[x + y * width] = wave((int16_t)coord.angle >> 8, coord.radius, frame);
+      }
+  }
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+}  // namespace
+
+TEST_CASE("PolarCache: angle and radius of every light from the layer centre") {
+  PolarCache<> cache;
+  for (auto [width, height] : {std::pair<int, int>{16, 16}, {15, 9}, {64, 1}, {128, 128}}) {
+    const PolarCoord* polar = cache.plane(PolarXY, width, height);
+    REQUIRE(polar);
+    int maxAngleError = 0, maxRadiusError = 0;
+    for (int y = 0; y < height; y++)
+      for (int x = 0; x < width; x++) {
+        double dx = x - width / 2.0, dy = y - height / 2.0;
+        const PolarCoord& coord = polar[x + y * width];
+        if (dx || dy) maxAngleError = std::max(maxAngleError, angleError(coord.angle, atan2(dy, dx)));
+        maxRadiusError = std::max(maxRadiusError, std::abs(coord.radius - (int)floor(hypot(dx, dy) * 16)));
+      }
+    CHECK(maxAngleError <= 2);
+    CHECK_EQ(maxRadiusError, 0);
+  }
+
+  const uint16_t* sphere = cache.sphere(9, 8, 7);
+  REQUIRE(sphere);
+  for (int z = 0; z < 7; z++)
+    for (int y = 0; y < 8; y++)
+      for (int x = 0; x < 9; x++) REQUIRE_EQ(sphere[x + y * 9 + z * 72], (uint16_t)floor(sqrt(pow(x - 4.5, 2) + pow(y - 4.0, 2) + pow(z - 3.5, 2)) * 16));
+
+  const PolarCoord* table = cache.plane(PolarXY, 15, 9);  // the same per light when effects have no table (low on memory)
+  for (int y = 0; y < 9; y++)
+    for (int x = 0; x < 15; x++) {
+      PolarCoord coord = polarCoord(x, y, 15, 9);
+      REQUIRE_EQ(coord.angle, table[x + y * 15].angle);
+      REQUIRE_EQ(coord.radius, table[x + y * 15].radius);
+    }
+
+  const PolarCoord* xz = cache.plane(PolarXZ, 4, 4);  // x, z: its own table
+  CHECK_EQ(xz[0].radius, (uint16_t)floor(sqrt(8.0) * 16));
+  CHECK_EQ(xz[3 + 3 * 4].angle, 8192);  // 45°
+}
+
+TEST_CASE("PolarCache: built once per size, again after invalidate or release") {
+  PolarCache<> cache;
+  const PolarCoord* first = cache.plane(PolarXY, 32, 32);
+  CHECK_EQ(cache.plane(PolarXY, 32, 32), first);
+  CHECK_EQ(cache.builds(), 1);
+
+  cache.plane(PolarXZ, 32, 8);
+  CHECK_EQ(cache.builds(), 2);
+  cache.plane(PolarXY, 32, 16);  // the layer size changed: the table follows even without invalidate
+  CHECK_EQ(cache.builds(), 3);
+  CHECK_EQ(cache.plane(PolarXY, 32, 16)[0].radius, (uint16_t)floor(hypot(16.0, 8.0) * 16));
+
+  cache.invalidate();  // VirtualLayer on a size change
+  cache.plane(PolarXY, 32, 16);
+  cache.sphere(4, 4, 4);
+  cache.sphere(4, 4, 4);
+  CHECK_EQ(cache.builds(), 5);
+  CHECK(cache.bytes() >= 32 * 32 * sizeof(PolarCoord) + 64 * sizeof(uint16_t));
+
+  cache.release();  // low on heap (MemBudget)
+  CHECK_EQ(cache.bytes(), 0u);
+  CHECK_EQ(cache.plane(PolarXY, 32, 16)[0].radius, (uint16_t)floor(hypot(16.0, 8.0) * 16));
+  CHECK_EQ(cache.builds(), 6);
+}
+
+TEST_CASE("PolarCache benchmark: radial effect frame with atan2f / hypotf per light and with the table") {
+  for (int size : {64, 128}) {
+    PolarCache<> cache;
+    const int frames = 100;
+    double floatUs = floatFrameUs(size, size, frames);
+    std::vector<uint8_t> floatLeds = leds;
+    double cachedUs = cachedFrameUs(cache, size, size, frames);
+    int differing = 0;
+    for (size_t i = 0; i < leds.size(); i++) {
+      uint8_t distance = leds[i] - floatLeds[i];  // across the wrap of 255 to 0
+      differing += std::min<int>(distance, 256 - distance) > 4;  // angles 1/256 turn apart at a bucket edge, times 4
+    }
+    CHECK(differing < (int)leds.size() / 50);  // the same frame
+    CHECK_EQ(cache.builds(), 1);
+    MESSAGE(size << "x" << size << ": " << floatUs << " us per frame computing, " << cachedUs << " us from the table (" << cache.bytes() / 1024 << " KB)");
+  }
+}
@@ -0,0 +1,356 @@
+/**
+    @title     MoonLight Unit Tests — RenderScheduler
+    @file      test_render_scheduler.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for multi-core rendering: the frame plan (planRender) and the worker
+    pool (RenderWorkers, std::thread stand-ins for the ESP32 helper task).
+    The Julia effect's own rows (JuliaKernel.h, as JuliaEffect::loopRows renders them) give the same frame untiled
+    and tiled over 2 to 4 workers.
+    The benchmark renders effect-like kernels and the Julia kernel serially and tiled over 2 workers and reports the
+    speed-up.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "MoonBase/utilities/JuliaKernel.h"
+#include "MoonLight/Layers/RenderScheduler.h"
+
+// ============================================================
+// planRender
+// ============================================================
+
+TEST_CASE("planRender: one worker renders every layer in one job on worker 0") {
+  RenderLoad loads[3];
+  loads[0].cost = 4096;
+  loads[0].rows = 64;
+  loads[0].tileable = true;
+  loads[1].cost = 0;  // empty layer
+  loads[2].cost = 100;
+  RenderJob jobs[RENDER_MAX_JOBS];
+  uint8_t n = planRender(loads, 3, 1, jobs, RENDER_MAX_JOBS);
+  CHECK_EQ(n, 2);
+  for (uint8_t i = 0; i < n; i++) {
+    CHECK_EQ(jobs[i].worker, 0);
+    CHECK_EQ(jobs[i].tiled, loads[jobs[i].layer].tileable);  // a tileable layer is one tile of all rows
+    CHECK_EQ(jobs[i].rowStart, 0);
+    CHECK_EQ(jobs[i].rowEnd, loads[jobs[i].layer].rows);
+  }
+}
+
+TEST_CASE("planRender: tileable layer is split in disjoint row bands covering all rows") {
+  RenderLoad load;
+  load.cost = 64 * 64;
+  load.rows = 64;
+  load.tileable = true;
+  RenderJob jobs[RENDER_MAX_JOBS];
+  uint8_t n = planRender(&load, 1, 2, jobs, RENDER_MAX_JOBS);
+  REQUIRE_EQ(n, 2);
+  bool covered[64] = {};
+  for (uint8_t i = 0; i < n; i++) {
+    CHECK(jobs[i].tiled);
+    for (uint16_t r = jobs[i].rowStart; r < jobs[i].rowEnd; r++) {
+      CHECK_FALSE(covered[r]);  // no row rendered twice
+      covered[r] = true;
+    }
+  }
+  for (bool c : covered) CHECK(c);
+  CHECK(jobs[0].worker != jobs[1].worker);
+  CHECK_EQ(planMakespan(jobs, n), 64 * 32);
+}
+
+TEST_CASE("planRender: uneven rows are split without gaps") {
+  RenderLoad load;
+  load.cost = 10000;
+  load.rows = 7;
+  load.tileable = true;
+  RenderJob jobs[RENDER_MAX_JOBS];
+  uint8_t n = planRender(&load, 1, 4, jobs, RENDER_MAX_JOBS);
+  REQUIRE_EQ(n, 4);
+  uint16_t rows = 0;
+  for (uint8_t i = 0; i < n; i++) rows += jobs[i].rowEnd - jobs[i].rowStart;
+  CHECK_EQ(rows, 7);
+}
+
+TEST_CASE("planRender: more workers than rows gives one row per tile") {
+  RenderLoad load;
+  load.cost = 5000;
+  load.rows = 2;
+  load.tileable = true;
+  RenderJob jobs[RENDER_MAX_JOBS];
+  CHECK_EQ(planRender(&load, 1, 4, jobs, RENDER_MAX_JOBS), 2);
+}
+
+TEST_CASE("planRender: small or non-tileable layers are not split, non-tileable ones run on worker 0") {
+  RenderLoad loads[2];
+  loads[0].cost = 100;  // below minTileCost
+  loads[0].rows = 10;
+  loads[0].tileable = true;
+  loads[1].cost = 5000;
+  loads[1].rows = 50;
+  loads[1].tileable = false;
+  RenderJob jobs[RENDER_MAX_JOBS];
+  uint8_t n = planRender(loads, 2, 2, jobs, RENDER_MAX_JOBS);
+  REQUIRE_EQ(n, 2);
+  for (uint8_t i = 0; i < n; i++) {
+    CHECK_EQ(jobs[i].rowStart, 0);
+    CHECK_EQ(jobs[i].rowEnd, loads[jobs[i].layer].rows);
+    if (jobs[i].layer == 1) {
+      CHECK_FALSE(jobs[i].tiled);  // whole layer, loop() on effectTask
+      CHECK_EQ(jobs[i].worker, 0);
+    } else {
+      CHECK(jobs[i].tiled);  // one tile of all rows, on the helper
+      CHECK_EQ(jobs[i].worker, 1);
+    }
+  }
+}
+
+TEST_CASE("planRender: layers that are not tileable never leave worker 0") {
+  RenderLoad loads[3];
+  uint32_t costs[3] = {4000, 3000, 2000};
+  for (int i = 0; i < 3; i++) {
+    loads[i].cost = costs[i];
+    loads[i].rows = 64;
+  }
+  RenderJob jobs[RENDER_MAX_JOBS];
+  uint8_t n = planRender(loads, 3, RENDER_MAX_WORKERS, jobs, RENDER_MAX_JOBS);
+  REQUIRE_EQ(n, 3);
+  for (uint8_t i = 0; i < n; i++) {
+    CHECK_EQ(jobs[i].worker, 0);
+    CHECK_FALSE(jobs[i].tiled);
+  }
+  CHECK_EQ(planMakespan(jobs, n), 9000);  // as serial rendering
+}
+
+TEST_CASE("planRender: pinned layers stay on worker 0, others balance around them") {
+  RenderLoad loads[3];
+  loads[0].cost = 3000;
+  loads[0].pinned = true;  // LiveScript
+  loads[1].cost = 2000;
+  loads[1].tileable = true;
+  loads[2].cost = 1000;
+  loads[2].tileable = true;
+  RenderJob jobs[RENDER_MAX_JOBS];
+  uint8_t n = planRender(loads, 3, 2, jobs, RENDER_MAX_JOBS);
+  REQUIRE_EQ(n, 3);
+  for (uint8_t i = 0; i < n; i++) {
+    if (jobs[i].layer == 0) CHECK_EQ(jobs[i].worker, 0);
+    else CHECK_EQ(jobs[i].worker, 1);
+  }
+  CHECK_EQ(planMakespan(jobs, n), 3000);
+}
+
+TEST_CASE("planRender: longest first balances independent layers") {
+  RenderLoad loads[4];
+  uint32_t costs[4] = {500, 4000, 1500, 2000};
+  for (int i = 0; i < 4; i++) {
+    loads[i].cost = costs[i];
+    loads[i].tileable = true;  // one row each: not split
+  }
+  RenderJob jobs[RENDER_MAX_JOBS];
+  uint8_t n = planRender(loads, 4, 2, jobs, RENDER_MAX_JOBS);
+  CHECK_EQ(n, 4);
+  CHECK_EQ(planMakespan(jobs, n), 4000);  // {4000} vs {2000, 1500, 500}
+}
+
+TEST_CASE("planRender: never writes more than maxJobs") {
+  RenderLoad loads[16];
+  for (auto& load : loads) {
+    load.cost = 10000;
+    load.rows = 100;
+    load.tileable = true;
+  }
+  RenderJob jobs[RENDER_MAX_JOBS];
+  CHECK_EQ(planRender(loads, 16, RENDER_MAX_WORKERS, jobs, RENDER_MAX_JOBS), RENDER_MAX_JOBS);
+  CHECK_EQ(planRender(loads, 16, RENDER_MAX_WORKERS, jobs, 5), 5);
+}
+
+// ============================================================
+// RenderWorkers
+// ============================================================
+
+TEST_CASE("RenderWorkers: without helpers run() executes on the caller only") {
+  RenderWorkers workers;
+  CHECK_EQ(workers.nrOfWorkers(), 1);
+  int calls = 0;
+  auto work = [&](uint8_t worker) {
+    CHECK_EQ(worker, 0);
+    calls++;
+  };
+  workers.run(work);
+  CHECK_EQ(calls, 1);
+}
+
+TEST_CASE("RenderWorkers: every worker runs once per run() and run() is a barrier") {
+  RenderWorkers workers;
+  REQUIRE_EQ(workers.begin(3), 4);
+  for (int frame = 0; frame < 1000; frame++) {
+    std::atomic<int> mask{0};
+    auto work = [&](uint8_t worker) { mask |= 1 << worker; };
+    workers.run(work);
+    CHECK_EQ(mask.load(), 0xF);  // all 4 done when run() returns
+  }
+  workers.end();
+  CHECK_EQ(workers.nrOfWorkers(), 1);
+}
+
+TEST_CASE("RenderWorkers: restart after end()") {
+  RenderWorkers workers;
+  for (int round = 0; round < 20; round++) {
+    REQUIRE_EQ(workers.begin(1), 2);
+    std::atomic<int> calls{0};
+    auto work = [&](uint8_t) { calls++; };
+    workers.run(work);
+    workers.run(work);
+    CHECK_EQ(calls.load(), 4);
+    workers.end();
+  }
+}
+
+// ============================================================
+// The Julia effect tiled, and a benchmark of effect-like kernels, serial vs tiled over 2 workers
+// ============================================================
+
+namespace {
+
+constexpr uint16_t benchCols = 128;
+constexpr uint16_t benchRows = 128;
+
+// integer wave kernel, like Distortion Waves
+void distortionRows(uint8_t* rgb, uint16_t rowStart, uint16_t rowEnd, uint16_t t) {
+  for (uint16_t y = rowStart; y < rowEnd; y++)
+    for (uint16_t x = 0; x < benchCols; x++) {
+      uint8_t* p = &rgb[(y * benchCols + x) * 3];
+      for (int c = 0; c < 3; c++) {
+        uint16_t d = (x - 40 - c * 5) * (x - 40 - c * 5) + (y - 60 + c * 7) * (y - 60 + c * 7);
+        p[c] = (uint8_t)(((x << 3) + t) ^ ((y << 3) - t / 2)) + (uint8_t)(t - (d >> 7)) * 2;
+      }
+    }
+}
+
+// the values of JuliaEffect::loopFrame at the default controls (whole set, c moving with t)
+JuliaFrame juliaFrame(uint16_t cols, uint16_t rows, uint16_t t) {
+  JuliaFrame frame;
+  frame.xmin = toJulia(-1.0f);
+  frame.ymin = toJulia(-0.8f);
+  frame.stepX = toJulia(2.0f / cols);
+  frame.stepY = toJulia(1.8f / rows);
+  frame.re = toJulia(-0.94299f + t / 4000.f);  // the effect moves c by up to 0.05 (sin16 / 655340)
+  frame.im = toJulia(0.3162f - t / 8000.f);
+  frame.maxIterations = 32;
+  return frame;
+}
+
+// the Julia effect's rows, colored as JuliaEffect::loopRows does (palette index, black inside the set)
+void juliaRender(const JuliaFrame& frame, uint8_t* rgb, uint16_t cols, uint16_t rowStart, uint16_t rowEnd) {
+  juliaRows(frame, cols, rowStart, rowEnd, [&](uint16_t column, uint16_t row, int iter) {
+    uint8_t* p = &rgb[(row * cols + column) * 3];
+    p[0] = p[1] = p[2] = iter == frame.maxIterations ? 0 : iter * 255 / frame.maxIterations;
+  });
+}
+
+void juliaBench(uint8_t* rgb, uint16_t rowStart, uint16_t rowEnd, uint16_t t) { juliaRender(juliaFrame(benchCols, benchRows, t), rgb, benchCols, rowStart, rowEnd); }
+
+// transcendental per pixel, like Plasma / Noise 2D
+void plasmaRows(uint8_t* rgb, uint16_t rowStart, uint16_t rowEnd, uint16_t t) {
+  for (uint16_t y = rowStart; y < rowEnd; y++)
+    for (uint16_t x = 0; x < benchCols; x++) {
+      float v = sinf(x * 0.11f + t * 0.01f) + cosf(y * 0.07f - t * 0.02f) + sinf((x + y) * 0.05f);
+      uint8_t* p = &rgb[(y * benchCols + x) * 3];
+      p[0] = (uint8_t)(v * 40 + 128);
+      p[1] = (uint8_t)(v * 20 + 64);
+      p[2] = (uint8_t)(255 - p[0]);
+    }
+}
+
+typedef void (*RowsKernel)(uint8_t*, uint16_t, uint16_t, uint16_t);
+
+double renderFrames(RenderWorkers& workers, RowsKernel kernel, uint8_t* rgb, int frames) {
+  RenderLoad load;
+  load.cost = benchCols * benchRows;
+  load.rows = benchRows;
+  load.tileable = true;
+  RenderJob jobs[RENDER_MAX_JOBS];
+  auto start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++) {
+    uint8_t n = planRender(&load, 1, workers.nrOfWorkers(), jobs, RENDER_MAX_JOBS);
+    auto work = [&](uint8_t worker) {
+      for (uint8_t j = 0; j < n; j++)
+        if (jobs[j].worker == worker) kernel(rgb, jobs[j].rowStart, jobs[j].rowEnd, frame);
+    };
+    workers.run(work);
+  }
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+}  // namespace
+
+TEST_CASE("Julia effect rows: the same frame untiled and tiled over 2, 3 and 4 workers") {
+  // uneven sizes: bands of different heights, the last band shorter
+  const uint16_t sizes[][2] = {{128, 128}, {61, 37}, {16, 9}};
+  for (const auto& size : sizes) {
+    const uint16_t cols = size[0], rows = size[1];
+    for (uint16_t t = 0; t < 200; t += 40) {
+      JuliaFrame frame = juliaFrame(cols, rows, t);
+      std::vector<uint8_t> untiled(cols * rows * 3, 1);
+      juliaRender(frame, untiled.data(), cols, 0, rows);  // loop(): loopFrame(); loopRows(0, rows)
+
+      size_t inside = 0;
+      for (size_t n = 0; n < untiled.size(); n += 3) inside += untiled[n] == 0;
+      CHECK(inside > 0);  // the frame has both the set and the escaping pixels
+      CHECK(inside < untiled.size() / 3);
+
+      for (uint8_t helpers = 1; helpers <= 3; helpers++) {
+        RenderWorkers workers;
+        REQUIRE_EQ(workers.begin(helpers), helpers + 1);
+        RenderLoad load;
+        load.cost = cols * rows;
+        load.rows = rows;
+        load.tileable = true;
+        RenderJob jobs[RENDER_MAX_JOBS];
+        uint8_t n = planRender(&load, 1, workers.nrOfWorkers(), jobs, RENDER_MAX_JOBS, 1);  // tile small layers too
+        CHECK_EQ(n, workers.nrOfWorkers());  // really tiled
+
+        std::vector<uint8_t> tiled(cols * rows * 3, 2);
+        auto work = [&](uint8_t worker) {
+          for (uint8_t j = 0; j < n; j++)
+            if (jobs[j].worker == worker) juliaRender(frame, tiled.data(), cols, jobs[j].rowStart, jobs[j].rowEnd);
+        };
+        workers.run(work);
+        workers.end();
+        CHECK(tiled == untiled);
+      }
+    }
+  }
+}
+
+TEST_CASE("RenderScheduler benchmark: speed-up per effect on 128x128, 2 workers") {
+  struct Bench {
+    const char* name;
+    RowsKernel kernel;
+  } benches[] = {{"Distortion Waves", distortionRows}, {"Julia", juliaBench}, {"Plasma", plasmaRows}};
+  const int frames = 50;
+
+  for (const Bench& bench : benches) {
+    std::vector<uint8_t> serialRGB(benchCols * benchRows * 3), parallelRGB(benchCols * benchRows * 3);
+
+    RenderWorkers serial;
+    double serialUs = renderFrames(serial, bench.kernel, serialRGB.data(), frames);
+
+    RenderWorkers parallel;
+    REQUIRE_EQ(parallel.begin(1), 2);
+    double parallelUs = renderFrames(parallel, bench.kernel, parallelRGB.data(), frames);
+    parallel.end();
+
+    CHECK(serialRGB == parallelRGB);  // tiles produce exactly the serial frame
+    MESSAGE(bench.name << ": serial " << serialUs << " us/frame, 2 workers " << parallelUs << " us/frame, speed-up " << serialUs / parallelUs << "x");
+  }
+}
@@ -0,0 +1,46 @@
+/**
+    @title     MoonLight Unit Tests — ScriptExternals
+    @file      test_script_externals.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the externals of LiveScript (src/MoonBase/utilities/ScriptExternals.h): definitions of
+    externals split as the linker takes them, and the functions a script defines.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <string>
+
+#include "ScriptExternals.h"
+
+TEST_CASE("ScriptExternals: externals split into return type, name and parameters") {
+  ExternalSymbol symbol;
+  REQUIRE(parseExternal("uint8_t beatsin8(uint16_t,uint8_t,uint8_t,uint32_t,uint8_t)", symbol));
+  CHECK(symbol.isFunction);
+  CHECK_EQ(symbol.returnType, "uint8_t");
+  CHECK_EQ(symbol.name, "beatsin8");
+  CHECK_EQ(symbol.parameters, "uint16_t,uint8_t,uint8_t,uint32_t,uint8_t");
+
+  REQUIRE(parseExternal("void nextPin()", symbol));
+  CHECK(symbol.isFunction);
+  CHECK_EQ(symbol.name, "nextPin");
+  CHECK(symbol.parameters.empty());
+
+  REQUIRE(parseExternal("CRGB* leds", symbol));
+  CHECK_FALSE(symbol.isFunction);
+  CHECK_EQ(symbol.returnType, "CRGB*");
+  CHECK_EQ(symbol.name, "leds");
+  CHECK(symbol.parameters.empty());  // nothing left of the function before
+
+  CHECK_FALSE(parseExternal("millis", symbol));               // no type
+  CHECK_FALSE(parseExternal("void delay(uint32_t", symbol));  // no closing parenthesis
+}
+
+TEST_CASE("ScriptExternals: the functions a script defines") {
+  CHECK_EQ(scriptFunctions("void setup() {} void loop() {}"), SCRIPT_SETUP | SCRIPT_LOOP);
+  CHECK_EQ(scriptFunctions("void onLayout() {} void modifyPosition(Coord3D &p) {}"), SCRIPT_ONLAYOUT | SCRIPT_MODIFY);
+  CHECK_EQ(scriptFunctions("void main() {}"), 0);
+}
@@ -0,0 +1,193 @@
+/**
+    @title     MoonBase Unit Tests — SpscQueue
+    @file      test_spsc_queue.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the lock-free single-producer / single-consumer queue
+    used to hand node control changes to effectTask / driverTask.
+    The stress tests run a real producer and consumer thread.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "MoonBase/utilities/SpscQueue.h"
+
+// ============================================================
+// Single-threaded behaviour
+// ============================================================
+
+TEST_CASE("SpscQueue: starts empty") {
+  SpscQueue<int, 8> q;
+  int v = -1;
+  CHECK(q.empty());
+  CHECK_EQ(q.size(), 0u);
+  CHECK_FALSE(q.pop(v));
+  CHECK_EQ(v, -1);  // untouched when empty
+}
+
+TEST_CASE("SpscQueue: capacity is N - 1") {
+  SpscQueue<int, 8> q;
+  CHECK_EQ(q.capacity(), 7u);
+  for (int i = 0; i < 7; i++) CHECK(q.push(i));
+  CHECK_EQ(q.size(), 7u);
+  CHECK_FALSE(q.push(99));  // full
+  CHECK_EQ(q.dropped(), 1u);
+}
+
+TEST_CASE("SpscQueue: FIFO order") {
+  SpscQueue<int, 8> q;
+  for (int i = 0; i < 5; i++) q.push(i * 10);
+  int v;
+  for (int i = 0; i < 5; i++) {
+    REQUIRE(q.pop(v));
+    CHECK_EQ(v, i * 10);
+  }
+  CHECK(q.empty());
+}
+
+TEST_CASE("SpscQueue: wraps around the ring") {
+  SpscQueue<int, 4> q;
+  int v;
+  for (int round = 0; round < 100; round++) {
+    CHECK(q.push(round));
+    CHECK(q.push(round + 1000));
+    REQUIRE(q.pop(v));
+    CHECK_EQ(v, round);
+    REQUIRE(q.pop(v));
+    CHECK_EQ(v, round + 1000);
+  }
+  CHECK(q.empty());
+  CHECK_EQ(q.dropped(), 0u);
+}
+
+TEST_CASE("SpscQueue: drain processes all items in order") {
+  SpscQueue<int, 16> q;
+  for (int i = 1; i <= 10; i++) q.push(i);
+  int sum = 0;
+  int last = 0;
+  bool ordered = true;
+  size_t n = q.drain([&](const int& v) {
+    if (v != last + 1) ordered = false;
+    last = v;
+    sum += v;
+  });
+  CHECK_EQ(n, 10u);
+  CHECK_EQ(sum, 55);
+  CHECK(ordered);
+  CHECK(q.empty());
+  CHECK_EQ(q.drain([](const int&) {}), 0u);
+}
+
+TEST_CASE("SpscQueue: a full queue accepts items again after a pop") {
+  SpscQueue<int, 4> q;
+  for (int i = 0; i < 3; i++) q.push(i);
+  CHECK_FALSE(q.push(3));
+  int v;
+  q.pop(v);
+  CHECK(q.push(3));
+  CHECK_EQ(q.size(), 3u);
+}
+
+// ============================================================
+// Stress: one producer thread, one consumer thread
+// ============================================================
+
+// Payload similar to NodeCommand: a pointer and a value copied in, text included
+struct StressItem {
+  uint32_t seq = 0;
+  uint32_t check = 0;  // derived from seq to detect torn reads
+  void* p = nullptr;
+  char text[32] = {};  // the seq as text
+};
+
+TEST_CASE("SpscQueue stress: every item arrives once, in order, untorn") {
+  constexpr uint32_t count = 200000;
+  SpscQueue<StressItem, 32> q;  // same capacity as the node command queues
+  std::atomic<bool> ok{true};
+
+  std::thread consumer([&] {
+    uint32_t expected = 0;
+    StressItem item;
+    while (expected < count) {
+      if (q.pop(item)) {
+        if (item.seq != expected || item.check != (item.seq ^ 0xA5A5A5A5u) || item.p != &q || strtoul(item.text, nullptr, 10) != item.seq) ok = false;
+        expected++;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::thread producer([&] {
+    for (uint32_t i = 0; i < count;) {
+      StressItem item;
+      item.seq = i;
+      item.check = i ^ 0xA5A5A5A5u;
+      item.p = &q;
+      snprintf(item.text, sizeof(item.text), "%u", (unsigned)i);
+      if (q.push(item))
+        i++;
+      else
+        std::this_thread::yield();  // full: retry, like a producer waiting for the next frame
+    }
+  });
+
+  producer.join();
+  consumer.join();
+
+  CHECK(ok.load());
+  CHECK(q.empty());
+}
+
+TEST_CASE("SpscQueue stress: frame-style drain with bursty producer") {
+  // Consumer drains once per "frame" like PhysicalLayer::loop(); producer pushes bursts
+  // and drops (counts) items when the queue is full, like queueNodeCommand's fallback path.
+  constexpr uint32_t bursts = 2000;
+  SpscQueue<uint32_t, 32> q;
+  std::atomic<bool> producerDone{false};
+  std::atomic<bool> ordered{true};
+  uint32_t pushed = 0;
+  uint32_t received = 0;
+
+  std::thread consumer([&] {
+    uint32_t last = 0;
+    bool first = true;
+    for (;;) {
+      bool done = producerDone.load();
+      q.drain([&](const uint32_t& v) {
+        if (!first && v <= last) ordered = false;
+        first = false;
+        last = v;
+        received++;
+      });
+      if (done && q.empty()) break;
+      std::this_thread::yield();  // next frame
+    }
+  });
+
+  std::thread producer([&] {
+    uint32_t seq = 0;
+    for (uint32_t b = 0; b < bursts; b++) {
+      for (int i = 0; i < 20; i++) {
+        if (q.push(++seq)) pushed++;
+      }
+      std::this_thread::yield();
+    }
+    producerDone = true;
+  });
+
+  producer.join();
+  consumer.join();
+
+  CHECK(ordered.load());
+  CHECK_EQ(received, pushed);
+  CHECK_EQ(pushed + q.dropped(), bursts * 20);
+}
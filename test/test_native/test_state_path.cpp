@@ -0,0 +1,250 @@
+/**
+    @title     MoonBase Unit Tests — StatePath
+    @file      test_state_path.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for path-addressed state updates (StatePath.h): parsing, applying one value
+    and the benchmark of a path update against the full-tree compare of ModuleState::update.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "StatePath.h"
+
+// ============================================================
+// parseStatePath
+// ============================================================
+
+TEST_CASE("parseStatePath: control value two rows deep") {
+  StatePath path;
+  REQUIRE(parseStatePath("nodes[3].controls[5].value", path));
+  CHECK_EQ(path.depth, 3);
+  CHECK_EQ(std::string(path.steps[0].key), "nodes");
+  CHECK_EQ(path.steps[0].index, 3);
+  CHECK_EQ(std::string(path.steps[1].key), "controls");
+  CHECK_EQ(path.steps[1].index, 5);
+  CHECK_EQ(std::string(path.name()), "value");
+  CHECK_EQ(path.steps[2].index, UINT8_MAX);
+
+  const char* parent[2];
+  uint8_t index[2];
+  path.location(parent, index);
+  CHECK_EQ(std::string(parent[0]), "nodes");
+  CHECK_EQ(index[0], 3);
+  CHECK_EQ(std::string(parent[1]), "controls");
+  CHECK_EQ(index[1], 5);
+}
+
+TEST_CASE("parseStatePath: root and row values") {
+  StatePath path;
+  REQUIRE(parseStatePath("brightness", path));
+  CHECK_EQ(path.depth, 1);
+  const char* parent[2];
+  uint8_t index[2];
+  path.location(parent, index);
+  CHECK_EQ(std::string(parent[0]), "");
+  CHECK_EQ(index[0], UINT8_MAX);
+
+  REQUIRE(parseStatePath("nodes[0].on", path));
+  path.location(parent, index);
+  CHECK_EQ(std::string(parent[0]), "nodes");
+  CHECK_EQ(index[0], 0);
+  CHECK_EQ(std::string(parent[1]), "");
+  CHECK_EQ(index[1], UINT8_MAX);
+}
+
+TEST_CASE("parseStatePath: malformed paths are rejected") {
+  StatePath path;
+  const char* bad[] = {"", "nodes[", "nodes[]", "nodes[3", "nodes[a].on", "nodes[3]x", "nodes..on", ".on", "nodes[3].", "nodes[255].on", "a.b.c.d.e", "a_key_longer_than_twenty_three"};
+  for (const char* text : bad) {
+    CAPTURE(text);
+    CHECK_FALSE(parseStatePath(text, path));
+  }
+  CHECK_FALSE(parseStatePath(nullptr, path));
+  CHECK(parseStatePath("nodes[254].on", path));
+}
+
+// ============================================================
+// applyStatePath
+// ============================================================
+
+namespace {
+
+const char* stateJson =
+    "{\"brightness\":10,\"nodes\":[{\"name\":\"Solid\",\"on\":true,\"controls\":[]},"
+    "{\"name\":\"Lava\",\"on\":true,\"p\":1234,\"controls\":[{\"name\":\"speed\",\"value\":128},{\"name\":\"center\",\"value\":{\"x\":1,\"y\":2}}]}]}";
+
+struct Applied {
+  int calls = 0;
+  std::string name, oldValue, value;
+  StatePathResult result;
+};
+
+Applied apply(JsonObject state, const char* pathText, const char* valueJson) {
+  JsonDocument valueDoc;
+  deserializeJson(valueDoc, valueJson);
+  StatePath path;
+  Applied applied;
+  REQUIRE(parseStatePath(pathText, path));
+  applied.result = applyStatePath(state, path, valueDoc.as<JsonVariantConst>(), [&](const StatePath& changed, JsonVariant oldValue, JsonVariant value) {
+    applied.calls++;
+    applied.name = changed.name();
+    serializeJson(oldValue, applied.oldValue);
+    serializeJson(value, applied.value);
+  });
+  return applied;
+}
+
+}  // namespace
+
+TEST_CASE("applyStatePath: sets a control value and reports it once") {
+  JsonDocument state;
+  deserializeJson(state, stateJson);
+  Applied applied = apply(state.as<JsonObject>(), "nodes[1].controls[0].value", "200");
+  CHECK(applied.result == StatePathResult::changed);
+  CHECK_EQ(applied.calls, 1);
+  CHECK_EQ(applied.name, "value");
+  CHECK_EQ(applied.oldValue, "128");
+  CHECK_EQ(applied.value, "200");
+  CHECK_EQ(state["nodes"][1]["controls"][0]["value"].as<int>(), 200);
+}
+
+TEST_CASE("applyStatePath: same value is unchanged") {
+  JsonDocument state;
+  deserializeJson(state, stateJson);
+  Applied applied = apply(state.as<JsonObject>(), "brightness", "10");
+  CHECK(applied.result == StatePathResult::unchanged);
+  CHECK_EQ(applied.calls, 0);
+}
+
+TEST_CASE("applyStatePath: objects are compared and replaced as a whole") {
+  JsonDocument state;
+  deserializeJson(state, stateJson);
+  CHECK(apply(state.as<JsonObject>(), "nodes[1].controls[1].value", "{\"x\":1,\"y\":2}").result == StatePathResult::unchanged);
+  Applied applied = apply(state.as<JsonObject>(), "nodes[1].controls[1].value", "{\"x\":3,\"y\":2}");
+  CHECK(applied.result == StatePathResult::changed);
+  CHECK_EQ(applied.oldValue, "{\"x\":1,\"y\":2}");
+  CHECK_EQ(state["nodes"][1]["controls"][1]["value"]["x"].as<int>(), 3);
+}
+
+TEST_CASE("applyStatePath: a missing key in an existing row is added") {
+  JsonDocument state;
+  deserializeJson(state, stateJson);
+  Applied applied = apply(state.as<JsonObject>(), "nodes[0].label", "\"first\"");
+  CHECK(applied.result == StatePathResult::changed);
+  CHECK_EQ(applied.oldValue, "null");
+  CHECK_EQ(state["nodes"][0]["label"].as<std::string>(), "first");
+}
+
+TEST_CASE("applyStatePath: paths outside the state, pointers and arrays are invalid") {
+  JsonDocument state;
+  deserializeJson(state, stateJson);
+  std::string before;
+  serializeJson(state, before);
+  CHECK(apply(state.as<JsonObject>(), "nodes[2].on", "false").result == StatePathResult::invalid);                  // no such row
+  CHECK(apply(state.as<JsonObject>(), "layers[0].on", "false").result == StatePathResult::invalid);                 // no such array
+  CHECK(apply(state.as<JsonObject>(), "nodes.on", "false").result == StatePathResult::invalid);                     // row without index
+  CHECK(apply(state.as<JsonObject>(), "nodes[1].p", "1").result == StatePathResult::invalid);                       // pointer
+  CHECK(apply(state.as<JsonObject>(), "nodes[1].controls", "[]").result == StatePathResult::invalid);               // rows
+  CHECK(apply(state.as<JsonObject>(), "nodes[1].controls[0]", "{}").result == StatePathResult::invalid);            // a row itself
+  CHECK(apply(state.as<JsonObject>(), "brightness", "null").result == StatePathResult::invalid);                    // no value
+  CHECK(apply(state.as<JsonObject>(), "brightness.x", "1").result == StatePathResult::invalid);                     // not a row
+  std::string after;
+  serializeJson(state, after);
+  CHECK_EQ(before, after);
+}
+
+// ============================================================
+// Benchmark: full-tree compare (ModuleState::update) vs path update
+// ============================================================
+
+namespace {
+
+// Copied from ModuleState::compareRecursive (Module.cpp), without swap detection and logging: the cost of the
+// full-tree walk for one changed value. Returns the number of changed values.
+int compareRecursive(const JsonVariant& stateData, const JsonVariant& newData) {
+  int changes = 0;
+  for (JsonPair newControl : newData.as<JsonObject>()) {
+    if (stateData[newControl.key()].isNull()) stateData[newControl.key()] = nullptr;
+  }
+  for (JsonPair stateControl : stateData.as<JsonObject>()) {
+    JsonString key = stateControl.key();
+    JsonVariant stateValue = stateData[key.c_str()];
+    JsonVariant newValue = newData[key.c_str()];
+    if (!newValue.isNull() && stateValue != newValue) {
+      if (stateValue.is<JsonArray>() || newValue.is<JsonArray>()) {
+        JsonArray stateArray = stateValue.as<JsonArray>();
+        JsonArray newArray = newValue.as<JsonArray>();
+        for (size_t i = 0; i < newArray.size() && i < stateArray.size(); i++) changes += compareRecursive(stateArray[i], newArray[i]);
+      } else if (key != "p") {
+        stateData[key.c_str()] = newValue;
+        changes++;
+      }
+    }
+  }
+  return changes;
+}
+
+void makeState(JsonDocument& doc, int nrOfNodes, int nrOfControls) {
+  JsonArray nodes = doc["nodes"].to<JsonArray>();
+  for (int n = 0; n < nrOfNodes; n++) {
+    JsonObject node = nodes.add<JsonObject>();
+    node["name"] = "Effect " + std::to_string(n);
+    node["on"] = true;
+    JsonArray controls = node["controls"].to<JsonArray>();
+    for (int c = 0; c < nrOfControls; c++) {
+      JsonObject control = controls.add<JsonObject>();
+      control["name"] = "control" + std::to_string(c);
+      control["type"] = "slider";
+      control["value"] = c;
+      control["p"] = 1000 + c;
+    }
+  }
+}
+
+}  // namespace
+
+TEST_CASE("StatePath benchmark: one slider on 20 nodes × 15 controls") {
+  const int nrOfNodes = 20, nrOfControls = 15, rounds = 200;
+  JsonDocument fullState, pathState;
+  makeState(fullState, nrOfNodes, nrOfControls);
+  makeState(pathState, nrOfNodes, nrOfControls);
+
+  // what the UI sent before: the whole nodes array with one value changed
+  JsonDocument message;
+  makeState(message, nrOfNodes, nrOfControls);
+
+  auto start = std::chrono::steady_clock::now();
+  int fullChanges = 0;
+  for (int r = 0; r < rounds; r++) {
+    message["nodes"][12]["controls"][7]["value"] = 1000 + r;
+    fullChanges += compareRecursive(fullState.as<JsonVariant>(), message.as<JsonVariant>());
+  }
+  double fullUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+  // what the UI sends now: {"_path":"nodes[12].controls[7].value","_value":...}
+  StatePath path;
+  int pathChanges = 0;
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) {
+    JsonDocument value;
+    value.set(1000 + r);
+    REQUIRE(parseStatePath("nodes[12].controls[7].value", path));
+    applyStatePath(pathState.as<JsonObject>(), path, value.as<JsonVariantConst>(), [&](const StatePath&, JsonVariant, JsonVariant) { pathChanges++; });
+  }
+  double pathUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+  CHECK_EQ(fullChanges, rounds);  // both report exactly one change per update
+  CHECK_EQ(pathChanges, rounds);
+  CHECK((fullState.as<JsonVariantConst>() == pathState.as<JsonVariantConst>()));
+  MESSAGE(nrOfNodes * nrOfControls << " controls: full compare " << fullUs << " us/update, path update " << pathUs << " us/update, " << fullUs / pathUs << "x");
+}
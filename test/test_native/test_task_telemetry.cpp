@@ -0,0 +1,159 @@
+/**
+    @title     MoonLight Unit Tests — TaskTelemetry
+    @file      test_task_telemetry.cpp
+    @repo      https://github.com/MoonModules/MoonLight
+    @Copyright © 2026 GitHub MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+
+    Native unit tests for the task telemetry of ModuleTasks (src/MoonBase/utilities/TaskTelemetry.h): CPU % per task
+    and core load over a window of wrapping run time counters, tasks that come and go, wait accounting of the frame
+    pipeline from two threads, and the 60 second ring with min / avg / max and its CSV.
+    Run with: pio test -e native
+**/
+
+#include "doctest.h"
+
+#include <string>
+#include <thread>
+
+#include "TaskTelemetry.h"
+
+namespace {
+
+TaskRunTime task(uintptr_t id, uint32_t counter, int8_t idleCore = -1) {
+  TaskRunTime runTime;
+  runTime.id = id;
+  runTime.counter = counter;
+  runTime.idleCore = idleCore;
+  return runTime;
+}
+
+}  // namespace
+
+TEST_CASE("CpuWindow: CPU per task over the window, not since boot") {
+  CpuWindow<8> cpu;
+  uint16_t permille[4];
+
+  // boot: effects ran 900 of 1000 (cumulative), the first sample has no window yet
+  TaskRunTime first[] = {task(1, 900), task(2, 50), task(10, 40, 0), task(11, 950, 1)};
+  cpu.update(first, 4, 1000, permille);
+  CHECK_EQ(permille[0], TELEMETRY_UNKNOWN);
+  CHECK_EQ(cpu.coreLoad(0), TELEMETRY_UNKNOWN);
+
+  // the next second effects only ran 250 of 1000: 25 %, where the cumulative share would still be 57 %
+  TaskRunTime second[] = {task(1, 1150), task(2, 150), task(10, 640, 0), task(11, 1850, 1)};
+  cpu.update(second, 4, 2000, permille);
+  CHECK_EQ(permille[0], 250);
+  CHECK_EQ(permille[1], 100);
+  CHECK_EQ(permille[2], 600);  // idle 0
+  CHECK_EQ(cpu.coreLoad(0), 400);
+  CHECK_EQ(cpu.coreLoad(1), 100);
+  CHECK_EQ(cpu.coreLoad(2), TELEMETRY_UNKNOWN);
+
+  // a task started (3), one ended (2), and the order changed: matched by id
+  TaskRunTime third[] = {task(3, 300), task(11, 2350, 1), task(1, 1650)};
+  cpu.update(third, 3, 3000, permille);
+  CHECK_EQ(permille[0], TELEMETRY_UNKNOWN);
+  CHECK_EQ(permille[1], 500);
+  CHECK_EQ(permille[2], 500);
+  CHECK_EQ(cpu.coreLoad(1), 500);
+  CHECK_EQ(cpu.coreLoad(0), TELEMETRY_UNKNOWN);  // idle 0 not sampled
+}
+
+TEST_CASE("CpuWindow: counters and total wrap") {
+  CpuWindow<4> cpu;
+  uint16_t permille[2];
+
+  // 32-bit microsecond counters wrap after 71 minutes
+  TaskRunTime before[] = {task(1, UINT32_MAX - 99), task(2, 5)};
+  cpu.update(before, 2, UINT32_MAX - 499, permille);
+  TaskRunTime after[] = {task(1, 300), task(2, 2000)};  // 400 and 1995 later
+  cpu.update(after, 2, 500, permille);                  // 1000 later
+  CHECK_EQ(permille[0], 400);
+  CHECK_EQ(permille[1], 1000);  // clamped: a task can't use more than its core
+
+  cpu.update(after, 2, 500, permille);  // no time passed
+  CHECK_EQ(permille[0], TELEMETRY_UNKNOWN);
+}
+
+TEST_CASE("CpuWindow: more tasks than it keeps") {
+  CpuWindow<2> cpu;
+  uint16_t permille[3];
+  TaskRunTime first[] = {task(1, 0), task(2, 0), task(3, 0)};
+  cpu.update(first, 3, 0, permille);
+  TaskRunTime second[] = {task(1, 100), task(2, 200), task(3, 300)};
+  cpu.update(second, 3, 1000, permille);
+  CHECK_EQ(permille[0], 100);
+  CHECK_EQ(permille[1], 200);
+  CHECK_EQ(permille[2], TELEMETRY_UNKNOWN);  // not kept, never known
+}
+
+TEST_CASE("WaitPoint: waits added by two tasks, taken per window") {
+  WaitPoint wait;
+  std::thread effects([&]() {
+    for (int n = 0; n < 10000; n++) wait.add(2);
+  });
+  std::thread drivers([&]() {
+    for (int n = 0; n < 10000; n++) wait.add(n == 5000 ? 700 : 1);
+  });
+  effects.join();
+  drivers.join();
+
+  WaitPoint::Window window = wait.take();
+  CHECK_EQ(window.count, 20000u);
+  CHECK_EQ(window.us, 20000u + 9999u + 700u);
+  CHECK_EQ(window.maxUs, 700u);
+  CHECK_EQ(WaitPoint::permille(window, 1000000), 30);  // 30.7 ms of a second
+
+  window = wait.take();  // the next window starts empty
+  CHECK_EQ(window.count, 0u);
+  CHECK_EQ(window.us, 0u);
+  CHECK_EQ(WaitPoint::permille(window, 0), TELEMETRY_UNKNOWN);
+}
+
+TEST_CASE("TelemetryRing: the last 60 seconds, min / avg / max") {
+  TelemetryRing<2> ring;
+  CHECK_EQ(ring.count(), 0u);
+  CHECK_EQ(ring.last(0), TELEMETRY_UNKNOWN);
+  CHECK_EQ(ring.summary(0).avg, TELEMETRY_UNKNOWN);
+
+  for (uint32_t second = 0; second < 75; second++) {
+    uint16_t values[2] = {(uint16_t)second, (uint16_t)(second % 10 == 0 ? TELEMETRY_UNKNOWN : 500)};
+    ring.push(second, values);
+  }
+  CHECK_EQ(ring.count(), (size_t)TELEMETRY_SECONDS);
+  CHECK_EQ(ring.at(0, 0), 15);  // 15 .. 74
+  CHECK_EQ(ring.last(0), 74);
+
+  TelemetryRing<2>::Summary summary = ring.summary(0);
+  CHECK_EQ(summary.min, 15);
+  CHECK_EQ(summary.max, 74);
+  CHECK_EQ(summary.avg, 45);  // 44.5 rounded
+
+  summary = ring.summary(1);  // unknown values left out
+  CHECK_EQ(summary.min, 500);
+  CHECK_EQ(summary.avg, 500);
+}
+
+TEST_CASE("TelemetryRing: CSV") {
+  TelemetryRing<3, 4> ring;
+  const TelemetryColumn columns[] = {{"core0_pct", 1}, {"lps", 0}, {"wait_ms", 3}};
+  uint16_t first[] = {255, 120, 1500};
+  uint16_t second[] = {1000, 118, TELEMETRY_UNKNOWN};
+  ring.push(7, first);
+  ring.push(8, second);
+
+  std::string csv;
+  size_t lines = 0;
+  ring.csv(columns, [&](const char* line, size_t length) {
+    csv.append(line, length);
+    lines++;
+  });
+  CHECK_EQ(lines, 3u);
+  CHECK(csv == "second,core0_pct,lps,wait_ms\n7,25.5,120,1.500\n8,100.0,118,\n");
+
+  char text[8];
+  size_t length = TelemetryRing<3, 4>::format(text, sizeof(text), 5, 1);
+  CHECK_EQ(length, 3u);
+  CHECK(std::string(text) == "0.5");
+}